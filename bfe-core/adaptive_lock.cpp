@@ -0,0 +1,291 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       adaptive_lock.cpp
+/// \brief      Implementation of class "CAdaptiveLock"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-12
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#include "adaptive_lock.h"
+
+//--- Standard header --------------------------------------------------------//
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+//--- Misc header ------------------------------------------------------------//
+#ifdef __linux__
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+using namespace bfe;
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t),
+              "Futex requires lock free 32 bit atomic without overhead");
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Global list of named locks
+///
+////////////////////////////////////////////////////////////////////////////////
+struct AdaptiveLockRegistry
+{
+    std::mutex                  Access;    ///< Locks list, registration is rare
+    std::vector<CAdaptiveLock*> Locks;     ///< Named locks
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns global list of named locks, constructed on first use
+///
+/// \return Registry of named locks
+///
+////////////////////////////////////////////////////////////////////////////////
+static AdaptiveLockRegistry& getAdaptiveLockRegistry()
+{
+    static AdaptiveLockRegistry s_Registry;
+    return s_Registry;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Gives the processor a hint that the thread is spinning
+///
+////////////////////////////////////////////////////////////////////////////////
+static inline void spinPause()
+{
+    #if defined(_MSC_VER)
+        _mm_pause();
+    #elif (defined(__clang__) || defined(__GNUC__)) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_ia32_pause();
+    #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Constructor for anonymous lock, which isn't registered
+///
+////////////////////////////////////////////////////////////////////////////////
+CAdaptiveLock::CAdaptiveLock() : CAdaptiveLock("")
+{
+    METHOD_ENTRY("CAdaptiveLock::CAdaptiveLock")
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Constructor, registering named lock
+///
+/// \param _strName Name of lock, statistics might be queried by
+///
+////////////////////////////////////////////////////////////////////////////////
+CAdaptiveLock::CAdaptiveLock(const std::string& _strName) : m_strName(_strName)
+{
+    METHOD_ENTRY("CAdaptiveLock::CAdaptiveLock")
+    CTOR_CALL("CAdaptiveLock::CAdaptiveLock")
+
+    for (auto& Waits : m_Waits) Waits.store(0u, std::memory_order_relaxed);
+
+    if (!m_strName.empty())
+    {
+        AdaptiveLockRegistry& Registry = getAdaptiveLockRegistry();
+        std::lock_guard<std::mutex> Lock(Registry.Access);
+        Registry.Locks.push_back(this);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Destructor, unregistering named lock
+///
+////////////////////////////////////////////////////////////////////////////////
+CAdaptiveLock::~CAdaptiveLock()
+{
+    METHOD_ENTRY("CAdaptiveLock::~CAdaptiveLock")
+    DTOR_CALL("CAdaptiveLock::~CAdaptiveLock")
+
+    if (!m_strName.empty())
+    {
+        AdaptiveLockRegistry& Registry = getAdaptiveLockRegistry();
+        std::lock_guard<std::mutex> Lock(Registry.Access);
+        Registry.Locks.erase(std::remove(Registry.Locks.begin(), Registry.Locks.end(), this),
+                             Registry.Locks.end());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the statistics of this lock as readable text
+///
+/// \return Statistics
+///
+////////////////////////////////////////////////////////////////////////////////
+std::string CAdaptiveLock::getStatistics() const
+{
+    METHOD_ENTRY("CAdaptiveLock::getStatistics")
+
+    std::ostringstream oss;
+    oss << (m_strName.empty() ? "<anonymous>" : m_strName) << ":"
+        << " acquisitions=" << this->getAcquisitions()
+        << " contentions=" << this->getContentions()
+        << " spins=" << this->getSpins()
+        << " parks=" << this->getParks()
+        << " waits[us]=";
+
+    // Skip empty buckets to keep output short
+    bool bFirst = true;
+    for (auto i=0; i<ADAPTIVE_LOCK_HISTOGRAM_BUCKETS; ++i)
+    {
+        const std::uint64_t nWaits = this->getWaits(i);
+        if (nWaits == 0u) continue;
+        if (!bFirst) oss << ",";
+        if (i == ADAPTIVE_LOCK_HISTOGRAM_BUCKETS-1)
+            oss << ">=" << (1u << (i-1));
+        else
+            oss << "<" << (1u << i);
+        oss << ":" << nWaits;
+        bFirst = false;
+    }
+    if (bFirst) oss << "-";
+    return oss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Resets all statistics of this lock
+///
+////////////////////////////////////////////////////////////////////////////////
+void CAdaptiveLock::resetStatistics()
+{
+    METHOD_ENTRY("CAdaptiveLock::resetStatistics")
+
+    m_nAcquisitions.store(0u, std::memory_order_relaxed);
+    m_nContentions.store(0u, std::memory_order_relaxed);
+    m_nParks.store(0u, std::memory_order_relaxed);
+    m_nSpins.store(0u, std::memory_order_relaxed);
+    for (auto& Waits : m_Waits) Waits.store(0u, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the statistics of named locks as readable text
+///
+/// \param _strName Name of lock, all locks if empty
+///
+/// \return Statistics, one line per lock
+///
+////////////////////////////////////////////////////////////////////////////////
+std::string CAdaptiveLock::getStatistics(const std::string& _strName)
+{
+    METHOD_ENTRY("CAdaptiveLock::getStatistics")
+
+    AdaptiveLockRegistry& Registry = getAdaptiveLockRegistry();
+    std::lock_guard<std::mutex> Lock(Registry.Access);
+
+    std::string strStatistics;
+    for (const auto pLock : Registry.Locks)
+    {
+        if (_strName.empty() || pLock->getName() == _strName)
+        {
+            if (!strStatistics.empty()) strStatistics += "\n";
+            strStatistics += pLock->getStatistics();
+        }
+    }
+    return strStatistics;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Acquires the lock if it is taken
+///
+/// Spins with exponential backoff first, then parks the thread until the lock
+/// is released.
+///
+////////////////////////////////////////////////////////////////////////////////
+void CAdaptiveLock::acquireLockContended()
+{
+    METHOD_ENTRY("CAdaptiveLock::acquireLockContended")
+
+    using namespace std::chrono;
+    const auto Start = steady_clock::now();
+
+    m_nContentions.fetch_add(1u, std::memory_order_relaxed);
+
+    bool bAcquired = false;
+    for (auto nBackoff=1; nBackoff<=ADAPTIVE_LOCK_BACKOFF_MAX && !bAcquired; nBackoff*=2)
+    {
+        for (auto i=0; i<nBackoff; ++i) spinPause();
+        m_nSpins.fetch_add(1u, std::memory_order_relaxed);
+
+        std::uint32_t nExpected = ADAPTIVE_LOCK_FREE;
+        bAcquired = m_nState.load(std::memory_order_relaxed) == ADAPTIVE_LOCK_FREE &&
+                    m_nState.compare_exchange_strong(nExpected, ADAPTIVE_LOCK_LOCKED,
+                                                     std::memory_order_acquire,
+                                                     std::memory_order_relaxed);
+    }
+
+    if (!bAcquired)
+    {
+        // Mark lock as possibly having parked threads. If it was free in the
+        // meantime, it is acquired (in parked state, causing one superfluous
+        // wake up on release).
+        while (m_nState.exchange(ADAPTIVE_LOCK_PARKED, std::memory_order_acquire) != ADAPTIVE_LOCK_FREE)
+        {
+            m_nParks.fetch_add(1u, std::memory_order_relaxed);
+            #ifdef __linux__
+                syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&m_nState), FUTEX_WAIT_PRIVATE,
+                        ADAPTIVE_LOCK_PARKED, nullptr, nullptr, 0);
+            #else
+                std::this_thread::yield();
+            #endif
+        }
+    }
+
+    m_nAcquisitions.fetch_add(1u, std::memory_order_relaxed);
+
+    const auto nWait = duration_cast<microseconds>(steady_clock::now() - Start).count();
+    int nBucket = 0;
+    while (nBucket < ADAPTIVE_LOCK_HISTOGRAM_BUCKETS-1 && nWait >= (1 << nBucket)) ++nBucket;
+    m_Waits[nBucket].fetch_add(1u, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Wakes up one parked thread
+///
+////////////////////////////////////////////////////////////////////////////////
+void CAdaptiveLock::wake()
+{
+    METHOD_ENTRY("CAdaptiveLock::wake")
+
+    #ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&m_nState), FUTEX_WAKE_PRIVATE,
+                1, nullptr, nullptr, 0);
+    #endif
+}
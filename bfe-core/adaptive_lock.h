@@ -0,0 +1,258 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       adaptive_lock.h
+/// \brief      Prototype of class "CAdaptiveLock"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-12
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ADAPTIVE_LOCK_H
+#define ADAPTIVE_LOCK_H
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+//--- Program header ---------------------------------------------------------//
+#include "log.h"
+
+/// BFEngine namespace
+namespace bfe
+{
+
+//--- Constants --------------------------------------------------------------//
+constexpr int ADAPTIVE_LOCK_BACKOFF_MAX         = 64;   ///< Maximum number of pauses per spin before parking
+constexpr int ADAPTIVE_LOCK_HISTOGRAM_BUCKETS   = 16;   ///< Number of buckets of wait time histogram
+
+constexpr std::uint32_t ADAPTIVE_LOCK_FREE      = 0u;   ///< Lock is free
+constexpr std::uint32_t ADAPTIVE_LOCK_LOCKED    = 1u;   ///< Lock is locked, no thread is parked
+constexpr std::uint32_t ADAPTIVE_LOCK_PARKED    = 2u;   ///< Lock is locked, threads might be parked
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Lock spinning with exponential backoff, then parking the thread
+///
+/// If the lock is taken, the thread spins for a short time, doubling the
+/// number of pauses each round. If it still can't acquire the lock, it is
+/// parked on a futex (Linux) and woken up as soon as the lock is released.
+/// Hence, there is no fixed sleep adding latency. On other platforms, parked
+/// threads yield instead.
+///
+/// Each lock counts its acquisitions, contentions, spins and parks and keeps
+/// a histogram of wait times of contended acquisitions. Bucket 0 counts
+/// waits below 1us, bucket i waits of [2^(i-1), 2^i) us, the last bucket all
+/// longer waits. Named locks are registered globally, their statistics might
+/// be queried by name, e.g. using command "lock_stats" of the com interface.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CAdaptiveLock
+{
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        CAdaptiveLock();
+        explicit CAdaptiveLock(const std::string&);
+        ~CAdaptiveLock();
+
+        CAdaptiveLock(const CAdaptiveLock&) = delete;
+        CAdaptiveLock& operator=(const CAdaptiveLock&) = delete;
+
+        //--- Constant methods -----------------------------------------------//
+        const std::string& getName() const;
+        std::uint64_t      getAcquisitions() const;
+        std::uint64_t      getContentions() const;
+        std::uint64_t      getParks() const;
+        std::uint64_t      getSpins() const;
+        std::uint64_t      getWaits(const int) const;
+        std::string        getStatistics() const;
+
+        //--- Methods --------------------------------------------------------//
+        void acquireLock();
+        void releaseLock();
+        bool tryLock();
+        void resetStatistics();
+
+        //--- Static methods -------------------------------------------------//
+        static std::string getStatistics(const std::string&);
+
+    private:
+
+        //--- Methods [private] ----------------------------------------------//
+        void acquireLockContended();
+        void wake();
+
+        //--- Variables [private] --------------------------------------------//
+        std::atomic<std::uint32_t>  m_nState{ADAPTIVE_LOCK_FREE};   ///< State of lock
+        std::atomic<std::uint64_t>  m_nAcquisitions{0u};            ///< Number of acquisitions
+        std::atomic<std::uint64_t>  m_nContentions{0u};             ///< Number of acquisitions that had to wait
+        std::atomic<std::uint64_t>  m_nParks{0u};                   ///< Number of times a thread was parked
+        std::atomic<std::uint64_t>  m_nSpins{0u};                   ///< Number of spin rounds
+        std::atomic<std::uint64_t>  m_Waits[ADAPTIVE_LOCK_HISTOGRAM_BUCKETS]; ///< Histogram of wait times
+
+        std::string                 m_strName;                      ///< Name of lock, registered if not empty
+};
+
+//--- Implementation is done here for inline optimisation --------------------//
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the name of the lock
+///
+/// \return Name of lock
+///
+////////////////////////////////////////////////////////////////////////////////
+inline const std::string& CAdaptiveLock::getName() const
+{
+    METHOD_ENTRY("CAdaptiveLock::getName")
+    return m_strName;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the number of acquisitions
+///
+/// \return Number of acquisitions
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint64_t CAdaptiveLock::getAcquisitions() const
+{
+    METHOD_ENTRY("CAdaptiveLock::getAcquisitions")
+    return m_nAcquisitions.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the number of acquisitions that had to wait
+///
+/// \return Number of contentions
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint64_t CAdaptiveLock::getContentions() const
+{
+    METHOD_ENTRY("CAdaptiveLock::getContentions")
+    return m_nContentions.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the number of times a thread was parked
+///
+/// \return Number of parks
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint64_t CAdaptiveLock::getParks() const
+{
+    METHOD_ENTRY("CAdaptiveLock::getParks")
+    return m_nParks.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the number of spin rounds
+///
+/// \return Number of spin rounds
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint64_t CAdaptiveLock::getSpins() const
+{
+    METHOD_ENTRY("CAdaptiveLock::getSpins")
+    return m_nSpins.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the number of contended acquisitions in given bucket of
+///        wait time histogram
+///
+/// \param _nBucket Bucket of histogram
+///
+/// \return Number of contended acquisitions
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint64_t CAdaptiveLock::getWaits(const int _nBucket) const
+{
+    METHOD_ENTRY("CAdaptiveLock::getWaits")
+    BFE_ASSERT(_nBucket >= 0 && _nBucket < ADAPTIVE_LOCK_HISTOGRAM_BUCKETS);
+    return m_Waits[_nBucket].load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Acquires the lock, waiting if it is taken
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void CAdaptiveLock::acquireLock()
+{
+    METHOD_ENTRY("CAdaptiveLock::acquireLock")
+
+    std::uint32_t nExpected = ADAPTIVE_LOCK_FREE;
+    if (m_nState.compare_exchange_strong(nExpected, ADAPTIVE_LOCK_LOCKED, std::memory_order_acquire,
+                                                                          std::memory_order_relaxed))
+    {
+        m_nAcquisitions.fetch_add(1u, std::memory_order_relaxed);
+        return;
+    }
+    this->acquireLockContended();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Releases the lock, waking up a parked thread
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void CAdaptiveLock::releaseLock()
+{
+    METHOD_ENTRY("CAdaptiveLock::releaseLock")
+
+    if (m_nState.exchange(ADAPTIVE_LOCK_FREE, std::memory_order_release) == ADAPTIVE_LOCK_PARKED)
+        this->wake();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Acquires the lock if it is free
+///
+/// \return Lock acquired?
+///
+////////////////////////////////////////////////////////////////////////////////
+inline bool CAdaptiveLock::tryLock()
+{
+    METHOD_ENTRY("CAdaptiveLock::tryLock")
+
+    std::uint32_t nExpected = ADAPTIVE_LOCK_FREE;
+    if (m_nState.compare_exchange_strong(nExpected, ADAPTIVE_LOCK_LOCKED, std::memory_order_acquire,
+                                                                          std::memory_order_relaxed))
+    {
+        m_nAcquisitions.fetch_add(1u, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+} // namespace bfe
+
+#endif // ADAPTIVE_LOCK_H
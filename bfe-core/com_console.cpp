@@ -241,7 +241,7 @@ void CComConsole::execute()
     {
         try
         {
-            m_strRet = m_pComInterface->call(m_strCurrent);
+            m_pComInterface->call(m_strCurrent, m_strRet);
         }
         catch (const CComInterfaceException& ComIntEx)
         {
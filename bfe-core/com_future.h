@@ -0,0 +1,485 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       com_future.h
+/// \brief      Prototype of classes "CComAsyncState" and "CComFuture"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-31
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COM_FUTURE_H
+#define COM_FUTURE_H
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+
+//--- Program header ---------------------------------------------------------//
+#include "log.h"
+
+/// BFEngine namespace
+namespace bfe
+{
+
+/// States of an asynchronous call
+enum class ComAsyncStateType : std::uint8_t
+{
+    PENDING = 0,        ///< Not called yet
+    CONTINUATION = 1,   ///< Not called yet, continuation set
+    READY = 2,          ///< Called, result available
+    FAILED = 3          ///< Never called or thrown, no result available
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Base of the state shared by an asynchronous call and its future
+///
+/// The result is published by the state, hence, no lock is needed: Whoever
+/// comes last, the thread fulfilling or the thread setting the continuation,
+/// calls the continuation. A failed call never calls the continuation. The
+/// continuation can be set once.
+///
+////////////////////////////////////////////////////////////////////////////////
+class IComAsyncState
+{
+
+    public:
+
+        //--- Constant methods -----------------------------------------------//
+        bool isDone() const;
+        bool isFailed() const;
+        bool isReady() const;
+        void wait() const;
+
+        //--- Methods --------------------------------------------------------//
+        void fail();
+
+    protected:
+
+        //--- Methods [protected] --------------------------------------------//
+        bool claimContinuation();
+        bool publish();
+        bool setContinuation();
+
+        //--- Variables [protected] ------------------------------------------//
+        std::atomic<ComAsyncStateType> m_State{ComAsyncStateType::PENDING}; ///< State of call
+        std::atomic<bool>              m_bContinuationClaimed{false};       ///< Indicates continuation set, in any state
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief State shared by an asynchronous call and its future
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class TRet>
+class CComAsyncState : public IComAsyncState
+{
+
+    public:
+
+        /// Continuation, called with the result
+        typedef std::function<void(const TRet&)> ContinuationType;
+
+        //--- Constant methods -----------------------------------------------//
+        const TRet& get() const;
+
+        //--- Methods --------------------------------------------------------//
+        void fulfil(TRet&&);
+        void then(const ContinuationType&);
+
+    private:
+
+        //--- Variables [private] --------------------------------------------//
+        TRet                m_Value{};          ///< Result of call
+        ContinuationType    m_Continuation;     ///< Called when result is available
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief State shared by an asynchronous call without result and its future
+///
+////////////////////////////////////////////////////////////////////////////////
+template <>
+class CComAsyncState<void> : public IComAsyncState
+{
+
+    public:
+
+        /// Continuation, called when done
+        typedef std::function<void()> ContinuationType;
+
+        //--- Constant methods -----------------------------------------------//
+        void get() const {}
+
+        //--- Methods --------------------------------------------------------//
+        void fulfil();
+        void then(const ContinuationType&);
+
+    private:
+
+        //--- Variables [private] --------------------------------------------//
+        ContinuationType    m_Continuation;     ///< Called when done
+};
+
+/// Shared state of an asynchronous call
+template <class TRet>
+using ComAsyncStatePtr = std::shared_ptr<CComAsyncState<TRet>>;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Result of an asynchronous call of the com interface
+///
+/// Writer functions called by \ref CComInterface::callAsync are fulfilled when
+/// their writer domain is flushed, thus, usually in another thread. The caller
+/// might poll by \ref isReady without stalling its frame, or set a
+/// continuation by \ref then.
+///
+/// Continuations are called by the thread fulfilling, i.e. the thread of the
+/// writer domain, or immediately, if the result is already available. To
+/// continue in the caller's thread, a continuation might call a writer
+/// function of the caller's domain.
+///
+/// A future is meant to be used by one thread. It fails if the function
+/// throws or is never called, e.g. if its writer domain is destroyed, thus,
+/// waiting always returns.
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class TRet>
+class CComFuture
+{
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        CComFuture() = default;
+        explicit CComFuture(ComAsyncStatePtr<TRet> _pState) : m_pState(std::move(_pState)) {}
+
+        //--- Constant methods -----------------------------------------------//
+        decltype(auto)  get() const;
+        bool            isFailed() const;
+        bool            isReady() const;
+        bool            isValid() const;
+        void            wait() const;
+
+        //--- Methods --------------------------------------------------------//
+        void then(const typename CComAsyncState<TRet>::ContinuationType&);
+
+    private:
+
+        //--- Variables [private] --------------------------------------------//
+        ComAsyncStatePtr<TRet> m_pState; ///< State shared with call, null if invalid
+};
+
+//--- Implementation is done here for inline optimisation --------------------//
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Indicates that the call is done, either ready or failed
+///
+/// \return Done?
+///
+////////////////////////////////////////////////////////////////////////////////
+inline bool IComAsyncState::isDone() const
+{
+    METHOD_ENTRY_QUIET("IComAsyncState::isDone")
+    const ComAsyncStateType State = m_State.load(std::memory_order_acquire);
+    return State == ComAsyncStateType::READY || State == ComAsyncStateType::FAILED;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Indicates that the call failed, no result will be available
+///
+/// \return Failed?
+///
+////////////////////////////////////////////////////////////////////////////////
+inline bool IComAsyncState::isFailed() const
+{
+    METHOD_ENTRY_QUIET("IComAsyncState::isFailed")
+    return m_State.load(std::memory_order_acquire) == ComAsyncStateType::FAILED;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Indicates that the result is available
+///
+/// \return Ready?
+///
+////////////////////////////////////////////////////////////////////////////////
+inline bool IComAsyncState::isReady() const
+{
+    METHOD_ENTRY_QUIET("IComAsyncState::isReady")
+    return m_State.load(std::memory_order_acquire) == ComAsyncStateType::READY;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Blocks until the result is available or the call failed
+///
+/// Never wait in the thread fulfilling, i.e. the thread flushing the writer
+/// domain.
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void IComAsyncState::wait() const
+{
+    METHOD_ENTRY_QUIET("IComAsyncState::wait")
+    while (!this->isDone()) std::this_thread::yield();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Marks the call as failed, unless already fulfilled
+///
+/// A continuation, if set, isn't called.
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void IComAsyncState::fail()
+{
+    METHOD_ENTRY_QUIET("IComAsyncState::fail")
+    ComAsyncStateType State = m_State.load(std::memory_order_relaxed);
+    while (State == ComAsyncStateType::PENDING || State == ComAsyncStateType::CONTINUATION)
+    {
+        if (m_State.compare_exchange_weak(State, ComAsyncStateType::FAILED, std::memory_order_acq_rel)) return;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Claims setting the continuation, which succeeds once
+///
+/// \return Continuation not set before?
+///
+////////////////////////////////////////////////////////////////////////////////
+inline bool IComAsyncState::claimContinuation()
+{
+    METHOD_ENTRY_QUIET("IComAsyncState::claimContinuation")
+    if (!m_bContinuationClaimed.exchange(true, std::memory_order_acq_rel)) return true;
+    WARNING_MSG_QUIET("Com Future", "Continuation already set, ignored.")
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Marks the result, written before, as available
+///
+/// \return Continuation set, to be called by fulfilling thread?
+///
+////////////////////////////////////////////////////////////////////////////////
+inline bool IComAsyncState::publish()
+{
+    METHOD_ENTRY_QUIET("IComAsyncState::publish")
+    return m_State.exchange(ComAsyncStateType::READY, std::memory_order_acq_rel) == ComAsyncStateType::CONTINUATION;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Marks the continuation, written before, as set
+///
+/// \return Still pending, i.e. continuation called by fulfilling thread?
+///
+////////////////////////////////////////////////////////////////////////////////
+inline bool IComAsyncState::setContinuation()
+{
+    METHOD_ENTRY_QUIET("IComAsyncState::setContinuation")
+    ComAsyncStateType Expected = ComAsyncStateType::PENDING;
+    return m_State.compare_exchange_strong(Expected, ComAsyncStateType::CONTINUATION, std::memory_order_acq_rel);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the result, which must be available
+///
+/// \return Result of call, default if failed
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class TRet>
+inline const TRet& CComAsyncState<TRet>::get() const
+{
+    METHOD_ENTRY_QUIET("CComAsyncState::get")
+    return m_Value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Publishes the result and calls the continuation, if set
+///
+/// \param _Value Result of call
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class TRet>
+inline void CComAsyncState<TRet>::fulfil(TRet&& _Value)
+{
+    METHOD_ENTRY_QUIET("CComAsyncState::fulfil")
+    m_Value = std::move(_Value);
+    if (this->publish()) m_Continuation(m_Value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Sets the continuation, called immediately if result is available
+///
+/// \param _Continuation Continuation, called with result
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class TRet>
+inline void CComAsyncState<TRet>::then(const ContinuationType& _Continuation)
+{
+    METHOD_ENTRY_QUIET("CComAsyncState::then")
+    if (!this->claimContinuation()) return;
+    m_Continuation = _Continuation;
+    if (!this->setContinuation() && this->isReady()) m_Continuation(m_Value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Publishes completion and calls the continuation, if set
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void CComAsyncState<void>::fulfil()
+{
+    METHOD_ENTRY_QUIET("CComAsyncState::fulfil")
+    if (this->publish()) m_Continuation();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Sets the continuation, called immediately if already done
+///
+/// \param _Continuation Continuation, called when done
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void CComAsyncState<void>::then(const ContinuationType& _Continuation)
+{
+    METHOD_ENTRY_QUIET("CComAsyncState::then")
+    if (!this->claimContinuation()) return;
+    m_Continuation = _Continuation;
+    if (!this->setContinuation() && this->isReady()) m_Continuation();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the result, blocking until available
+///
+/// The future must be valid. If the call failed, see \ref isFailed, the
+/// default value is returned.
+///
+/// \return Result of call, nothing if without result
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class TRet>
+inline decltype(auto) CComFuture<TRet>::get() const
+{
+    METHOD_ENTRY_QUIET("CComFuture::get")
+    BFE_ASSERT(m_pState != nullptr);
+    m_pState->wait();
+    if (m_pState->isFailed())
+    {
+        WARNING_MSG_QUIET("Com Future", "Call failed, no result available.")
+    }
+    return m_pState->get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Indicates that the call failed, i.e. it threw or was never called
+///
+/// \return Failed?
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class TRet>
+inline bool CComFuture<TRet>::isFailed() const
+{
+    METHOD_ENTRY_QUIET("CComFuture::isFailed")
+    BFE_ASSERT(m_pState != nullptr);
+    return m_pState->isFailed();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Indicates that the result is available, without blocking
+///
+/// \return Ready?
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class TRet>
+inline bool CComFuture<TRet>::isReady() const
+{
+    METHOD_ENTRY_QUIET("CComFuture::isReady")
+    BFE_ASSERT(m_pState != nullptr);
+    return m_pState->isReady();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Indicates that the future refers to a call
+///
+/// \return Valid?
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class TRet>
+inline bool CComFuture<TRet>::isValid() const
+{
+    METHOD_ENTRY_QUIET("CComFuture::isValid")
+    return m_pState != nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Blocks until the result is available or the call failed
+///
+/// Never wait in the thread flushing the writer domain of the function.
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class TRet>
+inline void CComFuture<TRet>::wait() const
+{
+    METHOD_ENTRY_QUIET("CComFuture::wait")
+    BFE_ASSERT(m_pState != nullptr);
+    m_pState->wait();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Sets the continuation, called once when the result is available
+///
+/// Only one continuation can be set. It isn't called if the call fails.
+///
+/// \param _Continuation Continuation, called with result, if any
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class TRet>
+inline void CComFuture<TRet>::then(const typename CComAsyncState<TRet>::ContinuationType& _Continuation)
+{
+    METHOD_ENTRY_QUIET("CComFuture::then")
+    BFE_ASSERT(m_pState != nullptr);
+    m_pState->then(_Continuation);
+}
+
+} // namespace bfe
+
+#endif // COM_FUTURE_H
@@ -31,35 +31,839 @@
 #include "com_interface.h"
 
 //--- Standard header --------------------------------------------------------//
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
 #include <sstream>
 
+//--- Program header ---------------------------------------------------------//
+#include "adaptive_lock.h"
+#include "thread_module.h"
+#include "uid_user.h"
+
 //--- Misc header ------------------------------------------------------------//
 #include <eigen3/Eigen/Geometry>
 
-using namespace Eigen;
+using namespace Eigen;
+
+thread_local const ComEntry* CComInterface::s_pAsyncEntry = nullptr;
+thread_local void* CComInterface::s_pAsyncState = nullptr;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Raises an atomic maximum to given value
+///
+/// \param _nMax Maximum
+/// \param _nValue Value
+///
+////////////////////////////////////////////////////////////////////////////////
+static void raiseMax(std::atomic<std::uint64_t>& _nMax, const std::uint64_t _nValue)
+{
+    std::uint64_t nMax = _nMax.load(std::memory_order_relaxed);
+    while (_nValue > nMax && !_nMax.compare_exchange_weak(nMax, _nValue, std::memory_order_relaxed));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Adds a call
+///
+/// \param _fTime Time of call [s]
+/// \param _nCallbacks Number of callbacks called
+///
+////////////////////////////////////////////////////////////////////////////////
+void ComCallStatistics::addCall(const double _fTime, const std::size_t _nCallbacks)
+{
+    METHOD_ENTRY_QUIET("ComCallStatistics::addCall")
+
+    const std::uint64_t nTime = std::uint64_t(_fTime*1.0e9);
+    nCalls.fetch_add(1u, std::memory_order_relaxed);
+    nCallbacks.fetch_add(_nCallbacks, std::memory_order_relaxed);
+    nTimeTotal.fetch_add(nTime, std::memory_order_relaxed);
+    raiseMax(nTimeMax, nTime);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Adds a queued writer call
+///
+/// \param _fQueued Time waited in queue [s]
+/// \param _fTime Time of call [s]
+///
+////////////////////////////////////////////////////////////////////////////////
+void ComCallStatistics::addQueued(const double _fQueued, const double _fTime)
+{
+    METHOD_ENTRY_QUIET("ComCallStatistics::addQueued")
+
+    const std::uint64_t nQueuedTime = std::uint64_t(_fQueued*1.0e9);
+    const std::uint64_t nTime = std::uint64_t(_fTime*1.0e9);
+    nQueued.fetch_add(1u, std::memory_order_relaxed);
+    nQueuedTimeTotal.fetch_add(nQueuedTime, std::memory_order_relaxed);
+    raiseMax(nQueuedTimeMax, nQueuedTime);
+    nWriterTimeTotal.fetch_add(nTime, std::memory_order_relaxed);
+    raiseMax(nWriterTimeMax, nTime);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Resets all counters and times
+///
+////////////////////////////////////////////////////////////////////////////////
+void ComCallStatistics::reset()
+{
+    METHOD_ENTRY_QUIET("ComCallStatistics::reset")
+
+    nCalls.store(0u, std::memory_order_relaxed);
+    nCallbacks.store(0u, std::memory_order_relaxed);
+    nTimeTotal.store(0u, std::memory_order_relaxed);
+    nTimeMax.store(0u, std::memory_order_relaxed);
+    nQueued.store(0u, std::memory_order_relaxed);
+    nQueuedTimeTotal.store(0u, std::memory_order_relaxed);
+    nQueuedTimeMax.store(0u, std::memory_order_relaxed);
+    nWriterTimeTotal.store(0u, std::memory_order_relaxed);
+    nWriterTimeMax.store(0u, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Return message according to exception type
+///
+/// \return Message according to exception type
+///
+////////////////////////////////////////////////////////////////////////////////
+const std::string CComInterfaceException::getMessage() const
+{
+    METHOD_ENTRY_QUIET("CComInterfaceException::getMessage")
+    
+    switch (m_EType)
+    {
+        case ComIntExceptionType::INVALID_VALUE:
+            return "Invalid parameter value";
+        case ComIntExceptionType::UNKNOWN_COMMAND:
+            return "Unknown command";
+        case ComIntExceptionType::PARAM_ERROR:
+            return "Parameter error. Wrong number or unknown value.";
+        default:
+            return "";
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads a boolean, given as 0 or 1
+///
+/// \return Value read, false if missing
+///
+///////////////////////////////////////////////////////////////////////////////
+bool CComStreamReader::readBool()
+{
+    METHOD_ENTRY_QUIET("CComStreamReader::readBool")
+    bool bValue = false;
+    m_Stream >> bValue;
+    return bValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads a floating point value
+///
+/// \return Value read, zero if missing
+///
+///////////////////////////////////////////////////////////////////////////////
+double CComStreamReader::readDouble()
+{
+    METHOD_ENTRY_QUIET("CComStreamReader::readDouble")
+    double fValue = 0.0;
+    m_Stream >> fValue;
+    return fValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads all remaining values of the stream
+///
+/// \return Values read
+///
+///////////////////////////////////////////////////////////////////////////////
+std::vector<double> CComStreamReader::readDoubleArray()
+{
+    METHOD_ENTRY_QUIET("CComStreamReader::readDoubleArray")
+    std::vector<double> Values;
+    double fValue = 0.0;
+    while (m_Stream >> fValue) Values.push_back(fValue);
+    return Values;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads an integer value
+///
+/// \return Value read, zero if missing
+///
+///////////////////////////////////////////////////////////////////////////////
+int CComStreamReader::readInt()
+{
+    METHOD_ENTRY_QUIET("CComStreamReader::readInt")
+    int nValue = 0;
+    m_Stream >> nValue;
+    return nValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads a string, i.e. the next word
+///
+/// \return Value read, empty if missing
+///
+///////////////////////////////////////////////////////////////////////////////
+std::string CComStreamReader::readString()
+{
+    METHOD_ENTRY_QUIET("CComStreamReader::readString")
+    std::string strValue("");
+    m_Stream >> strValue;
+    return strValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes a boolean as 0 or 1
+///
+/// \param _bValue Value to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComStreamWriter::writeBool(const bool _bValue)
+{
+    METHOD_ENTRY_QUIET("CComStreamWriter::writeBool")
+    this->separate() << _bValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes a floating point value
+///
+/// \param _fValue Value to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComStreamWriter::writeDouble(const double _fValue)
+{
+    METHOD_ENTRY_QUIET("CComStreamWriter::writeDouble")
+    this->separate() << _fValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes all values of an array
+///
+/// \param _Values Values to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComStreamWriter::writeDoubleArray(const std::vector<double>& _Values)
+{
+    METHOD_ENTRY_QUIET("CComStreamWriter::writeDoubleArray")
+    for (const auto fValue : _Values) this->separate() << fValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes an integer value
+///
+/// \param _nValue Value to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComStreamWriter::writeInt(const int _nValue)
+{
+    METHOD_ENTRY_QUIET("CComStreamWriter::writeInt")
+    this->separate() << _nValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes a string
+///
+/// \param _strValue Value to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComStreamWriter::writeString(const std::string& _strValue)
+{
+    METHOD_ENTRY_QUIET("CComStreamWriter::writeString")
+    this->separate() << _strValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Separates the next value from values written before
+///
+/// \return Stream to write the next value to
+///
+///////////////////////////////////////////////////////////////////////////////
+std::ostream& CComStreamWriter::separate()
+{
+    METHOD_ENTRY_QUIET("CComStreamWriter::separate")
+    if (!m_bEmpty) m_Stream << " ";
+    m_bEmpty = false;
+    return m_Stream;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Indicates whitespace, as classified by the "C" locale
+///
+/// \param _c Character
+///
+/// \return Whitespace?
+///
+////////////////////////////////////////////////////////////////////////////////
+static inline bool isWhitespace(const char _c)
+{
+    return _c == ' ' || _c == '\t' || _c == '\n' || _c == '\v' || _c == '\f' || _c == '\r';
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads a boolean, given as 0 or 1
+///
+/// \return Value read, false if missing, true if neither 0 nor 1
+///
+///////////////////////////////////////////////////////////////////////////////
+bool CComStringReader::readBool()
+{
+    METHOD_ENTRY_QUIET("CComStringReader::readBool")
+    long nValue = 0;
+    if (!this->readInteger(nValue) && nValue == 0) return false;
+    if (nValue == 0 || nValue == 1) return nValue == 1;
+    m_bFailed = true;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads a floating point value
+///
+/// \return Value read, zero if missing
+///
+///////////////////////////////////////////////////////////////////////////////
+double CComStringReader::readDouble()
+{
+    METHOD_ENTRY_QUIET("CComStringReader::readDouble")
+    double fValue = 0.0;
+    this->readFloat(fValue);
+    return fValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads all remaining values
+///
+/// \return Values read
+///
+///////////////////////////////////////////////////////////////////////////////
+std::vector<double> CComStringReader::readDoubleArray()
+{
+    METHOD_ENTRY_QUIET("CComStringReader::readDoubleArray")
+    std::vector<double> Values;
+    double fValue = 0.0;
+    while (this->readFloat(fValue)) Values.push_back(fValue);
+    return Values;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads an integer value
+///
+/// \return Value read, zero if missing, limit of int if out of range
+///
+///////////////////////////////////////////////////////////////////////////////
+int CComStringReader::readInt()
+{
+    METHOD_ENTRY_QUIET("CComStringReader::readInt")
+    long nValue = 0;
+    this->readInteger(nValue);
+    if (nValue < std::numeric_limits<int>::min())
+    {
+        m_bFailed = true;
+        return std::numeric_limits<int>::min();
+    }
+    if (nValue > std::numeric_limits<int>::max())
+    {
+        m_bFailed = true;
+        return std::numeric_limits<int>::max();
+    }
+    return int(nValue);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads a string, i.e. the next word
+///
+/// \return Value read, empty if missing
+///
+///////////////////////////////////////////////////////////////////////////////
+std::string CComStringReader::readString()
+{
+    METHOD_ENTRY_QUIET("CComStringReader::readString")
+    if (m_bFailed) return "";
+    this->skipWhitespace();
+
+    const char* const pBegin = m_pPos;
+    while (m_pPos != m_pEnd && !isWhitespace(*m_pPos)) ++m_pPos;
+    if (m_pPos == pBegin) m_bFailed = true;
+    return std::string(pBegin, m_pPos);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads a floating point value
+///
+/// Accepts the characters a stream accepts, i.e. an optional sign, digits
+/// with an optional decimal point and an optional exponent, and fails if
+/// they don't form a complete number. Conversion is done by strtod, which
+/// uses the "C" locale like streams in this engine.
+///
+/// \param _fValue Value read, zero if failed, limit of double if out of range
+///
+/// \return Success?
+///
+///////////////////////////////////////////////////////////////////////////////
+bool CComStringReader::readFloat(double& _fValue)
+{
+    METHOD_ENTRY_QUIET("CComStringReader::readFloat")
+
+    _fValue = 0.0;
+    if (m_bFailed) return false;
+    this->skipWhitespace();
+
+    const char* const pBegin = m_pPos;
+    bool bMantissa = false;
+    bool bPoint = false;
+    bool bExponent = false;
+    if (m_pPos != m_pEnd && (*m_pPos == '+' || *m_pPos == '-')) ++m_pPos;
+    while (m_pPos != m_pEnd)
+    {
+        const char c = *m_pPos;
+        if (c >= '0' && c <= '9')
+        {
+            if (!bExponent) bMantissa = true;
+        }
+        else if (c == '.' && !bPoint && !bExponent) bPoint = true;
+        else if ((c == 'e' || c == 'E') && bMantissa && !bExponent)
+        {
+            bExponent = true;
+            if (m_pPos+1 != m_pEnd && (m_pPos[1] == '+' || m_pPos[1] == '-')) ++m_pPos;
+        }
+        else break;
+        ++m_pPos;
+    }
+
+    // Copy to terminate the number for strtod, numbers are short
+    char Number[64];
+    const std::size_t nLength = std::size_t(m_pPos - pBegin);
+    if (nLength == 0u || nLength >= sizeof(Number))
+    {
+        m_bFailed = true;
+        return false;
+    }
+    std::copy(pBegin, m_pPos, Number);
+    Number[nLength] = '\0';
+
+    char* pNumberEnd = nullptr;
+    const double fValue = std::strtod(Number, &pNumberEnd);
+    if (pNumberEnd != Number + nLength)
+    {
+        m_bFailed = true;
+        return false;
+    }
+    if (fValue == HUGE_VAL || fValue == -HUGE_VAL)
+    {
+        _fValue = (fValue > 0.0) ? std::numeric_limits<double>::max() : std::numeric_limits<double>::lowest();
+        m_bFailed = true;
+        return false;
+    }
+    _fValue = fValue;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads a decimal integer value with optional sign
+///
+/// \param _nValue Value read, zero if failed, limit of long if out of range
+///
+/// \return Success?
+///
+///////////////////////////////////////////////////////////////////////////////
+bool CComStringReader::readInteger(long& _nValue)
+{
+    METHOD_ENTRY_QUIET("CComStringReader::readInteger")
+
+    _nValue = 0;
+    if (m_bFailed) return false;
+    this->skipWhitespace();
+
+    bool bNegative = false;
+    if (m_pPos != m_pEnd && (*m_pPos == '+' || *m_pPos == '-'))
+    {
+        bNegative = (*m_pPos == '-');
+        ++m_pPos;
+    }
+
+    const unsigned long nLimit = bNegative ? 0ul - static_cast<unsigned long>(std::numeric_limits<long>::min())
+                                           : static_cast<unsigned long>(std::numeric_limits<long>::max());
+    const char* const pDigits = m_pPos;
+    unsigned long nValue = 0u;
+    bool bOverflow = false;
+    while (m_pPos != m_pEnd && *m_pPos >= '0' && *m_pPos <= '9')
+    {
+        const unsigned long nDigit = static_cast<unsigned long>(*m_pPos - '0');
+        if (nValue > (nLimit - nDigit) / 10u) bOverflow = true;
+        else nValue = nValue * 10u + nDigit;
+        ++m_pPos;
+    }
+
+    if (m_pPos == pDigits)
+    {
+        m_bFailed = true;
+        return false;
+    }
+    if (bOverflow)
+    {
+        _nValue = bNegative ? std::numeric_limits<long>::min() : std::numeric_limits<long>::max();
+        m_bFailed = true;
+        return false;
+    }
+    if (bNegative)
+    {
+        _nValue = (nValue == nLimit) ? std::numeric_limits<long>::min() : -static_cast<long>(nValue);
+    }
+    else
+    {
+        _nValue = static_cast<long>(nValue);
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Skips whitespace before the next value
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComStringReader::skipWhitespace()
+{
+    METHOD_ENTRY_QUIET("CComStringReader::skipWhitespace")
+    while (m_pPos != m_pEnd && isWhitespace(*m_pPos)) ++m_pPos;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes a boolean as 0 or 1
+///
+/// \param _bValue Value to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComStringWriter::writeBool(const bool _bValue)
+{
+    METHOD_ENTRY_QUIET("CComStringWriter::writeBool")
+    this->separate() += _bValue ? '1' : '0';
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes a floating point value
+///
+/// Like streams with default precision, six significant digits are written.
+///
+/// \param _fValue Value to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComStringWriter::writeDouble(const double _fValue)
+{
+    METHOD_ENTRY_QUIET("CComStringWriter::writeDouble")
+    char Value[32];
+    const int nLength = std::snprintf(Value, sizeof(Value), "%g", _fValue);
+    this->separate().append(Value, std::size_t(nLength));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes all values of an array
+///
+/// \param _Values Values to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComStringWriter::writeDoubleArray(const std::vector<double>& _Values)
+{
+    METHOD_ENTRY_QUIET("CComStringWriter::writeDoubleArray")
+    for (const auto fValue : _Values) this->writeDouble(fValue);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes an integer value
+///
+/// \param _nValue Value to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComStringWriter::writeInt(const int _nValue)
+{
+    METHOD_ENTRY_QUIET("CComStringWriter::writeInt")
+    char Value[16];
+    const int nLength = std::snprintf(Value, sizeof(Value), "%d", _nValue);
+    this->separate().append(Value, std::size_t(nLength));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes a string
+///
+/// \param _strValue Value to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComStringWriter::writeString(const std::string& _strValue)
+{
+    METHOD_ENTRY_QUIET("CComStringWriter::writeString")
+    this->separate() += _strValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Separates the next value from values written before
+///
+/// \return String to append the next value to
+///
+///////////////////////////////////////////////////////////////////////////////
+std::string& CComStringWriter::separate()
+{
+    METHOD_ENTRY_QUIET("CComStringWriter::separate")
+    if (!m_bEmpty) m_strBuffer += ' ';
+    m_bEmpty = false;
+    return m_strBuffer;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads a boolean
+///
+/// \return Value read, false if missing
+///
+///////////////////////////////////////////////////////////////////////////////
+bool CComBinaryReader::readBool()
+{
+    METHOD_ENTRY_QUIET("CComBinaryReader::readBool")
+    std::uint8_t nValue = 0u;
+    if (!this->readTag(ComValueTagType::BOOL) || !this->readBytes(&nValue, sizeof(nValue))) return false;
+    return nValue != 0u;
+}
 
-////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
 ///
-/// \brief Return message according to exception type
+/// \brief Reads a floating point value
 ///
-/// \return Message according to exception type
+/// \return Value read, zero if missing
 ///
-////////////////////////////////////////////////////////////////////////////////
-const std::string CComInterfaceException::getMessage() const
+///////////////////////////////////////////////////////////////////////////////
+double CComBinaryReader::readDouble()
 {
-    METHOD_ENTRY_QUIET("CComInterfaceException::getMessage")
-    
-    switch (m_EType)
+    METHOD_ENTRY_QUIET("CComBinaryReader::readDouble")
+    double fValue = 0.0;
+    if (!this->readTag(ComValueTagType::DOUBLE) || !this->readBytes(&fValue, sizeof(fValue))) return 0.0;
+    return fValue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads an array of floating point values
+///
+/// \return Values read, empty if missing
+///
+///////////////////////////////////////////////////////////////////////////////
+std::vector<double> CComBinaryReader::readDoubleArray()
+{
+    METHOD_ENTRY_QUIET("CComBinaryReader::readDoubleArray")
+    std::uint32_t nSize = 0u;
+    if (!this->readTag(ComValueTagType::DOUBLE_ARRAY) || !this->readBytes(&nSize, sizeof(nSize))) return {};
+    if (std::size_t(m_pEnd - m_pPos) / sizeof(double) < nSize)
     {
-        case ComIntExceptionType::INVALID_VALUE:
-            return "Invalid parameter value";
-        case ComIntExceptionType::UNKNOWN_COMMAND:
-            return "Unknown command";
-        case ComIntExceptionType::PARAM_ERROR:
-            return "Parameter error. Wrong number or unknown value.";
-        default:
-            return "";
+        m_bFailed = true;
+        return {};
+    }
+    std::vector<double> Values(nSize);
+    if (nSize > 0u) this->readBytes(Values.data(), nSize * sizeof(double));
+    return Values;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads an integer value
+///
+/// \return Value read, zero if missing
+///
+///////////////////////////////////////////////////////////////////////////////
+int CComBinaryReader::readInt()
+{
+    METHOD_ENTRY_QUIET("CComBinaryReader::readInt")
+    std::int32_t nValue = 0;
+    if (!this->readTag(ComValueTagType::INT) || !this->readBytes(&nValue, sizeof(nValue))) return 0;
+    return int(nValue);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads a string
+///
+/// \return Value read, empty if missing
+///
+///////////////////////////////////////////////////////////////////////////////
+std::string CComBinaryReader::readString()
+{
+    METHOD_ENTRY_QUIET("CComBinaryReader::readString")
+    std::uint32_t nSize = 0u;
+    if (!this->readTag(ComValueTagType::STRING) || !this->readBytes(&nSize, sizeof(nSize))) return "";
+    if (std::size_t(m_pEnd - m_pPos) < nSize)
+    {
+        m_bFailed = true;
+        return "";
+    }
+    const char* const pBegin = m_pPos;
+    m_pPos += nSize;
+    return std::string(pBegin, m_pPos);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Copies the next bytes
+///
+/// \param _pValue Destination
+/// \param _nSize Number of bytes
+///
+/// \return Success? False if not enough bytes are left.
+///
+///////////////////////////////////////////////////////////////////////////////
+bool CComBinaryReader::readBytes(void* const _pValue, const std::size_t _nSize)
+{
+    METHOD_ENTRY_QUIET("CComBinaryReader::readBytes")
+    if (m_bFailed || std::size_t(m_pEnd - m_pPos) < _nSize)
+    {
+        m_bFailed = true;
+        return false;
     }
+    std::memcpy(_pValue, m_pPos, _nSize);
+    m_pPos += _nSize;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads the type of the next value and compares it to given type
+///
+/// \param _Tag Type expected
+///
+/// \return Success? False if type differs or is missing.
+///
+///////////////////////////////////////////////////////////////////////////////
+bool CComBinaryReader::readTag(const ComValueTagType _Tag)
+{
+    METHOD_ENTRY_QUIET("CComBinaryReader::readTag")
+    ComValueTagType Tag;
+    if (!this->readBytes(&Tag, sizeof(Tag))) return false;
+    if (Tag != _Tag) m_bFailed = true;
+    return !m_bFailed;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes a boolean
+///
+/// \param _bValue Value to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComBinaryWriter::writeBool(const bool _bValue)
+{
+    METHOD_ENTRY_QUIET("CComBinaryWriter::writeBool")
+    const ComValueTagType Tag = ComValueTagType::BOOL;
+    const std::uint8_t nValue = _bValue ? 1u : 0u;
+    this->writeBytes(&Tag, sizeof(Tag));
+    this->writeBytes(&nValue, sizeof(nValue));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes a floating point value
+///
+/// \param _fValue Value to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComBinaryWriter::writeDouble(const double _fValue)
+{
+    METHOD_ENTRY_QUIET("CComBinaryWriter::writeDouble")
+    const ComValueTagType Tag = ComValueTagType::DOUBLE;
+    this->writeBytes(&Tag, sizeof(Tag));
+    this->writeBytes(&_fValue, sizeof(_fValue));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes all values of an array
+///
+/// \param _Values Values to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComBinaryWriter::writeDoubleArray(const std::vector<double>& _Values)
+{
+    METHOD_ENTRY_QUIET("CComBinaryWriter::writeDoubleArray")
+    const ComValueTagType Tag = ComValueTagType::DOUBLE_ARRAY;
+    const std::uint32_t nSize = std::uint32_t(_Values.size());
+    this->writeBytes(&Tag, sizeof(Tag));
+    this->writeBytes(&nSize, sizeof(nSize));
+    if (nSize > 0u) this->writeBytes(_Values.data(), nSize * sizeof(double));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes an integer value
+///
+/// \param _nValue Value to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComBinaryWriter::writeInt(const int _nValue)
+{
+    METHOD_ENTRY_QUIET("CComBinaryWriter::writeInt")
+    const ComValueTagType Tag = ComValueTagType::INT;
+    const std::int32_t nValue = std::int32_t(_nValue);
+    this->writeBytes(&Tag, sizeof(Tag));
+    this->writeBytes(&nValue, sizeof(nValue));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes a string
+///
+/// \param _strValue Value to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComBinaryWriter::writeString(const std::string& _strValue)
+{
+    METHOD_ENTRY_QUIET("CComBinaryWriter::writeString")
+    const ComValueTagType Tag = ComValueTagType::STRING;
+    const std::uint32_t nSize = std::uint32_t(_strValue.size());
+    this->writeBytes(&Tag, sizeof(Tag));
+    this->writeBytes(&nSize, sizeof(nSize));
+    this->writeBytes(_strValue.data(), nSize);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Appends bytes to the string
+///
+/// \param _pValue Source
+/// \param _nSize Number of bytes
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComBinaryWriter::writeBytes(const void* const _pValue, const std::size_t _nSize)
+{
+    METHOD_ENTRY_QUIET("CComBinaryWriter::writeBytes")
+    m_strBuffer.append(static_cast<const char*>(_pValue), _nSize);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -90,556 +894,426 @@ CComInterface::CComInterface()
                                      {ParameterType::INT,"Verbosity (0-1)"}},
                                     "system"
     );
+    this->registerFunction("uid_lookup",  CCommand<std::string, int>([](const int _nUID) -> std::string
+                                    {
+                                        if (_nUID <= 0) return std::string();
+                                        const IUIDUser* const pUser = CUIDRegistry::getInstance().get(UIDType(_nUID));
+                                        return (pUser == nullptr) ? std::string() : pUser->getName();
+                                    }),
+                                    "Looks up the object of given UID in constant time",
+                                    {{ParameterType::STRING,"Name of object, empty if no object is registered"},
+                                     {ParameterType::INT,"UID of object"}},
+                                    "system"
+    );
+    this->registerFunction("lock_stats",  CCommand<std::string, std::string>([](const std::string& _strName) -> std::string
+                                    {
+                                        return CAdaptiveLock::getStatistics(_strName);
+                                    }),
+                                    "Provides contention statistics of named adaptive locks",
+                                    {{ParameterType::STRING,"Statistics, one line per lock"},
+                                     {ParameterType::STRING,"Name of lock, all locks if empty"}},
+                                    "system"
+    );
+    this->registerFunction("module_stats",  CCommand<std::string, std::string>([](const std::string& _strName) -> std::string
+                                    {
+                                        return IThreadModule::getStatisticsText(_strName);
+                                    }),
+                                    "Provides frame time statistics (min, mean, p50, p95, p99, max) of modules",
+                                    {{ParameterType::STRING,"Statistics, one line per module"},
+                                     {ParameterType::STRING,"Name of module, spaces as underscores, all modules if empty"}},
+                                    "system"
+    );
+    this->registerFunction("module_set_cores",  CCommand<void, std::string, std::string>([](const std::string& _strName,
+                                                                                          const std::string& _strCores)
+                                    {
+                                        if (IThreadModule::forEachModule(_strName, [&](IThreadModule& _Module){_Module.setCores(_strCores);}) == 0)
+                                            WARNING_MSG("Com Interface", "No module <" << _strName << "> found.")
+                                    }),
+                                    "Pins thread of module to given cores, applied at next frame",
+                                    {{ParameterType::NONE,"No return value"},
+                                     {ParameterType::STRING,"Name of module, spaces as underscores, all modules if empty"},
+                                     {ParameterType::STRING,"Comma separated cores or ranges, e.g. 0,2-3, or all"}},
+                                    "system"
+    );
+    this->registerFunction("module_set_nice",  CCommand<void, std::string, int>([](const std::string& _strName,
+                                                                                  const int _nNice)
+                                    {
+                                        if (IThreadModule::forEachModule(_strName, [&](IThreadModule& _Module){_Module.setNice(_nNice);}) == 0)
+                                            WARNING_MSG("Com Interface", "No module <" << _strName << "> found.")
+                                    }),
+                                    "Sets nice value of module's thread, applied at next frame",
+                                    {{ParameterType::NONE,"No return value"},
+                                     {ParameterType::STRING,"Name of module, spaces as underscores, all modules if empty"},
+                                     {ParameterType::INT,"Nice value, -20 (highest priority) to 19 (lowest)"}},
+                                    "system"
+    );
+    this->registerFunction("module_set_priority",  CCommand<void, std::string, int>([](const std::string& _strName,
+                                                                                      const int _nPriority)
+                                    {
+                                        if (IThreadModule::forEachModule(_strName, [&](IThreadModule& _Module){_Module.setPriority(_nPriority);}) == 0)
+                                            WARNING_MSG("Com Interface", "No module <" << _strName << "> found.")
+                                    }),
+                                    "Sets priority of module's thread for real time policies, applied at next frame",
+                                    {{ParameterType::NONE,"No return value"},
+                                     {ParameterType::STRING,"Name of module, spaces as underscores, all modules if empty"},
+                                     {ParameterType::INT,"Priority, 1 (lowest) to 99 (highest)"}},
+                                    "system"
+    );
+    this->registerFunction("module_set_scheduling",  CCommand<void, std::string, std::string>([](const std::string& _strName,
+                                                                                               const std::string& _strPolicy)
+                                    {
+                                        if (IThreadModule::forEachModule(_strName, [&](IThreadModule& _Module){_Module.setSchedulingPolicy(_strPolicy);}) == 0)
+                                            WARNING_MSG("Com Interface", "No module <" << _strName << "> found.")
+                                    }),
+                                    "Sets scheduling policy of module's thread, applied at next frame",
+                                    {{ParameterType::NONE,"No return value"},
+                                     {ParameterType::STRING,"Name of module, spaces as underscores, all modules if empty"},
+                                     {ParameterType::STRING,"Policy: default, other, batch, idle, fifo, rr"}},
+                                    "system"
+    );
+    this->registerFunction("com_profile",  CCommand<std::string, std::string>([&](const std::string& _strName) -> std::string
+                                    {
+                                        return this->getProfile(_strName);
+                                    }),
+                                    "Provides call profile (calls, callbacks, times, time queued) of functions and writer queues",
+                                    {{ParameterType::STRING,"Profile, one line per function or queue, longest total time first"},
+                                     {ParameterType::STRING,"Name of function or writer domain, all if empty"}},
+                                    "system"
+    );
+    this->registerFunction("com_profile_dump",  CCommand<bool, std::string>([&](const std::string& _strFilename) -> bool
+                                    {
+                                        return this->dumpProfile(_strFilename);
+                                    }),
+                                    "Writes call profile of all functions and writer queues to given file",
+                                    {{ParameterType::BOOL,"Success?"},
+                                     {ParameterType::STRING,"Name of file"}},
+                                    "system"
+    );
+    this->registerFunction("com_profile_enable",  CCommand<void, bool>([&](const bool _bProfiling)
+                                    {
+                                        this->setProfiling(_bProfiling);
+                                    }),
+                                    "Enables or disables profiling of calls, recorded profiles are kept",
+                                    {{ParameterType::NONE,"No return value"},
+                                     {ParameterType::BOOL,"Enable profiling?"}},
+                                    "system"
+    );
+    this->registerFunction("com_profile_reset",  CCommand<void>([&]()
+                                    {
+                                        this->resetProfile();
+                                    }),
+                                    "Resets call profiles of all functions and writer queues",
+                                    {{ParameterType::NONE,"No return value"}},
+                                    "system"
+    );
+    this->registerFunction("com_journal_start",  CCommand<bool, std::string>([&](const std::string& _strFilename) -> bool
+                                    {
+                                        return m_Journal.start(_strFilename);
+                                    }),
+                                    "Records commands, scripts and writer calls to a journal for replay",
+                                    {{ParameterType::BOOL,"Success?"},
+                                     {ParameterType::STRING,"Name of journal file"}},
+                                    "system"
+    );
+    this->registerFunction("com_journal_stop",  CCommand<void>([&]()
+                                    {
+                                        m_Journal.stop();
+                                    }),
+                                    "Stops recording and closes the journal",
+                                    {{ParameterType::NONE,"No return value"}},
+                                    "system"
+    );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Destructor, deletes callback functions
+///
+///////////////////////////////////////////////////////////////////////////////
+CComInterface::~CComInterface()
+{
+    METHOD_ENTRY_QUIET("CComInterface::~CComInterface")
+    DTOR_CALL_QUIET("CComInterface::~CComInterface")
+    
+    // Remove the listener, otherwise the already deleted com interface might
+    // be called during destruction
+    bfe::Log.removeListener("com");
+    
+    // Remaining commands of writer queues are destroyed with the queues
+    
+    for (auto& Entry : m_Entries)
+    {
+        const CallbackListType* pCallbacks = Entry.second.pCallbacks.load(std::memory_order_acquire);
+        if (pCallbacks != nullptr)
+        {
+            for (auto pCallback : *pCallbacks)
+            {
+                delete pCallback;
+                MEM_FREED_QUIET("IBaseCommand")
+            }
+            delete pCallbacks;
+            pCallbacks = nullptr;
+        }
+    }
+    for (auto pCallbacks : m_CallbacksRetired)
+    {
+        delete pCallbacks;
+    }
+    for (auto pFunction : m_FunctionsRetired)
+    {
+        delete pFunction;
+        MEM_FREED_QUIET("IBaseCommand")
+    }
+
+    for (auto pFunction : m_RegisteredFunctions)
+    {
+        if (pFunction.second != nullptr)
+        {
+            delete pFunction.second;
+            pFunction.second = nullptr;
+            MEM_FREED_QUIET("IBaseCommand")
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls the given function if registered
+///
+/// This method is a wrapper function to call registered functions without the
+/// need to use template parameters. Therefore, it's especially suited for
+/// external calls. Internally, direct call should be preferred to avoid
+/// the parsing.
+///
+/// \param _strCommand Command that should be called
+/// \return Return value of function as string
+///
+///////////////////////////////////////////////////////////////////////////////
+const std::string CComInterface::call(const std::string& _strCommand)
+{
+    METHOD_ENTRY_QUIET("CComInterface::call")
+
+    std::string strResult;
+    this->call(_strCommand, strResult);
+    return strResult;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls the given function if registered, writing to given string
+///
+/// Arguments are read from the command in place and the return value is
+/// written to the given string, which is cleared before. Hence, callers
+/// reusing the same string, e.g. consoles or automation, don't allocate
+/// for commands and return values of usual length.
+///
+/// \param _strCommand Command that should be called
+/// \param _strResult Return value of function as string
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComInterface::call(const std::string& _strCommand, std::string& _strResult)
+{
+    METHOD_ENTRY_QUIET("CComInterface::call")
+
+    // Buffer of the name is taken from the thread and given back when done.
+    // Commands calling by string themselves thus use a buffer of their own.
+    thread_local std::string t_strName;
+    std::string strName;
+    strName.swap(t_strName);
+
+    const char* pBegin = _strCommand.data();
+    const char* const pEnd = pBegin + _strCommand.size();
+    while (pBegin != pEnd && isWhitespace(*pBegin)) ++pBegin;
+    const char* pName = pBegin;
+    while (pName != pEnd && !isWhitespace(*pName)) ++pName;
+    strName.assign(pBegin, pName);
+
+    _strResult.clear();
+
+    CComStringReader Reader(pName, pEnd);
+    CComStringWriter Writer(_strResult);
+    if (!this->invoke(strName, Reader, Writer, ComJournalOriginType::COMMAND))
+    {
+        WARNING_MSG("Com Interface", "Unknown function <" << strName << ">. ");
+        throw CComInterfaceException(ComIntExceptionType::UNKNOWN_COMMAND);
+    }
+    t_strName.swap(strName);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls the given function with arguments read from a reader
+///
+/// The return value, if any, is written to the given writer.
+///
+/// \param _strName Name of the function that should be called
+/// \param _Reader Reader providing the arguments
+/// \param _Writer Writer receiving the return value
+/// \param _Origin Origin of call, recorded in journal
+///
+/// \return Function registered?
+///
+///////////////////////////////////////////////////////////////////////////////
+bool CComInterface::invoke(const std::string& _strName, IComValueReader& _Reader, IComValueWriter& _Writer,
+                           const ComJournalOriginType _Origin)
+{
+    METHOD_ENTRY_QUIET("CComInterface::invoke")
+
+    IBaseCommand* pCommand = nullptr;
+    m_AccessData.acquireReadLock();
+    const auto ci = m_RegisteredFunctions.find(_strName);
+    if (ci != m_RegisteredFunctions.end()) pCommand = ci->second;
+    m_AccessData.releaseReadLock();
+
+    if (pCommand == nullptr) return false;
+    pCommand->invoke(this, _strName, _Reader, _Writer, _Origin);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls all writing functions of given queue
+///
+/// Looks up the queue by name, modules calling writers each frame should use
+/// the queue returned on registration of their writer domain instead.
+///
+/// \param _strQueue Queue of which functions should be called
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComInterface::callWriters(const std::string& _strQueue)
+{
+    METHOD_ENTRY_QUIET("CComInterface::callWriters")
+    
+    CWriterQueue* const pWriterQueue = this->getWriterQueue(_strQueue);
+    if (pWriterQueue == nullptr)
+    {
+        WARNING_MSG("Com Interface", "Writer queue <" << _strQueue << "> doesn't exist. Skipping execution.")
+        return;
+    }
+    this->callWriters(pWriterQueue);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 ///
-/// \brief Destructor, deletes callback functions
+/// \brief Writes the profile of all functions and writer queues to a file
+///
+/// \param _strFilename Name of file, overwritten if existing
+///
+/// \return Success?
 ///
 ///////////////////////////////////////////////////////////////////////////////
-CComInterface::~CComInterface()
+bool CComInterface::dumpProfile(const std::string& _strFilename)
 {
-    METHOD_ENTRY_QUIET("CComInterface::~CComInterface")
-    DTOR_CALL_QUIET("CComInterface::~CComInterface")
-    
-    // Remove the listener, otherwise the already deleted com interface might
-    // be called during destruction
-    bfe::Log.removeListener("com");
-    
-    // Remove all remaining commands from queue
-    for (WriterQueuesType::iterator it = m_WriterQueues.begin();
-         it != m_WriterQueues.end(); ++it)
-    {
-        IBaseCommand* pCommand = nullptr;
-        while (it->second.try_dequeue(pCommand))
-        {
-            if (pCommand != nullptr)
-            {
-                delete pCommand;
-                MEM_FREED_QUIET("IBaseCommand")
-                pCommand = nullptr;
-            }
-        }
-    }
+    METHOD_ENTRY("CComInterface::dumpProfile")
     
-    for (auto pCallback : m_RegisteredCallbacks)
-    {
-        if (pCallback.second != nullptr)
-        {
-            delete pCallback.second;
-            pCallback.second = nullptr;
-            MEM_FREED_QUIET("IBaseCommand")
-        }
-    }
-
-    for (auto pFunction : m_RegisteredFunctions)
+    std::ofstream OutFile(_strFilename);
+    if (!OutFile.is_open())
     {
-        if (pFunction.second != nullptr)
-        {
-            delete pFunction.second;
-            pFunction.second = nullptr;
-            MEM_FREED_QUIET("IBaseCommand")
-        }
+        WARNING_MSG("Com Interface", "Could not open file <" << _strFilename << ">, profile not written.")
+        return false;
     }
+    OutFile << this->getProfile() << std::endl;
+    INFO_MSG("Com Interface", "Profile written to <" << _strFilename << ">.")
+    return OutFile.good();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 ///
-/// \brief Calls the given function if registered
+/// \brief Returns the profile of functions and writer queues
 ///
-/// This method is a wrapper function to call registered functions without the
-/// need to use template parameters. Therefore, it's especially suited for
-/// external calls. Internally, direct call should be preferred to avoid
-/// the parsing.
+/// Functions are listed by total time of calls and queued calls, longest
+/// first, functions never called are omitted. Times are given in
+/// microseconds.
 ///
-/// \param _strCommand Command that should be called
-/// \return Return value of function as string
+/// \param _strName Name of function or writer domain, all if empty
+///
+/// \return Profile, one line per function or writer queue
 ///
 ///////////////////////////////////////////////////////////////////////////////
-const std::string CComInterface::call(const std::string& _strCommand)
+std::string CComInterface::getProfile(const std::string& _strName)
 {
-    METHOD_ENTRY_QUIET("CComInterface::call")
+    METHOD_ENTRY("CComInterface::getProfile")
     
-    std::istringstream iss(_strCommand);
-    std::ostringstream oss("");
-    std::string strName;
+    CReadLockGuard Lock(m_AccessData);
     
-    iss >> strName;
+    std::vector<const ComEntry*> Entries;
+    for (const auto& Entry : m_Entries)
+    {
+        if (!_strName.empty() && Entry.first != _strName) continue;
+        const ComCallStatistics& Stats = Entry.second.Statistics;
+        if (Stats.nCalls.load(std::memory_order_relaxed) == 0u &&
+            Stats.nQueued.load(std::memory_order_relaxed) == 0u) continue;
+        Entries.push_back(&Entry.second);
+    }
+    std::sort(Entries.begin(), Entries.end(), [](const ComEntry* const _pA, const ComEntry* const _pB)
+    {
+        return _pA->Statistics.nTimeTotal.load(std::memory_order_relaxed) +
+               _pA->Statistics.nWriterTimeTotal.load(std::memory_order_relaxed) >
+               _pB->Statistics.nTimeTotal.load(std::memory_order_relaxed) +
+               _pB->Statistics.nWriterTimeTotal.load(std::memory_order_relaxed);
+    });
     
-    if (m_RegisteredFunctions.find(strName) != m_RegisteredFunctions.end())
+    std::ostringstream oss;
+    for (const auto pEntry : Entries)
     {
-        switch (m_RegisteredFunctions[strName]->getSignature())
+        const ComCallStatistics& Stats = pEntry->Statistics;
+        const std::uint64_t nCalls = Stats.nCalls.load(std::memory_order_relaxed);
+        const std::uint64_t nQueued = Stats.nQueued.load(std::memory_order_relaxed);
+        
+        if (oss.tellp() > 0) oss << "\n";
+        oss << pEntry->strName << ": calls " << nCalls <<
+               ", callbacks " << Stats.nCallbacks.load(std::memory_order_relaxed) <<
+               ", total " << Stats.nTimeTotal.load(std::memory_order_relaxed)*1.0e-3 <<
+               "us, mean " << ((nCalls == 0u) ? 0.0 : Stats.nTimeTotal.load(std::memory_order_relaxed)*1.0e-3/nCalls) <<
+               "us, max " << Stats.nTimeMax.load(std::memory_order_relaxed)*1.0e-3 << "us";
+        if (nQueued > 0u)
         {
-            case SignatureType::BOOL_INT:
-            {
-                int nParam(0);
-                iss >> nParam;
-                oss << this->call<bool,int>(strName, nParam);
-                break;
-            }
-            case SignatureType::DOUBLE:
-            {
-                oss << this->call<double>(strName);
-                break;
-            }
-            case SignatureType::DOUBLE_INT:
-            {
-                int nParam(0);
-                iss >> nParam;
-                oss << this->call<double,int>(strName, nParam);
-                break;
-            }
-            case SignatureType::DOUBLE_STRING:
-            {
-                std::string strParam = "";
-                iss >> strParam;
-                oss << this->call<double,std::string>(strName, strParam);
-                break;
-            }
-            case SignatureType::DOUBLE_STRING_DOUBLE:
-            {
-                std::string strParam = "";
-                double fParam = 0.0;
-                iss >> strParam >> fParam;
-                oss << this->call<double,std::string,double>(strName, strParam, fParam);
-                break;
-            }
-            case SignatureType::INT:
-            {
-                oss << this->call<int>(strName);
-                break;
-            }
-            case SignatureType::INT_INT:
-            {
-                int nParam = 0;
-                iss >> nParam;
-                oss << this->call<int,int>(strName, nParam);
-                break;
-            }
-            case SignatureType::INT_STRING:
-            {
-                std::string strS("");
-                iss >> strS;
-                oss << this->call<int,std::string>(strName, strS);
-                break;
-            }
-            case SignatureType::NONE:
-            {
-                this->call<void>(strName);
-                break;
-            }
-            case SignatureType::NONE_BOOL:
-            {
-                bool bParam = 0;
-                iss >> bParam;
-                this->call<void,bool>(strName, bParam);
-                break;
-            }
-            case SignatureType::NONE_DOUBLE:
-            {
-                double fParam = 0.0;
-                iss >> fParam;
-                this->call<void,double>(strName, fParam);
-                break;
-            }
-            case SignatureType::NONE_2DOUBLE:
-            {
-                double fParam1 = 0.0;
-                double fParam2 = 0.0;
-                iss >> fParam1 >> fParam2;
-                this->call<void,double>(strName, fParam1, fParam2);
-                break;
-            }
-            case SignatureType::NONE_INT:
-            {
-                int nParam = 0;
-                iss >> nParam;
-                this->call<void,int>(strName, nParam);
-                break;
-            }
-            case SignatureType::NONE_2INT:
-            {
-                int nParam1(0);
-                int nParam2(0);
-                iss >> nParam1 >> nParam2;
-                this->call<void,int,int>(strName, nParam1, nParam2);
-                break;
-            }
-            case SignatureType::NONE_3INT:
-            {
-                int nParam1(0);
-                int nParam2(0);
-                int nParam3(0);
-                iss >> nParam1 >> nParam2 >> nParam3;
-                this->call<void,int,int>(strName, nParam1, nParam2, nParam3);
-                break;
-            }
-            case SignatureType::NONE_INT_DOUBLE:
-            {
-                int    nParam = 0;
-                double fParam = 0.0;
-                iss >> nParam >> fParam;
-                this->call<void,int,double>(strName, nParam, fParam);
-                break;
-            }
-            case SignatureType::NONE_INT_STRING:
-            {
-                int         nParam(0);
-                std::string strParam("");
-                iss >> nParam >> strParam;
-                this->call<void,int,std::string>(strName, nParam, strParam);
-                break;
-            }
-            case SignatureType::NONE_STRING:
-            {
-                std::string strS;
-                iss >> strS;
-                this->call<void,std::string>(strName, strS);
-                break;
-            }
-            case SignatureType::NONE_2STRING:
-            {
-                std::string str1{""};
-                std::string str2{""};
-                iss >> str1 >> str2;
-                this->call<void,std::string,std::string>(strName, str1, str2);
-                break;
-            }
-            case SignatureType::NONE_4STRING:
-            {
-                std::string str1{""};
-                std::string str2{""};
-                std::string str3{""};
-                std::string str4{""};
-                iss >> str1 >> str2 >> str3 >> str4;
-                this->call<void,std::string,std::string,std::string,std::string>(strName, str1, str2, str3, str4);
-                break;
-            }
-            case SignatureType::NONE_INT_2DOUBLE:
-            {
-                int nParam(0);
-                iss >> nParam;
-                double fParam[2] = {0.0, 0.0};
-                iss >> fParam[0] >> fParam[1];
-                this->call<void, int, double, double>(strName, nParam, fParam[0], fParam[1]);
-                break;
-            }
-            case SignatureType::NONE_INT_4DOUBLE:
-            {
-                int nParam(0);
-                iss >> nParam;
-                double fParam[4] = {0.0, 0.0, 0.0, 0.0};
-                iss >> fParam[0] >> fParam[1] >> fParam[2] >> fParam[3];
-                this->call<void, int, double, double, double, double>(strName, nParam, fParam[0], fParam[1], fParam[2], fParam[3]);
-                break;
-            }
-            case SignatureType::NONE_INT_DYN_ARRAY:
-            {
-                int nParam(0);
-                iss >> nParam;
-                double fParam(0);
-                std::vector<double> vecDynArray{};
-                while (!iss.eof())
-                {
-                    iss >> fParam;
-                    vecDynArray.push_back(fParam);
-                }
-                this->call<void, int, std::vector<double>>(strName, nParam, vecDynArray);
-                break;
-            }
-            case SignatureType::NONE_STRING_DOUBLE:
-            {
-                std::string strS("");
-                iss >> strS;
-                double fParam = 0.0;
-                iss >> fParam;
-                this->call<void,std::string, double>(strName, strS, fParam);
-                break;
-            }
-            case SignatureType::NONE_STRING_INT:
-            {
-                std::string strS("");
-                iss >> strS;
-                int nParam = 0;
-                iss >> nParam;
-                this->call<void,std::string,int>(strName, strS, nParam);
-                break;
-            }
-            case SignatureType::NONE_STRING_2INT:
-            {
-                std::string strS("");
-                iss >> strS;
-                int nParam1 = 0;
-                int nParam2 = 0;
-                iss >> nParam1 >> nParam2;
-                this->call<void,std::string,int,int>(strName, strS, nParam1, nParam2);
-                break;
-            }
-            case SignatureType::STRING:
-            {
-                std::string strRet("");
-                strRet = this->call<std::string>(strName);
-                oss << strRet;
-                break;
-            }
-            case SignatureType::VEC2DDOUBLE:
-            {
-                Vector2d vecRet; vecRet.setZero();
-                vecRet = this->call<Vector2d>(strName);
-                oss << vecRet[0] << " " << vecRet[1];
-                break;
-            }
-            case SignatureType::VEC2DDOUBLE_INT:
-            {
-                int nParam(0);
-                iss >> nParam;
-                Vector2d vecRet; vecRet.setZero();
-                vecRet = this->call<Vector2d,int>(strName, nParam);
-                oss << vecRet[0] << " " << vecRet[1];
-                break;
-            }
-            case SignatureType::VEC2DDOUBLE_2INT:
-            {
-                int nParam1(0);
-                int nParam2(0);
-                iss >> nParam1 >> nParam2;
-                Vector2d vecRet; vecRet.setZero();
-                vecRet = this->call<Vector2d,int,int>(strName, nParam1, nParam2);
-                oss << vecRet[0] << " " << vecRet[1];
-                break;
-            }
-            case SignatureType::VEC2DDOUBLE_STRING:
-            {
-                std::string strParam = "";
-                iss >> strParam;
-                Vector2d vecRet; vecRet.setZero();
-                vecRet = this->call<Vector2d,std::string>(strName, strParam);
-                oss << vecRet[0] << " " << vecRet[1];
-                break;
-            }
-            case SignatureType::VEC2DDOUBLE_2STRING:
-            {
-                std::string strParam1 = "";
-                std::string strParam2 = "";
-                iss >> strParam1 >> strParam2;
-                Vector2d vecRet; vecRet.setZero();
-                vecRet = this->call<Vector2d,std::string,std::string>(strName, strParam1, strParam2);
-                oss << vecRet[0] << " " << vecRet[1];
-                break;
-            }
-            case SignatureType::VEC2DINT:
-            {
-                Vector2i vecRet; vecRet.setZero();
-                vecRet = this->call<Vector2i>(strName);
-                oss << vecRet[0] << " " << vecRet[1];
-                break;
-            }
-            case SignatureType::VEC2DINT_INT:
-            {
-                int nParam(0);
-                iss >> nParam;
-                Vector2i vecRet; vecRet.setZero();
-                vecRet = this->call<Vector2i,int>(strName, nParam);
-                oss << vecRet[0] << " " << vecRet[1];
-                break;
-            }
-            default:
-                DOM_DEV(NOTICE_MSG_QUIET("Com Interface", "Wrapper for " << strName << "'s signature not implemented."))
-                break;
+            oss << ", queued " << nQueued <<
+                   ", waited mean " << Stats.nQueuedTimeTotal.load(std::memory_order_relaxed)*1.0e-3/nQueued <<
+                   "us, waited max " << Stats.nQueuedTimeMax.load(std::memory_order_relaxed)*1.0e-3 <<
+                   "us, written total " << Stats.nWriterTimeTotal.load(std::memory_order_relaxed)*1.0e-3 <<
+                   "us, written max " << Stats.nWriterTimeMax.load(std::memory_order_relaxed)*1.0e-3 << "us";
         }
     }
-    else
+    for (const auto& WriterQueue : m_WriterQueues)
     {
-        WARNING_MSG("Com Interface", "Unknown function <" << strName << ">. ");
-        throw CComInterfaceException(ComIntExceptionType::UNKNOWN_COMMAND);
+        if (!_strName.empty() && WriterQueue.first != _strName) continue;
+        
+        if (oss.tellp() > 0) oss << "\n";
+        oss << "queue " << WriterQueue.first << ": flushes " << WriterQueue.second.getNumberOfFlushes() <<
+               ", commands " << WriterQueue.second.getNumberOfCommands() <<
+               ", merged " << WriterQueue.second.getNumberOfCoalesced() <<
+               ", depth " << WriterQueue.second.getDepth() <<
+               ", depth max " << WriterQueue.second.getDepthMax();
+    }
+    
+    if (oss.tellp() <= 0)
+    {
+        if (!_strName.empty()) return "No profile of <" + _strName + "> found.";
+        return m_bProfiling ? "No calls recorded." : "Profiling disabled.";
     }
     return oss.str();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 ///
-/// \brief Calls all writing functions of given queue
+/// \brief Returns the queue of given writer domain
 ///
-/// \param _strQueue Queue of which functions should be called
+/// Queues are never removed, thus the queue can be cached.
+///
+/// \param _strWriterDomain Writer domain
+///
+/// \return Queue, null if writer domain isn't registered
 ///
 ///////////////////////////////////////////////////////////////////////////////
-void CComInterface::callWriters(const std::string& _strQueue)
+CWriterQueue* CComInterface::getWriterQueue(const std::string& _strWriterDomain)
 {
-    METHOD_ENTRY_QUIET("CComInterface::callWriters")
-    
-    IBaseCommand* pQueuedFunction = nullptr;
-    
-    auto it = m_WriterQueues.find(_strQueue);
-    if (it == m_WriterQueues.end())
-    {
-        WARNING_MSG("Com Interface", "Writer queue <" << _strQueue << "> doesn't exist. Skipping execution.")
-    }
+    METHOD_ENTRY_QUIET("CComInterface::getWriterQueue")
     
-    while (m_WriterQueues[_strQueue].try_dequeue(pQueuedFunction))
-    {
-        DEBUG_MSG("Com Interface", "Flush writer queue " << _strQueue << ".")
-        switch (pQueuedFunction->getSignature())
-        {
-            case SignatureType::NONE:
-            {
-                auto pQueuedFunctionConcrete = static_cast<CCommandToQueueWrapper<void>*>(pQueuedFunction);
-                pQueuedFunctionConcrete->call();
-                break;
-            }
-            case SignatureType::NONE_BOOL:
-            {
-                auto pQueuedFunctionConcrete = static_cast<CCommandToQueueWrapper<void, bool>*>(pQueuedFunction);
-                pQueuedFunctionConcrete->call(std::get<0>(pQueuedFunctionConcrete->getParams()));
-                break;
-            }
-            case SignatureType::NONE_DOUBLE:
-            {
-                auto pQueuedFunctionConcrete = static_cast<CCommandToQueueWrapper<void, double>*>(pQueuedFunction);
-                pQueuedFunctionConcrete->call(std::get<0>(pQueuedFunctionConcrete->getParams()));
-                break;
-            }
-            case SignatureType::NONE_2DOUBLE:
-            {
-                auto pQueuedFunctionConcrete = static_cast<CCommandToQueueWrapper<void, double, double>*>(pQueuedFunction);
-                pQueuedFunctionConcrete->call(std::get<0>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<1>(pQueuedFunctionConcrete->getParams()));
-                break;
-            }
-            case SignatureType::NONE_INT:
-            {
-                auto pQueuedFunctionConcrete = static_cast<CCommandToQueueWrapper<void, int>*>(pQueuedFunction);
-                pQueuedFunctionConcrete->call(std::get<0>(pQueuedFunctionConcrete->getParams()));
-                break;
-            }
-            case SignatureType::NONE_2INT:
-            {
-                auto pQueuedFunctionConcrete = static_cast<CCommandToQueueWrapper<void, int, int>*>(pQueuedFunction);
-                pQueuedFunctionConcrete->call(std::get<0>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<1>(pQueuedFunctionConcrete->getParams()));
-                break;
-            }
-            case SignatureType::NONE_3INT:
-            {
-                auto pQueuedFunctionConcrete = static_cast<CCommandToQueueWrapper<void, int, int, int>*>(pQueuedFunction);
-                pQueuedFunctionConcrete->call(std::get<0>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<1>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<2>(pQueuedFunctionConcrete->getParams()));
-                break;
-            }
-            case SignatureType::NONE_INT_DOUBLE:
-            {
-                auto pQueuedFunctionConcrete = static_cast<CCommandToQueueWrapper<void, int, double>*>(pQueuedFunction);
-                pQueuedFunctionConcrete->call(std::get<0>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<1>(pQueuedFunctionConcrete->getParams()));
-                break;
-            }
-            case SignatureType::NONE_INT_2DOUBLE:
-            {
-                auto pQueuedFunctionConcrete = static_cast<CCommandToQueueWrapper<void, int, double, double>*>(pQueuedFunction);
-                pQueuedFunctionConcrete->call(std::get<0>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<1>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<2>(pQueuedFunctionConcrete->getParams()));
-                break;
-            }
-            case SignatureType::NONE_INT_4DOUBLE:
-            {
-                auto pQueuedFunctionConcrete = static_cast<CCommandToQueueWrapper<void, int, double, double, double, double>*>(pQueuedFunction);
-                pQueuedFunctionConcrete->call(std::get<0>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<1>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<2>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<3>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<4>(pQueuedFunctionConcrete->getParams()));
-                break;
-            }
-            case SignatureType::NONE_INT_DYN_ARRAY:
-            {
-                auto pQueuedFunctionConcrete = static_cast<CCommandToQueueWrapper<void, int, std::vector<double>>*>(pQueuedFunction);
-                pQueuedFunctionConcrete->call(std::get<0>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<1>(pQueuedFunctionConcrete->getParams()));
-                break;
-            }
-            case SignatureType::NONE_INT_STRING:
-            {
-                auto pQueuedFunctionConcrete = static_cast<CCommandToQueueWrapper<void, int, std::string>*>(pQueuedFunction);
-                pQueuedFunctionConcrete->call(std::get<0>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<1>(pQueuedFunctionConcrete->getParams()));
-                break;
-            }
-            case SignatureType::NONE_STRING:
-            {
-                auto pQueuedFunctionConcrete = static_cast<CCommandToQueueWrapper<void, std::string>*>(pQueuedFunction);
-                pQueuedFunctionConcrete->call(std::get<0>(pQueuedFunctionConcrete->getParams()));
-                break;
-            }
-            case SignatureType::NONE_2STRING:
-            {
-                auto pQueuedFunctionConcrete = static_cast<CCommandToQueueWrapper<void, std::string, std::string>*>(pQueuedFunction);
-                pQueuedFunctionConcrete->call(std::get<0>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<1>(pQueuedFunctionConcrete->getParams()));
-                break;
-            }
-            case SignatureType::NONE_4STRING:
-            {
-                auto pQueuedFunctionConcrete = static_cast<CCommandToQueueWrapper<void, std::string, std::string, std::string, std::string>*>(pQueuedFunction);
-                pQueuedFunctionConcrete->call(std::get<0>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<1>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<2>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<3>(pQueuedFunctionConcrete->getParams()));
-                break;
-            }
-            case SignatureType::NONE_STRING_DOUBLE:
-            {
-                auto pQueuedFunctionConcrete = static_cast<CCommandToQueueWrapper<void, std::string, double>*>(pQueuedFunction);
-                pQueuedFunctionConcrete->call(std::get<0>(pQueuedFunctionConcrete->getParams()), std::get<1>(pQueuedFunctionConcrete->getParams()));
-                break;
-            }
-            case SignatureType::NONE_STRING_INT:
-            {
-                auto pQueuedFunctionConcrete = static_cast<CCommandToQueueWrapper<void, std::string, int>*>(pQueuedFunction);
-                pQueuedFunctionConcrete->call(std::get<0>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<1>(pQueuedFunctionConcrete->getParams()));
-                break;
-            }
-            case SignatureType::NONE_STRING_2INT:
-            {
-                auto pQueuedFunctionConcrete = static_cast<CCommandToQueueWrapper<void, std::string, int, int>*>(pQueuedFunction);
-                pQueuedFunctionConcrete->call(std::get<0>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<1>(pQueuedFunctionConcrete->getParams()),
-                                              std::get<2>(pQueuedFunctionConcrete->getParams()));
-                break;
-            }
-            case SignatureType::BOOL_INT:
-            case SignatureType::DOUBLE:
-            case SignatureType::DOUBLE_INT:
-            case SignatureType::DOUBLE_STRING:
-            case SignatureType::DOUBLE_STRING_DOUBLE:
-            case SignatureType::INT:
-            case SignatureType::INT_INT:
-            case SignatureType::INT_STRING:
-            case SignatureType::STRING:
-            case SignatureType::VEC2DDOUBLE:
-            case SignatureType::VEC2DDOUBLE_INT:
-            case SignatureType::VEC2DDOUBLE_2INT:
-            case SignatureType::VEC2DDOUBLE_STRING:
-            case SignatureType::VEC2DDOUBLE_2STRING:
-            case SignatureType::VEC2DINT:
-            case SignatureType::VEC2DINT_INT:
-            {
-                DOM_DEV(WARNING_MSG("Com Interface", "Something went wrong, writing functions shouldn't have a return value."))
-                break;
-            }
-            default:
-            {
-                DOM_DEV(NOTICE_MSG("Com Interface", "Queued writer call not implemented."))
-            }
-        }
-        if (pQueuedFunction != nullptr)
-        {
-            delete pQueuedFunction;
-            MEM_FREED_QUIET("IBaseCommand")
-            pQueuedFunction = nullptr;
-        }
-    }
+    CReadLockGuard Lock(m_AccessData);
+    const auto it = m_WriterQueues.find(_strWriterDomain);
+    if (it == m_WriterQueues.end()) return nullptr;
+    return &it->second;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -652,6 +1326,8 @@ void CComInterface::callWriters(const std::string& _strQueue)
 void CComInterface::help(int nVerboseLevel)
 {
     METHOD_ENTRY_QUIET("CComInterface::help")
+
+    CReadLockGuard Lock(m_AccessData);
     switch (nVerboseLevel)
     {
         case 0:
@@ -688,3 +1364,152 @@ void CComInterface::help()
     METHOD_ENTRY_QUIET("CComInterface::help")
     this->help(0);
 }
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Registers a callback independent of the function's signature
+///
+/// This allows for callbacks from scripts, which don't know the signature at
+/// compile time. Arguments of each call are passed by a writer.
+///
+/// \param _strName Name the function the callback should listen to
+/// \param _Callback Callback function to be registered
+/// \param _strWriterDomain Indicates a callback that writes data (will be
+///                         queued for thread safety). Reader functions will
+///                         have the default domain "Reader"
+///
+/// \return Success?
+///
+///////////////////////////////////////////////////////////////////////////////
+bool CComInterface::registerGenericCallback(const std::string& _strName,
+                                            const ComGenericCallbackType& _Callback,
+                                            const std::string& _strWriterDomain)
+{
+    METHOD_ENTRY_QUIET("CComInterface::registerGenericCallback")
+
+    IBaseCommand* pCommand = nullptr;
+    {
+        CReadLockGuard Lock(m_AccessData);
+        const auto ci = m_RegisteredFunctions.find(_strName);
+        if (ci != m_RegisteredFunctions.end()) pCommand = ci->second;
+    }
+    if (pCommand == nullptr)
+    {
+        WARNING_MSG("Com Interface", "Unknown function <" << _strName << ">, callback not registered.")
+        return false;
+    }
+    return pCommand->registerGenericCallback(this, _strName, _Callback, _strWriterDomain);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Resets the profiles of all functions and writer queues
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComInterface::resetProfile()
+{
+    METHOD_ENTRY("CComInterface::resetProfile")
+    
+    CReadLockGuard Lock(m_AccessData);
+    for (auto& Entry : m_Entries) Entry.second.Statistics.reset();
+    for (auto& WriterQueue : m_WriterQueues) WriterQueue.second.resetStatistics();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Enables or disables profiling of calls
+///
+/// If disabled, calls only check a flag of the function. Queued calls are
+/// recorded if profiling was enabled when they were enqueued.
+///
+/// \param _bProfiling Enable profiling?
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComInterface::setProfiling(const bool _bProfiling)
+{
+    METHOD_ENTRY("CComInterface::setProfiling")
+    
+    {
+        CWriteLockGuard Lock(m_AccessData);
+        m_bProfiling = _bProfiling;
+        for (auto& Entry : m_Entries) Entry.second.bProfiled.store(_bProfiling, std::memory_order_relaxed);
+    }
+    
+    // Logging calls the com interface, thus not while locked
+    INFO_MSG("Com Interface", "Profiling " << (_bProfiling ? "enabled." : "disabled."))
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Adds a callback to the function with given name
+///
+/// The list of callbacks is copied, thus, readers can still iterate the list
+/// before. Write lock must be held.
+///
+/// \param _strName Name of the function
+/// \param _pCallback Callback to be added
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComInterface::addCallback(const std::string& _strName, IBaseCommand* const _pCallback)
+{
+    METHOD_ENTRY_QUIET("CComInterface::addCallback")
+
+    ComEntry& Entry = this->getEntry(_strName);
+    const CallbackListType* const pCallbacksOld = Entry.pCallbacks.load(std::memory_order_relaxed);
+
+    CallbackListType* const pCallbacks = (pCallbacksOld == nullptr) ? new CallbackListType
+                                                                     : new CallbackListType(*pCallbacksOld);
+    pCallbacks->push_back(_pCallback);
+    Entry.pCallbacks.store(pCallbacks, std::memory_order_release);
+
+    // Freed on destruction, since calls might still iterate the old list
+    if (pCallbacksOld != nullptr) m_CallbacksRetired.push_back(pCallbacksOld);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Adds a function, replacing the function of the same name
+///
+/// A replaced function is freed on destruction, since resolved references or
+/// calls that looked it up before might still call it. Write lock must be
+/// held.
+///
+/// \param _strName Name of the function
+/// \param _pFunction Function to be added
+///
+///////////////////////////////////////////////////////////////////////////////
+void CComInterface::addFunction(const std::string& _strName, IBaseCommand* const _pFunction)
+{
+    METHOD_ENTRY_QUIET("CComInterface::addFunction")
+
+    IBaseCommand*& pFunction = m_RegisteredFunctions[_strName];
+    if (pFunction != nullptr) m_FunctionsRetired.push_back(pFunction);
+    pFunction = _pFunction;
+    this->getEntry(_strName).pFunction.store(_pFunction, std::memory_order_release);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the entry of given name, created if not existing
+///
+/// Write lock must be held.
+///
+/// \param _strName Name of the function
+///
+/// \return Entry with stable address
+///
+///////////////////////////////////////////////////////////////////////////////
+ComEntry& CComInterface::getEntry(const std::string& _strName)
+{
+    METHOD_ENTRY_QUIET("CComInterface::getEntry")
+
+    auto it = m_Entries.find(_strName);
+    if (it == m_Entries.end())
+    {
+        it = m_Entries.emplace(std::piecewise_construct,
+                               std::forward_as_tuple(_strName),
+                               std::forward_as_tuple(_strName)).first;
+        it->second.bProfiled.store(m_bProfiling, std::memory_order_relaxed);
+    }
+    return it->second;
+}
@@ -32,20 +32,35 @@
 #define COM_INTERFACE_H
 
 //--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <map>
+#include <new>
 #include <set>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 //--- Program header ---------------------------------------------------------//
+#include "com_future.h"
+#include "com_journal.h"
+#include "command_pool.h"
 #include "conf_bfengine.h"
 #include "log.h"
 #include "log_listener.h"
-#include "spinlock.h"
+#include "rw_spinlock.h"
+#include "timer.h"
+#include "writer_queue.h"
 
 //--- Misc header ------------------------------------------------------------//
 #include "concurrentqueue.h"
+#include <eigen3/Eigen/Core>
 
 /// BFEngine namespace
 namespace bfe
@@ -66,47 +81,6 @@ enum class ParameterType
     VEC2DINT
 };
 
-/// Specifies the signature of the function
-enum class SignatureType
-{
-    UNDEFINED,
-    NONE,
-    BOOL_INT,
-    DOUBLE,
-    DOUBLE_INT,
-    DOUBLE_STRING,
-    DOUBLE_STRING_DOUBLE,
-    INT,
-    INT_INT,
-    INT_STRING,
-    NONE_BOOL,
-    NONE_DOUBLE,
-    NONE_2DOUBLE,
-    NONE_INT,
-    NONE_2INT,
-    NONE_3INT,
-    NONE_INT_DOUBLE,
-    NONE_INT_2DOUBLE,
-    NONE_INT_4DOUBLE,
-    NONE_INT_DYN_ARRAY,
-    NONE_INT_STRING,
-    NONE_STRING,
-    NONE_2STRING,
-    NONE_4STRING,
-    NONE_STRING_DOUBLE,
-    NONE_STRING_INT,
-    NONE_STRING_2INT,
-    NONE_UID,
-    STRING,
-    VEC2DDOUBLE,
-    VEC2DDOUBLE_INT,
-    VEC2DDOUBLE_2INT,
-    VEC2DDOUBLE_STRING,
-    VEC2DDOUBLE_2STRING,
-    VEC2DINT,
-    VEC2DINT_INT
-};
-
 /// Specifies type of possible exceptions in com interface
 enum class ComIntExceptionType
 {
@@ -137,10 +111,428 @@ class CComInterfaceException
 
 };
 
+class CComInterface;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Interface for reading the arguments of a call
+///
+/// Readers convert the values of an external caller, e.g. a command string or
+/// a script, to the types of a function's signature.
+///
+////////////////////////////////////////////////////////////////////////////////
+class IComValueReader
+{
+    public:
+        //--- Constructor/Destructor -----------------------------------------//
+        virtual ~IComValueReader(){}
+
+        //--- Methods --------------------------------------------------------//
+        virtual bool                readBool() = 0;
+        virtual double              readDouble() = 0;
+        virtual std::vector<double> readDoubleArray() = 0;
+        virtual int                 readInt() = 0;
+        virtual std::string         readString() = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Interface for writing return values or arguments of a call
+///
+////////////////////////////////////////////////////////////////////////////////
+class IComValueWriter
+{
+    public:
+        //--- Constructor/Destructor -----------------------------------------//
+        virtual ~IComValueWriter(){}
+
+        //--- Methods --------------------------------------------------------//
+        virtual void writeBool(const bool) = 0;
+        virtual void writeDouble(const double) = 0;
+        virtual void writeDoubleArray(const std::vector<double>&) = 0;
+        virtual void writeInt(const int) = 0;
+        virtual void writeString(const std::string&) = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads arguments separated by whitespace from a stream
+///
+/// Strings are read as one word, arrays consume the remaining stream.
+/// Missing values are read as zero or empty.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CComStreamReader : public IComValueReader
+{
+    public:
+        //--- Constructor/Destructor -----------------------------------------//
+        explicit CComStreamReader(std::istream& _Stream) : m_Stream(_Stream) {}
+
+        //--- Methods --------------------------------------------------------//
+        bool                readBool() override;
+        double              readDouble() override;
+        std::vector<double> readDoubleArray() override;
+        int                 readInt() override;
+        std::string         readString() override;
+
+    private:
+
+        //--- Variables [private] --------------------------------------------//
+        std::istream& m_Stream; ///< Stream to read arguments from
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes values separated by spaces to a stream
+///
+////////////////////////////////////////////////////////////////////////////////
+class CComStreamWriter : public IComValueWriter
+{
+    public:
+        //--- Constructor/Destructor -----------------------------------------//
+        explicit CComStreamWriter(std::ostream& _Stream) : m_Stream(_Stream) {}
+
+        //--- Methods --------------------------------------------------------//
+        void writeBool(const bool) override;
+        void writeDouble(const double) override;
+        void writeDoubleArray(const std::vector<double>&) override;
+        void writeInt(const int) override;
+        void writeString(const std::string&) override;
+
+    private:
+
+        //--- Methods [private] ----------------------------------------------//
+        std::ostream& separate();
+
+        //--- Variables [private] --------------------------------------------//
+        std::ostream&   m_Stream;           ///< Stream to write values to
+        bool            m_bEmpty = true;    ///< Indicates that nothing was written yet
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads arguments separated by whitespace from a range of characters
+///
+/// Reads the same values as \ref CComStreamReader, including partially read
+/// words and failed reads, after which all values are read as zero or empty,
+/// but without creating a stream. The characters are not copied and must
+/// outlive the reader.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CComStringReader : public IComValueReader
+{
+    public:
+        //--- Constructor/Destructor -----------------------------------------//
+        CComStringReader(const char* const _pBegin, const char* const _pEnd) : m_pPos(_pBegin),
+                                                                             m_pEnd(_pEnd) {}
+
+        //--- Methods --------------------------------------------------------//
+        bool                readBool() override;
+        double              readDouble() override;
+        std::vector<double> readDoubleArray() override;
+        int                 readInt() override;
+        std::string         readString() override;
+
+    private:
+
+        //--- Methods [private] ----------------------------------------------//
+        bool readFloat(double&);
+        bool readInteger(long&);
+        void skipWhitespace();
+
+        //--- Variables [private] --------------------------------------------//
+        const char*         m_pPos;             ///< Next character to be read
+        const char* const   m_pEnd;             ///< End of characters
+        bool                m_bFailed = false;  ///< Indicates a failed read, like a stream's fail bit
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Appends values separated by spaces to a string
+///
+/// Values are formatted like by \ref CComStreamWriter. Since the string is
+/// appended to, its capacity is reused if cleared before.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CComStringWriter : public IComValueWriter
+{
+    public:
+        //--- Constructor/Destructor -----------------------------------------//
+        explicit CComStringWriter(std::string& _strBuffer) : m_strBuffer(_strBuffer) {}
+
+        //--- Methods --------------------------------------------------------//
+        void writeBool(const bool) override;
+        void writeDouble(const double) override;
+        void writeDoubleArray(const std::vector<double>&) override;
+        void writeInt(const int) override;
+        void writeString(const std::string&) override;
+
+    private:
+
+        //--- Methods [private] ----------------------------------------------//
+        std::string& separate();
+
+        //--- Variables [private] --------------------------------------------//
+        std::string&    m_strBuffer;        ///< String to append values to
+        bool            m_bEmpty = true;    ///< Indicates that nothing was written yet
+};
+
+/// Identifies the type of a value written by \ref CComBinaryWriter
+enum class ComValueTagType : std::uint8_t
+{
+    BOOL = 1,
+    DOUBLE = 2,
+    DOUBLE_ARRAY = 3,
+    INT = 4,
+    STRING = 5
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads values written by \ref CComBinaryWriter
+///
+/// A value of different type than written fails, after which all values are
+/// read as zero or empty. The characters are not copied and must outlive the
+/// reader.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CComBinaryReader : public IComValueReader
+{
+    public:
+        //--- Constructor/Destructor -----------------------------------------//
+        CComBinaryReader(const char* const _pBegin, const char* const _pEnd) : m_pPos(_pBegin),
+                                                                             m_pEnd(_pEnd) {}
+
+        //--- Methods --------------------------------------------------------//
+        bool                readBool() override;
+        double              readDouble() override;
+        std::vector<double> readDoubleArray() override;
+        int                 readInt() override;
+        std::string         readString() override;
+
+    private:
+
+        //--- Methods [private] ----------------------------------------------//
+        bool readBytes(void* const, const std::size_t);
+        bool readTag(const ComValueTagType);
+
+        //--- Variables [private] --------------------------------------------//
+        const char*         m_pPos;             ///< Next character to be read
+        const char* const   m_pEnd;             ///< End of characters
+        bool                m_bFailed = false;  ///< Indicates a failed read
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Appends values and their types in binary form to a string
+///
+/// Values are written in host byte order without loss of precision, each
+/// preceded by its \ref ComValueTagType.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CComBinaryWriter : public IComValueWriter
+{
+    public:
+        //--- Constructor/Destructor -----------------------------------------//
+        explicit CComBinaryWriter(std::string& _strBuffer) : m_strBuffer(_strBuffer) {}
+
+        //--- Methods --------------------------------------------------------//
+        void writeBool(const bool) override;
+        void writeDouble(const double) override;
+        void writeDoubleArray(const std::vector<double>&) override;
+        void writeInt(const int) override;
+        void writeString(const std::string&) override;
+
+    private:
+
+        //--- Methods [private] ----------------------------------------------//
+        void writeBytes(const void* const, const std::size_t);
+
+        //--- Variables [private] --------------------------------------------//
+        std::string& m_strBuffer; ///< String to append values to
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Conversion of a type from readers and to writers
+///
+/// Specialised for all types that can be used by string or script calls.
+/// Functions with other types can still be called directly.
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+struct ComValue
+{
+    static constexpr bool IS_SUPPORTED = false; ///< Indicates a convertible type
+};
+
+template <>
+struct ComValue<void>
+{
+    static constexpr bool IS_SUPPORTED = true;
+};
+
+template <>
+struct ComValue<bool>
+{
+    static constexpr bool IS_SUPPORTED = true;
+    static bool read(IComValueReader& _Reader) {return _Reader.readBool();}
+    static void write(IComValueWriter& _Writer, const bool _bValue) {_Writer.writeBool(_bValue);}
+};
+
+template <>
+struct ComValue<double>
+{
+    static constexpr bool IS_SUPPORTED = true;
+    static double read(IComValueReader& _Reader) {return _Reader.readDouble();}
+    static void write(IComValueWriter& _Writer, const double _fValue) {_Writer.writeDouble(_fValue);}
+};
+
+template <>
+struct ComValue<int>
+{
+    static constexpr bool IS_SUPPORTED = true;
+    static int read(IComValueReader& _Reader) {return _Reader.readInt();}
+    static void write(IComValueWriter& _Writer, const int _nValue) {_Writer.writeInt(_nValue);}
+};
+
+template <>
+struct ComValue<std::string>
+{
+    static constexpr bool IS_SUPPORTED = true;
+    static std::string read(IComValueReader& _Reader) {return _Reader.readString();}
+    static void write(IComValueWriter& _Writer, const std::string& _strValue) {_Writer.writeString(_strValue);}
+};
+
+template <>
+struct ComValue<std::vector<double>>
+{
+    static constexpr bool IS_SUPPORTED = true;
+    static std::vector<double> read(IComValueReader& _Reader) {return _Reader.readDoubleArray();}
+    static void write(IComValueWriter& _Writer, const std::vector<double>& _Values) {_Writer.writeDoubleArray(_Values);}
+};
+
+template <>
+struct ComValue<Eigen::Vector2d>
+{
+    static constexpr bool IS_SUPPORTED = true;
+    static Eigen::Vector2d read(IComValueReader& _Reader)
+    {
+        const double fX = _Reader.readDouble();
+        const double fY = _Reader.readDouble();
+        return Eigen::Vector2d(fX, fY);
+    }
+    static void write(IComValueWriter& _Writer, const Eigen::Vector2d& _vecValue)
+    {
+        _Writer.writeDouble(_vecValue[0]);
+        _Writer.writeDouble(_vecValue[1]);
+    }
+};
+
+template <>
+struct ComValue<Eigen::Vector2i>
+{
+    static constexpr bool IS_SUPPORTED = true;
+    static Eigen::Vector2i read(IComValueReader& _Reader)
+    {
+        const int nX = _Reader.readInt();
+        const int nY = _Reader.readInt();
+        return Eigen::Vector2i(nX, nY);
+    }
+    static void write(IComValueWriter& _Writer, const Eigen::Vector2i& _vecValue)
+    {
+        _Writer.writeInt(_vecValue[0]);
+        _Writer.writeInt(_vecValue[1]);
+    }
+};
+
+/// Indicates that all given types are convertible, see \ref ComValue
+template <class... T>
+struct ComValuesSupported : std::true_type {};
+
+template <class T, class... TRest>
+struct ComValuesSupported<T, TRest...> :
+    std::integral_constant<bool, ComValue<std::decay_t<T>>::IS_SUPPORTED && ComValuesSupported<TRest...>::value> {};
+
+/// Specifies how queued calls of a writer function are merged when flushed
+///
+/// The target of a call is its first argument, e.g. the UID of an object.
+/// Merged calls are called at the position of the last call.
+enum class ComCoalesceType : std::uint8_t
+{
+    NONE = 0,                   ///< Every call is executed
+    LAST = 1,                   ///< Only the last call is executed
+    LAST_PER_TARGET = 2,        ///< Only the last call per target is executed
+    ACCUMULATE = 3,             ///< Arguments of calls are summed up, e.g. deltas
+    ACCUMULATE_PER_TARGET = 4   ///< Arguments but target of calls per target are summed up
+};
+
+/// Indicates that values of given type can be compared for equality
+template <class T, class = void>
+struct ComComparable : std::false_type {};
+
+template <class T>
+struct ComComparable<T, decltype(void(bool(std::declval<const T&>() == std::declval<const T&>())))> : std::true_type {};
+
+/// Indicates that values of given type are summed up when merged, i.e. numbers
+/// but no booleans
+template <class T>
+struct ComAddable : std::integral_constant<bool, std::is_arithmetic<T>::value && !std::is_same<T, bool>::value> {};
+
+/// Indicates that values of given type are summed up when merged, i.e. vectors
+/// of numbers
+template <class T, int R, int O, int MR>
+struct ComAddable<Eigen::Matrix<T, R, 1, O, MR, 1>> : ComAddable<T> {};
+
+/// Indicates that values of all given types can be summed up
+template <class... T>
+struct ComAccumulable : std::true_type {};
+
+template <class T, class... TRest>
+struct ComAccumulable<T, TRest...> :
+    std::integral_constant<bool, ComAddable<std::decay_t<T>>::value && ComAccumulable<TRest...>::value> {};
+
+/// Indicates that values of all given types but the target can be summed up
+template <class... T>
+struct ComAccumulablePerTarget : std::false_type {};
+
+template <class T, class... TRest>
+struct ComAccumulablePerTarget<T, TRest...> : ComAccumulable<TRest...> {};
+
+/// Indicates that calls have a target, i.e. a comparable first argument
+template <class... T>
+struct ComTargeted : std::false_type {};
+
+template <class T, class... TRest>
+struct ComTargeted<T, TRest...> : ComComparable<T> {};
+
+/// Hash of targets, constant for types without standard hash, which merges
+/// calls to different targets less often
+template <class T, bool = std::is_arithmetic<T>::value || std::is_enum<T>::value ||
+                          std::is_pointer<T>::value || std::is_same<T, std::string>::value>
+struct ComTargetHash
+{
+    static std::size_t get(const T&) {return 0u;}
+};
+
+template <class T>
+struct ComTargetHash<T, true>
+{
+    static std::size_t get(const T& _Target) {return std::hash<T>()(_Target);}
+};
+
+/// Writes the arguments of a call
+typedef std::function<void(IComValueWriter&)> ComArgumentsWriterType;
+/// Callback independent of signature, receiving the arguments of a call by a writer
+typedef std::function<void(const ComArgumentsWriterType&)> ComGenericCallbackType;
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Base class for callback functions registered at com interface
 ///
+/// Calls with unknown signature, e.g. from strings or scripts, are dispatched
+/// by the virtual methods, thus, new signatures don't need any registration.
+///
 ////////////////////////////////////////////////////////////////////////////////
 class IBaseCommand
 {
@@ -149,11 +541,26 @@ class IBaseCommand
         virtual ~IBaseCommand(){}
         
         //--- Constant methods -----------------------------------------------//
-        SignatureType getSignature() const {return m_Signature;}
+        ComCoalesceType       getCoalesce() const {return m_Coalesce;}
+        const std::type_info& getSignature() const {return *m_pSignature;}
+
+        virtual std::size_t getCoalesceKey() const {return 0u;}
+        virtual void invoke(CComInterface* const, const std::string&,
+                            IComValueReader&, IComValueWriter&,
+                            const ComJournalOriginType = ComJournalOriginType::SCRIPT) const {}
+        virtual bool registerGenericCallback(CComInterface* const, const std::string&,
+                                             const ComGenericCallbackType&,
+                                             const std::string&) const {return false;}
+
+        //--- Methods --------------------------------------------------------//
+        virtual void callQueued() {}
+        virtual bool coalesce(IBaseCommand* const) {return false;}
+        virtual void destroy() {delete this;}
         
     protected:
     
-        SignatureType m_Signature = SignatureType::UNDEFINED;
+        const std::type_info*   m_pSignature = &typeid(void);       ///< Type of the concrete command
+        ComCoalesceType         m_Coalesce = ComCoalesceType::NONE; ///< Merging when queued
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -172,20 +579,100 @@ class CCommand : public IBaseCommand
         
         //--- Constant methods -----------------------------------------------//
         std::function<TRet(TArgs...)> getFunction() const {return m_Function;}
+
+        void invoke(CComInterface* const, const std::string&,
+                    IComValueReader&, IComValueWriter&,
+                    const ComJournalOriginType = ComJournalOriginType::SCRIPT) const override;
+        bool registerGenericCallback(CComInterface* const, const std::string&,
+                                     const ComGenericCallbackType&,
+                                     const std::string&) const override;
         
         //--- Methods --------------------------------------------------------//
         TRet call(TArgs...);
         
     private:
         
-        /// --- Methods [private] --------------------------------------------//
-        void dispatchSignature();
+        /// --- Constant methods [private] -----------------------------------//
+        void invokeSupported(CComInterface* const, const std::string&,
+                             IComValueReader&, IComValueWriter&,
+                             const ComJournalOriginType, std::false_type) const;
+        void invokeSupported(CComInterface* const, const std::string&,
+                             IComValueReader&, IComValueWriter&,
+                             const ComJournalOriginType, std::true_type) const;
+        template <std::size_t... I>
+        void journalUnpacked(CComInterface* const, const std::string&, const ComJournalOriginType,
+                             const std::tuple<std::decay_t<TArgs>...>&, std::index_sequence<I...>) const;
+        template <std::size_t... I>
+        void invokeUnpacked(CComInterface* const, const std::string&, IComValueWriter&,
+                            std::tuple<std::decay_t<TArgs>...>&, std::index_sequence<I...>,
+                            std::false_type) const;
+        template <std::size_t... I>
+        void invokeUnpacked(CComInterface* const, const std::string&, IComValueWriter&,
+                            std::tuple<std::decay_t<TArgs>...>&, std::index_sequence<I...>,
+                            std::true_type) const;
+        bool registerGenericCallbackSupported(CComInterface* const, const std::string&,
+                                              const ComGenericCallbackType&,
+                                              const std::string&, std::false_type) const;
+        bool registerGenericCallbackSupported(CComInterface* const, const std::string&,
+                                              const ComGenericCallbackType&,
+                                              const std::string&, std::true_type) const;
         
         /// --- Variables [private] ------------------------------------------//
         std::function<TRet(TArgs...)> m_Function; ///< Function to be registered at com interface
         
 };
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Profile of calls of one function
+///
+/// Recorded only while profiling is enabled, see
+/// \ref CComInterface::setProfiling. Times are stored in nanoseconds, since
+/// atomic doubles can't be added.
+///
+////////////////////////////////////////////////////////////////////////////////
+struct ComCallStatistics
+{
+    std::atomic<std::uint64_t> nCalls{0u};              ///< Number of calls
+    std::atomic<std::uint64_t> nCallbacks{0u};          ///< Number of callbacks called by all calls
+    std::atomic<std::uint64_t> nTimeTotal{0u};          ///< Time of all calls, including callbacks
+    std::atomic<std::uint64_t> nTimeMax{0u};            ///< Time of longest call
+    std::atomic<std::uint64_t> nQueued{0u};             ///< Number of queued writer calls executed
+    std::atomic<std::uint64_t> nQueuedTimeTotal{0u};    ///< Time all queued calls waited
+    std::atomic<std::uint64_t> nQueuedTimeMax{0u};      ///< Longest time a queued call waited
+    std::atomic<std::uint64_t> nWriterTimeTotal{0u};    ///< Time of all queued calls executed
+    std::atomic<std::uint64_t> nWriterTimeMax{0u};      ///< Time of longest queued call executed
+
+    void addCall(const double, const std::size_t);
+    void addQueued(const double, const double);
+    void reset();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Records time of a call in its statistics when leaving scope
+///
+////////////////////////////////////////////////////////////////////////////////
+class CComCallTimer
+{
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        CComCallTimer(ComCallStatistics* const _pStatistics, const std::size_t _nCallbacks) :
+            m_pStatistics(_pStatistics), m_nCallbacks(_nCallbacks) {m_Timer.start();}
+        ~CComCallTimer() {m_Timer.stop(); m_pStatistics->addCall(m_Timer.getTime(), m_nCallbacks);}
+
+        CComCallTimer(const CComCallTimer&) = delete;
+        CComCallTimer& operator=(const CComCallTimer&) = delete;
+
+    private:
+
+        //--- Variables [private] --------------------------------------------//
+        CTimer              m_Timer;        ///< Measures time of call
+        ComCallStatistics*  m_pStatistics;  ///< Statistics the call is added to
+        std::size_t         m_nCallbacks;   ///< Callbacks called by call
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Specialised callback functions with parameters to store in queue
@@ -194,6 +681,18 @@ class CCommand : public IBaseCommand
 /// In contrast to \ref CCommand, it also stores all parameters which are later
 /// needed for actual execution of the command.
 ///
+/// Wrappers are created by \ref create in a slot of the pool of the writer
+/// domain and must be destroyed by \ref destroy. The function is referenced,
+/// not copied, since it is owned by the registered command.
+///
+/// Wrappers of asynchronous calls share a state with the caller's future,
+/// which is fulfilled when the command is called.
+///
+/// Wrappers of functions registered with a \ref ComCoalesceType are merged
+/// by the writer queue: The key identifies the function and, if merged per
+/// target, the target. Calls with equal keys might still differ, e.g. by
+/// target, which is checked by \ref coalesce.
+///
 ////////////////////////////////////////////////////////////////////////////////
 template <class TRet, class... TArgs>
 class CCommandToQueueWrapper : public IBaseCommand
@@ -202,25 +701,116 @@ class CCommandToQueueWrapper : public IBaseCommand
         
         //--- Constructor/Destructor -----------------------------------------//
         CCommandToQueueWrapper() = delete;
-        CCommandToQueueWrapper(const std::function<TRet(TArgs...)>&, TArgs...);
+        
+        //--- Static methods -------------------------------------------------//
+        static CCommandToQueueWrapper* create(CCommandPool* const,
+                                              const std::function<TRet(TArgs...)>* const,
+                                              ComCallStatistics* const,
+                                              ComAsyncStatePtr<TRet>&&,
+                                              const ComCoalesceType,
+                                              TArgs...);
         
         //--- Constant methods -----------------------------------------------//
+        std::size_t getCoalesceKey() const override;
         const std::tuple<TArgs...> getParams() const {return m_Params;}
         
         //--- Methods --------------------------------------------------------//
-        TRet call(TArgs...);
+        void callQueued() override;
+        bool coalesce(IBaseCommand* const) override;
+        void destroy() override;
         
     private:
         
+        //--- Constructor [private] ------------------------------------------//
+        CCommandToQueueWrapper(CCommandPool* const, const std::function<TRet(TArgs...)>* const,
+                               ComCallStatistics* const, ComAsyncStatePtr<TRet>&&,
+                               const ComCoalesceType, TArgs...);
+        
+        /// --- Constant methods [private] -----------------------------------//
+        std::size_t getTargetHash(std::false_type) const;
+        std::size_t getTargetHash(std::true_type) const;
+        bool        isSameTarget(const CCommandToQueueWrapper&, std::false_type) const;
+        bool        isSameTarget(const CCommandToQueueWrapper&, std::true_type) const;
+        
         /// --- Methods [private] --------------------------------------------//
-        void dispatchSignature();
+        template <std::size_t N>
+        void accumulate(const CCommandToQueueWrapper&, std::false_type);
+        template <std::size_t N>
+        void accumulate(const CCommandToQueueWrapper&, std::true_type);
+        template <std::size_t N, std::size_t... I>
+        void accumulateUnpacked(const CCommandToQueueWrapper&, std::index_sequence<I...>);
+        template <std::size_t... I>
+        void callUnpacked(std::index_sequence<I...>);
+        template <std::size_t... I>
+        void callUnpacked(std::index_sequence<I...>, std::false_type);
+        template <std::size_t... I>
+        void callUnpacked(std::index_sequence<I...>, std::true_type);
         
         /// --- Variables [private] ------------------------------------------//
-        std::function<TRet(TArgs...)> m_Function; ///< Function to be registered at com interface
-        std::tuple<TArgs...>          m_Params;   ///< Parameter function is called with
+        const std::function<TRet(TArgs...)>*    m_pFunction;    ///< Function owned by registered command
+        CCommandPool*                           m_pPool;        ///< Pool of slot, null if allocated on heap
+        ComCallStatistics*                      m_pStatistics;  ///< Profile of function, null if not profiled
+        std::chrono::steady_clock::time_point   m_Enqueued;     ///< Time enqueued, if profiled
+        ComAsyncStatePtr<TRet>                  m_pAsync;       ///< State of asynchronous call, null if none
+        std::tuple<TArgs...>                    m_Params;       ///< Parameter function is called with
         
 };
 
+/// Callbacks of a function, replaced as a whole when a callback is added
+typedef std::vector<IBaseCommand*> CallbackListType;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Function and callbacks registered under one name
+///
+/// Entries are never removed, thus their addresses are stable and they can be
+/// accessed without lookup. Function and callbacks are published atomically,
+/// hence, readers don't need any lock.
+///
+////////////////////////////////////////////////////////////////////////////////
+struct ComEntry
+{
+    explicit ComEntry(const std::string& _strName) : strName(_strName) {}
+
+    std::string                             strName;                ///< Registered name
+    std::atomic<IBaseCommand*>              pFunction{nullptr};     ///< Registered function, null if unknown
+    std::atomic<const CallbackListType*>    pCallbacks{nullptr};    ///< Current callbacks, null if none
+    std::atomic<bool>                       bProfiled{false};       ///< Indicates if calls are recorded
+    mutable ComCallStatistics               Statistics;             ///< Profile of calls
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Typed reference to a function, resolved once by name
+///
+/// Calls skip the lookup by name and the locking of the com interface, which
+/// is meant for functions called each frame. References can be resolved before
+/// the function is registered and stay valid for the lifetime of the com
+/// interface.
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+class CCommandRef
+{
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        CCommandRef() = default;
+        explicit CCommandRef(const ComEntry* const _pEntry) : m_pEntry(_pEntry) {}
+
+        //--- Constant methods -----------------------------------------------//
+        TRet call(TArgs...) const;
+        bool isValid() const;
+
+    private:
+
+        //--- Constant methods [private] -------------------------------------//
+        TRet callUnprofiled(TArgs...) const;
+
+        //--- Variables [private] --------------------------------------------//
+        const ComEntry* m_pEntry = nullptr; ///< Resolved entry, null if not resolved
+};
+
 /// Map of all functions, accessed by name
 typedef std::map<std::string, IBaseCommand*> RegisteredFunctionsType;
 /// Map of descriptions, accessed by name
@@ -235,13 +825,13 @@ typedef std::string DomainType;
 /// Map of domains, accessed by function name
 typedef std::unordered_map<std::string, DomainType> RegisteredDomainsType;
 
-/// Multimap of callback functions, accessed by name
-typedef std::unordered_multimap<std::string, IBaseCommand*> RegisteredCallbacksType;
+/// Map of functions and their callbacks, accessed by name
+typedef std::unordered_map<std::string, ComEntry> ComEntriesType;
 
 /// List of writer domains
 typedef std::set<std::string> DomainsType;
 /// Map of queues with one queue for each writer domain
-typedef std::unordered_map<std::string, moodycamel::ConcurrentQueue<IBaseCommand*>> WriterQueuesType;
+typedef std::unordered_map<std::string, CWriterQueue> WriterQueuesType;
 
 //--- Enum parser ------------------------------------------------------------//
 static std::map<ParameterType, std::string> mapParameterToString = {
@@ -275,18 +865,37 @@ class CComInterface : public bfe::ILogListener
         DomainsType*                  getDomains() {return &m_RegisteredDomains;} 
         RegisteredDomainsType*        getDomainsByFunction() {return &m_RegisteredFunctionsDomain;}
         RegisteredFunctionsType*      getFunctions()  {return &m_RegisteredFunctions;} 
+        CComJournal*                  getJournal() {return &m_Journal;}
         
         //--- Methods --------------------------------------------------------//
         template<class TRet, class... Args>
         TRet                call(const std::string&, Args...);
         const std::string   call(const std::string&);
+        void                call(const std::string&, std::string&);
+        template <class TRet, class... TArgs>
+        CComFuture<TRet>    callAsync(const std::string&, TArgs...);
         void                callWriters(const std::string&);
+        void                callWriters(CWriterQueue* const);
+        CWriterQueue*       getWriterQueue(const std::string&);
+        bool                invoke(const std::string&, IComValueReader&, IComValueWriter&,
+                                   const ComJournalOriginType = ComJournalOriginType::SCRIPT);
+        template <class... TArgs>
+        void                journal(const ComJournalOriginType, const std::string&, const TArgs&...);
+        bool                dumpProfile(const std::string&);
+        std::string         getProfile(const std::string& = "");
+        void                resetProfile();
+        void                setProfiling(const bool);
         void                help();
         void                help(int);
 
         template <class TRet, class... TArgs>
         bool registerCallback(const std::string&, const std::function<TRet(TArgs...)>&,
                               const std::string& = "Reader");
+        bool registerGenericCallback(const std::string&, const ComGenericCallbackType&,
+                                     const std::string& = "Reader");
+
+        template <class TRet, class... TArgs>
+        CCommandRef<TRet, TArgs...> resolve(const std::string&);
         
         template <class... TArgs>
         bool registerEvent(const std::string&,
@@ -299,9 +908,10 @@ class CComInterface : public bfe::ILogListener
                               const std::string&,
                               const ParameterListType& = {},
                               const DomainType& = "",
-                              const std::string& = "Reader"
+                              const std::string& = "Reader",
+                              const ComCoalesceType = ComCoalesceType::NONE
         );
-        void registerWriterDomain(const std::string&);
+        CWriterQueue* registerWriterDomain(const std::string&);
         
         void logEntry(const std::string&, const std::string&,
                       const LogLevelType&, const LogDomainType&);
@@ -311,11 +921,30 @@ class CComInterface : public bfe::ILogListener
         friend std::ostream& operator<<(std::ostream&, CComInterface&);
         
     private:
+
+        //--- Methods [private] ----------------------------------------------//
+        void        addCallback(const std::string&, IBaseCommand* const);
+        void        addFunction(const std::string&, IBaseCommand* const);
+        template <class TRet, class... TArgs>
+        void        callAsyncFulfil(const ComEntry* const, CComAsyncState<TRet>* const, std::false_type, TArgs...);
+        template <class TRet, class... TArgs>
+        void        callAsyncFulfil(const ComEntry* const, CComAsyncState<TRet>* const, std::true_type, TArgs...);
+        ComEntry&   getEntry(const std::string&);
+        template <class... TArgs>
+        void        journalSupported(const ComJournalOriginType, const std::string&, std::false_type,
+                                     const TArgs&...);
+        template <class... TArgs>
+        void        journalSupported(const ComJournalOriginType, const std::string&, std::true_type,
+                                     const TArgs&...);
         
-        CSpinlock                           m_AccessData;                ///< Indicates access, important for multithreading
-        
+        static thread_local const ComEntry* s_pAsyncEntry;               ///< Function called asynchronously by this thread
+        static thread_local void*           s_pAsyncState;               ///< Its state, taken by writer when enqueued
+
+        CRWSpinlock                         m_AccessData;                ///< Registration writes, lookups read
         
-        RegisteredCallbacksType             m_RegisteredCallbacks;       ///< Callbacks attached to registered functions
+        ComEntriesType                      m_Entries;                   ///< Functions and callbacks, for calls without lock
+        std::vector<const CallbackListType*> m_CallbacksRetired;         ///< Replaced callback lists, maybe still read
+        std::vector<IBaseCommand*>          m_FunctionsRetired;          ///< Replaced functions, maybe still called
         
         RegisteredFunctionsType             m_RegisteredFunctions;       ///< All registered functions provided by modules
         RegisteredFunctionsDescriptionType  m_RegisteredFunctionsDescriptions; ///< Descriptions of registered functions
@@ -324,6 +953,9 @@ class CComInterface : public bfe::ILogListener
         DomainsType                         m_RegisteredDomains;         ///< All domains registered
         DomainsType                         m_WriterDomains;             ///< Domains for queued functions
         WriterQueuesType                    m_WriterQueues;              ///< Command queues for write access
+        
+        bool                                m_bProfiling = false;        ///< Indicates if calls are recorded, copied to entries
+        CComJournal                         m_Journal;                   ///< Records calls for replay
 };
 
 //--- Implementation is done here for inline optimisation --------------------//
@@ -336,11 +968,38 @@ class CComInterface : public bfe::ILogListener
 ///                         will have a separate queue for writer functions.
 ///                         This allows for multi-threading.
 ///
+/// \return Queue of writer domain, to be flushed without lookup
+///
 ////////////////////////////////////////////////////////////////////////////////
-inline void CComInterface::registerWriterDomain(const std::string& _strWriterDomain)
+inline CWriterQueue* CComInterface::registerWriterDomain(const std::string& _strWriterDomain)
 {
     METHOD_ENTRY_QUIET("CComInterface::registerWriterDomain")
+
+    CWriteLockGuard Lock(m_AccessData);
     m_WriterDomains.emplace(_strWriterDomain);
+    return &m_WriterQueues[_strWriterDomain]; // Create queue, it mustn't be inserted on first call
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls all writing functions of given queue
+///
+/// Writer functions were journaled when enqueued, thus, calls they make
+/// aren't.
+///
+/// \param _pWriterQueue Queue as returned by \ref registerWriterDomain or
+///                      \ref getWriterQueue
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void CComInterface::callWriters(CWriterQueue* const _pWriterQueue)
+{
+    METHOD_ENTRY_QUIET("CComInterface::callWriters")
+
+    CComJournalScope Scope;
+    if (_pWriterQueue->flush() > 0u)
+    {
+        DEBUG_MSG_QUIET("Com Interface", "Writer queue flushed.")
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -46,26 +46,81 @@ CCommand<TRet, TArgs...>::CCommand(const std::function<TRet(TArgs...)>& _Functio
 {
     METHOD_ENTRY_QUIET("CCommand::CCommand")
     CTOR_CALL("CCommand")
-    this->dispatchSignature();
+    m_pSignature = &typeid(CCommand<TRet, TArgs...>);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Constructor for a registered function called from a command queue.
 ///
-/// \param _Function Function to register
+/// \param _pPool Pool the wrapper is stored in, null if allocated on heap
+/// \param _pFunction Function to call, must outlive the wrapper
+/// \param _pStatistics Profile of function, null if not profiled
+/// \param _pAsync State of asynchronous call, null if none
+/// \param _Coalesce Merging of queued calls
 /// \param _Args Parameters of registered function call
 ///
 ///////////////////////////////////////////////////////////////////////////////
 template <class TRet, class... TArgs>
-CCommandToQueueWrapper<TRet, TArgs...>::CCommandToQueueWrapper(const std::function<TRet(TArgs...)>& _Function,
+CCommandToQueueWrapper<TRet, TArgs...>::CCommandToQueueWrapper(CCommandPool* const _pPool,
+                                               const std::function<TRet(TArgs...)>* const _pFunction,
+                                               ComCallStatistics* const _pStatistics,
+                                               ComAsyncStatePtr<TRet>&& _pAsync,
+                                               const ComCoalesceType _Coalesce,
                                                TArgs... _Args) : 
-                                               m_Function(_Function),
-                                               m_Params(_Args...)
+                                               m_pFunction(_pFunction),
+                                               m_pPool(_pPool),
+                                               m_pStatistics(_pStatistics),
+                                               m_pAsync(std::move(_pAsync)),
+                                               m_Params(std::forward<TArgs>(_Args)...)
 {
     METHOD_ENTRY_QUIET("CCommandToQueueWrapper::CCommandToQueueWrapper")
     CTOR_CALL_QUIET("CCommandToQueueWrapper")
-    this->dispatchSignature();
+    m_pSignature = &typeid(CCommandToQueueWrapper<TRet, TArgs...>);
+    m_Coalesce = _Coalesce;
+    if (m_pStatistics != nullptr) m_Enqueued = std::chrono::steady_clock::now();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Creates a wrapper in a slot of the given pool
+///
+/// Wrappers exceeding \ref COMMAND_POOL_SLOT_SIZE, e.g. due to many or large
+/// arguments, are allocated on heap instead.
+///
+/// \param _pPool Pool of the writer domain
+/// \param _pFunction Function to call, must outlive the wrapper
+/// \param _pStatistics Profile of function, null if not profiled
+/// \param _pAsync State of asynchronous call, null if none
+/// \param _Coalesce Merging of queued calls
+/// \param _Args Parameters of registered function call
+///
+/// \return Wrapper, to be destroyed by \ref destroy
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+CCommandToQueueWrapper<TRet, TArgs...>* CCommandToQueueWrapper<TRet, TArgs...>::create(
+                                                CCommandPool* const _pPool,
+                                                const std::function<TRet(TArgs...)>* const _pFunction,
+                                                ComCallStatistics* const _pStatistics,
+                                                ComAsyncStatePtr<TRet>&& _pAsync,
+                                                const ComCoalesceType _Coalesce,
+                                                TArgs... _Args)
+{
+    METHOD_ENTRY_QUIET("CCommandToQueueWrapper::create")
+
+    MEM_ALLOC_QUIET("IBaseCommand")
+    if (sizeof(CCommandToQueueWrapper) <= COMMAND_POOL_SLOT_SIZE &&
+        alignof(CCommandToQueueWrapper) <= COMMAND_POOL_SLOT_ALIGN)
+    {
+        return new (_pPool->allocate()) CCommandToQueueWrapper(_pPool, _pFunction, _pStatistics, std::move(_pAsync),
+                                                                  _Coalesce, std::forward<TArgs>(_Args)...);
+    }
+    else
+    {
+        return new CCommandToQueueWrapper(nullptr, _pFunction, _pStatistics, std::move(_pAsync),
+                                          _Coalesce, std::forward<TArgs>(_Args)...);
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -86,24 +141,597 @@ TRet CCommand<TRet, TArgs...>::call(TArgs... _Args)
 
 ///////////////////////////////////////////////////////////////////////////////
 ///
-/// \brief Calls the queued writer function with given arguments
+/// \brief Calls the function by name with arguments read from a reader
 ///
-/// \return Return value of function
+/// The return value, if any, is written to the given writer. Calling by name
+/// also executes registered callbacks and queues writer functions.
+///
+/// \param _pComInterface Com interface the function is registered at
+/// \param _strName Registered name of the function
+/// \param _Reader Reader providing the arguments
+/// \param _Writer Writer receiving the return value
+/// \param _Origin Origin of call, recorded in journal
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+void CCommand<TRet, TArgs...>::invoke(CComInterface* const _pComInterface, const std::string& _strName,
+                                      IComValueReader& _Reader, IComValueWriter& _Writer,
+                                      const ComJournalOriginType _Origin) const
+{
+    METHOD_ENTRY_QUIET("CCommand::invoke")
+    this->invokeSupported(_pComInterface, _strName, _Reader, _Writer, _Origin,
+                          ComValuesSupported<TRet, TArgs...>());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Registers a callback independent of the function's signature
+///
+/// The callback receives the arguments of each call by a writer, its return
+/// value is not used.
+///
+/// \param _pComInterface Com interface the function is registered at
+/// \param _strName Registered name of the function
+/// \param _Callback Callback to be registered
+/// \param _strWriterDomain Writer domain of the callback, "Reader" if not queued
+///
+/// \return Success?
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+bool CCommand<TRet, TArgs...>::registerGenericCallback(CComInterface* const _pComInterface,
+                                                       const std::string& _strName,
+                                                       const ComGenericCallbackType& _Callback,
+                                                       const std::string& _strWriterDomain) const
+{
+    METHOD_ENTRY_QUIET("CCommand::registerGenericCallback")
+    return this->registerGenericCallbackSupported(_pComInterface, _strName, _Callback, _strWriterDomain,
+                                                  ComValuesSupported<TArgs...>());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Fallback for signatures with types unknown to readers and writers
+///
+/// \param _strName Registered name of the function
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+void CCommand<TRet, TArgs...>::invokeSupported(CComInterface* const, const std::string& _strName,
+                                               IComValueReader&, IComValueWriter&,
+                                               const ComJournalOriginType, std::false_type) const
+{
+    METHOD_ENTRY_QUIET("CCommand::invokeSupported")
+    static_cast<void>(_strName); // Unused if notices are disabled
+    DOM_DEV(NOTICE_MSG_QUIET("Com Interface", "Wrapper for " << _strName << "'s signature not implemented."))
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads all arguments and calls the function
+///
+/// The call is recorded in the journal with the arguments read, calls made
+/// by the function aren't.
+///
+/// \param _pComInterface Com interface the function is registered at
+/// \param _strName Registered name of the function
+/// \param _Reader Reader providing the arguments
+/// \param _Writer Writer receiving the return value
+/// \param _Origin Origin of call, recorded in journal
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+void CCommand<TRet, TArgs...>::invokeSupported(CComInterface* const _pComInterface, const std::string& _strName,
+                                               IComValueReader& _Reader, IComValueWriter& _Writer,
+                                               const ComJournalOriginType _Origin, std::true_type) const
+{
+    METHOD_ENTRY_QUIET("CCommand::invokeSupported")
+
+    static_cast<void>(_Reader); // Unused for functions without arguments
+
+    // Braced initialisation reads arguments from left to right
+    std::tuple<std::decay_t<TArgs>...> Args{ComValue<std::decay_t<TArgs>>::read(_Reader)...};
+    this->journalUnpacked(_pComInterface, _strName, _Origin, Args, std::index_sequence_for<TArgs...>());
+
+    CComJournalScope Scope;
+    this->invokeUnpacked(_pComInterface, _strName, _Writer, Args,
+                         std::index_sequence_for<TArgs...>(), std::is_void<TRet>());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Records the call with its arguments in the journal
+///
+/// \param _pComInterface Com interface the function is registered at
+/// \param _strName Registered name of the function
+/// \param _Origin Origin of call
+/// \param _Args Arguments read before
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+template <std::size_t... I>
+void CCommand<TRet, TArgs...>::journalUnpacked(CComInterface* const _pComInterface, const std::string& _strName,
+                                               const ComJournalOriginType _Origin,
+                                               const std::tuple<std::decay_t<TArgs>...>& _Args,
+                                               std::index_sequence<I...>) const
+{
+    METHOD_ENTRY_QUIET("CCommand::journalUnpacked")
+    static_cast<void>(_Args); // Unused for functions without arguments
+    _pComInterface->journal(_Origin, _strName, std::get<I>(_Args)...);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls the function and writes its return value
+///
+/// \param _pComInterface Com interface the function is registered at
+/// \param _strName Registered name of the function
+/// \param _Writer Writer receiving the return value
+/// \param _Args Arguments read before
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+template <std::size_t... I>
+void CCommand<TRet, TArgs...>::invokeUnpacked(CComInterface* const _pComInterface, const std::string& _strName,
+                                              IComValueWriter& _Writer,
+                                              std::tuple<std::decay_t<TArgs>...>& _Args,
+                                              std::index_sequence<I...>, std::false_type) const
+{
+    METHOD_ENTRY_QUIET("CCommand::invokeUnpacked")
+    static_cast<void>(_Args); // Unused for functions without arguments
+    ComValue<std::decay_t<TRet>>::write(_Writer,
+        _pComInterface->template call<TRet, TArgs...>(_strName, std::get<I>(_Args)...));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls the function without return value
+///
+/// \param _pComInterface Com interface the function is registered at
+/// \param _strName Registered name of the function
+/// \param _Args Arguments read before
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+template <std::size_t... I>
+void CCommand<TRet, TArgs...>::invokeUnpacked(CComInterface* const _pComInterface, const std::string& _strName,
+                                              IComValueWriter&,
+                                              std::tuple<std::decay_t<TArgs>...>& _Args,
+                                              std::index_sequence<I...>, std::true_type) const
+{
+    METHOD_ENTRY_QUIET("CCommand::invokeUnpacked")
+    static_cast<void>(_Args); // Unused for functions without arguments
+    _pComInterface->template call<TRet, TArgs...>(_strName, std::get<I>(_Args)...);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Fallback for signatures with types unknown to writers
+///
+/// \param _strName Registered name of the function
+///
+/// \return Always false
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+bool CCommand<TRet, TArgs...>::registerGenericCallbackSupported(CComInterface* const,
+                                                                const std::string& _strName,
+                                                                const ComGenericCallbackType&,
+                                                                const std::string&, std::false_type) const
+{
+    METHOD_ENTRY_QUIET("CCommand::registerGenericCallbackSupported")
+    static_cast<void>(_strName); // Unused if notices are disabled
+    DOM_DEV(NOTICE_MSG_QUIET("Com Interface", "Callback wrapper for " << _strName << "'s signature not implemented."))
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Registers a typed callback passing its arguments to the generic one
+///
+/// \param _pComInterface Com interface the function is registered at
+/// \param _strName Registered name of the function
+/// \param _Callback Callback to be registered
+/// \param _strWriterDomain Writer domain of the callback, "Reader" if not queued
+///
+/// \return Success?
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+bool CCommand<TRet, TArgs...>::registerGenericCallbackSupported(CComInterface* const _pComInterface,
+                                                                const std::string& _strName,
+                                                                const ComGenericCallbackType& _Callback,
+                                                                const std::string& _strWriterDomain,
+                                                                std::true_type) const
+{
+    METHOD_ENTRY_QUIET("CCommand::registerGenericCallbackSupported")
+
+    const std::function<TRet(TArgs...)> Func = [_Callback](TArgs... _Args) -> TRet
+    {
+        _Callback([&](IComValueWriter& _Writer)
+        {
+            static_cast<void>(_Writer); // Unused for functions without arguments
+            const int Expand[] = {0, (ComValue<std::decay_t<TArgs>>::write(_Writer, _Args), 0)...};
+            static_cast<void>(Expand);
+        });
+        return TRet();
+    };
+    return _pComInterface->registerCallback(_strName, Func, _strWriterDomain);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls the queued writer function with its stored arguments
 ///
 ///////////////////////////////////////////////////////////////////////////////
 template <class TRet, class... TArgs>
-TRet CCommandToQueueWrapper<TRet, TArgs...>::call(TArgs... _Args)
+void CCommandToQueueWrapper<TRet, TArgs...>::callQueued()
 {
-    METHOD_ENTRY_QUIET("CCommandWriter::call")
+    METHOD_ENTRY_QUIET("CCommandToQueueWrapper::callQueued")
     try
     {
         DEBUG_MSG_QUIET("Queued Command", "Queued command called.")
-        m_Function(_Args...);
+        if (m_pStatistics == nullptr)
+        {
+            this->callUnpacked(std::index_sequence_for<TArgs...>());
+        }
+        else
+        {
+            const double fQueued = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_Enqueued).count();
+            CTimer Timer;
+            Timer.start();
+            this->callUnpacked(std::index_sequence_for<TArgs...>());
+            Timer.stop();
+            m_pStatistics->addQueued(fQueued, Timer.getTime());
+        }
     }
     catch (const CComInterfaceException& ComIntEx)
     {
+        // Asynchronous call fails when destroyed unfulfilled
         WARNING_MSG_QUIET("Queued Command", ComIntEx.getMessage())
     }
+    catch (...)
+    {
+        if (m_pAsync != nullptr) m_pAsync->fail();
+        throw;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls the function with the stored arguments unpacked
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+template <std::size_t... I>
+void CCommandToQueueWrapper<TRet, TArgs...>::callUnpacked(std::index_sequence<I...> _Indices)
+{
+    METHOD_ENTRY_QUIET("CCommandToQueueWrapper::callUnpacked")
+    if (m_pAsync == nullptr)
+    {
+        (*m_pFunction)(std::get<I>(m_Params)...);
+    }
+    else
+    {
+        this->callUnpacked(_Indices, std::is_void<TRet>());
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls the function and fulfils the asynchronous call with its result
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+template <std::size_t... I>
+void CCommandToQueueWrapper<TRet, TArgs...>::callUnpacked(std::index_sequence<I...>, std::false_type)
+{
+    METHOD_ENTRY_QUIET("CCommandToQueueWrapper::callUnpacked")
+    m_pAsync->fulfil((*m_pFunction)(std::get<I>(m_Params)...));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls the function and fulfils the asynchronous call without result
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+template <std::size_t... I>
+void CCommandToQueueWrapper<TRet, TArgs...>::callUnpacked(std::index_sequence<I...>, std::true_type)
+{
+    METHOD_ENTRY_QUIET("CCommandToQueueWrapper::callUnpacked")
+    (*m_pFunction)(std::get<I>(m_Params)...);
+    m_pAsync->fulfil();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the key of calls to be merged
+///
+/// \return Hash of function and, if merged per target, of target
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+std::size_t CCommandToQueueWrapper<TRet, TArgs...>::getCoalesceKey() const
+{
+    METHOD_ENTRY_QUIET("CCommandToQueueWrapper::getCoalesceKey")
+
+    // The function is owned by the registered command, thus, identifies it
+    std::size_t nKey = std::hash<const void*>()(m_pFunction);
+    if (m_Coalesce == ComCoalesceType::LAST_PER_TARGET || m_Coalesce == ComCoalesceType::ACCUMULATE_PER_TARGET)
+    {
+        nKey ^= this->getTargetHash(ComTargeted<TArgs...>()) + 0x9e3779b9u + (nKey << 6) + (nKey >> 2);
+    }
+    return nKey;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Merges an earlier call of the same key into this call
+///
+/// Earlier asynchronous calls aren't merged, since their future must be
+/// fulfilled.
+///
+/// \param _pEarlier Earlier call, to be destroyed without calling if merged
+///
+/// \return Merged?
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+bool CCommandToQueueWrapper<TRet, TArgs...>::coalesce(IBaseCommand* const _pEarlier)
+{
+    METHOD_ENTRY_QUIET("CCommandToQueueWrapper::coalesce")
+
+    // Different keys might have equal hashes
+    if (m_Coalesce == ComCoalesceType::NONE || _pEarlier->getSignature() != *m_pSignature) return false;
+    const auto* const pEarlier = static_cast<const CCommandToQueueWrapper*>(_pEarlier);
+    if (pEarlier->m_pFunction != m_pFunction || pEarlier->m_pAsync != nullptr) return false;
+
+    switch (m_Coalesce)
+    {
+        case ComCoalesceType::LAST:
+            return true;
+        case ComCoalesceType::LAST_PER_TARGET:
+            return this->isSameTarget(*pEarlier, ComTargeted<TArgs...>());
+        case ComCoalesceType::ACCUMULATE:
+            this->template accumulate<0u>(*pEarlier, ComAccumulable<TArgs...>());
+            return true;
+        case ComCoalesceType::ACCUMULATE_PER_TARGET:
+            if (!this->isSameTarget(*pEarlier, ComTargeted<TArgs...>())) return false;
+            this->template accumulate<1u>(*pEarlier, ComAccumulablePerTarget<TArgs...>());
+            return true;
+        default:
+            return false;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Fallback for functions without target
+///
+/// \return Constant hash
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+std::size_t CCommandToQueueWrapper<TRet, TArgs...>::getTargetHash(std::false_type) const
+{
+    METHOD_ENTRY_QUIET("CCommandToQueueWrapper::getTargetHash")
+    return 0u;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the hash of the target, i.e. the first argument
+///
+/// \return Hash of target
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+std::size_t CCommandToQueueWrapper<TRet, TArgs...>::getTargetHash(std::true_type) const
+{
+    METHOD_ENTRY_QUIET("CCommandToQueueWrapper::getTargetHash")
+    return ComTargetHash<std::decay_t<decltype(std::get<0>(m_Params))>>::get(std::get<0>(m_Params));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Fallback for functions without target, never merged per target
+///
+/// \return False
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+bool CCommandToQueueWrapper<TRet, TArgs...>::isSameTarget(const CCommandToQueueWrapper&, std::false_type) const
+{
+    METHOD_ENTRY_QUIET("CCommandToQueueWrapper::isSameTarget")
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Indicates that the given call has the same target
+///
+/// \param _Other Other call of same function
+///
+/// \return Same target?
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+bool CCommandToQueueWrapper<TRet, TArgs...>::isSameTarget(const CCommandToQueueWrapper& _Other, std::true_type) const
+{
+    METHOD_ENTRY_QUIET("CCommandToQueueWrapper::isSameTarget")
+    return bool(std::get<0>(m_Params) == std::get<0>(_Other.m_Params));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Fallback for arguments that can't be summed up
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+template <std::size_t N>
+void CCommandToQueueWrapper<TRet, TArgs...>::accumulate(const CCommandToQueueWrapper&, std::false_type)
+{
+    METHOD_ENTRY_QUIET("CCommandToQueueWrapper::accumulate")
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Adds the arguments of an earlier call to the arguments
+///
+/// The first N arguments aren't summed up, i.e. N is 1 to skip the target.
+///
+/// \param _Earlier Earlier call of same function
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+template <std::size_t N>
+void CCommandToQueueWrapper<TRet, TArgs...>::accumulate(const CCommandToQueueWrapper& _Earlier, std::true_type)
+{
+    METHOD_ENTRY_QUIET("CCommandToQueueWrapper::accumulate")
+    this->template accumulateUnpacked<N>(_Earlier, std::make_index_sequence<sizeof...(TArgs)-N>());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Adds the arguments of an earlier call behind the first N, unpacked
+///
+/// \param _Earlier Earlier call of same function
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+template <std::size_t N, std::size_t... I>
+void CCommandToQueueWrapper<TRet, TArgs...>::accumulateUnpacked(const CCommandToQueueWrapper& _Earlier,
+                                                                std::index_sequence<I...>)
+{
+    METHOD_ENTRY_QUIET("CCommandToQueueWrapper::accumulateUnpacked")
+    static_cast<void>(_Earlier); // Unused for functions without arguments
+    const int Expand[] = {0, (void(std::get<N+I>(m_Params) = std::get<N+I>(_Earlier.m_Params) +
+                                                             std::get<N+I>(m_Params)), 0)...};
+    static_cast<void>(Expand);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Destroys the wrapper and returns its slot to the pool
+///
+/// An asynchronous call not fulfilled, i.e. never called or thrown, fails.
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+void CCommandToQueueWrapper<TRet, TArgs...>::destroy()
+{
+    METHOD_ENTRY_QUIET("CCommandToQueueWrapper::destroy")
+
+    if (m_pAsync != nullptr) m_pAsync->fail();
+
+    MEM_FREED_QUIET("IBaseCommand")
+    CCommandPool* const pPool = m_pPool;
+    if (pPool != nullptr)
+    {
+        this->~CCommandToQueueWrapper();
+        pPool->release(this);
+    }
+    else
+    {
+        delete this;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls the referenced function and its callbacks
+///
+/// \param _Args Arguments of the function to be called
+/// \return Return value of function, default if not registered
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+TRet CCommandRef<TRet, TArgs...>::call(TArgs... _Args) const
+{
+    METHOD_ENTRY_QUIET("CCommandRef::call")
+
+    if (m_pEntry == nullptr)
+    {
+        WARNING_MSG_QUIET("Com Interface", "Function not resolved.")
+        return TRet();
+    }
+
+    // A single relaxed load if profiling is disabled
+    if (m_pEntry->bProfiled.load(std::memory_order_relaxed))
+    {
+        const CallbackListType* const pCallbacks = m_pEntry->pCallbacks.load(std::memory_order_acquire);
+        CComCallTimer Timer(&m_pEntry->Statistics, (pCallbacks == nullptr) ? 0u : pCallbacks->size());
+        return this->callUnprofiled(_Args...);
+    }
+    return this->callUnprofiled(_Args...);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls the referenced function and its callbacks without recording
+///
+/// \param _Args Arguments of the function to be called
+/// \return Return value of function, default if not registered
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+TRet CCommandRef<TRet, TArgs...>::callUnprofiled(TArgs... _Args) const
+{
+    METHOD_ENTRY_QUIET("CCommandRef::callUnprofiled")
+
+    // Search for callbacks and execute if exist
+    const CallbackListType* const pCallbacks = m_pEntry->pCallbacks.load(std::memory_order_acquire);
+    if (pCallbacks != nullptr)
+    {
+        for (const auto pCallback : *pCallbacks)
+        {
+            DEBUG_MSG_QUIET("Com Interface", "Callback called.")
+
+            // Comparing the type is cheaper than dynamic_cast, and
+            // is the only check needed, since types are exact
+            if (pCallback->getSignature() == typeid(CCommand<TRet, TArgs...>))
+            {
+                static_cast<CCommand<TRet, TArgs...>*>(pCallback)->call(_Args...);
+            }
+            else
+            {
+                WARNING_MSG_QUIET("Com Interface", "Known function with different signature <" << m_pEntry->strName << ">. ")
+            }
+        }
+    }
+
+    IBaseCommand* const pFunction = m_pEntry->pFunction.load(std::memory_order_acquire);
+    if (pFunction == nullptr) return TRet();
+
+    DEBUG_MSG_QUIET("Com Interface", "Command called: <" << m_pEntry->strName << ">")
+
+    if (pFunction->getSignature() == typeid(CCommand<TRet, TArgs...>))
+    {
+        return static_cast<CCommand<TRet, TArgs...>*>(pFunction)->call(_Args...);
+    }
+    else
+    {
+        WARNING_MSG_QUIET("Com Interface", "Known function with different signature <" << m_pEntry->strName << ">. ")
+        return TRet();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Indicates if the function is registered with matching signature
+///
+/// \return Function callable?
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+bool CCommandRef<TRet, TArgs...>::isValid() const
+{
+    METHOD_ENTRY_QUIET("CCommandRef::isValid")
+
+    if (m_pEntry == nullptr) return false;
+    const IBaseCommand* const pFunction = m_pEntry->pFunction.load(std::memory_order_acquire);
+    return (pFunction != nullptr && pFunction->getSignature() == typeid(CCommand<TRet, TArgs...>));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -122,77 +750,17 @@ inline TRet CComInterface::call(const std::string& _strName, Args... _Args)
     
     try
     {
-        #ifdef LOGLEVEL_DEBUG
-            
-            // Search for callbacks and execute if exist
-            m_AccessData.acquireLock();
-            const auto Range = m_RegisteredCallbacks.equal_range(_strName);
-            if (Range.first != m_RegisteredCallbacks.end())
-            {
-                for_each(Range.first, Range.second, 
-                    [&](RegisteredCallbacksType::value_type& _Com)
-                    {
-                        DEBUG_MSG_QUIET("Com Interface", "Callback called.")
-                        
-                        auto pCallback = dynamic_cast<CCommand<TRet, Args...>*>(_Com.second);
-                        if (pCallback != nullptr)
-                        {
-                            pCallback->call(_Args...);
-                        }
-                        else
-                        {
-                            WARNING_MSG_QUIET("Com Interface", "Known function with different signature <" << _strName << ">. ")
-                        }
-                    }
-                );
-            }
-            m_AccessData.releaseLock();            
-            
-            // Execute function if existant
-            const auto ci = m_RegisteredFunctions.find(_strName);
-            if (ci != m_RegisteredFunctions.end())
-            {
-                DEBUG_MSG_QUIET("Com Interface", "Command called: <" << _strName << ">")
-                
-                auto pFunction = dynamic_cast<CCommand<TRet, Args...>*>(ci->second);
-                if (pFunction != nullptr)
-                {
-                    return pFunction->call(_Args...);
-                }
-                else
-                {
-                    WARNING_MSG_QUIET("Com Interface", "Known function with different signature <" << _strName << ">. ")
-                    return TRet();
-                }
-            }
-            else
-            {
-                return TRet();
-            }
-        #else
-            // Search for callbacks and execute if exist
-            m_AccessData.acquireLock();
-            const auto Range = m_RegisteredCallbacks.equal_range(_strName);
-            for_each(Range.first, Range.second, 
-                [&](RegisteredCallbacksType::value_type& _Com)
-                {
-                    auto pCallback = static_cast<CCommand<TRet, Args...>*>(_Com.second);
-                    pCallback->call(_Args...);
-                }
-            );
-            m_AccessData.releaseLock();
-            // Execute function if existant
-            const auto ci = m_RegisteredFunctions.find(_strName);
-            if (ci != m_RegisteredFunctions.end())
-            {
-                auto pFunction = static_cast<CCommand<TRet, Args...>*>(ci->second);
-                return pFunction->call(_Args...);
-            }
-            else
-            {
-                return TRet();
-            }
-        #endif
+        const ComEntry* pEntry = nullptr;
+        {
+            // Lookups only read, registration is the only writer
+            CReadLockGuard Lock(m_AccessData);
+            const auto ci = m_Entries.find(_strName);
+            if (ci != m_Entries.end()) pEntry = &ci->second;
+        }
+
+        // Entries are never removed, thus no lock is needed for calling
+        if (pEntry == nullptr) return TRet();
+        return CCommandRef<TRet, Args...>(pEntry).call(_Args...);
     }
     catch (const CComInterfaceException& ComIntEx)
     {
@@ -206,6 +774,174 @@ inline TRet CComInterface::call(const std::string& _strName, Args... _Args)
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls a function by name, returning a future for its result
+///
+/// Writer functions are enqueued like by \ref call, their future is
+/// fulfilled when the writer domain is flushed. Other functions are called
+/// immediately, their future is ready when returned. Callbacks, profiling
+/// and journaling are the same as for \ref call.
+///
+/// The state is handed over to the writer function thread locally, thus,
+/// calls by \ref call only compare a pointer.
+///
+/// \param _strName Name of the function to be called
+/// \param _Args Arguments of the function
+///
+/// \return Future of result, invalid if function is unknown or of different
+///         signature
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+inline CComFuture<TRet> CComInterface::callAsync(const std::string& _strName, TArgs... _Args)
+{
+    METHOD_ENTRY_QUIET("CComInterface::callAsync")
+
+    const ComEntry* pEntry = nullptr;
+    {
+        CReadLockGuard Lock(m_AccessData);
+        const auto ci = m_Entries.find(_strName);
+        if (ci != m_Entries.end()) pEntry = &ci->second;
+    }
+    if (pEntry == nullptr)
+    {
+        WARNING_MSG("Com Interface", "Unknown function <" << _strName << ">.")
+        return CComFuture<TRet>();
+    }
+    const IBaseCommand* const pFunction = pEntry->pFunction.load(std::memory_order_acquire);
+    if (pFunction == nullptr || pFunction->getSignature() != typeid(CCommand<TRet, TArgs...>))
+    {
+        WARNING_MSG("Com Interface", "Function <" << _strName << "> not registered with this signature.")
+        return CComFuture<TRet>();
+    }
+
+    // Calls of nested asynchronous calls restore the outer hand over
+    const ComEntry* const pEntryOuter = s_pAsyncEntry;
+    void* const pStateOuter = s_pAsyncState;
+    ComAsyncStatePtr<TRet> pState = std::make_shared<CComAsyncState<TRet>>();
+    s_pAsyncEntry = pEntry;
+    s_pAsyncState = &pState;
+    try
+    {
+        this->callAsyncFulfil(pEntry, pState.get(), std::is_void<TRet>(), _Args...);
+    }
+    catch (const CComInterfaceException&)
+    {
+        s_pAsyncEntry = pEntryOuter;
+        s_pAsyncState = pStateOuter;
+        throw;
+    }
+    s_pAsyncEntry = pEntryOuter;
+    s_pAsyncState = pStateOuter;
+
+    return CComFuture<TRet>(std::move(pState));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls the function, fulfilling unless taken by a writer
+///
+/// \param _pEntry Entry of function
+/// \param _pState State of asynchronous call
+/// \param _Args Arguments of the function
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+inline void CComInterface::callAsyncFulfil(const ComEntry* const _pEntry, CComAsyncState<TRet>* const _pState,
+                                           std::false_type, TArgs... _Args)
+{
+    METHOD_ENTRY_QUIET("CComInterface::callAsyncFulfil")
+
+    TRet Ret = CCommandRef<TRet, TArgs...>(_pEntry).call(_Args...);
+    if (s_pAsyncState != nullptr) _pState->fulfil(std::move(Ret));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls the function without result, fulfilling unless taken by a writer
+///
+/// \param _pEntry Entry of function
+/// \param _pState State of asynchronous call
+/// \param _Args Arguments of the function
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+inline void CComInterface::callAsyncFulfil(const ComEntry* const _pEntry, CComAsyncState<TRet>* const _pState,
+                                           std::true_type, TArgs... _Args)
+{
+    METHOD_ENTRY_QUIET("CComInterface::callAsyncFulfil")
+
+    CCommandRef<TRet, TArgs...>(_pEntry).call(_Args...);
+    if (s_pAsyncState != nullptr) _pState->fulfil();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Records a call in the journal, if recording
+///
+/// Calls made while another call is executed aren't recorded.
+///
+/// \param _Origin Origin of call
+/// \param _strName Name of function called
+/// \param _Args Arguments of call
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class... TArgs>
+inline void CComInterface::journal(const ComJournalOriginType _Origin, const std::string& _strName,
+                                   const TArgs&... _Args)
+{
+    METHOD_ENTRY_QUIET("CComInterface::journal")
+
+    // A single relaxed load if not recording
+    if (m_Journal.isRecording() && !CComJournal::isNested())
+    {
+        this->journalSupported(_Origin, _strName, ComValuesSupported<TArgs...>(), _Args...);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Fallback for arguments with types unknown to writers
+///
+/// \param _strName Name of function called
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class... TArgs>
+void CComInterface::journalSupported(const ComJournalOriginType, const std::string& _strName,
+                                     std::false_type, const TArgs&...)
+{
+    METHOD_ENTRY_QUIET("CComInterface::journalSupported")
+    static_cast<void>(_strName); // Unused if notices are disabled
+    DOM_DEV(NOTICE_MSG_QUIET("Com Interface", "Call of " << _strName << " not journaled, signature not implemented."))
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes the arguments and records the call
+///
+/// \param _Origin Origin of call
+/// \param _strName Name of function called
+/// \param _Args Arguments of call
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class... TArgs>
+void CComInterface::journalSupported(const ComJournalOriginType _Origin, const std::string& _strName,
+                                     std::true_type, const TArgs&... _Args)
+{
+    METHOD_ENTRY_QUIET("CComInterface::journalSupported")
+
+    thread_local std::string t_strArguments;
+    t_strArguments.clear();
+
+    CComBinaryWriter Writer(t_strArguments);
+    static_cast<void>(Writer); // Unused for functions without arguments
+    const int Expand[] = {0, (ComValue<std::decay_t<TArgs>>::write(Writer, _Args), 0)...};
+    static_cast<void>(Expand);
+
+    m_Journal.record(_Origin, _strName, t_strArguments);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Register the given callback to existing function
@@ -239,28 +975,52 @@ bool CComInterface::registerCallback(const std::string& _strName, const std::fun
             }
         ) // DOM_DEV
  
-        m_AccessData.acquireLock();
-        m_RegisteredCallbacks.insert({{_strName,
-                                        new CCommand<TRet, TArgs...>([this, _strName, _Func, _strWriterDomain](TArgs... _Args) -> TRet
-                                        {
-                                            auto pCommand = new CCommandToQueueWrapper<TRet, TArgs...>(_Func, _Args...);
-                                            m_WriterQueues[_strWriterDomain].enqueue(pCommand);
-                                            MEM_ALLOC_QUIET("IBaseCommand")
-                                        })}});
-        m_AccessData.releaseLock();
+        CWriteLockGuard Lock(m_AccessData);
+        
+        // Queues are never removed, thus they can be captured
+        CWriterQueue* const pWriterQueue = &m_WriterQueues[_strWriterDomain];
+        ComEntry* const pEntry = &this->getEntry(_strName);
+        this->addCallback(_strName, new CCommand<TRet, TArgs...>([pWriterQueue, pEntry, _Func](TArgs... _Args) -> TRet
+                          {
+                              pWriterQueue->enqueue(CCommandToQueueWrapper<TRet, TArgs...>::create(
+                                  pWriterQueue->getPool(), &_Func,
+                                  pEntry->bProfiled.load(std::memory_order_relaxed) ? &pEntry->Statistics : nullptr,
+                                  nullptr, ComCoalesceType::NONE, std::forward<TArgs>(_Args)...));
+                              return TRet();
+                          }));
         MEM_ALLOC_QUIET("IBaseCommand")
     }
     else
     {
-        m_AccessData.acquireLock();
-        m_RegisteredCallbacks.insert({{_strName, new CCommand<TRet, TArgs...>(_Func)}});
-        m_AccessData.releaseLock();
+        CWriteLockGuard Lock(m_AccessData);
+        this->addCallback(_strName, new CCommand<TRet, TArgs...>(_Func));
         MEM_ALLOC_QUIET("IBaseCommand")
     }    
     
     return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Resolves a function by name for calls without lookup
+///
+/// The function doesn't need to be registered yet, the reference calls it as
+/// soon as it is.
+///
+/// \param _strName Name of the function
+///
+/// \return Reference to the function
+///
+///////////////////////////////////////////////////////////////////////////////
+template <class TRet, class... TArgs>
+CCommandRef<TRet, TArgs...> CComInterface::resolve(const std::string& _strName)
+{
+    METHOD_ENTRY_QUIET("CComInterface::resolve")
+
+    CWriteLockGuard Lock(m_AccessData);
+    return CCommandRef<TRet, TArgs...>(&this->getEntry(_strName));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Register the given event with its arguments
@@ -286,7 +1046,8 @@ bool CComInterface::registerEvent(const std::string& _strName,
     // Events are always readers, since they only trigger callbacks which
     // might then be writers
 
-    m_RegisteredFunctions[_strName] = new CCommand<void, TArgs...>([](const TArgs&...){});
+    CWriteLockGuard Lock(m_AccessData);
+    this->addFunction(_strName, new CCommand<void, TArgs...>([](const TArgs&...){}));
     MEM_ALLOC_QUIET("IBaseCommand")
     
     m_RegisteredFunctionsDescriptions[_strName] = _strDescription;
@@ -309,6 +1070,8 @@ bool CComInterface::registerEvent(const std::string& _strName,
 /// \param _strWriterDomain Indicates a function that writes data (will be
 ///                         queued for thread safety). Reader functions will
 ///                         have the default domain "Reader"
+/// \param _Coalesce Merging of queued calls of writer functions when
+///                  flushed, e.g. for idempotent setters or deltas
 ///
 /// \return Success?
 ///
@@ -318,13 +1081,37 @@ bool CComInterface::registerFunction(const std::string& _strName, const CCommand
                                      const std::string& _strDescription,
                                      const ParameterListType& _ParamList,
                                      const DomainType& _Domain,
-                                     const std::string& _strWriterDomain
+                                     const std::string& _strWriterDomain,
+                                     const ComCoalesceType _Coalesce
                                     )
 {
     METHOD_ENTRY_QUIET("CComInterface::registerFunction")
     
     DEBUG_MSG_QUIET("Com Interface", "Registering function <" << _strName << ">.")
 
+    // Only queued calls are merged, targets must be comparable, other arguments
+    // numbers or vectors of numbers to be summed up
+    bool bCoalescable = (_strWriterDomain != "Reader");
+    if (_Coalesce == ComCoalesceType::LAST_PER_TARGET || _Coalesce == ComCoalesceType::ACCUMULATE_PER_TARGET)
+    {
+        bCoalescable &= ComTargeted<TArgs...>::value;
+    }
+    if (_Coalesce == ComCoalesceType::ACCUMULATE)
+    {
+        bCoalescable &= ComAccumulable<TArgs...>::value;
+    }
+    if (_Coalesce == ComCoalesceType::ACCUMULATE_PER_TARGET)
+    {
+        bCoalescable &= ComAccumulablePerTarget<TArgs...>::value;
+    }
+    if (_Coalesce != ComCoalesceType::NONE && !bCoalescable)
+    {
+        WARNING_MSG("Com Interface", "Calls of <" << _strName << "> can't be merged, registered without merging.")
+    }
+    const ComCoalesceType Coalesce = bCoalescable ? _Coalesce : ComCoalesceType::NONE;
+
+    CWriteLockGuard Lock(m_AccessData);
+
     if (_strWriterDomain != "Reader")
     {
         DOM_DEV(
@@ -339,18 +1126,32 @@ bool CComInterface::registerFunction(const std::string& _strName, const CCommand
             }
         ) // DOM_DEV
         
-        m_RegisteredFunctions[_strName] = new CCommand<TRet, TArgs...>([this,_strName,_Command, _strWriterDomain](TArgs... _Args) -> TRet
+        // Queues are never removed, thus they can be captured
+        CWriterQueue* const pWriterQueue = &m_WriterQueues[_strWriterDomain];
+        ComEntry* const pEntry = &this->getEntry(_strName);
+        this->addFunction(_strName, new CCommand<TRet, TArgs...>([this, pWriterQueue, pEntry, Coalesce, Function = _Command.getFunction()](TArgs... _Args) -> TRet
                                             {
-                                                auto pCommand = new CCommandToQueueWrapper<TRet, TArgs...>(_Command.getFunction(), _Args...);
-                                                m_WriterQueues[_strWriterDomain].enqueue(pCommand);
-                                                MEM_ALLOC_QUIET("IBaseCommand")
+                                                this->journal(ComJournalOriginType::WRITER, pEntry->strName, _Args...);
+
+                                                // Asynchronous calls hand over their state, see callAsync
+                                                ComAsyncStatePtr<TRet> pAsync;
+                                                if (s_pAsyncEntry == pEntry)
+                                                {
+                                                    pAsync = *static_cast<ComAsyncStatePtr<TRet>*>(s_pAsyncState);
+                                                    s_pAsyncEntry = nullptr;
+                                                    s_pAsyncState = nullptr;
+                                                }
+                                                pWriterQueue->enqueue(CCommandToQueueWrapper<TRet, TArgs...>::create(
+                                                    pWriterQueue->getPool(), &Function,
+                                                    pEntry->bProfiled.load(std::memory_order_relaxed) ? &pEntry->Statistics : nullptr,
+                                                    std::move(pAsync), Coalesce, std::forward<TArgs>(_Args)...));
                                                 return TRet();
-                                            });
+                                            }));
         MEM_ALLOC_QUIET("IBaseCommand")
     }
     else
     {
-        m_RegisteredFunctions[_strName] = new CCommand<TRet, TArgs...>(_Command);
+        this->addFunction(_strName, new CCommand<TRet, TArgs...>(_Command));
         MEM_ALLOC_QUIET("IBaseCommand")
     }
     
@@ -364,80 +1165,5 @@ bool CComInterface::registerFunction(const std::string& _strName, const CCommand
 
 } // namespace bfe
 
-//--- Misc header ------------------------------------------------------------//
-#include <eigen3/Eigen/Core>
-
 using namespace Eigen;
 using namespace bfe;
-
-template<class TRet, class... TArgs> void CCommand<TRet, TArgs...>::dispatchSignature() {m_Signature = SignatureType::UNDEFINED;}
-template<> inline void CCommand<void>::dispatchSignature() {m_Signature = SignatureType::NONE;}
-template<> inline void CCommand<bool,int>::dispatchSignature() {m_Signature = SignatureType::BOOL_INT;}
-template<> inline void CCommand<double>::dispatchSignature() {m_Signature = SignatureType::DOUBLE;}
-template<> inline void CCommand<double,int>::dispatchSignature() {m_Signature = SignatureType::DOUBLE_INT;}
-template<> inline void CCommand<double,std::string>::dispatchSignature() {m_Signature = SignatureType::DOUBLE_STRING;}
-template<> inline void CCommand<double,std::string,double>::dispatchSignature() {m_Signature = SignatureType::DOUBLE_STRING_DOUBLE;}
-template<> inline void CCommand<int>::dispatchSignature() {m_Signature = SignatureType::INT;}
-template<> inline void CCommand<int,int>::dispatchSignature() {m_Signature = SignatureType::INT_INT;}
-template<> inline void CCommand<int,std::string>::dispatchSignature() {m_Signature = SignatureType::INT_STRING;}
-template<> inline void CCommand<void, bool>::dispatchSignature() {m_Signature = SignatureType::NONE_BOOL;}
-template<> inline void CCommand<void, double>::dispatchSignature() {m_Signature = SignatureType::NONE_DOUBLE;}
-template<> inline void CCommand<void, double, double>::dispatchSignature() {m_Signature = SignatureType::NONE_2DOUBLE;}
-template<> inline void CCommand<void, int>::dispatchSignature() {m_Signature = SignatureType::NONE_INT;}
-template<> inline void CCommand<void, int, double>::dispatchSignature() {m_Signature = SignatureType::NONE_INT_DOUBLE;}
-template<> inline void CCommand<void, int, double, double>::dispatchSignature() {m_Signature = SignatureType::NONE_INT_2DOUBLE;}
-template<> inline void CCommand<void, int, double, double, double, double>::dispatchSignature() {m_Signature = SignatureType::NONE_INT_4DOUBLE;}
-template<> inline void CCommand<void, int, std::vector<double>>::dispatchSignature() {m_Signature = SignatureType::NONE_INT_DYN_ARRAY;}
-template<> inline void CCommand<void, int, int>::dispatchSignature() {m_Signature = SignatureType::NONE_2INT;}
-template<> inline void CCommand<void, int, int, int>::dispatchSignature() {m_Signature = SignatureType::NONE_3INT;}
-template<> inline void CCommand<void, int, std::string>::dispatchSignature() {m_Signature = SignatureType::NONE_INT_STRING;}
-template<> inline void CCommand<void, std::string>::dispatchSignature() {m_Signature = SignatureType::NONE_STRING;}
-template<> inline void CCommand<void, std::string, std::string>::dispatchSignature() {m_Signature = SignatureType::NONE_2STRING;}
-template<> inline void CCommand<void, std::string, std::string, std::string, std::string>::dispatchSignature() {m_Signature = SignatureType::NONE_4STRING;}
-template<> inline void CCommand<void, std::string, double>::dispatchSignature() {m_Signature = SignatureType::NONE_STRING_DOUBLE;}
-template<> inline void CCommand<void, std::string, int>::dispatchSignature() {m_Signature = SignatureType::NONE_STRING_INT;}
-template<> inline void CCommand<void, std::string, int, int>::dispatchSignature() {m_Signature = SignatureType::NONE_STRING_2INT;}
-template<> inline void CCommand<std::string>::dispatchSignature() {m_Signature = SignatureType::STRING;}
-template<> inline void CCommand<Vector2d>::dispatchSignature() {m_Signature = SignatureType::VEC2DDOUBLE;}
-template<> inline void CCommand<Vector2d, int>::dispatchSignature() {m_Signature = SignatureType::VEC2DDOUBLE_INT;}
-template<> inline void CCommand<Vector2d, int, int>::dispatchSignature() {m_Signature = SignatureType::VEC2DDOUBLE_2INT;}
-template<> inline void CCommand<Vector2d, std::string>::dispatchSignature() {m_Signature = SignatureType::VEC2DDOUBLE_STRING;}
-template<> inline void CCommand<Vector2d, std::string, std::string>::dispatchSignature() {m_Signature = SignatureType::VEC2DDOUBLE_2STRING;}
-template<> inline void CCommand<Vector2i>::dispatchSignature() {m_Signature = SignatureType::VEC2DINT;}
-template<> inline void CCommand<Vector2i, int>::dispatchSignature() {m_Signature = SignatureType::VEC2DINT_INT;}
-
-template<class TRet, class... TArgs> void CCommandToQueueWrapper<TRet, TArgs...>::dispatchSignature() {m_Signature = SignatureType::UNDEFINED;}
-template<> inline void CCommandToQueueWrapper<void>::dispatchSignature() {m_Signature = SignatureType::NONE;}
-template<> inline void CCommandToQueueWrapper<bool,int>::dispatchSignature() {m_Signature = SignatureType::BOOL_INT;}
-template<> inline void CCommandToQueueWrapper<double>::dispatchSignature() {m_Signature = SignatureType::DOUBLE;}
-template<> inline void CCommandToQueueWrapper<double,int>::dispatchSignature() {m_Signature = SignatureType::DOUBLE_INT;}
-template<> inline void CCommandToQueueWrapper<double,std::string>::dispatchSignature() {m_Signature = SignatureType::DOUBLE_STRING;}
-template<> inline void CCommandToQueueWrapper<double,std::string,double>::dispatchSignature() {m_Signature = SignatureType::DOUBLE_STRING_DOUBLE;}
-template<> inline void CCommandToQueueWrapper<int>::dispatchSignature() {m_Signature = SignatureType::INT;}
-template<> inline void CCommandToQueueWrapper<int,int>::dispatchSignature() {m_Signature = SignatureType::INT_INT;}
-template<> inline void CCommandToQueueWrapper<int,std::string>::dispatchSignature() {m_Signature = SignatureType::INT_STRING;}
-template<> inline void CCommandToQueueWrapper<void, bool>::dispatchSignature() {m_Signature = SignatureType::NONE_BOOL;}
-template<> inline void CCommandToQueueWrapper<void, double>::dispatchSignature() {m_Signature = SignatureType::NONE_DOUBLE;}
-template<> inline void CCommandToQueueWrapper<void, double, double>::dispatchSignature() {m_Signature = SignatureType::NONE_2DOUBLE;}
-template<> inline void CCommandToQueueWrapper<void, int>::dispatchSignature() {m_Signature = SignatureType::NONE_INT;}
-template<> inline void CCommandToQueueWrapper<void, int, double>::dispatchSignature() {m_Signature = SignatureType::NONE_INT_DOUBLE;}
-template<> inline void CCommandToQueueWrapper<void, int, double, double>::dispatchSignature() {m_Signature = SignatureType::NONE_INT_2DOUBLE;}
-template<> inline void CCommandToQueueWrapper<void, int, double, double, double, double>::dispatchSignature() {m_Signature = SignatureType::NONE_INT_4DOUBLE;}
-template<> inline void CCommandToQueueWrapper<void, int, std::vector<double>>::dispatchSignature() {m_Signature = SignatureType::NONE_INT_DYN_ARRAY;}
-template<> inline void CCommandToQueueWrapper<void, int, int>::dispatchSignature() {m_Signature = SignatureType::NONE_2INT;}
-template<> inline void CCommandToQueueWrapper<void, int, int, int>::dispatchSignature() {m_Signature = SignatureType::NONE_3INT;}
-template<> inline void CCommandToQueueWrapper<void, int, std::string>::dispatchSignature() {m_Signature = SignatureType::NONE_INT_STRING;}
-template<> inline void CCommandToQueueWrapper<void, std::string>::dispatchSignature() {m_Signature = SignatureType::NONE_STRING;}
-template<> inline void CCommandToQueueWrapper<void, std::string, std::string>::dispatchSignature() {m_Signature = SignatureType::NONE_2STRING;}
-template<> inline void CCommandToQueueWrapper<void, std::string, std::string, std::string, std::string>::dispatchSignature() {m_Signature = SignatureType::NONE_4STRING;}
-template<> inline void CCommandToQueueWrapper<void, std::string, double>::dispatchSignature() {m_Signature = SignatureType::NONE_STRING_DOUBLE;}
-template<> inline void CCommandToQueueWrapper<void, std::string, int>::dispatchSignature() {m_Signature = SignatureType::NONE_STRING_INT;}
-template<> inline void CCommandToQueueWrapper<void, std::string, int, int>::dispatchSignature() {m_Signature = SignatureType::NONE_STRING_2INT;}
-template<> inline void CCommandToQueueWrapper<std::string>::dispatchSignature() {m_Signature = SignatureType::STRING;}
-template<> inline void CCommandToQueueWrapper<Vector2d>::dispatchSignature() {m_Signature = SignatureType::VEC2DDOUBLE;}
-template<> inline void CCommandToQueueWrapper<Vector2d, int>::dispatchSignature() {m_Signature = SignatureType::VEC2DDOUBLE_INT;}
-template<> inline void CCommandToQueueWrapper<Vector2d, int, int>::dispatchSignature() {m_Signature = SignatureType::VEC2DDOUBLE_2INT;}
-template<> inline void CCommandToQueueWrapper<Vector2d, std::string>::dispatchSignature() {m_Signature = SignatureType::VEC2DDOUBLE_STRING;}
-template<> inline void CCommandToQueueWrapper<Vector2d, std::string, std::string>::dispatchSignature() {m_Signature = SignatureType::VEC2DDOUBLE_2STRING;}
-template<> inline void CCommandToQueueWrapper<Vector2i>::dispatchSignature() {m_Signature = SignatureType::VEC2DINT;}
-template<> inline void CCommandToQueueWrapper<Vector2i, int>::dispatchSignature() {m_Signature = SignatureType::VEC2DINT_INT;}
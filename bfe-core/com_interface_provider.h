@@ -53,7 +53,7 @@ class IComInterfaceProvider
     public:
    
         //--- Constructor/Destructor -----------------------------------------//
-        IComInterfaceProvider() : m_pComInterface(nullptr){}
+        IComInterfaceProvider() : m_pComInterface(nullptr), m_pWriterQueue(nullptr){}
 
         //--- Methods --------------------------------------------------------//
         void initComInterface(bfe::CComInterface* const, const std::string&);
@@ -64,6 +64,7 @@ class IComInterfaceProvider
         virtual void myInitComInterface() = 0;
         
         bfe::CComInterface*  m_pComInterface;   ///< Pointer to com interface
+        bfe::CWriterQueue*   m_pWriterQueue;    ///< Queue of writer domain, flushed without lookup
 };
 
 //--- Implementation is done here for inline optimisation --------------------//
@@ -97,7 +98,7 @@ inline void IComInterfaceProvider::initComInterface(CComInterface* const _pComIn
     }
     
     m_pComInterface = _pComInterface;
-    m_pComInterface->registerWriterDomain(_strWriterDomain);
+    m_pWriterQueue = m_pComInterface->registerWriterDomain(_strWriterDomain);
     
     this->myInitComInterface();
     
@@ -0,0 +1,302 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       com_journal.cpp
+/// \brief      Implementation of class "CComJournal"
+///
+/// A journal starts with \ref COM_JOURNAL_MAGIC and \ref COM_JOURNAL_VERSION,
+/// followed by records, each starting with its type:
+///  - Name: index (u16), length (u16), characters, written before first use
+///  - Call: frame (u64), name index (u16), origin (u8), length of arguments
+///          (u32), arguments
+///
+/// Values are written in host byte order.
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-24
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#include "com_journal.h"
+
+//--- Standard header --------------------------------------------------------//
+#include <algorithm>
+#include <limits>
+
+using namespace bfe;
+
+/// Types of records in journal file
+enum class ComJournalRecordType : std::uint8_t
+{
+    NAME = 1,
+    CALL = 2
+};
+
+thread_local int CComJournal::s_nDepth = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes a value in host byte order
+///
+/// \param _File File to write to
+/// \param _Value Value to write
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+static void writeRaw(std::ofstream& _File, const T& _Value)
+{
+    _File.write(reinterpret_cast<const char*>(&_Value), sizeof(T));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads a value in host byte order
+///
+/// \param _File File to read from
+/// \param _Value Value read
+///
+/// \return Success?
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+static bool readRaw(std::ifstream& _File, T& _Value)
+{
+    return bool(_File.read(reinterpret_cast<char*>(&_Value), sizeof(T)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Destructor, closes journal if recording
+///
+////////////////////////////////////////////////////////////////////////////////
+CComJournal::~CComJournal()
+{
+    METHOD_ENTRY("CComJournal::~CComJournal")
+    DTOR_CALL("CComJournal::~CComJournal")
+
+    if (this->isRecording()) this->stop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Records a call in current frame
+///
+/// \param _Origin Origin of call
+/// \param _strName Name of function called
+/// \param _strArguments Arguments, written by CComBinaryWriter
+///
+////////////////////////////////////////////////////////////////////////////////
+void CComJournal::record(const ComJournalOriginType _Origin, const std::string& _strName,
+                         const std::string& _strArguments)
+{
+    METHOD_ENTRY_QUIET("CComJournal::record")
+
+    // Length of names is stored in 16 bits
+    if (_strName.size() > std::numeric_limits<std::uint16_t>::max())
+    {
+        WARNING_MSG_QUIET("Com Journal", "Name of function too long, call not recorded.")
+        return;
+    }
+
+    bool bSkipped = false;
+    m_AccessFile.acquireLock();
+
+    // Recording might have been stopped in the meantime
+    if (m_bRecording.load(std::memory_order_relaxed))
+    {
+        auto it = m_Names.find(_strName);
+        if (it == m_Names.end() && m_Names.size() <= std::numeric_limits<std::uint16_t>::max())
+        {
+            it = m_Names.emplace(_strName, std::uint16_t(m_Names.size())).first;
+            writeRaw(m_File, ComJournalRecordType::NAME);
+            writeRaw(m_File, it->second);
+            writeRaw(m_File, std::uint16_t(_strName.size()));
+            m_File.write(_strName.data(), std::streamsize(_strName.size()));
+        }
+        if (it != m_Names.end())
+        {
+            writeRaw(m_File, ComJournalRecordType::CALL);
+            writeRaw(m_File, m_nFrame.load(std::memory_order_relaxed));
+            writeRaw(m_File, it->second);
+            writeRaw(m_File, _Origin);
+            writeRaw(m_File, std::uint32_t(_strArguments.size()));
+            m_File.write(_strArguments.data(), std::streamsize(_strArguments.size()));
+            m_nRecords.fetch_add(1u, std::memory_order_relaxed);
+        }
+        else
+        {
+            bSkipped = true;
+        }
+    }
+
+    m_AccessFile.releaseLock();
+
+    // Logging calls the com interface, thus not while locked
+    if (bSkipped)
+    {
+        WARNING_MSG_QUIET("Com Journal", "Too many functions, call of <" << _strName << "> not recorded.")
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Starts recording to given file, replacing its content
+///
+/// A journal recording before is closed.
+///
+/// \param _strFilename Name of journal file
+///
+/// \return Success?
+///
+////////////////////////////////////////////////////////////////////////////////
+bool CComJournal::start(const std::string& _strFilename)
+{
+    METHOD_ENTRY("CComJournal::start")
+
+    if (this->isRecording()) this->stop();
+
+    m_AccessFile.acquireLock();
+    m_File.open(_strFilename, std::ios::binary | std::ios::trunc);
+    const bool bOpen = m_File.is_open();
+    if (bOpen)
+    {
+        m_File.write(COM_JOURNAL_MAGIC, sizeof(COM_JOURNAL_MAGIC));
+        writeRaw(m_File, COM_JOURNAL_VERSION);
+        m_Names.clear();
+        m_nRecords.store(0u, std::memory_order_relaxed);
+        m_bRecording.store(true, std::memory_order_relaxed);
+    }
+    m_AccessFile.releaseLock();
+
+    if (bOpen)
+    {
+        INFO_MSG("Com Journal", "Recording to " << _strFilename << ".")
+    }
+    else
+    {
+        WARNING_MSG("Com Journal", "Couldn't open " << _strFilename << ", not recording.")
+    }
+    return bOpen;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Stops recording and closes the journal file
+///
+////////////////////////////////////////////////////////////////////////////////
+void CComJournal::stop()
+{
+    METHOD_ENTRY("CComJournal::stop")
+
+    m_AccessFile.acquireLock();
+    const bool bRecording = m_bRecording.exchange(false, std::memory_order_relaxed);
+    if (bRecording) m_File.close();
+    m_AccessFile.releaseLock();
+
+    if (bRecording)
+    {
+        INFO_MSG("Com Journal", "Recording stopped, " << this->getNumberOfRecords() << " calls recorded.")
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads all names and calls of a journal file
+///
+/// Records read before an invalid or truncated record are kept.
+///
+/// \param _strFilename Name of journal file
+/// \param _Names Names of functions, indexed by records
+/// \param _Records Calls in order of recording
+///
+/// \return Success?
+///
+////////////////////////////////////////////////////////////////////////////////
+bool CComJournal::load(const std::string& _strFilename, std::vector<std::string>& _Names,
+                       std::vector<ComJournalRecord>& _Records)
+{
+    METHOD_ENTRY("CComJournal::load")
+
+    _Names.clear();
+    _Records.clear();
+
+    std::ifstream File(_strFilename, std::ios::binary | std::ios::ate);
+    if (!File.is_open())
+    {
+        WARNING_MSG("Com Journal", "Couldn't open " << _strFilename << ".")
+        return false;
+    }
+    // Lengths read from file are bound by its size, not to allocate in vain
+    const std::streamoff nSize = File.tellg();
+    File.seekg(0);
+
+    char Magic[sizeof(COM_JOURNAL_MAGIC)];
+    std::uint8_t nVersion = 0u;
+    if (!File.read(Magic, sizeof(Magic)) || !std::equal(Magic, Magic+sizeof(Magic), COM_JOURNAL_MAGIC) ||
+        !readRaw(File, nVersion) || nVersion != COM_JOURNAL_VERSION)
+    {
+        WARNING_MSG("Com Journal", _strFilename << " is no journal of version " << int(COM_JOURNAL_VERSION) << ".")
+        return false;
+    }
+
+    ComJournalRecordType RecordType;
+    while (readRaw(File, RecordType))
+    {
+        bool bValid = false;
+        if (RecordType == ComJournalRecordType::NAME)
+        {
+            std::uint16_t nName = 0u;
+            std::uint16_t nLength = 0u;
+            if (readRaw(File, nName) && readRaw(File, nLength) && nName == _Names.size())
+            {
+                std::string strName(nLength, '\0');
+                bValid = bool(File.read(&strName[0], nLength));
+                if (bValid) _Names.push_back(std::move(strName));
+            }
+        }
+        else if (RecordType == ComJournalRecordType::CALL)
+        {
+            ComJournalRecord Record;
+            std::uint32_t nLength = 0u;
+            if (readRaw(File, Record.nFrame) && readRaw(File, Record.nName) &&
+                readRaw(File, Record.Origin) && readRaw(File, nLength) &&
+                Record.nName < _Names.size() &&
+                std::size_t(Record.Origin) < COM_JOURNAL_NUMBER_OF_ORIGINS &&
+                std::streamoff(nLength) <= nSize - std::streamoff(File.tellg()))
+            {
+                Record.strArguments.resize(nLength);
+                bValid = (nLength == 0u) || bool(File.read(&Record.strArguments[0], nLength));
+                if (bValid) _Records.push_back(std::move(Record));
+            }
+        }
+        if (!bValid)
+        {
+            WARNING_MSG("Com Journal", "Invalid record in " << _strFilename << " after " <<
+                                       _Records.size() << " calls.")
+            return false;
+        }
+    }
+
+    DEBUG_MSG("Com Journal", "Loaded " << _Records.size() << " calls of " << _Names.size() <<
+                             " functions from " << _strFilename << ".")
+    return true;
+}
@@ -0,0 +1,218 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       com_journal.h
+/// \brief      Prototype of class "CComJournal"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-24
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COM_JOURNAL_H
+#define COM_JOURNAL_H
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "adaptive_lock.h"
+#include "log.h"
+
+/// BFEngine namespace
+namespace bfe
+{
+
+//--- Constants --------------------------------------------------------------//
+constexpr char          COM_JOURNAL_MAGIC[4] = {'B', 'F', 'E', 'J'}; ///< Identifies journal files
+constexpr std::uint8_t  COM_JOURNAL_VERSION = 1u;   ///< Version of file format
+
+/// Specifies where a journaled call came from
+enum class ComJournalOriginType : std::uint8_t
+{
+    COMMAND = 0,    ///< Command from string, e.g. console or automation
+    SCRIPT  = 1,    ///< Arguments read dynamically, e.g. Lua
+    WRITER  = 2     ///< Writer function called directly, i.e. enqueued to its domain
+};
+constexpr std::size_t COM_JOURNAL_NUMBER_OF_ORIGINS = 3u; ///< Number of origins
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Call read from a journal
+///
+////////////////////////////////////////////////////////////////////////////////
+struct ComJournalRecord
+{
+    std::uint64_t           nFrame = 0u;    ///< Frame of call
+    std::uint16_t           nName = 0u;     ///< Index of function's name
+    ComJournalOriginType    Origin = ComJournalOriginType::COMMAND; ///< Origin of call
+    std::string             strArguments;   ///< Arguments, written by CComBinaryWriter
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Records calls of the com interface to a binary file
+///
+/// Only calls that are input to the engine are recorded, i.e. commands,
+/// scripts and writer functions. Calls made while another call or writer
+/// queue is executed are not recorded, since replaying the outer call
+/// repeats them. Nesting is tracked per thread by \ref CComJournalScope.
+///
+/// Recording is disabled by default, then, a call costs a single relaxed
+/// load.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CComJournal
+{
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        CComJournal() = default;
+        ~CComJournal();
+        CComJournal(const CComJournal&) = delete;
+        CComJournal& operator=(const CComJournal&) = delete;
+
+        //--- Constant methods -----------------------------------------------//
+        std::uint64_t   getFrame() const;
+        std::uint64_t   getNumberOfRecords() const;
+        bool            isRecording() const;
+
+        //--- Methods --------------------------------------------------------//
+        void record(const ComJournalOriginType, const std::string&, const std::string&);
+        void setFrame(const std::uint64_t);
+        bool start(const std::string&);
+        void stop();
+
+        //--- Static methods -------------------------------------------------//
+        static bool isNested();
+        static bool load(const std::string&, std::vector<std::string>&, std::vector<ComJournalRecord>&);
+
+    private:
+
+        friend class CComJournalScope;
+
+        //--- Variables [private] --------------------------------------------//
+        static thread_local int s_nDepth;           ///< Nesting of calls of current thread
+
+        CAdaptiveLock                                   m_AccessFile;           ///< Serialises recording threads
+        std::ofstream                                   m_File;                 ///< Journal file
+        std::unordered_map<std::string, std::uint16_t>  m_Names;                ///< Indices of names written
+        std::atomic<bool>                               m_bRecording{false};    ///< Indicates that calls are recorded
+        std::atomic<std::uint64_t>                      m_nFrame{0u};           ///< Frame of calls
+        std::atomic<std::uint64_t>                      m_nRecords{0u};         ///< Number of calls recorded
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Marks calls of the current thread as nested while in scope
+///
+////////////////////////////////////////////////////////////////////////////////
+class CComJournalScope
+{
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        CComJournalScope() {++CComJournal::s_nDepth;}
+        ~CComJournalScope() {--CComJournal::s_nDepth;}
+        CComJournalScope(const CComJournalScope&) = delete;
+        CComJournalScope& operator=(const CComJournalScope&) = delete;
+};
+
+//--- Implementation is done here for inline optimisation --------------------//
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the frame calls are recorded with
+///
+/// \return Current frame
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint64_t CComJournal::getFrame() const
+{
+    METHOD_ENTRY_QUIET("CComJournal::getFrame")
+    return m_nFrame.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the number of calls recorded since start
+///
+/// \return Number of records
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint64_t CComJournal::getNumberOfRecords() const
+{
+    METHOD_ENTRY_QUIET("CComJournal::getNumberOfRecords")
+    return m_nRecords.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Indicates that calls are recorded
+///
+/// \return Recording?
+///
+////////////////////////////////////////////////////////////////////////////////
+inline bool CComJournal::isRecording() const
+{
+    METHOD_ENTRY_QUIET("CComJournal::isRecording")
+    return m_bRecording.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Sets the frame following calls are recorded with
+///
+/// Usually set by whatever drives the frames, e.g. the frame graph.
+///
+/// \param _nFrame Current frame
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void CComJournal::setFrame(const std::uint64_t _nFrame)
+{
+    METHOD_ENTRY_QUIET("CComJournal::setFrame")
+    m_nFrame.store(_nFrame, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Indicates that the current thread is executing a call
+///
+/// \return Nested?
+///
+////////////////////////////////////////////////////////////////////////////////
+inline bool CComJournal::isNested()
+{
+    METHOD_ENTRY_QUIET("CComJournal::isNested")
+    return s_nDepth > 0;
+}
+
+} // namespace bfe
+
+#endif // COM_JOURNAL_H
@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       com_journal_player.cpp
+/// \brief      Implementation of class "CComJournalPlayer"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-24
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#include "com_journal_player.h"
+
+using namespace bfe;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Constructor
+///
+/// \param _pComInterface Com interface calls are injected to
+///
+////////////////////////////////////////////////////////////////////////////////
+CComJournalPlayer::CComJournalPlayer(CComInterface* const _pComInterface) : m_pComInterface(_pComInterface)
+{
+    METHOD_ENTRY("CComJournalPlayer::CComJournalPlayer")
+    CTOR_CALL("CComJournalPlayer::CComJournalPlayer")
+
+    m_strModuleName = "Com Journal Player";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Loads a journal, replacing calls loaded before
+///
+/// \param _strFilename Name of journal file
+///
+/// \return Success?
+///
+////////////////////////////////////////////////////////////////////////////////
+bool CComJournalPlayer::load(const std::string& _strFilename)
+{
+    METHOD_ENTRY("CComJournalPlayer::load")
+
+    const bool bLoaded = CComJournal::load(_strFilename, m_Names, m_Records);
+
+    m_nNext = 0u;
+    m_nReplayed = 0u;
+    m_nFrame = m_Records.empty() ? 0u : m_Records.front().nFrame;
+
+    INFO_MSG("Com Journal Player", "Loaded " << m_Records.size() << " calls from " << _strFilename << ".")
+    return bLoaded;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Replays calls of the next journal frame
+///
+/// \return Continue? False if all calls are replayed.
+///
+////////////////////////////////////////////////////////////////////////////////
+bool CComJournalPlayer::processFrame()
+{
+    METHOD_ENTRY("CComJournalPlayer::processFrame")
+
+    while (!this->isDone() && m_Records[m_nNext].nFrame <= m_nFrame) this->replayNext();
+    ++m_nFrame;
+
+    if (this->isDone())
+    {
+        INFO_MSG("Com Journal Player", "Replay done, " << m_nReplayed << " calls replayed.")
+        return false;
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Replays all remaining calls at once
+///
+/// \return Number of calls replayed
+///
+////////////////////////////////////////////////////////////////////////////////
+std::size_t CComJournalPlayer::replay()
+{
+    METHOD_ENTRY("CComJournalPlayer::replay")
+
+    const std::size_t nReplayed = m_nReplayed;
+    while (!this->isDone()) this->replayNext();
+    if (!m_Records.empty()) m_nFrame = m_Records.back().nFrame + 1u;
+    return m_nReplayed - nReplayed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Injects the next call, unless its origin is excluded
+///
+////////////////////////////////////////////////////////////////////////////////
+void CComJournalPlayer::replayNext()
+{
+    METHOD_ENTRY("CComJournalPlayer::replayNext")
+
+    const ComJournalRecord& Record = m_Records[m_nNext++];
+    if (!m_Origins[std::size_t(Record.Origin)]) return;
+
+    const std::string& strName = m_Names[Record.nName];
+    CComBinaryReader Reader(Record.strArguments.data(), Record.strArguments.data() + Record.strArguments.size());
+    CComStringWriter Writer(m_strReturn);
+    m_strReturn.clear();
+
+    if (m_pComInterface->invoke(strName, Reader, Writer, Record.Origin))
+    {
+        ++m_nReplayed;
+    }
+    else
+    {
+        WARNING_MSG("Com Journal Player", "Unknown function <" << strName << ">, call not replayed.")
+    }
+}
@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       com_journal_player.h
+/// \brief      Prototype of class "CComJournalPlayer"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-24
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COM_JOURNAL_PLAYER_H
+#define COM_JOURNAL_PLAYER_H
+
+//--- Standard header --------------------------------------------------------//
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "com_interface.h"
+#include "com_journal.h"
+#include "log.h"
+#include "thread_module.h"
+
+/// BFEngine namespace
+namespace bfe
+{
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Replays a journal recorded by the com interface
+///
+/// Calls are injected by name with their recorded arguments and origin, thus,
+/// callbacks and queueing of writers happen like when recorded. Return values
+/// are discarded.
+///
+/// As module, e.g. of a \ref CHeadlessRunner, each frame replays the calls of
+/// one journal frame, starting with the first frame recorded. The module's
+/// frequency should match the frame rate of recording. Processing stops when
+/// all calls are replayed. Alternatively, \ref replay injects all calls at
+/// once.
+///
+/// Modules making the recorded writer calls themselves shouldn't run during
+/// replay, or writer calls should be excluded by \ref setOrigin.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CComJournalPlayer : public IThreadModule
+{
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        explicit CComJournalPlayer(CComInterface* const);
+
+        //--- Constant methods -----------------------------------------------//
+        std::uint64_t   getFrame() const;
+        std::size_t     getNumberOfRecords() const;
+        std::size_t     getNumberOfReplayed() const;
+        bool            isDone() const;
+
+        //--- Methods --------------------------------------------------------//
+        bool            load(const std::string&);
+        bool            processFrame() override;
+        std::size_t     replay();
+        void            setOrigin(const ComJournalOriginType, const bool);
+
+    private:
+
+        //--- Methods [private] ----------------------------------------------//
+        void replayNext();
+
+        //--- Variables [private] --------------------------------------------//
+        CComInterface*                  m_pComInterface;    ///< Com interface calls are injected to
+        std::vector<std::string>        m_Names;            ///< Names of functions called
+        std::vector<ComJournalRecord>   m_Records;          ///< Calls in order of recording
+        std::size_t                     m_nNext = 0u;       ///< Index of next call
+        std::size_t                     m_nReplayed = 0u;   ///< Number of calls replayed
+        std::uint64_t                   m_nFrame = 0u;      ///< Journal frame replayed next
+        bool                            m_Origins[COM_JOURNAL_NUMBER_OF_ORIGINS] = {true, true, true}; ///< Origins replayed
+        std::string                     m_strReturn;        ///< Return values, discarded
+};
+
+//--- Implementation is done here for inline optimisation --------------------//
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the journal frame replayed next
+///
+/// \return Frame as recorded
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint64_t CComJournalPlayer::getFrame() const
+{
+    METHOD_ENTRY("CComJournalPlayer::getFrame")
+    return m_nFrame;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the number of calls loaded
+///
+/// \return Number of calls
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::size_t CComJournalPlayer::getNumberOfRecords() const
+{
+    METHOD_ENTRY("CComJournalPlayer::getNumberOfRecords")
+    return m_Records.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the number of calls replayed, excluded origins not counted
+///
+/// \return Number of calls
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::size_t CComJournalPlayer::getNumberOfReplayed() const
+{
+    METHOD_ENTRY("CComJournalPlayer::getNumberOfReplayed")
+    return m_nReplayed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Indicates that all calls were replayed
+///
+/// \return Done?
+///
+////////////////////////////////////////////////////////////////////////////////
+inline bool CComJournalPlayer::isDone() const
+{
+    METHOD_ENTRY("CComJournalPlayer::isDone")
+    return m_nNext >= m_Records.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Includes or excludes calls of given origin from replay
+///
+/// \param _Origin Origin of calls
+/// \param _bReplay Replay calls?
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void CComJournalPlayer::setOrigin(const ComJournalOriginType _Origin, const bool _bReplay)
+{
+    METHOD_ENTRY("CComJournalPlayer::setOrigin")
+    m_Origins[std::size_t(_Origin)] = _bReplay;
+}
+
+} // namespace bfe
+
+#endif // COM_JOURNAL_PLAYER_H
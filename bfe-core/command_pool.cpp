@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       command_pool.cpp
+/// \brief      Implementation of class "CCommandPool"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-18
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#include "command_pool.h"
+
+using namespace bfe;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Destructor, frees all chunks
+///
+/// All slots must have been returned, i.e. no queued commands are left.
+///
+////////////////////////////////////////////////////////////////////////////////
+CCommandPool::~CCommandPool()
+{
+    METHOD_ENTRY("CCommandPool::~CCommandPool")
+    DTOR_CALL("CCommandPool::~CCommandPool")
+
+    for (auto& pChunk : m_Chunks)
+    {
+        pChunk.reset();
+        MEM_FREED("SlotType[]")
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Allocates a new chunk of slots
+///
+/// Concurrent callers might have grown the pool in the meantime, then, their
+/// slots are taken instead.
+///
+/// \return Slot of the new chunk, the others are free slots
+///
+////////////////////////////////////////////////////////////////////////////////
+void* CCommandPool::grow()
+{
+    METHOD_ENTRY("CCommandPool::grow")
+
+    m_AccessChunks.acquireLock();
+
+    void* pSlot = nullptr;
+    if (!m_FreeSlots.try_dequeue(pSlot))
+    {
+        m_Chunks.emplace_back(new SlotType[COMMAND_POOL_CHUNK_SLOTS]);
+        MEM_ALLOC("SlotType[]")
+
+        SlotType* const pChunk = m_Chunks.back().get();
+        std::vector<void*> Slots(COMMAND_POOL_CHUNK_SLOTS-1u);
+        for (auto i=1u; i<COMMAND_POOL_CHUNK_SLOTS; ++i) Slots[i-1u] = &pChunk[i];
+        m_FreeSlots.enqueue_bulk(Slots.begin(), Slots.size());
+
+        m_nNumberOfSlots.fetch_add(COMMAND_POOL_CHUNK_SLOTS, std::memory_order_relaxed);
+        pSlot = &pChunk[0];
+
+        DEBUG_MSG("Command Pool", "Grown to " << m_nNumberOfSlots.load(std::memory_order_relaxed) << " slots.")
+    }
+
+    m_AccessChunks.releaseLock();
+    return pSlot;
+}
@@ -0,0 +1,150 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       command_pool.h
+/// \brief      Prototype of class "CCommandPool"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-18
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COMMAND_POOL_H
+#define COMMAND_POOL_H
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "adaptive_lock.h"
+#include "log.h"
+
+//--- Misc header ------------------------------------------------------------//
+#include "concurrentqueue.h"
+
+/// BFEngine namespace
+namespace bfe
+{
+
+//--- Constants --------------------------------------------------------------//
+constexpr std::size_t COMMAND_POOL_SLOT_SIZE   = 128u;    ///< Bytes per slot, larger commands are allocated on heap
+constexpr std::size_t COMMAND_POOL_SLOT_ALIGN  = alignof(std::max_align_t); ///< Alignment of slots
+constexpr std::size_t COMMAND_POOL_CHUNK_SLOTS = 256u;    ///< Number of slots allocated at once
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Fixed size slots for queued commands of one writer domain
+///
+/// Any thread may take a slot, usually the caller of a writer function, and
+/// any thread may return it, usually the thread of the writer domain. Free
+/// slots are kept in a lock-free queue. If it runs empty, a new chunk of
+/// slots is allocated, which is the only allocation. Chunks are kept until
+/// the pool is destroyed, hence, once the pool has grown to the number of
+/// commands in flight, taking and returning slots doesn't allocate.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CCommandPool
+{
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        CCommandPool() = default;
+        ~CCommandPool();
+        CCommandPool(const CCommandPool&) = delete;
+        CCommandPool& operator=(const CCommandPool&) = delete;
+
+        //--- Constant methods -----------------------------------------------//
+        std::size_t getNumberOfSlots() const;
+
+        //--- Methods --------------------------------------------------------//
+        void* allocate();
+        void  release(void* const);
+
+    private:
+
+        /// Storage of one command
+        struct alignas(COMMAND_POOL_SLOT_ALIGN) SlotType
+        {
+            unsigned char Data[COMMAND_POOL_SLOT_SIZE]; ///< Raw storage
+        };
+
+        //--- Methods [private] ----------------------------------------------//
+        void* grow();
+
+        //--- Variables [private] --------------------------------------------//
+        moodycamel::ConcurrentQueue<void*>          m_FreeSlots;        ///< Slots ready to be taken
+        std::vector<std::unique_ptr<SlotType[]>>    m_Chunks;           ///< All chunks, owning the slots
+        std::atomic<std::size_t>                    m_nNumberOfSlots{0u}; ///< Number of slots of all chunks
+        CAdaptiveLock                               m_AccessChunks;     ///< Serialises growing
+};
+
+//--- Implementation is done here for inline optimisation --------------------//
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the number of slots, taken or free
+///
+/// \return Number of slots
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::size_t CCommandPool::getNumberOfSlots() const
+{
+    METHOD_ENTRY_QUIET("CCommandPool::getNumberOfSlots")
+    return m_nNumberOfSlots.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Takes a free slot of \ref COMMAND_POOL_SLOT_SIZE bytes
+///
+/// \return Uninitialised storage for one command
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void* CCommandPool::allocate()
+{
+    METHOD_ENTRY_QUIET("CCommandPool::allocate")
+
+    void* pSlot = nullptr;
+    if (m_FreeSlots.try_dequeue(pSlot)) return pSlot;
+    return this->grow();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns a slot taken by \ref allocate
+///
+/// \param _pSlot Slot, command stored must already be destroyed
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void CCommandPool::release(void* const _pSlot)
+{
+    METHOD_ENTRY_QUIET("CCommandPool::release")
+    m_FreeSlots.enqueue(_pSlot);
+}
+
+} // namespace bfe
+
+#endif // COMMAND_POOL_H
@@ -40,6 +40,20 @@
 
 // #define BFE_MULTITHREADING
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \def BFE_HANDLE_COMPACT
+///         Defines if handle id's are packed into 32 bits (index and counter)
+///
+/// \def BFE_HANDLE_INDEX_BITS
+///         Number of bits of the handle index in compact mode, the remaining
+///         bits are used for the counter (at most 16 bits)
+///
+////////////////////////////////////////////////////////////////////////////////
+
+// #define BFE_HANDLE_COMPACT
+#define BFE_HANDLE_INDEX_BITS 16
+
 //--- End of configuration ---------------------------------------------------//
 
 #endif
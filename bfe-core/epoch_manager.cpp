@@ -0,0 +1,260 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       epoch_manager.cpp
+/// \brief      Implementation of class "CEpochManager"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-09
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#include "epoch_manager.h"
+
+using namespace bfe;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Constructor
+///
+////////////////////////////////////////////////////////////////////////////////
+CEpochManager::CEpochManager() : m_nEpoch(1u),
+                                 m_nParticipants(0u),
+                                 m_pRetired(nullptr),
+                                 m_nRetired(0u)
+{
+    METHOD_ENTRY("CEpochManager::CEpochManager")
+    CTOR_CALL("CEpochManager::CEpochManager")
+
+    for (auto& Announced : m_Announced) Announced.store(0u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Destructor, releasing all retired entries
+///
+////////////////////////////////////////////////////////////////////////////////
+CEpochManager::~CEpochManager()
+{
+    METHOD_ENTRY("CEpochManager::~CEpochManager")
+    DTOR_CALL("CEpochManager::~CEpochManager")
+
+    EpochRetiredEntry* pEntry = m_pRetired.exchange(nullptr);
+    while (pEntry != nullptr)
+    {
+        EpochRetiredEntry* const pNext = pEntry->pNext;
+        pEntry->Release();
+        delete pEntry;
+        MEM_FREED("EpochRetiredEntry")
+        pEntry = pNext;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Registers the calling thread as participant
+///
+/// Registration counts as quiescent state in the current epoch.
+///
+/// \return Id of participant, EPOCH_PARTICIPANT_NONE if maximum is reached
+///
+////////////////////////////////////////////////////////////////////////////////
+int CEpochManager::registerParticipant()
+{
+    METHOD_ENTRY("CEpochManager::registerParticipant")
+
+    for (auto i=0; i<EPOCH_PARTICIPANTS_MAX; ++i)
+    {
+        std::uint64_t nUnused = 0u;
+        if (m_Announced[i].compare_exchange_strong(nUnused, m_nEpoch.load()))
+        {
+            ++m_nParticipants;
+            return i;
+        }
+    }
+    WARNING_MSG("Epoch Manager", "Maximum number of participants (" << EPOCH_PARTICIPANTS_MAX << ") reached.")
+    return EPOCH_PARTICIPANT_NONE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Unregisters participant, it won't hold back epochs any more
+///
+/// \param _nParticipant Id of participant
+///
+////////////////////////////////////////////////////////////////////////////////
+void CEpochManager::unregisterParticipant(const int _nParticipant)
+{
+    METHOD_ENTRY("CEpochManager::unregisterParticipant")
+
+    if (_nParticipant == EPOCH_PARTICIPANT_NONE) return;
+
+    BFE_ASSERT(_nParticipant >= 0 && _nParticipant < EPOCH_PARTICIPANTS_MAX);
+
+    m_Announced[_nParticipant].store(0u);
+    --m_nParticipants;
+
+    this->tryAdvance();
+    this->collect();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Announces quiescent state of participant
+///
+/// The participant must not hold any raw pointers obtained before this call.
+/// If possible, the global epoch is advanced and retired entries are
+/// released.
+///
+/// \param _nParticipant Id of participant
+///
+////////////////////////////////////////////////////////////////////////////////
+void CEpochManager::announce(const int _nParticipant)
+{
+    METHOD_ENTRY("CEpochManager::announce")
+
+    if (_nParticipant == EPOCH_PARTICIPANT_NONE) return;
+
+    BFE_ASSERT(_nParticipant >= 0 && _nParticipant < EPOCH_PARTICIPANTS_MAX);
+
+    m_Announced[_nParticipant].store(m_nEpoch.load());
+
+    if (this->tryAdvance() && m_nRetired.load() != 0u) this->collect();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Retires a resource, which is released after a grace period
+///
+/// The resource must not be reachable for new readers any more, e.g. its
+/// handle must be invalid.
+///
+/// \param _Release Function releasing the resource
+///
+////////////////////////////////////////////////////////////////////////////////
+void CEpochManager::retire(const std::function<void()>& _Release)
+{
+    METHOD_ENTRY("CEpochManager::retire")
+
+    if (m_nParticipants.load() == 0u)
+    {
+        _Release();
+        return;
+    }
+
+    EpochRetiredEntry* const pEntry = new EpochRetiredEntry;
+    MEM_ALLOC("EpochRetiredEntry")
+    pEntry->nEpoch = m_nEpoch.load();
+    pEntry->Release = _Release;
+
+    ++m_nRetired;
+    this->pushRetired(pEntry, pEntry);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Releases retired entries if their grace period passed
+///
+/// Only one thread collects at a time, concurrent calls return immediately.
+///
+/// \return Number of entries released
+///
+////////////////////////////////////////////////////////////////////////////////
+std::uint32_t CEpochManager::collect()
+{
+    METHOD_ENTRY("CEpochManager::collect")
+
+    if (m_Collecting.test_and_set(std::memory_order_acquire)) return 0u;
+
+    const std::uint64_t nEpoch = m_nEpoch.load();
+    const bool bNoParticipants = (m_nParticipants.load() == 0u);
+
+    EpochRetiredEntry* pEntry = m_pRetired.exchange(nullptr);
+    EpochRetiredEntry* pKeptFirst = nullptr;
+    EpochRetiredEntry* pKeptLast = nullptr;
+    std::uint32_t nReleased = 0u;
+
+    while (pEntry != nullptr)
+    {
+        EpochRetiredEntry* const pNext = pEntry->pNext;
+        if (bNoParticipants || pEntry->nEpoch + 2u <= nEpoch)
+        {
+            pEntry->Release();
+            delete pEntry;
+            MEM_FREED("EpochRetiredEntry")
+            ++nReleased;
+        }
+        else
+        {
+            pEntry->pNext = pKeptFirst;
+            if (pKeptFirst == nullptr) pKeptLast = pEntry;
+            pKeptFirst = pEntry;
+        }
+        pEntry = pNext;
+    }
+    if (pKeptFirst != nullptr) this->pushRetired(pKeptFirst, pKeptLast);
+
+    m_nRetired -= nReleased;
+    m_Collecting.clear(std::memory_order_release);
+
+    return nReleased;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Advances the global epoch if all participants announced it
+///
+/// \return Epoch advanced?
+///
+////////////////////////////////////////////////////////////////////////////////
+bool CEpochManager::tryAdvance()
+{
+    METHOD_ENTRY("CEpochManager::tryAdvance")
+
+    std::uint64_t nEpoch = m_nEpoch.load();
+    for (const auto& Announced : m_Announced)
+    {
+        const std::uint64_t nAnnounced = Announced.load();
+        if (nAnnounced != 0u && nAnnounced != nEpoch) return false;
+    }
+    return m_nEpoch.compare_exchange_strong(nEpoch, nEpoch+1u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Pushes a linked list of entries to the retired list
+///
+/// \param _pFirst First entry of list
+/// \param _pLast Last entry of list, will be linked to current list
+///
+////////////////////////////////////////////////////////////////////////////////
+void CEpochManager::pushRetired(EpochRetiredEntry* const _pFirst, EpochRetiredEntry* const _pLast)
+{
+    METHOD_ENTRY("CEpochManager::pushRetired")
+
+    EpochRetiredEntry* pHead = m_pRetired.load(std::memory_order_relaxed);
+    do
+    {
+        _pLast->pNext = pHead;
+    } while (!m_pRetired.compare_exchange_weak(pHead, _pFirst, std::memory_order_release,
+                                                               std::memory_order_relaxed));
+}
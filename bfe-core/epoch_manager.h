@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       epoch_manager.h
+/// \brief      Prototype of class "CEpochManager"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-09
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef EPOCH_MANAGER_H
+#define EPOCH_MANAGER_H
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+//--- Program header ---------------------------------------------------------//
+#include "log.h"
+
+/// BFEngine namespace
+namespace bfe
+{
+
+//--- Constants --------------------------------------------------------------//
+constexpr int EPOCH_PARTICIPANTS_MAX = 64;  ///< Maximum number of registered threads
+constexpr int EPOCH_PARTICIPANT_NONE = -1;  ///< Id of participant if registration failed
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Entry of retired list, released after a grace period
+///
+////////////////////////////////////////////////////////////////////////////////
+struct EpochRetiredEntry
+{
+    std::uint64_t           nEpoch;     ///< Global epoch when entry was retired
+    std::function<void()>   Release;    ///< Function releasing resources
+    EpochRetiredEntry*      pNext;      ///< Next entry of retired list
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Deferred reclamation based on quiescent states
+///
+/// Participating threads (typically thread modules) register once and announce
+/// a quiescent state regularly, e.g. at each frame boundary. At that point, a
+/// thread must not hold any raw pointers obtained before. The global epoch is
+/// advanced as soon as all registered participants announced the current
+/// epoch.
+///
+/// Resources (e.g. objects and handle slots) are retired with a function
+/// releasing them. They are released once the global epoch advanced twice
+/// since retirement, hence, every participant passed a quiescent state
+/// afterwards. Readers never lock, writers never block on readers.
+///
+/// Threads accessing shared pointers have to register before. If no thread
+/// is registered, retired resources are released immediately.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CEpochManager
+{
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        CEpochManager();
+        ~CEpochManager();
+
+        CEpochManager(const CEpochManager&) = delete;
+        CEpochManager& operator=(const CEpochManager&) = delete;
+
+        //--- Constant Methods -----------------------------------------------//
+        std::uint64_t getEpoch() const;
+        std::uint32_t getNumberOfParticipants() const;
+        std::uint32_t getNumberOfRetired() const;
+
+        //--- Methods --------------------------------------------------------//
+        int           registerParticipant();
+        void          unregisterParticipant(const int);
+        void          announce(const int);
+        void          retire(const std::function<void()>&);
+        std::uint32_t collect();
+
+    private:
+
+        //--- Methods [private] ----------------------------------------------//
+        bool tryAdvance();
+        void pushRetired(EpochRetiredEntry* const, EpochRetiredEntry* const);
+
+        //--- Variables [private] --------------------------------------------//
+        std::atomic<std::uint64_t>      m_nEpoch;                               ///< Global epoch
+        std::atomic<std::uint64_t>      m_Announced[EPOCH_PARTICIPANTS_MAX];    ///< Epoch announced by participant, 0 if unused
+        std::atomic<std::uint32_t>      m_nParticipants;                        ///< Number of registered participants
+        std::atomic<EpochRetiredEntry*> m_pRetired;                             ///< List of retired entries
+        std::atomic<std::uint32_t>      m_nRetired;                             ///< Number of retired entries
+        std::atomic_flag                m_Collecting = ATOMIC_FLAG_INIT;        ///< Indicates that retired entries are collected
+};
+
+//--- Implementation is done here for inline optimisation --------------------//
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the global epoch
+///
+/// \return Global epoch
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint64_t CEpochManager::getEpoch() const
+{
+    METHOD_ENTRY("CEpochManager::getEpoch")
+    return m_nEpoch.load();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the number of registered participants
+///
+/// \return Number of registered participants
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint32_t CEpochManager::getNumberOfParticipants() const
+{
+    METHOD_ENTRY("CEpochManager::getNumberOfParticipants")
+    return m_nParticipants.load();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the number of retired entries, not released yet
+///
+/// \return Number of retired entries
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint32_t CEpochManager::getNumberOfRetired() const
+{
+    METHOD_ENTRY("CEpochManager::getNumberOfRetired")
+    return m_nRetired.load();
+}
+
+} // namespace bfe
+
+#endif // EPOCH_MANAGER_H
@@ -0,0 +1,345 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       frame_graph.cpp
+/// \brief      Implementation of class "CFrameGraph"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-15
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#include "frame_graph.h"
+
+//--- Standard header --------------------------------------------------------//
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
+//--- Program header ---------------------------------------------------------//
+#include "com_interface.h"
+
+using namespace bfe;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Constructor
+///
+/// \param _pJobSystem Job system executing the modules
+/// \param _pComInterface Com interface, used for writer queues of modules
+///
+////////////////////////////////////////////////////////////////////////////////
+CFrameGraph::CFrameGraph(CJobSystem* const _pJobSystem, CComInterface* const _pComInterface) :
+                         m_pJobSystem(_pJobSystem),
+                         m_pComInterface(_pComInterface)
+{
+    METHOD_ENTRY("CFrameGraph::CFrameGraph")
+    CTOR_CALL("CFrameGraph::CFrameGraph")
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Destructor, waiting for frames in flight
+///
+////////////////////////////////////////////////////////////////////////////////
+CFrameGraph::~CFrameGraph()
+{
+    METHOD_ENTRY("CFrameGraph::~CFrameGraph")
+    DTOR_CALL("CFrameGraph::~CFrameGraph")
+
+    this->waitForFrames();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Adds a module with the resources it produces and consumes
+///
+/// The module is registered in the module registry, if not done yet.
+///
+/// \param _strName Name of module
+/// \param _pModule Module processing frames
+/// \param _Produces Resources written by module
+/// \param _Consumes Resources read by module
+/// \param _strWriterDomain Writer queue of com interface, flushed before each
+///                         frame of the module. None if empty, e.g. if the
+///                         module flushes its queue itself.
+///
+/// \return Success?
+///
+////////////////////////////////////////////////////////////////////////////////
+bool CFrameGraph::addModule(const std::string& _strName, IThreadModule* const _pModule,
+                            const std::vector<std::string>& _Produces,
+                            const std::vector<std::string>& _Consumes,
+                            const std::string& _strWriterDomain)
+{
+    METHOD_ENTRY("CFrameGraph::addModule")
+
+    if (_pModule == nullptr)
+    {
+        WARNING_MSG("Frame Graph", "Module <" << _strName << "> invalid, not added.")
+        return false;
+    }
+    for (const auto& Node : m_Nodes)
+    {
+        if (Node.strName == _strName)
+        {
+            WARNING_MSG("Frame Graph", "Module <" << _strName << "> already added.")
+            return false;
+        }
+    }
+    if (!_strWriterDomain.empty() && m_pComInterface == nullptr)
+    {
+        WARNING_MSG("Frame Graph", "No com interface given, writer domain <" << _strWriterDomain <<
+                                   "> of module <" << _strName << "> not flushed.")
+    }
+
+    // Dependencies change, don't mix with frames in flight
+    this->waitForFrames();
+    m_JobsLast.clear();
+
+    FrameGraphNode Node;
+    Node.strName = _strName;
+    Node.pModule = _pModule;
+    Node.Produces = _Produces;
+    Node.Consumes = _Consumes;
+    Node.strWriterDomain = _strWriterDomain;
+    Node.pWriterQueue = nullptr;
+    m_Nodes.push_back(Node);
+    _pModule->registerModule();
+
+    m_bCompiled = false;
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Resolves dependencies and orders modules topologically
+///
+/// \return Success? Fails if dependencies are cyclic.
+///
+////////////////////////////////////////////////////////////////////////////////
+bool CFrameGraph::compile()
+{
+    METHOD_ENTRY("CFrameGraph::compile")
+
+    std::unordered_map<std::string, std::vector<int>> Producers;
+    for (auto i=0u; i<m_Nodes.size(); ++i)
+    {
+        for (const auto& strResource : m_Nodes[i].Produces) Producers[strResource].push_back(i);
+    }
+
+    for (auto& Node : m_Nodes)
+    {
+        Node.Producers.clear();
+        Node.Consumers.clear();
+
+        // Resolve queue once, flushing each frame then needs no lookup
+        Node.pWriterQueue = nullptr;
+        if (m_pComInterface != nullptr && !Node.strWriterDomain.empty())
+        {
+            Node.pWriterQueue = m_pComInterface->getWriterQueue(Node.strWriterDomain);
+            if (Node.pWriterQueue == nullptr)
+            {
+                WARNING_MSG("Frame Graph", "Unknown writer domain <" << Node.strWriterDomain <<
+                                           "> of module <" << Node.strName << ">, not flushed.")
+            }
+        }
+    }
+    for (auto i=0u; i<m_Nodes.size(); ++i)
+    {
+        for (const auto& strResource : m_Nodes[i].Consumes)
+        {
+            const auto it = Producers.find(strResource);
+            if (it == Producers.end())
+            {
+                DEBUG_MSG("Frame Graph", "Resource <" << strResource << "> of module <" << m_Nodes[i].strName <<
+                                         "> isn't produced by any module.")
+                continue;
+            }
+            for (const auto nProducer : it->second)
+            {
+                // Modules updating a resource in place don't depend on themselves
+                if (nProducer == int(i)) continue;
+                m_Nodes[i].Producers.push_back(nProducer);
+                m_Nodes[nProducer].Consumers.push_back(i);
+            }
+        }
+    }
+    for (auto& Node : m_Nodes)
+    {
+        std::sort(Node.Producers.begin(), Node.Producers.end());
+        Node.Producers.erase(std::unique(Node.Producers.begin(), Node.Producers.end()), Node.Producers.end());
+        std::sort(Node.Consumers.begin(), Node.Consumers.end());
+        Node.Consumers.erase(std::unique(Node.Consumers.begin(), Node.Consumers.end()), Node.Consumers.end());
+    }
+
+    // Kahn's algorithm, keeping order of insertion for independent modules
+    std::vector<int> Incoming(m_Nodes.size());
+    for (auto i=0u; i<m_Nodes.size(); ++i) Incoming[i] = m_Nodes[i].Producers.size();
+
+    m_Order.clear();
+    std::vector<bool> Done(m_Nodes.size(), false);
+    while (m_Order.size() < m_Nodes.size())
+    {
+        int nNext = -1;
+        for (auto i=0u; i<m_Nodes.size(); ++i)
+        {
+            if (!Done[i] && Incoming[i] == 0)
+            {
+                nNext = i;
+                break;
+            }
+        }
+        if (nNext == -1)
+        {
+            ERROR_MSG("Frame Graph", "Cyclic dependencies of modules, frame graph not compiled.")
+            m_Order.clear();
+            m_bCompiled = false;
+            return false;
+        }
+        Done[nNext] = true;
+        m_Order.push_back(nNext);
+        for (const auto nConsumer : m_Nodes[nNext].Consumers) --Incoming[nConsumer];
+    }
+
+    DOM_DEV(
+        DEBUG_BLK(
+            std::string strOrder;
+            for (const auto nNode : m_Order) strOrder += " " + m_Nodes[nNode].strName;
+            DEBUG_MSG("Frame Graph", "Order of modules:" << strOrder)
+        )
+    )
+
+    m_bCompiled = true;
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Submits the next frame of all modules
+///
+/// Returns as soon as less than the maximum number of frames are in flight,
+/// thus, frames of different modules overlap.
+///
+/// A module stopping is reported once, hence, processing can be resumed.
+///
+/// \return Continue? False if a module stopped processing since the last
+///         call or graph is invalid.
+///
+////////////////////////////////////////////////////////////////////////////////
+bool CFrameGraph::processFrame()
+{
+    METHOD_ENTRY("CFrameGraph::processFrame")
+
+    if (!m_bCompiled && !this->compile()) return false;
+
+    // Calls of frames still in flight are journaled with the frame submitted
+    if (m_pComInterface != nullptr) m_pComInterface->getJournal()->setFrame(m_nFrame);
+
+    using namespace std::chrono;
+    const auto Start = steady_clock::now();
+
+    std::vector<JobPtrType> Jobs(m_Nodes.size());
+    for (const auto nNode : m_Order)
+    {
+        const FrameGraphNode& Node = m_Nodes[nNode];
+        IThreadModule* const pModule = Node.pModule;
+        CComInterface* const pComInterface = m_pComInterface;
+        CWriterQueue* const pWriterQueue = Node.pWriterQueue;
+
+        Jobs[nNode] = m_pJobSystem->createJob([this, pModule, pComInterface, pWriterQueue]
+        {
+            if (pWriterQueue != nullptr)
+                pComInterface->callWriters(pWriterQueue);
+            const auto StartModule = steady_clock::now();
+            if (!pModule->processFrame()) m_bStop = true;
+            pModule->recordFrame(duration<double>(steady_clock::now() - StartModule).count(), 0.0);
+        });
+
+        // Read after write within frame
+        for (const auto nProducer : Node.Producers)
+            m_pJobSystem->addDependency(Jobs[nNode], Jobs[nProducer]);
+
+        if (!m_JobsLast.empty())
+        {
+            // Module's frame before
+            m_pJobSystem->addDependency(Jobs[nNode], m_JobsLast[nNode]);
+
+            // Write after read of frame before
+            for (const auto nConsumer : Node.Consumers)
+                m_pJobSystem->addDependency(Jobs[nNode], m_JobsLast[nConsumer]);
+        }
+    }
+
+    JobPtrType pFrame = m_pJobSystem->createJob([this, Start]
+    {
+        m_fLatency.store(duration<double>(steady_clock::now() - Start).count(), std::memory_order_relaxed);
+    });
+    for (const auto& pJob : Jobs) m_pJobSystem->addDependency(pFrame, pJob);
+
+    for (const auto nNode : m_Order) m_pJobSystem->submit(Jobs[nNode]);
+    m_pJobSystem->submit(pFrame);
+
+    m_JobsLast = std::move(Jobs);
+    m_FramesInFlight.push_back(pFrame);
+    ++m_nFrame;
+
+    while (int(m_FramesInFlight.size()) >= m_nFramesInFlight)
+    {
+        m_pJobSystem->wait(m_FramesInFlight.front());
+        m_FramesInFlight.pop_front();
+    }
+
+    return !m_bStop.exchange(false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Sets maximum number of frames processed at the same time
+///
+/// One frame in flight means no pipelining, i.e. processFrame blocks until
+/// the frame is finished.
+///
+/// \param _nFrames Maximum number of frames in flight
+///
+////////////////////////////////////////////////////////////////////////////////
+void CFrameGraph::setFramesInFlight(const int _nFrames)
+{
+    METHOD_ENTRY("CFrameGraph::setFramesInFlight")
+    m_nFramesInFlight = std::max(1, _nFrames);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Waits until all frames in flight are finished
+///
+////////////////////////////////////////////////////////////////////////////////
+void CFrameGraph::waitForFrames()
+{
+    METHOD_ENTRY("CFrameGraph::waitForFrames")
+
+    while (!m_FramesInFlight.empty())
+    {
+        m_pJobSystem->wait(m_FramesInFlight.front());
+        m_FramesInFlight.pop_front();
+    }
+}
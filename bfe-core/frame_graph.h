@@ -0,0 +1,210 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       frame_graph.h
+/// \brief      Prototype of class "CFrameGraph"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-15
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef FRAME_GRAPH_H
+#define FRAME_GRAPH_H
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "log.h"
+#include "job_system.h"
+#include "thread_module.h"
+
+/// BFEngine namespace
+namespace bfe
+{
+
+//--- Constants --------------------------------------------------------------//
+constexpr int FRAME_GRAPH_FRAMES_IN_FLIGHT_DEFAULT = 2; ///< Default number of pipelined frames
+
+class CComInterface;
+class CWriterQueue;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Module of frame graph with the resources it produces and consumes
+///
+////////////////////////////////////////////////////////////////////////////////
+struct FrameGraphNode
+{
+    std::string                 strName;            ///< Name of module
+    IThreadModule*              pModule;            ///< Module processing frames
+    std::vector<std::string>    Produces;           ///< Resources written by module
+    std::vector<std::string>    Consumes;           ///< Resources read by module
+    std::string                 strWriterDomain;    ///< Writer queue flushed before frame, none if empty
+    CWriterQueue*               pWriterQueue;       ///< Writer queue, resolved when compiled
+
+    std::vector<int>            Producers;          ///< Nodes producing consumed resources
+    std::vector<int>            Consumers;          ///< Nodes consuming produced resources
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Schedules frames of modules by the resources they share
+///
+/// Modules declare which resources they produce and consume, e.g.
+/// input events -> Lua update -> simulation -> render snapshot -> render.
+/// Each frame, all modules are run as jobs of the given job system:
+///  - Within a frame, a consumer starts after all producers of its resources.
+///  - A module starts after its frame before.
+///  - A producer starts after all consumers of its resources in the frame
+///    before, thus data isn't overwritten while still being read.
+///
+/// Several frames are in flight at the same time. Hence, frame N+1 of the
+/// simulation runs while frame N is rendered from a snapshot, keeping cores
+/// busy and latency from input to render low.
+///
+/// The frequencies of the modules are not used, the caller paces the frames.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CFrameGraph
+{
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        explicit CFrameGraph(CJobSystem* const, CComInterface* const = nullptr);
+        ~CFrameGraph();
+
+        CFrameGraph(const CFrameGraph&) = delete;
+        CFrameGraph& operator=(const CFrameGraph&) = delete;
+
+        //--- Constant methods -----------------------------------------------//
+        std::uint64_t                       getFrame() const;
+        int                                 getFramesInFlight() const;
+        double                              getLatency() const;
+        const std::vector<FrameGraphNode>&  getNodes() const;
+        const std::vector<int>&             getOrder() const;
+
+        //--- Methods --------------------------------------------------------//
+        bool addModule(const std::string&, IThreadModule* const,
+                       const std::vector<std::string>&,
+                       const std::vector<std::string>&,
+                       const std::string& = "");
+        bool compile();
+        bool processFrame();
+        void setFramesInFlight(const int);
+        void waitForFrames();
+
+    private:
+
+        //--- Variables [private] --------------------------------------------//
+        CJobSystem*                 m_pJobSystem;       ///< Job system executing modules
+        CComInterface*              m_pComInterface;    ///< Com interface for writer queues
+
+        std::vector<FrameGraphNode> m_Nodes;            ///< Modules of graph
+        std::vector<int>            m_Order;            ///< Nodes in topological order
+        bool                        m_bCompiled = false;///< Indicates that dependencies are resolved
+
+        std::vector<JobPtrType>     m_JobsLast;         ///< Jobs of nodes of latest frame
+        std::deque<JobPtrType>      m_FramesInFlight;   ///< Jobs finishing the frames in flight
+        int                         m_nFramesInFlight = FRAME_GRAPH_FRAMES_IN_FLIGHT_DEFAULT; ///< Maximum frames in flight
+        std::uint64_t               m_nFrame = 0u;      ///< Number of frames submitted
+
+        std::atomic<double>         m_fLatency{0.0};    ///< Time from submission to finish of latest frame
+        std::atomic_bool            m_bStop{false};     ///< Indicates that a module stopped processing
+};
+
+//--- Implementation is done here for inline optimisation --------------------//
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns number of frames submitted
+///
+/// \return Number of frames
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint64_t CFrameGraph::getFrame() const
+{
+    METHOD_ENTRY("CFrameGraph::getFrame")
+    return m_nFrame;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns maximum number of frames processed at the same time
+///
+/// \return Maximum number of frames in flight
+///
+////////////////////////////////////////////////////////////////////////////////
+inline int CFrameGraph::getFramesInFlight() const
+{
+    METHOD_ENTRY("CFrameGraph::getFramesInFlight")
+    return m_nFramesInFlight;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns time from submission to finish of the latest finished frame
+///
+/// \return Latency in seconds
+///
+////////////////////////////////////////////////////////////////////////////////
+inline double CFrameGraph::getLatency() const
+{
+    METHOD_ENTRY("CFrameGraph::getLatency")
+    return m_fLatency.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns modules of the graph
+///
+/// \return Nodes of graph
+///
+////////////////////////////////////////////////////////////////////////////////
+inline const std::vector<FrameGraphNode>& CFrameGraph::getNodes() const
+{
+    METHOD_ENTRY("CFrameGraph::getNodes")
+    return m_Nodes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns indices of nodes in order of execution, valid after compile
+///
+/// \return Indices of nodes in topological order
+///
+////////////////////////////////////////////////////////////////////////////////
+inline const std::vector<int>& CFrameGraph::getOrder() const
+{
+    METHOD_ENTRY("CFrameGraph::getOrder")
+    return m_Order;
+}
+
+} // namespace bfe
+
+#endif // FRAME_GRAPH_H
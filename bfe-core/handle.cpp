@@ -33,19 +33,40 @@
 using namespace bfe;
 
 CHandleManager CHandleBase::s_HandleManager;
+CEpochManager  CHandleBase::s_EpochManager;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns epoch manager used for retiring handles
+///
+/// Threads accessing handled objects register here and announce quiescent
+/// states (see \ref IThreadModule::run).
+///
+/// \return Epoch manager
+///
+////////////////////////////////////////////////////////////////////////////////
+CEpochManager& CHandleBase::getEpochManager()
+{
+    METHOD_ENTRY("CHandleBase::getEpochManager")
+    return s_EpochManager;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Returns list (here: deque) of free handles
 ///
 /// This method is mainly used for informatory purposes, debugging, or
-/// statistics.
+/// statistics. A copy is returned since handles might be changed concurrently.
 /// Delegate to \ref CHandleManager::getFreeHandles .
 ///
+/// \note Formerly, a pointer to the internal list was returned. Handles are
+///       stored in lock-free slots now, thus, callers use the copy instead,
+///       e.g. getFreeHandles().size() instead of getFreeHandles()->size().
+///
 /// \return List of free handles
 ///
 ////////////////////////////////////////////////////////////////////////////////
-const std::deque<std::uint32_t>* CHandleBase::getFreeHandles()
+std::deque<std::uint32_t> CHandleBase::getFreeHandles()
 {
     METHOD_ENTRY("CHandleBase::getFreeHandles")
     return s_HandleManager.getFreeHandles();
@@ -58,13 +79,16 @@ const std::deque<std::uint32_t>* CHandleBase::getFreeHandles()
 /// The handle index (id) refers to the vectors index (offset by 1 to mark
 /// zero as invalid handle, so vector[0] => handle id 1.
 /// This method is mainly used for informatory purposes, debugging, or
-/// statistics.
+/// statistics. A copy is returned since handles might be changed concurrently.
 /// Delegate to \ref CHandleManager::getHandleMap .
 ///
+/// \note Formerly, a pointer to the internal map was returned. Handles are
+///       stored in lock-free slots now, thus, callers use the copy instead.
+///
 /// \return Map of handled pointers
 ///
 ////////////////////////////////////////////////////////////////////////////////
-const std::vector<HandleMapEntry>* CHandleBase::getHandleMap()
+std::vector<HandleMapEntry> CHandleBase::getHandleMap()
 {
     METHOD_ENTRY("CHandleBase::getHandleMap")
     return s_HandleManager.getHandleMap();
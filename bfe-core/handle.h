@@ -33,8 +33,10 @@
 
 //--- Standard header --------------------------------------------------------//
 #include <cstdint>
+#include <functional>
 
 //--- Program header ---------------------------------------------------------//
+#include "epoch_manager.h"
 #include "handle_manager.h"
 
 /// BFEngine namespace
@@ -48,17 +50,21 @@ namespace bfe
 /// Since CHandle is a templated class, a static member would be instanciated
 /// for each template parameter. Therefore, this helper instanciates exactly one
 /// Handle manager that all CHandle instanciation will inherit from.
+/// The same holds for the epoch manager, deferring reclamation of retired
+/// handles.
 ///
 ////////////////////////////////////////////////////////////////////////////////
 class CHandleBase
 {
     public:
-        static const std::deque<std::uint32_t>*     getFreeHandles();
-        static const std::vector<HandleMapEntry>*   getHandleMap();
+        static std::deque<std::uint32_t>     getFreeHandles();
+        static std::vector<HandleMapEntry>   getHandleMap();
+        static CEpochManager&                getEpochManager();
     
     protected:
         //--- Variables [static, private] ------------------------------------//
         static CHandleManager   s_HandleManager; ///< Static handle manager instance
+        static CEpochManager    s_EpochManager;  ///< Static epoch manager instance
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -88,6 +94,8 @@ class CHandle : public CHandleBase
         
         //--- Methods --------------------------------------------------------//
         bool remove();
+        bool retire();
+        bool retire(const std::function<void(T*)>&);
         void update(T* const);
         
     private:
@@ -108,7 +116,6 @@ inline CHandle<T>::CHandle(T* _ptr)
 {
     METHOD_ENTRY("CHandle::CHandle")
     m_ID = s_HandleManager.add(_ptr);
-    std::cout << "CHandle::CHandle(T* _ptr) calls CHandleManager::add" << std::endl;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -129,7 +136,7 @@ inline bool CHandle<T>::isValid() const
 ///
 /// \brief Returns pointer which is represented by handle
 ///
-/// \return Pointer represented by handle
+/// \return Pointer represented by handle, nullptr if handle is stale
 ///
 ////////////////////////////////////////////////////////////////////////////////
 template<class T>
@@ -143,6 +150,8 @@ inline T* CHandle<T>::operator->() const
 ///
 /// \brief Derefences pointer returning the content/value
 ///
+/// The handle must be valid, a stale handle is caught by assertion.
+///
 /// \return Content/value referenced by handle
 ///
 ////////////////////////////////////////////////////////////////////////////////
@@ -150,7 +159,9 @@ template<class T>
 inline T& CHandle<T>::operator*() const
 {
     METHOD_ENTRY("CHandle::operator*")
-    return *s_HandleManager.get<T>(m_ID);
+    T* const pEntry = s_HandleManager.get<T>(m_ID);
+    BFE_ASSERT(pEntry != nullptr);
+    return *pEntry;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -161,7 +172,7 @@ inline T& CHandle<T>::operator*() const
 /// typically not needed. If used to copy the pointer, only use it locally and
 /// with caution, if you definitely know about the pointers validity.
 ///
-/// \return Pointer represented by handle
+/// \return Pointer represented by handle, nullptr if handle is stale
 ///
 ////////////////////////////////////////////////////////////////////////////////
 template<class T>
@@ -186,6 +197,62 @@ inline bool CHandle<T>::remove()
     return CHandleBase::s_HandleManager.remove(m_ID);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Retires handle, all instances of this handle will become invalid.
+///
+/// In contrast to \ref remove, the slot of the handle is not reused before
+/// all threads registered at the epoch manager passed a quiescent state.
+///
+/// \return Success?
+///
+////////////////////////////////////////////////////////////////////////////////
+template<class T>
+inline bool CHandle<T>::retire()
+{
+    METHOD_ENTRY("CHandle::retire")
+    
+    if (!CHandleBase::s_HandleManager.invalidate(m_ID)) return false;
+    
+    const HandleID ID = m_ID;
+    CHandleBase::s_EpochManager.retire([ID]{CHandleBase::s_HandleManager.release(ID);});
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Retires handle and the object it represents, all instances of this
+///        handle will become invalid.
+///
+/// In contrast to \ref remove, the object is only disposed and the slot
+/// reused when all threads registered at the epoch manager passed a
+/// quiescent state. Hence, these threads might still use raw pointers
+/// until then.
+///
+/// \param _Dispose Function to dispose the object, e.g. deleting it
+///
+/// \return Success?
+///
+////////////////////////////////////////////////////////////////////////////////
+template<class T>
+inline bool CHandle<T>::retire(const std::function<void(T*)>& _Dispose)
+{
+    METHOD_ENTRY("CHandle::retire")
+    
+    // Default handles don't represent an object. If the handle is released
+    // or changed concurrently, invalidation fails and the pointer is not used.
+    T* const pObject = (m_ID.C.Index > 0u) ? CHandleBase::s_HandleManager.get<T>(m_ID) : nullptr;
+    if (!CHandleBase::s_HandleManager.invalidate(m_ID)) return false;
+    
+    const HandleID ID = m_ID;
+    CHandleBase::s_EpochManager.retire([ID, pObject, _Dispose]
+    {
+        _Dispose(pObject);
+        CHandleBase::s_HandleManager.release(ID);
+    });
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Updates handle with new pointer, all other instances of this handle 
@@ -199,12 +266,10 @@ inline void CHandle<T>::update(T* const _ptr)
     if (m_ID.C.Index > 0u)
     {
         CHandleBase::s_HandleManager.update<T>(m_ID, _ptr);
-        std::cout << "CHandle::update calls s_HandleManager::update" << std::endl;
     }
     else
     {
         m_ID = CHandleBase::s_HandleManager.add(_ptr);
-        std::cout << "CHandle::update calls s_HandleManager::add" << std::endl;
     }
 }
 
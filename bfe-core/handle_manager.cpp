@@ -30,49 +30,201 @@
 
 #include "handle_manager.h"
 
+//--- Standard header --------------------------------------------------------//
+#include <algorithm>
+
 using namespace bfe;
 
+/// Mask for the index part of the free list head
+constexpr std::uint64_t HANDLE_FREE_INDEX_MASK = 0x00000000FFFFFFFFull;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Constructor, allocating the handle map
+///
+////////////////////////////////////////////////////////////////////////////////
+CHandleManager::CHandleManager() : m_FreeHead(0u),
+                                   m_nSize(0u)
+{
+    METHOD_ENTRY("CHandleManager::CHandleManager")
+    CTOR_CALL("CHandleManager::CHandleManager")
+
+    m_pCounters = new std::atomic<HandleCounterType>[MAX_HANDLES];
+    MEM_ALLOC("std::atomic<HandleCounterType>")
+    m_pEntries = new std::atomic<void*>[MAX_HANDLES];
+    MEM_ALLOC("std::atomic<void*>")
+    m_pNextFree = new std::atomic<std::uint32_t>[MAX_HANDLES];
+    MEM_ALLOC("std::atomic<std::uint32_t>")
+    
+    for (auto i=0u; i<MAX_HANDLES; ++i)
+    {
+        m_pCounters[i].store(0u, std::memory_order_relaxed);
+        m_pEntries[i].store(nullptr, std::memory_order_relaxed);
+        m_pNextFree[i].store(0u, std::memory_order_relaxed);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Destructor, freeing the handle map
+///
+////////////////////////////////////////////////////////////////////////////////
+CHandleManager::~CHandleManager()
+{
+    METHOD_ENTRY("CHandleManager::~CHandleManager")
+    DTOR_CALL("CHandleManager::~CHandleManager")
+
+    delete[] m_pCounters;
+    MEM_FREED("std::atomic<HandleCounterType>")
+    m_pCounters = nullptr;
+    delete[] m_pEntries;
+    MEM_FREED("std::atomic<void*>")
+    m_pEntries = nullptr;
+    delete[] m_pNextFree;
+    MEM_FREED("std::atomic<std::uint32_t>")
+    m_pNextFree = nullptr;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Add new pointer to map and create unique handle id
 ///
+/// Free handles are reused first. If there are none, a new slot is taken
+/// from the handle map.
+///
 /// \param _ptr Pointer to be handled by unique handle id
 ///
-/// \return Unique handle id
+/// \return Unique handle id, index is 0 (invalid) if map is full
 ///
 ////////////////////////////////////////////////////////////////////////////////
 HandleID CHandleManager::add(void* const _ptr)
 {
     METHOD_ENTRY("CHandleManager::add")
-    
+
     BFE_ASSERT(_ptr != nullptr);
-    
-    HandleMapEntry HMap;
-    HMap.pEntry = _ptr;
-    
-    if (m_HandlesFree.size() > 0)
+
+    std::uint32_t nIndex = this->popFree();
+    if (nIndex == 0u && this->reserveSlots(1u, &nIndex) == 0u)
     {
-        std::uint32_t IndexFree = m_HandlesFree.front();
-        m_HandlesFree.pop_front();
-        HMap.ID.C.Index = IndexFree;
-        HMap.ID.C.Counter = m_HandleMap[IndexFree-1].ID.C.Counter+1;
-        m_HandleMap[IndexFree-1] = HMap;
+        ERROR_MSG("Handle Manager", "Maximum number of handles (" << MAX_HANDLES << ") reached.")
+        return HandleID();
     }
-    else
+    return this->activateSlot(nIndex, _ptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Add multiple pointers to map and create unique handle ids
+///
+/// In contrast to calling \ref add for each pointer, free handles are taken
+/// from the free list at once and new slots are reserved as one contiguous
+/// range. Hence, there is only a constant number of atomic operations per
+/// batch (besides setting the slots), unless other threads interfere.
+///
+/// \param _ppEntries Pointers to be handled by unique handle ids
+/// \param _nCount Number of pointers
+/// \param _pIDs Array (of size _nCount) receiving the unique handle ids,
+///              index is 0 (invalid) for all pointers exceeding the map
+///
+/// \return Number of pointers added
+///
+////////////////////////////////////////////////////////////////////////////////
+std::uint32_t CHandleManager::addBatch(void* const* const _ppEntries,
+                                       const std::uint32_t _nCount,
+                                       HandleID* const _pIDs)
+{
+    METHOD_ENTRY("CHandleManager::addBatch")
+
+    std::uint32_t nAdded = 0u;
+
+    // Reuse free handles first
+    std::uint32_t nFree = 0u;
+    std::uint32_t nIndex = this->popFreeChain(_nCount, &nFree);
+    for (auto i=0u; i<nFree; ++i)
     {
-        HMap.ID.C.Index = m_HandleMap.size()+1;
-        HMap.ID.C.Counter = 1;
-        m_HandleMap.push_back(HMap);
+        const std::uint32_t nNext = m_pNextFree[nIndex-1].load(std::memory_order_relaxed);
+        _pIDs[nAdded] = this->activateSlot(nIndex, _ppEntries[nAdded]);
+        ++nAdded;
+        nIndex = nNext;
     }
-    
-    return HMap.ID;
+
+    // Take remaining handles from unused slots
+    if (nAdded < _nCount)
+    {
+        std::uint32_t nFirst = 0u;
+        const std::uint32_t nReserved = this->reserveSlots(_nCount-nAdded, &nFirst);
+        for (auto i=0u; i<nReserved; ++i)
+        {
+            _pIDs[nAdded] = this->activateSlot(nFirst+i, _ppEntries[nAdded]);
+            ++nAdded;
+        }
+    }
+    if (nAdded < _nCount)
+    {
+        ERROR_MSG("Handle Manager", "Maximum number of handles (" << MAX_HANDLES << ") reached, "
+                                    << _nCount-nAdded << " of " << _nCount << " not added.")
+        for (auto i=nAdded; i<_nCount; ++i) _pIDs[i] = HandleID();
+    }
+    return nAdded;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Invalidates handle, all instances of this handle will become
+///        invalid. The slot is not reused before it is released.
+///
+/// Only the current (valid) handle can be invalidated. If the handle is
+/// stale, e.g. because it was removed concurrently, nothing happens.
+///
+/// \param _ID Handle Id to be invalidated
+///
+/// \return Success?
+///
+////////////////////////////////////////////////////////////////////////////////
+bool CHandleManager::invalidate(const HandleID _ID)
+{
+    METHOD_ENTRY("CHandleManager::invalidate")
+
+    if (_ID.C.Index <= m_nSize.load(std::memory_order_acquire) &&
+        _ID.C.Index != 0)
+    {
+        HandleCounterType nCounter = _ID.C.Counter;
+        if (m_pCounters[_ID.C.Index-1].compare_exchange_strong(nCounter,
+                HandleCounterType((nCounter+1u) & HANDLE_COUNTER_MASK), std::memory_order_acq_rel))
+        {
+            m_pEntries[_ID.C.Index-1].store(nullptr, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    WARNING_MSG("Handle Manager", "Handle " << _ID.C.Index << " not valid.")
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Releases slot of an invalidated handle for reuse
+///
+/// \param _ID Handle Id, that was successfully invalidated before
+///
+////////////////////////////////////////////////////////////////////////////////
+void CHandleManager::release(const HandleID _ID)
+{
+    METHOD_ENTRY("CHandleManager::release")
+
+    BFE_ASSERT(_ID.C.Index != 0u && _ID.C.Index <= m_nSize.load(std::memory_order_acquire));
+    BFE_ASSERT(!this->isValid(_ID));
+
+    this->pushFree(_ID.C.Index);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ///
-/// \brief Removes handle from handle manager, all other instances of this 
+/// \brief Removes handle from handle manager, all other instances of this
 ///        handle will become invalid.
 ///
+/// This is equal to \ref invalidate followed by \ref release, the slot is
+/// reused immediately.
+///
 /// \param _ID Handle Id to be removed
 ///
 /// \return Success?
@@ -81,21 +233,63 @@ HandleID CHandleManager::add(void* const _ptr)
 bool CHandleManager::remove(const HandleID _ID)
 {
     METHOD_ENTRY("CHandleManager::remove")
-    
-    if (_ID.C.Index <= m_HandleMap.size() &&
-        _ID.C.Index != 0)
+
+    if (this->invalidate(_ID))
     {
-        m_HandleMap[_ID.C.Index-1].ID.C.Index = 0;
-        m_HandleMap[_ID.C.Index-1].ID.C.Counter += 1;
-        m_HandleMap[_ID.C.Index-1].pEntry = nullptr;
-        m_HandlesFree.push_back(_ID.C.Index);
+        this->pushFree(_ID.C.Index);
         return true;
     }
-    else
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Removes multiple handles from handle manager, all other instances
+///        of these handles will become invalid.
+///
+/// In contrast to calling \ref remove for each handle, all removed handles
+/// are linked locally and returned to the free list at once.
+///
+/// \param _pIDs Handle ids to be removed
+/// \param _nCount Number of handle ids
+///
+/// \return Number of handles removed
+///
+////////////////////////////////////////////////////////////////////////////////
+std::uint32_t CHandleManager::removeBatch(const HandleID* const _pIDs, const std::uint32_t _nCount)
+{
+    METHOD_ENTRY("CHandleManager::removeBatch")
+
+    const std::uint32_t nSize = m_nSize.load(std::memory_order_acquire);
+
+    std::uint32_t nFirst = 0u;
+    std::uint32_t nLast = 0u;
+    std::uint32_t nRemoved = 0u;
+
+    for (auto i=0u; i<_nCount; ++i)
     {
-        WARNING_MSG("Handle Manager", "Handle " << _ID.C.Index << " not valid.")
-        return false;
+        const std::uint32_t nIndex = _pIDs[i].C.Index;
+        if (nIndex != 0u && nIndex <= nSize)
+        {
+            HandleCounterType nCounter = _pIDs[i].C.Counter;
+            if (m_pCounters[nIndex-1].compare_exchange_strong(nCounter,
+                    HandleCounterType((nCounter+1u) & HANDLE_COUNTER_MASK), std::memory_order_acq_rel))
+            {
+                m_pEntries[nIndex-1].store(nullptr, std::memory_order_relaxed);
+                m_pNextFree[nIndex-1].store(nFirst, std::memory_order_relaxed);
+                if (nFirst == 0u) nLast = nIndex;
+                nFirst = nIndex;
+                ++nRemoved;
+            }
+        }
     }
+    if (nFirst != 0u) this->pushFreeChain(nFirst, nLast);
+
+    if (nRemoved < _nCount)
+    {
+        WARNING_MSG("Handle Manager", _nCount-nRemoved << " of " << _nCount << " handles not valid.")
+    }
+    return nRemoved;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -103,15 +297,30 @@ bool CHandleManager::remove(const HandleID _ID)
 /// \brief Returns list (here: deque) of free handles
 ///
 /// This method is mainly used for informatory purposes, debugging, or
-/// statistics.
+/// statistics. The list is a copy and might not be consistent if handles are
+/// added or removed concurrently.
+///
+/// \note Formerly, a pointer to the internal list was returned. Handles are
+///       stored in lock-free slots now, thus, callers use the copy instead,
+///       e.g. getFreeHandles().size() instead of getFreeHandles()->size().
 ///
 /// \return List of free handles
 ///
 ////////////////////////////////////////////////////////////////////////////////
-const std::deque<std::uint32_t>* CHandleManager::getFreeHandles()
+std::deque<std::uint32_t> CHandleManager::getFreeHandles() const
 {
     METHOD_ENTRY("CHandleManager::getFreeHandles")
-    return &m_HandlesFree;
+
+    std::deque<std::uint32_t> FreeHandles;
+
+    const std::uint32_t nSize = m_nSize.load(std::memory_order_acquire);
+    std::uint32_t nIndex = std::uint32_t(m_FreeHead.load(std::memory_order_acquire) & HANDLE_FREE_INDEX_MASK);
+    while (nIndex != 0u && FreeHandles.size() < nSize)
+    {
+        FreeHandles.push_back(nIndex);
+        nIndex = m_pNextFree[nIndex-1].load(std::memory_order_relaxed);
+    }
+    return FreeHandles;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -119,15 +328,188 @@ const std::deque<std::uint32_t>* CHandleManager::getFreeHandles()
 /// \brief Returns map (here: vector) of handled pointers
 ///
 /// The handle index (id) refers to the vectors index (offset by 1 to mark
-/// zero as invalid handle, so vector[0] => handle id 1.
+/// zero as invalid handle, so vector[0] => handle id 1. The index of removed
+/// (free) handles is set to zero.
 /// This method is mainly used for informatory purposes, debugging, or
-/// statistics.
+/// statistics. The map is a copy and might not be consistent if handles are
+/// added or removed concurrently.
+///
+/// \note Formerly, a pointer to the internal map was returned. Handles are
+///       stored in lock-free slots now, thus, callers use the copy instead.
 ///
 /// \return Map of handled pointers
 ///
 ////////////////////////////////////////////////////////////////////////////////
-const std::vector<HandleMapEntry>* CHandleManager::getHandleMap()
+std::vector<HandleMapEntry> CHandleManager::getHandleMap() const
 {
     METHOD_ENTRY("CHandleManager::getHandleMap")
-    return &m_HandleMap;
+
+    const std::uint32_t nSize = m_nSize.load(std::memory_order_acquire);
+
+    std::vector<HandleMapEntry> HandleMap(nSize);
+    for (auto i=0u; i<nSize; ++i)
+    {
+        HandleMap[i].pEntry = m_pEntries[i].load(std::memory_order_acquire);
+        HandleMap[i].ID.C.Counter = m_pCounters[i].load(std::memory_order_acquire);
+        if (HandleMap[i].pEntry != nullptr) HandleMap[i].ID.C.Index = i+1;
+    }
+    return HandleMap;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Sets pointer of an exclusively owned slot and makes it valid
+///
+/// \param _nIndex Index of slot
+/// \param _ptr Pointer to be handled by slot
+///
+/// \return Unique handle id
+///
+////////////////////////////////////////////////////////////////////////////////
+HandleID CHandleManager::activateSlot(const std::uint32_t _nIndex, void* const _ptr)
+{
+    METHOD_ENTRY_QUIET("CHandleManager::activateSlot")
+
+    // Set pointer first, the counter increment publishes it
+    m_pEntries[_nIndex-1].store(_ptr, std::memory_order_relaxed);
+
+    const HandleCounterType nCounter = HandleCounterType(
+        (m_pCounters[_nIndex-1].load(std::memory_order_relaxed)+1u) & HANDLE_COUNTER_MASK);
+    m_pCounters[_nIndex-1].store(nCounter, std::memory_order_release);
+
+    HandleID ID;
+    ID.C.Index = _nIndex;
+    ID.C.Counter = nCounter;
+    return ID;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Takes a handle index from the free list
+///
+/// \return Free handle index, 0 if there is none
+///
+////////////////////////////////////////////////////////////////////////////////
+std::uint32_t CHandleManager::popFree()
+{
+    METHOD_ENTRY("CHandleManager::popFree")
+
+    std::uint64_t nHead = m_FreeHead.load(std::memory_order_acquire);
+    while ((nHead & HANDLE_FREE_INDEX_MASK) != 0u)
+    {
+        const std::uint32_t nIndex = std::uint32_t(nHead & HANDLE_FREE_INDEX_MASK);
+        const std::uint32_t nNext  = m_pNextFree[nIndex-1].load(std::memory_order_relaxed);
+        const std::uint64_t nNew   = (((nHead >> 32) + 1u) << 32) | nNext;
+        if (m_FreeHead.compare_exchange_weak(nHead, nNew, std::memory_order_acq_rel,
+                                                          std::memory_order_acquire))
+        {
+            return nIndex;
+        }
+    }
+    return 0u;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Takes multiple handle indices from the free list
+///
+/// The list is walked up to the requested number of indices and cut off
+/// there. Since every change of the free list alters the tag of its head,
+/// the walked list is still valid if its head is unchanged. The returned
+/// indices are linked by their next free indices.
+///
+/// \param _nMax Maximum number of indices to take
+/// \param _pnCount Number of indices taken
+///
+/// \return First free handle index, 0 if there is none
+///
+////////////////////////////////////////////////////////////////////////////////
+std::uint32_t CHandleManager::popFreeChain(const std::uint32_t _nMax, std::uint32_t* const _pnCount)
+{
+    METHOD_ENTRY("CHandleManager::popFreeChain")
+
+    std::uint64_t nHead = m_FreeHead.load(std::memory_order_acquire);
+    while ((nHead & HANDLE_FREE_INDEX_MASK) != 0u && _nMax > 0u)
+    {
+        const std::uint32_t nFirst = std::uint32_t(nHead & HANDLE_FREE_INDEX_MASK);
+        std::uint32_t nNext  = nFirst;
+        std::uint32_t nCount = 0u;
+        while (nNext != 0u && nCount < _nMax)
+        {
+            nNext = m_pNextFree[nNext-1].load(std::memory_order_relaxed);
+            ++nCount;
+        }
+        const std::uint64_t nNew = (((nHead >> 32) + 1u) << 32) | nNext;
+        if (m_FreeHead.compare_exchange_weak(nHead, nNew, std::memory_order_acq_rel,
+                                                          std::memory_order_acquire))
+        {
+            *_pnCount = nCount;
+            return nFirst;
+        }
+    }
+    *_pnCount = 0u;
+    return 0u;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns a handle index to the free list
+///
+/// \param _nIndex Handle index to be reused
+///
+////////////////////////////////////////////////////////////////////////////////
+void CHandleManager::pushFree(const std::uint32_t _nIndex)
+{
+    METHOD_ENTRY("CHandleManager::pushFree")
+    this->pushFreeChain(_nIndex, _nIndex);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns a linked list of handle indices to the free list
+///
+/// \param _nFirst First handle index of list
+/// \param _nLast Last handle index of list, will be linked to current list
+///
+////////////////////////////////////////////////////////////////////////////////
+void CHandleManager::pushFreeChain(const std::uint32_t _nFirst, const std::uint32_t _nLast)
+{
+    METHOD_ENTRY("CHandleManager::pushFreeChain")
+
+    std::uint64_t nHead = m_FreeHead.load(std::memory_order_relaxed);
+    std::uint64_t nNew;
+    do
+    {
+        m_pNextFree[_nLast-1].store(std::uint32_t(nHead & HANDLE_FREE_INDEX_MASK),
+                                    std::memory_order_relaxed);
+        nNew = (((nHead >> 32) + 1u) << 32) | _nFirst;
+    } while (!m_FreeHead.compare_exchange_weak(nHead, nNew, std::memory_order_release,
+                                                            std::memory_order_relaxed));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reserves a contiguous range of unused slots
+///
+/// \param _nCount Number of slots requested
+/// \param _pnFirst Index of first reserved slot
+///
+/// \return Number of slots reserved, might be less than requested if map is
+///         full
+///
+////////////////////////////////////////////////////////////////////////////////
+std::uint32_t CHandleManager::reserveSlots(const std::uint32_t _nCount, std::uint32_t* const _pnFirst)
+{
+    METHOD_ENTRY("CHandleManager::reserveSlots")
+
+    std::uint32_t nSize = m_nSize.load(std::memory_order_relaxed);
+    std::uint32_t nReserved = 0u;
+    do
+    {
+        nReserved = std::min(_nCount, MAX_HANDLES-nSize);
+        if (nReserved == 0u) return 0u;
+    } while (!m_nSize.compare_exchange_weak(nSize, nSize+nReserved, std::memory_order_acq_rel,
+                                                                    std::memory_order_relaxed));
+    *_pnFirst = nSize+1u;
+    return nReserved;
 }
@@ -32,11 +32,13 @@
 #define HANDLE_MANAGER_H
 
 //--- Standard header --------------------------------------------------------//
+#include <atomic>
 #include <cstdint>
 #include <deque>
 #include <vector>
 
 //--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
 #include "log.h"
 
 //--- Misc header ------------------------------------------------------------//
@@ -47,29 +49,62 @@ namespace bfe
 
 constexpr std::uint32_t MAX_HANDLES = 32768;
 
+/// Type of handle counters
+typedef std::uint16_t HandleCounterType;
+
+#ifdef BFE_HANDLE_COMPACT
+    /// Type of raw handle value
+    typedef std::uint32_t HandleRawType;
+
+    constexpr std::uint32_t HANDLE_INDEX_BITS   = BFE_HANDLE_INDEX_BITS;        ///< Bits of handle index
+    constexpr std::uint32_t HANDLE_COUNTER_BITS = 32u - BFE_HANDLE_INDEX_BITS;  ///< Bits of handle counter
+
+    static_assert(HANDLE_COUNTER_BITS <= 16u, "Handle counter is limited to 16 bits.");
+    static_assert(HANDLE_INDEX_BITS < 32u && MAX_HANDLES < (1u << HANDLE_INDEX_BITS),
+                  "Handle index bits too small for maximum number of handles.");
+#else
+    /// Type of raw handle value
+    typedef std::uint64_t HandleRawType;
+
+    constexpr std::uint32_t HANDLE_INDEX_BITS   = 32u;  ///< Bits of handle index
+    constexpr std::uint32_t HANDLE_COUNTER_BITS = 16u;  ///< Bits of handle counter
+#endif
+
+/// Mask to wrap handle counters to the number of bits available
+constexpr HandleCounterType HANDLE_COUNTER_MASK = HandleCounterType((1u << HANDLE_COUNTER_BITS) - 1u);
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Struct defining components of the numeric handle value
 ///
 /// The Index is the actual handle id, the Counter is used to manage stale
-/// handles while the Free component is not used, yet.
+/// handles. In compact mode (\ref BFE_HANDLE_COMPACT), both are packed into
+/// 32 bits, otherwise a 16 bit Free component is not used, yet.
 ///
 ////////////////////////////////////////////////////////////////////////////////
 struct HandleIDComposition
 {
+#ifdef BFE_HANDLE_COMPACT
+    std::uint32_t   Index   : HANDLE_INDEX_BITS;    ///< Actual handle id
+    std::uint32_t   Counter : HANDLE_COUNTER_BITS;  ///< Counter to manage stale handles
+    
+    HandleIDComposition() : Index(0u), Counter(0u) {}
+#else
     std::uint32_t   Index;      ///< Actual handle id
     std::uint16_t   Counter;    ///< Counter to manage stale handles
     std::uint16_t   Free;       ///< Not used, yet
     
     HandleIDComposition() : Index(0u), Counter(0u), Free(0u) {}
+#endif
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief This struct defines the numeric handle value
 ///
-/// The handle id can either be used as raw 64 bit value or allows for access
-/// to individual components given by \ref HandleIDComposition .
+/// The handle id can either be used as raw value (32 bit in compact mode,
+/// 64 bit otherwise) or allows for access to individual components given by
+/// \ref HandleIDComposition .
 ///
 ////////////////////////////////////////////////////////////////////////////////
 struct HandleID
@@ -77,7 +112,7 @@ struct HandleID
     union
     {
         HandleIDComposition  C;     ///< Components of handle id
-        std::uint64_t        Raw;   ///< 64 bit raw value
+        HandleRawType        Raw;   ///< Raw value
     };
     
     HandleID() : Raw(0) {}
@@ -87,6 +122,9 @@ struct HandleID
 ///
 /// \brief Handle map entry for actual mapping from handle to pointer
 ///
+/// This is a plain copy of a handle slot as returned by
+/// \ref CHandleManager::getHandleMap for informatory purposes.
+///
 ////////////////////////////////////////////////////////////////////////////////
 struct HandleMapEntry
 {
@@ -100,6 +138,22 @@ struct HandleMapEntry
 ///
 /// \brief Handle management ensuring unique id's and valid pointers
 ///
+/// The handle manager is thread safe and lock-free. The handle map is
+/// allocated once with a capacity of \ref MAX_HANDLES, hence, slots never
+/// move and may be read while other threads add or remove handles. Access
+/// (\ref get, \ref isValid) only takes atomic loads, stale handles are
+/// detected by the atomic counter of each slot. Removed slots are kept in a lock-free
+/// free list (Treiber stack). Its head stores a tag besides the index to
+/// prevent ABA problems.
+///
+/// Removal can be split into \ref invalidate and \ref release, e.g. to defer
+/// reuse of the slot until no reader holds its pointer any more (see
+/// \ref CEpochManager).
+///
+/// The handle map is stored as structure of arrays: counters, pointers, and
+/// free list links are separate arrays. Validation only touches the densely
+/// packed counters, which are 2 bytes per handle instead of a full entry.
+///
 ////////////////////////////////////////////////////////////////////////////////
 class CHandleManager
 {
@@ -107,26 +161,45 @@ class CHandleManager
     public:
         
         //--- Constructor/Destructor -----------------------------------------//
-        CHandleManager() {m_HandleMap.reserve(MAX_HANDLES);}
+        CHandleManager();
+        ~CHandleManager();
+        
+        CHandleManager(const CHandleManager&) = delete;
+        CHandleManager& operator=(const CHandleManager&) = delete;
    
         //--- Constant Methods -----------------------------------------------//
         bool isValid(const HandleID) const;
+        
+        std::deque<std::uint32_t>   getFreeHandles() const;
+        std::vector<HandleMapEntry> getHandleMap() const;
+        std::uint32_t               getSize() const;
 
         //--- Methods --------------------------------------------------------//
         HandleID                add(void* const);
+        std::uint32_t           addBatch(void* const* const, const std::uint32_t, HandleID* const);
         template<class T> T*    get(const HandleID);
+        bool                    invalidate(const HandleID);
+        void                    release(const HandleID);
         bool                    remove(const HandleID);
+        std::uint32_t           removeBatch(const HandleID* const, const std::uint32_t);
         template<class T> void  update(HandleID&, T* const);
         
-        const std::deque<std::uint32_t>* getFreeHandles();
-        const std::vector<HandleMapEntry>* getHandleMap();
-        
-        
     private:
         
-        //--- Variables [protected] ------------------------------------------//
-        std::vector<HandleMapEntry> m_HandleMap;    ///< Handle map, mapping handle id's to pointers
-        std::deque<std::uint32_t>   m_HandlesFree;  ///< Free handles to be reused
+        //--- Methods [private] ----------------------------------------------//
+        HandleID        activateSlot(const std::uint32_t, void* const);
+        std::uint32_t   popFree();
+        std::uint32_t   popFreeChain(const std::uint32_t, std::uint32_t* const);
+        void            pushFree(const std::uint32_t);
+        void            pushFreeChain(const std::uint32_t, const std::uint32_t);
+        std::uint32_t   reserveSlots(const std::uint32_t, std::uint32_t* const);
+        
+        //--- Variables [private] --------------------------------------------//
+        std::atomic<HandleCounterType>* m_pCounters;    ///< Counter of each slot to detect stale handles
+        std::atomic<void*>*             m_pEntries;     ///< Pointer of each slot represented by handle
+        std::atomic<std::uint32_t>*     m_pNextFree;    ///< Index of next free slot while in free list
+        std::atomic<std::uint64_t>      m_FreeHead;     ///< Head of free handles to be reused (tag | index)
+        std::atomic<std::uint32_t>      m_nSize;        ///< Number of slots used so far
         
 };
 
@@ -135,7 +208,7 @@ class CHandleManager
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Tests given handle for validity
-///ß
+///
 /// \param _ID Handle id to test for validity
 ///
 /// \return Handle valid (true/false)?
@@ -144,16 +217,34 @@ class CHandleManager
 inline bool CHandleManager::isValid(const HandleID _ID) const
 {
     METHOD_ENTRY("CHandleManager::isValid")
-    return (_ID.C.Index && (_ID.C.Counter == m_HandleMap[_ID.C.Index-1].ID.C.Counter));
+    return (_ID.C.Index != 0u && _ID.C.Index <= MAX_HANDLES &&
+            _ID.C.Counter == m_pCounters[_ID.C.Index-1].load(std::memory_order_acquire));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the number of slots used so far
+///
+/// \return Number of slots (valid and free) in handle map
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint32_t CHandleManager::getSize() const
+{
+    METHOD_ENTRY("CHandleManager::getSize")
+    return m_nSize.load(std::memory_order_acquire);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Returns pointer which is represented by handle
 ///
+/// The counter of the slot is compared before and after loading the pointer.
+/// Hence, if the handle is stale, e.g. because it was removed concurrently
+/// and its slot was reused, nullptr is returned instead of another object.
+///
 /// \param _ID Handle id of pointer to be returned
 ///
-/// \return Pointer represented by handle
+/// \return Pointer represented by handle, nullptr if handle is stale
 ///
 ////////////////////////////////////////////////////////////////////////////////
 template<class T>
@@ -161,10 +252,15 @@ inline T* CHandleManager::get(const HandleID _ID)
 {
     METHOD_ENTRY("CHandleManager::get")
     
-    BFE_ASSERT(_ID.C.Index > 0u);
-    BFE_ASSERT(m_HandleMap[_ID.C.Index-1].pEntry != nullptr);
+    BFE_ASSERT(_ID.C.Index > 0u && _ID.C.Index <= MAX_HANDLES);
+    
+    const std::uint32_t nSlot = _ID.C.Index-1;
+    if (m_pCounters[nSlot].load(std::memory_order_acquire) != _ID.C.Counter) return nullptr;
+    T* const pEntry = static_cast<T*>(m_pEntries[nSlot].load(std::memory_order_acquire));
     
-    return static_cast<T*>(m_HandleMap[_ID.C.Index-1].pEntry);
+    // The slot might have been invalidated and reused in between
+    if (m_pCounters[nSlot].load(std::memory_order_acquire) != _ID.C.Counter) return nullptr;
+    return pEntry;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -172,6 +268,10 @@ inline T* CHandleManager::get(const HandleID _ID)
 /// \brief Updates handle with new pointer, all other instances of this handle 
 ///        will become invalid.
 ///
+/// The counter is advanced first, hence, other instances are invalid before
+/// the new pointer is set. If the handle was removed concurrently, nothing
+/// is updated.
+///
 /// \param _ID Handle id of pointer to be updated
 /// \param _ptr Pointer to update handle with
 ///
@@ -184,9 +284,14 @@ inline void CHandleManager::update(HandleID& _ID, T* const _ptr)
     BFE_ASSERT(_ptr != nullptr);
     if (this->isValid(_ID))
     {
-        m_HandleMap[_ID.C.Index-1].pEntry = _ptr;
-        m_HandleMap[_ID.C.Index-1].ID.C.Counter += 1;
-        _ID.C.Counter += 1;
+        HandleCounterType nCounter = _ID.C.Counter;
+        const HandleCounterType nCounterNew = HandleCounterType((nCounter+1u) & HANDLE_COUNTER_MASK);
+        if (m_pCounters[_ID.C.Index-1].compare_exchange_strong(nCounter, nCounterNew,
+                                                               std::memory_order_acq_rel))
+        {
+            m_pEntries[_ID.C.Index-1].store(_ptr, std::memory_order_release);
+            _ID.C.Counter = nCounterNew;
+        }
     }
 }
 
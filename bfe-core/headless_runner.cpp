@@ -0,0 +1,223 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       headless_runner.cpp
+/// \brief      Implementation of class "CHeadlessRunner"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-16
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#include "headless_runner.h"
+
+//--- Standard header --------------------------------------------------------//
+#include <chrono>
+#include <cmath>
+
+using namespace bfe;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Constructor
+///
+////////////////////////////////////////////////////////////////////////////////
+CHeadlessRunner::CHeadlessRunner()
+{
+    METHOD_ENTRY("CHeadlessRunner::CHeadlessRunner")
+    CTOR_CALL("CHeadlessRunner::CHeadlessRunner")
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns number of frames a module processed
+///
+/// \param _pModule Module to query
+///
+/// \return Number of frames, 0 if module isn't registered
+///
+////////////////////////////////////////////////////////////////////////////////
+std::uint64_t CHeadlessRunner::getTicks(const IThreadModule* const _pModule) const
+{
+    METHOD_ENTRY("CHeadlessRunner::getTicks")
+
+    for (const auto& Module : m_Modules)
+    {
+        if (Module.pModule == _pModule) return Module.nTicks;
+    }
+    return 0u;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns simulated time per frame of the runner
+///
+/// If not set explicitly, the period of the module with the highest frequency
+/// is used, thus each frame processes at least one module.
+///
+/// \return Time step in seconds
+///
+////////////////////////////////////////////////////////////////////////////////
+double CHeadlessRunner::getTimeStep() const
+{
+    METHOD_ENTRY("CHeadlessRunner::getTimeStep")
+
+    if (m_fTimeStep > 0.0) return m_fTimeStep;
+
+    double fFrequencyMax = 0.0;
+    for (const auto& Module : m_Modules)
+    {
+        if (Module.pModule->getFrequency() > fFrequencyMax) fFrequencyMax = Module.pModule->getFrequency();
+    }
+    if (fFrequencyMax <= 0.0) fFrequencyMax = THREAD_MODULE_DEFAULT_FREQUENCY;
+    return 1.0/fFrequencyMax;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Adds a module, processed after all modules added before
+///
+/// The module is registered in the module registry, if not done yet.
+///
+/// \param _pModule Module to add
+///
+/// \return Success?
+///
+////////////////////////////////////////////////////////////////////////////////
+bool CHeadlessRunner::addModule(IThreadModule* const _pModule)
+{
+    METHOD_ENTRY("CHeadlessRunner::addModule")
+
+    if (_pModule == nullptr)
+    {
+        WARNING_MSG("Headless Runner", "Module invalid, not added.")
+        return false;
+    }
+    if (_pModule->getFrequency() <= 0.0)
+    {
+        WARNING_MSG("Headless Runner", "Module <" << _pModule->getModuleName() << "> has invalid frequency, not added.")
+        return false;
+    }
+    for (const auto& Module : m_Modules)
+    {
+        if (Module.pModule == _pModule)
+        {
+            WARNING_MSG("Headless Runner", "Module <" << _pModule->getModuleName() << "> already added.")
+            return false;
+        }
+    }
+
+    HeadlessModule Module;
+    Module.pModule = _pModule;
+    // Start with the next frame due, modules added later don't catch up
+    Module.nTicks = std::uint64_t(std::ceil(m_fTimeSimulated * _pModule->getFrequency() - 1.0e-9));
+    m_Modules.push_back(Module);
+    _pModule->registerModule();
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Runs given number of frames without any sleeping
+///
+/// Within a frame, each module processes all its frames that are due until
+/// the end of the frame's time step, modules in order of registration.
+/// Frame times are recorded in the modules' statistics.
+///
+/// \param _nFrames Number of frames to run
+///
+/// \return Continue? False if a module stopped processing.
+///
+////////////////////////////////////////////////////////////////////////////////
+bool CHeadlessRunner::run(const std::uint64_t _nFrames)
+{
+    METHOD_ENTRY("CHeadlessRunner::run")
+
+    using namespace std::chrono;
+
+    const double fTimeStep = this->getTimeStep();
+    const double fTimeStart = m_fTimeSimulated;
+    const std::uint64_t nFrameStart = m_nFrame;
+    bool bContinue = true;
+
+    const auto Start = steady_clock::now();
+    for (auto i=1u; i<=_nFrames && bContinue; ++i)
+    {
+        // Absolute time avoids accumulating rounding errors
+        const double fTimeEnd = fTimeStart + i*fTimeStep;
+        const double fEpsilon = 1.0e-9 * fTimeStep;
+
+        for (auto& Module : m_Modules)
+        {
+            const double fFrequency = Module.pModule->getFrequency();
+            while (Module.nTicks / fFrequency < fTimeEnd - fEpsilon)
+            {
+                const auto StartModule = steady_clock::now();
+                if (!Module.pModule->processFrame()) bContinue = false;
+                Module.pModule->recordFrame(duration<double>(steady_clock::now() - StartModule).count(), 0.0);
+                ++Module.nTicks;
+            }
+        }
+        m_fTimeSimulated = fTimeEnd;
+        ++m_nFrame;
+    }
+    const double fTimeWall = duration<double>(steady_clock::now() - Start).count();
+    m_fTimeWall += fTimeWall;
+
+    INFO_MSG("Headless Runner", "Ran " << m_nFrame-nFrameStart << " frames of " << fTimeStep << "s in " << fTimeWall << "s, " <<
+                                "simulated time " << m_fTimeSimulated << "s, " <<
+                                this->getFramesPerSecond() << " fps, " <<
+                                this->getTimeAcceleration() << "x real time.")
+
+    return bContinue;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Runs frames for given simulated time without any sleeping
+///
+/// \param _fTime Simulated time to run, rounded up to full time steps
+///
+/// \return Continue? False if a module stopped processing.
+///
+////////////////////////////////////////////////////////////////////////////////
+bool CHeadlessRunner::runFor(const double _fTime)
+{
+    METHOD_ENTRY("CHeadlessRunner::runFor")
+
+    const double fFrames = std::ceil(_fTime / this->getTimeStep() - 1.0e-9);
+    if (fFrames <= 0.0) return true;
+    return this->run(std::uint64_t(fFrames));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Sets simulated time per frame of the runner
+///
+/// \param _fTimeStep Time step in seconds, derived from modules if not positive
+///
+////////////////////////////////////////////////////////////////////////////////
+void CHeadlessRunner::setTimeStep(const double _fTimeStep)
+{
+    METHOD_ENTRY("CHeadlessRunner::setTimeStep")
+    m_fTimeStep = _fTimeStep;
+}
@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       headless_runner.h
+/// \brief      Prototype of class "CHeadlessRunner"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-16
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HEADLESS_RUNNER_H
+#define HEADLESS_RUNNER_H
+
+//--- Standard header --------------------------------------------------------//
+#include <cstdint>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "log.h"
+#include "thread_module.h"
+
+/// BFEngine namespace
+namespace bfe
+{
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Module driven by headless runner
+///
+////////////////////////////////////////////////////////////////////////////////
+struct HeadlessModule
+{
+    IThreadModule*  pModule;        ///< Module processing frames
+    std::uint64_t   nTicks = 0u;    ///< Number of frames processed
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Runs modules deterministically as fast as possible
+///
+/// Modules are processed within the calling thread in order of registration,
+/// without any sleeping, window or graphics context. Simulated time advances
+/// by a fixed time step each frame of the runner. A module is processed
+/// whenever simulated time reaches its next frame, given by the module's
+/// frequency, hence modules of different frequencies keep their ratio. Time
+/// acceleration of modules only scales wall clock pacing and is ignored.
+///
+/// Since no module runs as thread, preRun() isn't called and modules
+/// must be initialised by the caller.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CHeadlessRunner
+{
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        CHeadlessRunner();
+
+        //--- Constant methods -----------------------------------------------//
+        std::uint64_t   getFrames() const;
+        double          getFramesPerSecond() const;
+        double          getSimulatedTime() const;
+        double          getTimeAcceleration() const;
+        double          getTimeStep() const;
+        std::uint64_t   getTicks(const IThreadModule* const) const;
+
+        //--- Methods --------------------------------------------------------//
+        bool addModule(IThreadModule* const);
+        bool run(const std::uint64_t);
+        bool runFor(const double);
+        void setTimeStep(const double);
+
+    private:
+
+        //--- Variables [private] --------------------------------------------//
+        std::vector<HeadlessModule> m_Modules;          ///< Modules in order of processing
+
+        double          m_fTimeStep = -1.0;             ///< Simulated time per frame, derived from modules if negative
+        std::uint64_t   m_nFrame = 0u;                  ///< Number of frames run
+        double          m_fTimeSimulated = 0.0;         ///< Simulated time of all runs
+        double          m_fTimeWall = 0.0;              ///< Wall clock time of all runs
+};
+
+//--- Implementation is done here for inline optimisation --------------------//
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns number of frames run
+///
+/// \return Number of frames
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint64_t CHeadlessRunner::getFrames() const
+{
+    METHOD_ENTRY("CHeadlessRunner::getFrames")
+    return m_nFrame;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns frames per second of wall clock time over all runs
+///
+/// \return Frames per second
+///
+////////////////////////////////////////////////////////////////////////////////
+inline double CHeadlessRunner::getFramesPerSecond() const
+{
+    METHOD_ENTRY("CHeadlessRunner::getFramesPerSecond")
+    if (m_fTimeWall <= 0.0) return 0.0;
+    return m_nFrame / m_fTimeWall;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns simulated time of all runs
+///
+/// \return Simulated time in seconds
+///
+////////////////////////////////////////////////////////////////////////////////
+inline double CHeadlessRunner::getSimulatedTime() const
+{
+    METHOD_ENTRY("CHeadlessRunner::getSimulatedTime")
+    return m_fTimeSimulated;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns ratio of simulated time to wall clock time
+///
+/// \return Time acceleration reached
+///
+////////////////////////////////////////////////////////////////////////////////
+inline double CHeadlessRunner::getTimeAcceleration() const
+{
+    METHOD_ENTRY("CHeadlessRunner::getTimeAcceleration")
+    if (m_fTimeWall <= 0.0) return 0.0;
+    return m_fTimeSimulated / m_fTimeWall;
+}
+
+} // namespace bfe
+
+#endif // HEADLESS_RUNNER_H
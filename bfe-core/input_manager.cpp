@@ -43,9 +43,7 @@ CInputManager::CInputManager() : m_pWindow(nullptr),
     METHOD_ENTRY("CInputManager::CInputManager")
     CTOR_CALL("CInputManager::CInputManager")
     
-    #ifdef BFE_MULTITHREADING
-        m_strModuleName = "Input Manager";
-    #endif
+    m_strModuleName = "Input Manager";
     
     m_vecMouse = {0,0};
     m_vecMouseCenter = {0,0};
@@ -68,13 +66,13 @@ bool CInputManager::processFrame()
     if (m_MouseMode == MouseModeType::RELATIVE)
         sf::Mouse::setPosition(m_vecMouseCenter,*m_pWindow);
     
-    m_pComInterface->call<void, int, int>("mouse_set_cursor", vecMouse.x, vecMouse.y);
+    m_MouseSetCursor.call(vecMouse.x, vecMouse.y);
 
     //--- Handle events ---//
     sf::Event Event;
     while (m_pWindow->pollEvent(Event))
     {
-        int nCamMainUID = m_pComInterface->call<int>("get_main_camera");
+        int nCamMainUID = m_GetMainCamera.call();
         
         switch (Event.type)
         {
@@ -292,7 +290,7 @@ bool CInputManager::processFrame()
                 break;
         }
     }
-    m_pComInterface->callWriters("input");
+    m_pComInterface->callWriters(m_pWriterQueue);
     
     return true; 
 }
@@ -308,6 +306,10 @@ void CInputManager::myInitComInterface()
 
     INFO_MSG("Input Manager", "Initialising com interace.")
     
+    // Functions called each frame, registered by other modules
+    m_GetMainCamera = m_pComInterface->resolve<int>("get_main_camera");
+    m_MouseSetCursor = m_pComInterface->resolve<void, int, int>("mouse_set_cursor");
+
     // Events
     m_pComInterface->registerEvent<int>("e_key_pressed",
                                     "Event, indicating that a key was pressed.",
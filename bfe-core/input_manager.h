@@ -87,6 +87,9 @@ class CInputManager : public IComInterfaceProvider,
         sf::Vector2i    m_vecMouse;             ///< Current mouse position
         sf::Vector2i    m_vecMouseCenter;       ///< Mouse position at window center
         MouseModeType   m_MouseMode;            ///< Currently active mouse mode
+
+        CCommandRef<int>            m_GetMainCamera;    ///< Resolved, called for each event
+        CCommandRef<void, int, int> m_MouseSetCursor;   ///< Resolved, called each frame
 };
 
 //--- Implementation is done here for inline optimisation --------------------//
@@ -0,0 +1,669 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       job_system.cpp
+/// \brief      Implementation of class "CJobSystem"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-14
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#include "job_system.h"
+
+//--- Standard header --------------------------------------------------------//
+#include <algorithm>
+
+//--- Program header ---------------------------------------------------------//
+#include "handle.h"
+
+using namespace bfe;
+
+static_assert((JOB_SYSTEM_DEQUE_SIZE & (JOB_SYSTEM_DEQUE_SIZE-1)) == 0,
+              "Size of job deque must be a power of two");
+
+static thread_local CJobSystem* t_pJobSystem = nullptr; ///< Job system of worker thread
+static thread_local int         t_nJobWorker = -1;      ///< Index of worker thread, -1 if no worker
+static thread_local JobRecurring* t_pJobRecurring = nullptr; ///< Recurring function executed by thread
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Constructor
+///
+/// \param _Function Function to be executed
+///
+////////////////////////////////////////////////////////////////////////////////
+CJob::CJob(const std::function<void()>& _Function) : m_Function(_Function)
+{
+    METHOD_ENTRY("CJob::CJob")
+    CTOR_CALL("CJob::CJob")
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Constructor
+///
+////////////////////////////////////////////////////////////////////////////////
+CJobDeque::CJobDeque()
+{
+    METHOD_ENTRY("CJobDeque::CJobDeque")
+    CTOR_CALL("CJobDeque::CJobDeque")
+
+    for (auto& pJob : m_Jobs) pJob.store(nullptr, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Pushes a job to the bottom, only called by owner
+///
+/// \param _pJob Job to be pushed
+///
+/// \return Success? Fails if deque is full.
+///
+////////////////////////////////////////////////////////////////////////////////
+bool CJobDeque::push(CJob* const _pJob)
+{
+    METHOD_ENTRY("CJobDeque::push")
+
+    const std::int64_t nBottom = m_nBottom.load(std::memory_order_relaxed);
+    const std::int64_t nTop = m_nTop.load(std::memory_order_acquire);
+    if (nBottom - nTop >= JOB_SYSTEM_DEQUE_SIZE) return false;
+
+    m_Jobs[nBottom & (JOB_SYSTEM_DEQUE_SIZE-1)].store(_pJob, std::memory_order_relaxed);
+
+    // Publishes the job to thieves
+    m_nBottom.store(nBottom+1, std::memory_order_release);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Pops a job from the bottom, only called by owner
+///
+/// \return Job, nullptr if deque is empty
+///
+////////////////////////////////////////////////////////////////////////////////
+CJob* CJobDeque::pop()
+{
+    METHOD_ENTRY("CJobDeque::pop")
+
+    const std::int64_t nBottom = m_nBottom.load(std::memory_order_relaxed) - 1;
+    m_nBottom.store(nBottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t nTop = m_nTop.load(std::memory_order_relaxed);
+
+    if (nTop > nBottom)
+    {
+        // Empty
+        m_nBottom.store(nBottom+1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    CJob* pJob = m_Jobs[nBottom & (JOB_SYSTEM_DEQUE_SIZE-1)].load(std::memory_order_relaxed);
+    if (nTop == nBottom)
+    {
+        // Last job, race against thieves
+        if (!m_nTop.compare_exchange_strong(nTop, nTop+1, std::memory_order_seq_cst,
+                                                          std::memory_order_relaxed))
+            pJob = nullptr;
+        m_nBottom.store(nBottom+1, std::memory_order_relaxed);
+    }
+    return pJob;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Steals a job from the top, called by any thread
+///
+/// \return Job, nullptr if deque is empty or another thread was faster
+///
+////////////////////////////////////////////////////////////////////////////////
+CJob* CJobDeque::steal()
+{
+    METHOD_ENTRY("CJobDeque::steal")
+
+    std::int64_t nTop = m_nTop.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t nBottom = m_nBottom.load(std::memory_order_acquire);
+
+    if (nTop >= nBottom) return nullptr;
+
+    CJob* const pJob = m_Jobs[nTop & (JOB_SYSTEM_DEQUE_SIZE-1)].load(std::memory_order_relaxed);
+    if (!m_nTop.compare_exchange_strong(nTop, nTop+1, std::memory_order_seq_cst,
+                                                      std::memory_order_relaxed))
+        return nullptr;
+    return pJob;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Constructor, starting worker threads
+///
+/// \param _nWorkers Number of worker threads, one less than number of cores
+///                  if negative (the main thread helps while waiting)
+///
+////////////////////////////////////////////////////////////////////////////////
+CJobSystem::CJobSystem(const int _nWorkers)
+{
+    METHOD_ENTRY("CJobSystem::CJobSystem")
+    CTOR_CALL("CJobSystem::CJobSystem")
+
+    int nWorkers = _nWorkers;
+    if (nWorkers < 0) nWorkers = std::max(1, int(std::thread::hardware_concurrency())-1);
+
+    // All deques must exist before any worker might steal
+    for (auto i=0; i<nWorkers; ++i)
+    {
+        m_Deques.emplace_back(new CJobDeque);
+        MEM_ALLOC("CJobDeque")
+    }
+    for (auto i=0; i<nWorkers; ++i) m_Workers.emplace_back(&CJobSystem::runWorker, this, i);
+
+    INFO_MSG("Job System", "Started " << nWorkers << " worker threads.")
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Destructor, stopping worker threads
+///
+/// Jobs not started yet are discarded.
+///
+////////////////////////////////////////////////////////////////////////////////
+CJobSystem::~CJobSystem()
+{
+    METHOD_ENTRY("CJobSystem::~CJobSystem")
+    DTOR_CALL("CJobSystem::~CJobSystem")
+
+    m_bRunning = false;
+    {
+        std::lock_guard<std::mutex> Lock(m_SleepMutex);
+        m_SleepCondition.notify_all();
+    }
+    for (auto& Worker : m_Workers) Worker.join();
+
+    // Release jobs that were never started
+    CJob* pJob = nullptr;
+    while (m_Global.try_dequeue(pJob)) pJob->m_pSelf.reset();
+    for (auto& pDeque : m_Deques)
+    {
+        while ((pJob = pDeque->steal()) != nullptr) pJob->m_pSelf.reset();
+        MEM_FREED("CJobDeque")
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Creates a job, which is started after submitting
+///
+/// \param _Function Function to be executed
+///
+/// \return Job
+///
+////////////////////////////////////////////////////////////////////////////////
+JobPtrType CJobSystem::createJob(const std::function<void()>& _Function)
+{
+    METHOD_ENTRY("CJobSystem::createJob")
+    return std::make_shared<CJob>(_Function);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Creates a child job, which has to finish before its parent does
+///
+/// The parent must not be finished yet, i.e. this is called before the parent
+/// is submitted or while it is executed.
+///
+/// \param _pParent Parent job
+/// \param _Function Function to be executed
+///
+/// \return Job
+///
+////////////////////////////////////////////////////////////////////////////////
+JobPtrType CJobSystem::createChildJob(const JobPtrType& _pParent, const std::function<void()>& _Function)
+{
+    METHOD_ENTRY("CJobSystem::createChildJob")
+
+    BFE_ASSERT(!_pParent->isFinished());
+
+    JobPtrType pJob = std::make_shared<CJob>(_Function);
+    pJob->m_pParent = _pParent;
+    _pParent->m_nUnfinished.fetch_add(1, std::memory_order_relaxed);
+    return pJob;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Lets a job wait for another job to be finished
+///
+/// Dependencies must be added before the job is submitted.
+///
+/// \param _pJob Job that should wait
+/// \param _pDependency Job to wait for
+///
+////////////////////////////////////////////////////////////////////////////////
+void CJobSystem::addDependency(const JobPtrType& _pJob, const JobPtrType& _pDependency)
+{
+    METHOD_ENTRY("CJobSystem::addDependency")
+
+    _pDependency->m_AccessDependents.acquireLock();
+    if (!_pDependency->m_bFinished.load(std::memory_order_relaxed))
+    {
+        _pJob->m_nDependencies.fetch_add(1, std::memory_order_relaxed);
+        _pDependency->m_Dependents.push_back(_pJob);
+    }
+    _pDependency->m_AccessDependents.releaseLock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Submits a job, it is started as soon as its dependencies finished
+///
+/// \param _pJob Job to be submitted
+///
+////////////////////////////////////////////////////////////////////////////////
+void CJobSystem::submit(const JobPtrType& _pJob)
+{
+    METHOD_ENTRY("CJobSystem::submit")
+
+    _pJob->m_pSelf = _pJob;
+    if (_pJob->m_nDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        this->schedule(_pJob.get());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Waits for a job to be finished, executing other jobs meanwhile
+///
+/// \param _pJob Job to wait for
+///
+////////////////////////////////////////////////////////////////////////////////
+void CJobSystem::wait(const JobPtrType& _pJob)
+{
+    METHOD_ENTRY("CJobSystem::wait")
+
+    const int nWorker = (t_pJobSystem == this) ? t_nJobWorker : -1;
+    while (!_pJob->isFinished())
+    {
+        CJob* const pJob = this->getJob(nWorker);
+        if (pJob != nullptr)
+            this->execute(pJob);
+        else
+            std::this_thread::yield();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Executes a function for a range of indices in parallel, blocking
+///
+/// The range is split into chunks, each being a job. The calling thread
+/// executes jobs while waiting.
+///
+/// \param _nBegin First index
+/// \param _nEnd Index behind last index
+/// \param _nGrain Number of indices per job
+/// \param _Function Function processing the indices [begin, end)
+///
+////////////////////////////////////////////////////////////////////////////////
+void CJobSystem::parallelFor(const int _nBegin, const int _nEnd, const int _nGrain,
+                             const std::function<void(const int, const int)>& _Function)
+{
+    METHOD_ENTRY("CJobSystem::parallelFor")
+
+    if (_nEnd <= _nBegin) return;
+
+    const int nGrain = std::max(1, _nGrain);
+    JobPtrType pRoot = this->createJob([]{});
+    for (auto i=_nBegin; i<_nEnd; i+=nGrain)
+    {
+        const int nEnd = std::min(_nEnd, i+nGrain);
+        this->submit(this->createChildJob(pRoot, [&_Function, i, nEnd]{_Function(i, nEnd);}));
+    }
+    this->submit(pRoot);
+    this->wait(pRoot);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Adds a function executed periodically as a job
+///
+/// \param _Function Function to be executed, removed if it returns false
+/// \param _fFrequency Frequency of execution in Hertz
+///
+/// \return Id of recurring function
+///
+////////////////////////////////////////////////////////////////////////////////
+int CJobSystem::addRecurring(const std::function<bool()>& _Function, const double _fFrequency)
+{
+    METHOD_ENTRY("CJobSystem::addRecurring")
+
+    BFE_ASSERT(_fFrequency > 0.0);
+
+    using namespace std::chrono;
+
+    std::unique_ptr<JobRecurring> pRecurring(new JobRecurring);
+    MEM_ALLOC("JobRecurring")
+    pRecurring->Function = _Function;
+    pRecurring->Period = duration_cast<steady_clock::duration>(duration<double>(1.0/_fFrequency));
+    pRecurring->Due = steady_clock::now();
+    pRecurring->bScheduled = false;
+    pRecurring->bActive = true;
+
+    CWriteLockGuard Lock(m_AccessRecurring);
+    m_Recurring.push_back(std::move(pRecurring));
+    return static_cast<int>(m_Recurring.size())-1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Removes a recurring function, waiting for a running execution
+///
+/// If called by the recurring function itself, it isn't executed again, but
+/// the running execution isn't waited for.
+///
+/// \param _nID Id of recurring function
+///
+////////////////////////////////////////////////////////////////////////////////
+void CJobSystem::removeRecurring(const int _nID)
+{
+    METHOD_ENTRY("CJobSystem::removeRecurring")
+
+    JobRecurring* pRecurring = nullptr;
+    {
+        CReadLockGuard Lock(m_AccessRecurring);
+        if (_nID < 0 || _nID >= int(m_Recurring.size())) return;
+        pRecurring = m_Recurring[_nID].get();
+    }
+    pRecurring->bActive = false;
+
+    // Waiting for itself would never return
+    if (pRecurring == t_pJobRecurring) return;
+
+    // Execute jobs meanwhile, the pending execution might be one of them
+    const int nWorker = (t_pJobSystem == this) ? t_nJobWorker : -1;
+    while (pRecurring->bScheduled)
+    {
+        CJob* const pJob = this->getJob(nWorker);
+        if (pJob != nullptr)
+            this->execute(pJob);
+        else
+            std::this_thread::yield();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Schedules all recurring functions that are due
+///
+////////////////////////////////////////////////////////////////////////////////
+void CJobSystem::dispatchRecurring()
+{
+    METHOD_ENTRY("CJobSystem::dispatchRecurring")
+
+    using namespace std::chrono;
+    const auto Now = steady_clock::now();
+
+    CReadLockGuard Lock(m_AccessRecurring);
+    for (auto& pRecurring : m_Recurring)
+    {
+        // Due is only accessed by the thread that scheduled the execution
+        bool bScheduled = false;
+        if (!pRecurring->bActive.load(std::memory_order_relaxed) ||
+            pRecurring->bScheduled.load(std::memory_order_relaxed) ||
+            !pRecurring->bScheduled.compare_exchange_strong(bScheduled, true, std::memory_order_acquire))
+            continue;
+
+        if (Now < pRecurring->Due || !pRecurring->bActive)
+        {
+            pRecurring->bScheduled.store(false, std::memory_order_release);
+            continue;
+        }
+
+        JobRecurring* const pRec = pRecurring.get();
+        this->submit(this->createJob([pRec]
+        {
+            // Executions might be nested by waiting inside the function
+            JobRecurring* const pOuter = t_pJobRecurring;
+            t_pJobRecurring = pRec;
+            if (pRec->bActive && !pRec->Function()) pRec->bActive = false;
+            t_pJobRecurring = pOuter;
+
+            // Skip missed executions instead of catching up
+            pRec->Due = std::max(pRec->Due + pRec->Period, steady_clock::now());
+            pRec->bScheduled.store(false, std::memory_order_release);
+        }));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Executes a job and finishes it
+///
+/// \param _pJob Job to be executed
+///
+////////////////////////////////////////////////////////////////////////////////
+void CJobSystem::execute(CJob* const _pJob)
+{
+    METHOD_ENTRY("CJobSystem::execute")
+
+    _pJob->m_Function();
+    this->finish(_pJob);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Finishes a job if it has no unfinished children
+///
+/// Dependent jobs are scheduled, the parent is notified.
+///
+/// \param _pJob Job to be finished
+///
+////////////////////////////////////////////////////////////////////////////////
+void CJobSystem::finish(CJob* const _pJob)
+{
+    METHOD_ENTRY("CJobSystem::finish")
+
+    if (_pJob->m_nUnfinished.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+    // Keep the job alive until it is completely finished
+    JobPtrType pSelf = std::move(_pJob->m_pSelf);
+
+    std::vector<JobPtrType> Dependents;
+    _pJob->m_AccessDependents.acquireLock();
+    _pJob->m_bFinished.store(true, std::memory_order_release);
+    Dependents.swap(_pJob->m_Dependents);
+    _pJob->m_AccessDependents.releaseLock();
+
+    for (const auto& pDependent : Dependents)
+    {
+        if (pDependent->m_nDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            this->schedule(pDependent.get());
+    }
+
+    if (_pJob->m_pParent != nullptr)
+    {
+        JobPtrType pParent = std::move(_pJob->m_pParent);
+        this->finish(pParent.get());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns a job from own deque, global queue, or other workers
+///
+/// \param _nWorker Index of calling worker, -1 if no worker
+///
+/// \return Job, nullptr if no job was found
+///
+////////////////////////////////////////////////////////////////////////////////
+CJob* CJobSystem::getJob(const int _nWorker)
+{
+    METHOD_ENTRY("CJobSystem::getJob")
+
+    CJob* pJob = nullptr;
+    if (_nWorker >= 0)
+    {
+        pJob = m_Deques[_nWorker]->pop();
+        if (pJob != nullptr) return pJob;
+    }
+    if (m_Global.try_dequeue(pJob)) return pJob;
+
+    // Start with different victims to spread stealing
+    const int nDeques = static_cast<int>(m_Deques.size());
+    const int nStart = _nWorker + 1;
+    for (auto i=0; i<nDeques; ++i)
+    {
+        const int nVictim = (nStart + i) % nDeques;
+        if (nVictim == _nWorker) continue;
+        pJob = m_Deques[nVictim]->steal();
+        if (pJob != nullptr) return pJob;
+    }
+    return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Indicates if there are jobs to be executed
+///
+/// \return Jobs available?
+///
+////////////////////////////////////////////////////////////////////////////////
+bool CJobSystem::hasJobs() const
+{
+    METHOD_ENTRY("CJobSystem::hasJobs")
+
+    if (m_Global.size_approx() != 0u) return true;
+    for (const auto& pDeque : m_Deques)
+    {
+        if (!pDeque->isEmpty()) return true;
+    }
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main loop of worker threads
+///
+/// \param _nWorker Index of worker
+///
+////////////////////////////////////////////////////////////////////////////////
+void CJobSystem::runWorker(const int _nWorker)
+{
+    METHOD_ENTRY("CJobSystem::runWorker")
+
+    t_pJobSystem = this;
+    t_nJobWorker = _nWorker;
+
+    CEpochManager& EpochManager = CHandleBase::getEpochManager();
+    const int nEpochParticipant = EpochManager.registerParticipant();
+
+    int nIdle = 0;
+    int nExecuted = 0;
+    while (m_bRunning)
+    {
+        this->dispatchRecurring();
+
+        CJob* const pJob = this->getJob(_nWorker);
+        if (pJob != nullptr)
+        {
+            this->execute(pJob);
+            nIdle = 0;
+
+            // Announce under load, too, otherwise the epoch never advances
+            // and retired handles aren't released
+            if (++nExecuted >= JOB_SYSTEM_ANNOUNCE_JOBS)
+            {
+                EpochManager.announce(nEpochParticipant);
+                nExecuted = 0;
+            }
+            continue;
+        }
+
+        // No job is running, hence this is a quiescent state
+        EpochManager.announce(nEpochParticipant);
+        nExecuted = 0;
+
+        if (++nIdle < JOB_SYSTEM_SPIN_MAX)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            // Sleep until new jobs are submitted, wake up regularly for
+            // recurring functions
+            std::unique_lock<std::mutex> Lock(m_SleepMutex);
+            m_nSleeping.fetch_add(1);
+            if (m_bRunning && !this->hasJobs())
+                m_SleepCondition.wait_for(Lock, std::chrono::microseconds(JOB_SYSTEM_SLEEP_MAX_US));
+            m_nSleeping.fetch_sub(1);
+        }
+    }
+
+    EpochManager.unregisterParticipant(nEpochParticipant);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Puts a job to own deque if called by a worker, to the global queue
+///        otherwise
+///
+/// \param _pJob Job to be scheduled
+///
+////////////////////////////////////////////////////////////////////////////////
+void CJobSystem::schedule(CJob* const _pJob)
+{
+    METHOD_ENTRY("CJobSystem::schedule")
+
+    if (t_pJobSystem == this)
+    {
+        // Execute immediately if deque is full
+        if (!m_Deques[t_nJobWorker]->push(_pJob))
+        {
+            this->execute(_pJob);
+            return;
+        }
+    }
+    else
+    {
+        m_Global.enqueue(_pJob);
+    }
+    this->wakeWorker();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Wakes a sleeping worker, if any
+///
+////////////////////////////////////////////////////////////////////////////////
+void CJobSystem::wakeWorker()
+{
+    METHOD_ENTRY("CJobSystem::wakeWorker")
+
+    // Pairs with incrementing the number of sleeping workers before they check
+    // for jobs, thus, either the job is seen or the sleeper is
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_nSleeping.load() > 0)
+    {
+        std::lock_guard<std::mutex> Lock(m_SleepMutex);
+        m_SleepCondition.notify_one();
+    }
+}
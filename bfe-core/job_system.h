@@ -0,0 +1,278 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       job_system.h
+/// \brief      Prototype of class "CJobSystem"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-14
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "log.h"
+#include "adaptive_lock.h"
+#include "rw_spinlock.h"
+
+//--- Misc header ------------------------------------------------------------//
+#include "concurrentqueue.h"
+
+/// BFEngine namespace
+namespace bfe
+{
+
+//--- Constants --------------------------------------------------------------//
+constexpr std::int64_t JOB_SYSTEM_DEQUE_SIZE = 4096;    ///< Capacity of each worker's deque, power of two
+constexpr int JOB_SYSTEM_SPIN_MAX            = 64;      ///< Unsuccessful searches for jobs before sleeping
+constexpr int JOB_SYSTEM_SLEEP_MAX_US        = 1000;    ///< Maximum time an idle worker sleeps
+constexpr int JOB_SYSTEM_ANNOUNCE_JOBS      = 16;      ///< Jobs executed before announcing a quiescent state
+
+class CJob;
+
+/// Shared pointer to a job, keeping it alive for waiting
+typedef std::shared_ptr<CJob> JobPtrType;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Job, i.e. a function executed by the job system
+///
+/// A job is finished when its function and the functions of all its children
+/// have been executed. Jobs depending on it are started afterwards.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CJob
+{
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        explicit CJob(const std::function<void()>&);
+        CJob(const CJob&) = delete;
+        CJob& operator=(const CJob&) = delete;
+
+        //--- Constant methods -----------------------------------------------//
+        bool isFinished() const;
+
+    private:
+
+        friend class CJobSystem;
+
+        //--- Variables [private] --------------------------------------------//
+        std::function<void()>   m_Function;             ///< Function to be executed
+        JobPtrType              m_pParent;              ///< Parent job, finished after this job
+        JobPtrType              m_pSelf;                ///< Keeps job alive while it is scheduled
+
+        std::atomic<int>        m_nUnfinished{1};       ///< Number of unfinished jobs, including children
+        std::atomic<int>        m_nDependencies{1};     ///< Unfinished dependencies, +1 until submitted
+        std::atomic_bool        m_bFinished{false};     ///< Indicates that job and children are finished
+
+        CAdaptiveLock           m_AccessDependents;     ///< Protects dependents against finishing
+        std::vector<JobPtrType> m_Dependents;           ///< Jobs waiting for this job to be finished
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Bounded work stealing deque (Chase-Lev)
+///
+/// The owning worker pushes and pops jobs at the bottom (LIFO, cache
+/// friendly), other threads steal from the top (FIFO, larger jobs first).
+/// Push and pop don't need atomic read-modify-write operations unless there
+/// is only one job left.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CJobDeque
+{
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        CJobDeque();
+        CJobDeque(const CJobDeque&) = delete;
+        CJobDeque& operator=(const CJobDeque&) = delete;
+
+        //--- Constant methods -----------------------------------------------//
+        bool isEmpty() const;
+
+        //--- Methods --------------------------------------------------------//
+        bool  push(CJob* const);
+        CJob* pop();
+        CJob* steal();
+
+    private:
+
+        //--- Variables [private] --------------------------------------------//
+        std::atomic<std::int64_t> m_nTop{0};                        ///< Index stolen from
+        std::atomic<std::int64_t> m_nBottom{0};                     ///< Index pushed to, owner only
+        std::atomic<CJob*>        m_Jobs[JOB_SYSTEM_DEQUE_SIZE];    ///< Ring buffer of jobs
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Function executed periodically by the job system
+///
+////////////////////////////////////////////////////////////////////////////////
+struct JobRecurring
+{
+    std::function<bool()>                   Function;       ///< Function, removed if it returns false
+    std::chrono::steady_clock::duration     Period;         ///< Period of execution
+    std::chrono::steady_clock::time_point   Due;            ///< Time of next execution
+    std::atomic_bool                        bScheduled;     ///< Indicates a pending or running execution
+    std::atomic_bool                        bActive;        ///< Indicates that function wasn't removed
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Work stealing thread pool
+///
+/// Each worker thread owns a deque of jobs. Jobs submitted by a worker, e.g.
+/// children of the job it is running, are pushed to its own deque. Jobs
+/// submitted by other threads are put to a global queue. Idle workers take
+/// jobs from their own deque first, then the global queue, and finally steal
+/// from other workers. Threads waiting for a job execute other jobs
+/// meanwhile, hence waiting inside of jobs doesn't block workers.
+///
+/// Dependencies are expressed by
+///  - children: A parent isn't finished before all its children are and
+///  - dependencies: A job isn't started before its dependencies finished.
+///
+/// Recurring functions, e.g. the frames of thread modules, are scheduled as
+/// jobs by the workers once they are due. An execution is never scheduled
+/// while the previous one is still pending, hence, the function isn't run
+/// concurrently to itself.
+///
+/// Workers are registered at the epoch manager of handles and announce a
+/// quiescent state between jobs, when idle or every
+/// \ref JOB_SYSTEM_ANNOUNCE_JOBS jobs under load. Thus, raw pointers obtained
+/// from handles must not be kept across jobs.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CJobSystem
+{
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        explicit CJobSystem(const int = -1);
+        ~CJobSystem();
+
+        CJobSystem(const CJobSystem&) = delete;
+        CJobSystem& operator=(const CJobSystem&) = delete;
+
+        //--- Constant methods -----------------------------------------------//
+        int getNumberOfWorkers() const;
+
+        //--- Methods --------------------------------------------------------//
+        JobPtrType  createJob(const std::function<void()>&);
+        JobPtrType  createChildJob(const JobPtrType&, const std::function<void()>&);
+        void        addDependency(const JobPtrType&, const JobPtrType&);
+        void        submit(const JobPtrType&);
+        void        wait(const JobPtrType&);
+        void        parallelFor(const int, const int, const int,
+                                const std::function<void(const int, const int)>&);
+
+        int         addRecurring(const std::function<bool()>&, const double);
+        void        removeRecurring(const int);
+
+    private:
+
+        //--- Methods [private] ----------------------------------------------//
+        void  dispatchRecurring();
+        void  execute(CJob* const);
+        void  finish(CJob* const);
+        CJob* getJob(const int);
+        bool  hasJobs() const;
+        void  runWorker(const int);
+        void  schedule(CJob* const);
+        void  wakeWorker();
+
+        //--- Variables [private] --------------------------------------------//
+        std::vector<std::unique_ptr<CJobDeque>>     m_Deques;       ///< Deque of each worker
+        std::vector<std::thread>                    m_Workers;      ///< Worker threads
+        moodycamel::ConcurrentQueue<CJob*>          m_Global;       ///< Jobs submitted by other threads
+
+        std::vector<std::unique_ptr<JobRecurring>>  m_Recurring;        ///< Recurring functions
+        CRWSpinlock                                 m_AccessRecurring;  ///< Protects list of recurring functions
+
+        std::atomic_bool                            m_bRunning{true};   ///< Indicates that workers are running
+        std::atomic<int>                            m_nSleeping{0};     ///< Number of sleeping workers
+        std::mutex                                  m_SleepMutex;       ///< Mutex for sleeping workers
+        std::condition_variable                     m_SleepCondition;   ///< Wakes sleeping workers
+};
+
+//--- Implementation is done here for inline optimisation --------------------//
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Indicates if job and all its children were executed
+///
+/// \return Job finished?
+///
+////////////////////////////////////////////////////////////////////////////////
+inline bool CJob::isFinished() const
+{
+    METHOD_ENTRY("CJob::isFinished")
+    return m_bFinished.load(std::memory_order_acquire);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Indicates if deque is empty, might be outdated immediately
+///
+/// \return Deque empty?
+///
+////////////////////////////////////////////////////////////////////////////////
+inline bool CJobDeque::isEmpty() const
+{
+    METHOD_ENTRY("CJobDeque::isEmpty")
+    return m_nBottom.load(std::memory_order_acquire) <= m_nTop.load(std::memory_order_acquire);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns number of worker threads
+///
+/// \return Number of worker threads
+///
+////////////////////////////////////////////////////////////////////////////////
+inline int CJobSystem::getNumberOfWorkers() const
+{
+    METHOD_ENTRY("CJobSystem::getNumberOfWorkers")
+    return static_cast<int>(m_Workers.size());
+}
+
+} // namespace bfe
+
+#endif // JOB_SYSTEM_H
@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       rw_spinlock.cpp
+/// \brief      Implementation of class "CRWSpinlock"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-13
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#include "rw_spinlock.h"
+
+//--- Standard header --------------------------------------------------------//
+#include <thread>
+
+using namespace bfe;
+
+thread_local std::uint32_t CRWSpinlock::s_nReadLocks = 0u;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Waits a little, first spinning, then yielding
+///
+/// \param _nIter Number of waits so far, incremented
+///
+////////////////////////////////////////////////////////////////////////////////
+static inline void backoff(int& _nIter)
+{
+    if (_nIter < RW_SPINLOCK_MAX_ITER)
+    {
+        #if defined(_MSC_VER)
+            _mm_pause();
+        #elif (defined(__clang__) || defined(__GNUC__)) && (defined(__x86_64__) || defined(__i386__))
+            __builtin_ia32_pause();
+        #endif
+        ++_nIter;
+    }
+    else
+    {
+        std::this_thread::yield();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Acquires the lock for reading if a writer holds or waits for it
+///
+/// Only reads the state while waiting to keep the cache line shared.
+///
+////////////////////////////////////////////////////////////////////////////////
+void CRWSpinlock::acquireReadLockContended()
+{
+    METHOD_ENTRY("CRWSpinlock::acquireReadLockContended")
+
+    const std::uint32_t nBlocking = (s_nReadLocks == 0u) ? RW_SPINLOCK_WRITER | RW_SPINLOCK_PENDING :
+                                                            RW_SPINLOCK_WRITER;
+    int nIter = 0;
+    do
+    {
+        while ((m_nState.load(std::memory_order_relaxed) & nBlocking) != 0u) backoff(nIter);
+    }
+    while (!this->tryReadLock());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Acquires the lock for writing if it is held by others
+///
+/// Sets the pending bit, hence, readers drain and no new ones enter. It is set
+/// again if another writer took the lock, clearing it. Only reads the state
+/// otherwise while waiting to keep the cache line shared.
+///
+////////////////////////////////////////////////////////////////////////////////
+void CRWSpinlock::acquireWriteLockContended()
+{
+    METHOD_ENTRY("CRWSpinlock::acquireWriteLockContended")
+
+    int nIter = 0;
+    do
+    {
+        std::uint32_t nState = m_nState.load(std::memory_order_relaxed);
+        while ((nState & ~RW_SPINLOCK_PENDING) != 0u)
+        {
+            if ((nState & RW_SPINLOCK_PENDING) == 0u) m_nState.fetch_or(RW_SPINLOCK_PENDING, std::memory_order_relaxed);
+            backoff(nIter);
+            nState = m_nState.load(std::memory_order_relaxed);
+        }
+    }
+    while (!this->tryWriteLock());
+}
@@ -0,0 +1,286 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       rw_spinlock.h
+/// \brief      Prototype of class "CRWSpinlock"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-13
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RW_SPINLOCK_H
+#define RW_SPINLOCK_H
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <cstdint>
+
+//--- Program header ---------------------------------------------------------//
+#include "log.h"
+
+/// BFEngine namespace
+namespace bfe
+{
+
+//--- Constants --------------------------------------------------------------//
+constexpr std::uint32_t RW_SPINLOCK_WRITER = 0x80000000u;  ///< Bit indicating a writer holding the lock
+constexpr std::uint32_t RW_SPINLOCK_PENDING = 0x40000000u; ///< Bit indicating a writer waiting for the lock
+constexpr std::uint32_t RW_SPINLOCK_READERS = 0x3FFFFFFFu; ///< Bits counting the readers
+constexpr int RW_SPINLOCK_MAX_ITER = 100;                  ///< Number of pauses before yielding
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reader-writer spinlock for read mostly data
+///
+/// Any number of readers may hold the lock at the same time, a writer holds it
+/// exclusively. The lock state is a single atomic with the writer bits and the
+/// number of readers, hence an uncontended read lock costs one atomic
+/// operation for acquiring and releasing, each.
+///
+/// A waiting writer sets the pending bit, which stops new readers from
+/// entering, thus, writers don't starve under continuous reads. Threads
+/// already holding a read lock still enter, which allows for nested read locks
+/// of the same thread, e.g. if a command calls another command.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRWSpinlock
+{
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        CRWSpinlock() = default;
+        CRWSpinlock(const CRWSpinlock&) = delete;
+        CRWSpinlock& operator=(const CRWSpinlock&) = delete;
+
+        //--- Constant methods -----------------------------------------------//
+        std::uint32_t getReaders() const;
+        bool          isWriteLocked() const;
+        bool          isWritePending() const;
+
+        //--- Methods --------------------------------------------------------//
+        void acquireReadLock();
+        void acquireWriteLock();
+        void releaseReadLock();
+        void releaseWriteLock();
+        bool tryReadLock();
+        bool tryWriteLock();
+
+    private:
+
+        //--- Methods [private] ----------------------------------------------//
+        void acquireReadLockContended();
+        void acquireWriteLockContended();
+
+        //--- Variables [private] --------------------------------------------//
+        std::atomic<std::uint32_t> m_nState{0u}; ///< Writer bits and number of readers
+
+        static thread_local std::uint32_t s_nReadLocks; ///< Read locks held by this thread, any lock
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Holds a read lock for the lifetime of the object
+///
+////////////////////////////////////////////////////////////////////////////////
+class CReadLockGuard
+{
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        explicit CReadLockGuard(CRWSpinlock& _Lock) : m_Lock(_Lock) {m_Lock.acquireReadLock();}
+        ~CReadLockGuard() {m_Lock.releaseReadLock();}
+
+        CReadLockGuard(const CReadLockGuard&) = delete;
+        CReadLockGuard& operator=(const CReadLockGuard&) = delete;
+
+    private:
+
+        //--- Variables [private] --------------------------------------------//
+        CRWSpinlock& m_Lock; ///< Lock held
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Holds a write lock for the lifetime of the object
+///
+////////////////////////////////////////////////////////////////////////////////
+class CWriteLockGuard
+{
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        explicit CWriteLockGuard(CRWSpinlock& _Lock) : m_Lock(_Lock) {m_Lock.acquireWriteLock();}
+        ~CWriteLockGuard() {m_Lock.releaseWriteLock();}
+
+        CWriteLockGuard(const CWriteLockGuard&) = delete;
+        CWriteLockGuard& operator=(const CWriteLockGuard&) = delete;
+
+    private:
+
+        //--- Variables [private] --------------------------------------------//
+        CRWSpinlock& m_Lock; ///< Lock held
+};
+
+//--- Implementation is done here for inline optimisation --------------------//
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the number of readers currently holding the lock
+///
+/// \return Number of readers
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint32_t CRWSpinlock::getReaders() const
+{
+    METHOD_ENTRY("CRWSpinlock::getReaders")
+    return m_nState.load(std::memory_order_relaxed) & RW_SPINLOCK_READERS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Indicates if a writer holds the lock
+///
+/// \return Write locked?
+///
+////////////////////////////////////////////////////////////////////////////////
+inline bool CRWSpinlock::isWriteLocked() const
+{
+    METHOD_ENTRY("CRWSpinlock::isWriteLocked")
+    return (m_nState.load(std::memory_order_relaxed) & RW_SPINLOCK_WRITER) != 0u;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Indicates if a writer waits for the lock
+///
+/// \return Write pending?
+///
+////////////////////////////////////////////////////////////////////////////////
+inline bool CRWSpinlock::isWritePending() const
+{
+    METHOD_ENTRY("CRWSpinlock::isWritePending")
+    return (m_nState.load(std::memory_order_relaxed) & RW_SPINLOCK_PENDING) != 0u;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Acquires the lock for reading, waiting while a writer holds or waits for it
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void CRWSpinlock::acquireReadLock()
+{
+    METHOD_ENTRY("CRWSpinlock::acquireReadLock")
+    if (!this->tryReadLock()) this->acquireReadLockContended();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Acquires the lock for writing, waiting while it is held by others
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void CRWSpinlock::acquireWriteLock()
+{
+    METHOD_ENTRY("CRWSpinlock::acquireWriteLock")
+    if (!this->tryWriteLock()) this->acquireWriteLockContended();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Releases the read lock
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void CRWSpinlock::releaseReadLock()
+{
+    METHOD_ENTRY("CRWSpinlock::releaseReadLock")
+    BFE_ASSERT(this->getReaders() > 0u);
+    m_nState.fetch_sub(1u, std::memory_order_release);
+    --s_nReadLocks;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Releases the write lock
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void CRWSpinlock::releaseWriteLock()
+{
+    METHOD_ENTRY("CRWSpinlock::releaseWriteLock")
+    BFE_ASSERT(this->isWriteLocked());
+
+    // Readers don't register while the writer bit is set, writers might wait
+    m_nState.fetch_and(~RW_SPINLOCK_WRITER, std::memory_order_release);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Acquires the lock for reading if no writer holds or waits for it
+///
+/// Threads holding a read lock ignore waiting writers, since they might wait
+/// for this thread.
+///
+/// \return Lock acquired?
+///
+////////////////////////////////////////////////////////////////////////////////
+inline bool CRWSpinlock::tryReadLock()
+{
+    METHOD_ENTRY("CRWSpinlock::tryReadLock")
+
+    const std::uint32_t nBlocking = (s_nReadLocks == 0u) ? RW_SPINLOCK_WRITER | RW_SPINLOCK_PENDING :
+                                                            RW_SPINLOCK_WRITER;
+    std::uint32_t nState = m_nState.load(std::memory_order_relaxed);
+    while ((nState & nBlocking) == 0u)
+    {
+        if (m_nState.compare_exchange_weak(nState, nState+1u, std::memory_order_acquire,
+                                                               std::memory_order_relaxed))
+        {
+            ++s_nReadLocks;
+            return true;
+        }
+    }
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Acquires the lock for writing if it is free
+///
+/// A pending bit, set by this or another waiting writer, is cleared.
+///
+/// \return Lock acquired?
+///
+////////////////////////////////////////////////////////////////////////////////
+inline bool CRWSpinlock::tryWriteLock()
+{
+    METHOD_ENTRY("CRWSpinlock::tryWriteLock")
+
+    std::uint32_t nExpected = m_nState.load(std::memory_order_relaxed) & RW_SPINLOCK_PENDING;
+    return m_nState.compare_exchange_strong(nExpected, RW_SPINLOCK_WRITER, std::memory_order_acquire,
+                                                                           std::memory_order_relaxed);
+}
+
+} // namespace bfe
+
+#endif // RW_SPINLOCK_H
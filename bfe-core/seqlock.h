@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       seqlock.h
+/// \brief      Prototype of class "CSeqlock"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-13
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+//--- Program header ---------------------------------------------------------//
+#include "log.h"
+
+/// BFEngine namespace
+namespace bfe
+{
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Sequence lock, protecting a small value that is read mostly
+///
+/// Readers never write to shared memory, hence they don't contend with each
+/// other at all. They copy the value and retry if the sequence number changed
+/// meanwhile or a write was in progress (odd sequence number). Writers
+/// increment the sequence number before and after writing and are
+/// serialised by it.
+///
+/// The value is stored as relaxed atomic words, thus concurrent reading
+/// while writing is well defined. The type must be trivially copyable.
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+class CSeqlock
+{
+
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock requires trivially copyable type");
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        CSeqlock();
+        explicit CSeqlock(const T&);
+        CSeqlock(const CSeqlock&) = delete;
+        CSeqlock& operator=(const CSeqlock&) = delete;
+
+        //--- Constant methods -----------------------------------------------//
+        T               read() const;
+        std::uint32_t   getSequence() const;
+
+        //--- Methods --------------------------------------------------------//
+        void write(const T&);
+
+    private:
+
+        //--- Constants [private] --------------------------------------------//
+        static constexpr std::size_t NUMBER_OF_WORDS = (sizeof(T) + sizeof(std::uint64_t) - 1) /
+                                                       sizeof(std::uint64_t);
+
+        //--- Methods [private] ----------------------------------------------//
+        void store(const T&);
+
+        //--- Variables [private] --------------------------------------------//
+        std::atomic<std::uint32_t> m_nSequence{0u};            ///< Sequence number, odd while writing
+        std::atomic<std::uint64_t> m_Words[NUMBER_OF_WORDS];   ///< Value, stored as words
+};
+
+//--- Implementation is done here for inline optimisation --------------------//
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Constructor, initialising value by default
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline CSeqlock<T>::CSeqlock()
+{
+    METHOD_ENTRY("CSeqlock::CSeqlock")
+    this->store(T());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Constructor, initialising value
+///
+/// \param _Value Initial value
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline CSeqlock<T>::CSeqlock(const T& _Value)
+{
+    METHOD_ENTRY("CSeqlock::CSeqlock")
+    this->store(_Value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns a consistent copy of the value
+///
+/// \return Value
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline T CSeqlock<T>::read() const
+{
+    METHOD_ENTRY("CSeqlock::read")
+
+    std::uint64_t Words[NUMBER_OF_WORDS];
+    std::uint32_t nSequence = 0u;
+    do
+    {
+        nSequence = m_nSequence.load(std::memory_order_acquire);
+        while (nSequence & 1u)
+        {
+            std::this_thread::yield();
+            nSequence = m_nSequence.load(std::memory_order_acquire);
+        }
+        for (auto i=0u; i<NUMBER_OF_WORDS; ++i) Words[i] = m_Words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    while (m_nSequence.load(std::memory_order_relaxed) != nSequence);
+
+    T Value;
+    std::memcpy(&Value, Words, sizeof(T));
+    return Value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the sequence number, incremented by two for each write
+///
+/// \return Sequence number
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline std::uint32_t CSeqlock<T>::getSequence() const
+{
+    METHOD_ENTRY("CSeqlock::getSequence")
+    return m_nSequence.load(std::memory_order_acquire);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes the value, waiting for concurrent writers
+///
+/// \param _Value Value to be written
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline void CSeqlock<T>::write(const T& _Value)
+{
+    METHOD_ENTRY("CSeqlock::write")
+
+    // Make sequence number odd, serialising writers
+    std::uint32_t nSequence = m_nSequence.load(std::memory_order_relaxed);
+    while ((nSequence & 1u) ||
+           !m_nSequence.compare_exchange_weak(nSequence, nSequence+1u, std::memory_order_relaxed))
+    {
+        if (nSequence & 1u)
+        {
+            std::this_thread::yield();
+            nSequence = m_nSequence.load(std::memory_order_relaxed);
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    this->store(_Value);
+
+    m_nSequence.store(nSequence+2u, std::memory_order_release);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Stores the value to words without synchronisation
+///
+/// \param _Value Value to be stored
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline void CSeqlock<T>::store(const T& _Value)
+{
+    METHOD_ENTRY("CSeqlock::store")
+
+    std::uint64_t Words[NUMBER_OF_WORDS] = {};
+    std::memcpy(Words, &_Value, sizeof(T));
+    for (auto i=0u; i<NUMBER_OF_WORDS; ++i) m_Words[i].store(Words[i], std::memory_order_relaxed);
+}
+
+} // namespace bfe
+
+#endif // SEQLOCK_H
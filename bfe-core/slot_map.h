@@ -0,0 +1,319 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       slot_map.h
+/// \brief      Prototype of class "CSlotMap"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-04
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+//--- Standard header --------------------------------------------------------//
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "handle_manager.h"
+#include "log.h"
+
+/// BFEngine namespace
+namespace bfe
+{
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Slot of a slot map, referring to the dense array
+///
+/// While the slot is free, the dense index is used as link to the next free
+/// slot.
+///
+////////////////////////////////////////////////////////////////////////////////
+struct SlotMapEntry
+{
+    std::uint32_t       Dense;      ///< Index in dense array, next free slot if free
+    HandleCounterType   Counter;    ///< Counter to manage stale handles
+
+    SlotMapEntry() : Dense(0u), Counter(0u) {}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Class storing objects densely packed, referenced by handle id's
+///
+/// Objects are stored contiguously in memory. They are referenced by a
+/// \ref HandleID (index and counter, just as handles of \ref CHandleManager),
+/// which stays valid until the object is removed. Removal moves the last
+/// object into the gap (swap and pop), hence, the dense range can be iterated
+/// without any gaps or indirections, e.g. for per-frame updates.
+///
+/// In contrast to \ref CHandleManager, the slot map owns the objects and is
+/// not thread safe. Pointers and references to objects (and iterators of the
+/// dense range) are invalidated by \ref insert, \ref emplace and
+/// \ref remove, handle id's are not.
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+class CSlotMap
+{
+
+    public:
+
+        typedef typename std::vector<T>::iterator       iterator;       ///< Iterator of dense range
+        typedef typename std::vector<T>::const_iterator const_iterator; ///< Constant iterator of dense range
+
+        //--- Constructor/Destructor -----------------------------------------//
+        CSlotMap();
+
+        //--- Constant Methods -----------------------------------------------//
+        const T*        get(const HandleID) const;
+        HandleID        getID(const std::uint32_t) const;
+        bool            isValid(const HandleID) const;
+
+        const_iterator  begin() const;
+        const_iterator  end() const;
+        const T*        data() const;
+        bool            empty() const;
+        std::uint32_t   size() const;
+
+        //--- Methods --------------------------------------------------------//
+        template <class... TArgs>
+        HandleID        emplace(TArgs&&...);
+        HandleID        insert(const T&);
+        HandleID        insert(T&&);
+        T*              get(const HandleID);
+        bool            remove(const HandleID);
+        void            clear();
+        void            reserve(const std::uint32_t);
+
+        iterator        begin();
+        iterator        end();
+        T*              data();
+
+    private:
+
+        //--- Methods [private] ----------------------------------------------//
+        HandleID        allocateSlot();
+
+        //--- Variables [private] --------------------------------------------//
+        std::vector<T>              m_Objects;      ///< Densely packed objects
+        std::vector<std::uint32_t>  m_DenseToSlot;  ///< Slot index for each object
+        std::vector<SlotMapEntry>   m_Slots;        ///< Slots referring to objects
+        std::uint32_t               m_nFreeHead;    ///< First free slot (index+1), 0 if none
+};
+
+//--- Implementation is done here for inline optimisation --------------------//
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Tests given handle for validity
+///
+/// \param _ID Handle id to test for validity
+///
+/// \return Handle valid (true/false)?
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline bool CSlotMap<T>::isValid(const HandleID _ID) const
+{
+    METHOD_ENTRY("CSlotMap::isValid")
+    return (_ID.C.Index != 0u && _ID.C.Index <= m_Slots.size() &&
+            _ID.C.Counter == m_Slots[_ID.C.Index-1].Counter);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns object which is represented by handle
+///
+/// \param _ID Handle id of object to be returned
+///
+/// \return Pointer to object, nullptr if handle is not valid
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline T* CSlotMap<T>::get(const HandleID _ID)
+{
+    METHOD_ENTRY("CSlotMap::get")
+    if (!this->isValid(_ID)) return nullptr;
+    return &m_Objects[m_Slots[_ID.C.Index-1].Dense];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns object which is represented by handle
+///
+/// \param _ID Handle id of object to be returned
+///
+/// \return Pointer to object, nullptr if handle is not valid
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline const T* CSlotMap<T>::get(const HandleID _ID) const
+{
+    METHOD_ENTRY("CSlotMap::get")
+    if (!this->isValid(_ID)) return nullptr;
+    return &m_Objects[m_Slots[_ID.C.Index-1].Dense];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns handle id of object at given position of dense range
+///
+/// \param _nDense Position in dense range
+///
+/// \return Handle id of object
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline HandleID CSlotMap<T>::getID(const std::uint32_t _nDense) const
+{
+    METHOD_ENTRY("CSlotMap::getID")
+
+    BFE_ASSERT(_nDense < m_Objects.size());
+
+    HandleID ID;
+    ID.C.Index = m_DenseToSlot[_nDense]+1;
+    ID.C.Counter = m_Slots[m_DenseToSlot[_nDense]].Counter;
+    return ID;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns iterator to begin of dense range
+///
+/// \return Iterator to first object
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline typename CSlotMap<T>::iterator CSlotMap<T>::begin()
+{
+    METHOD_ENTRY("CSlotMap::begin")
+    return m_Objects.begin();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns iterator to end of dense range
+///
+/// \return Iterator behind last object
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline typename CSlotMap<T>::iterator CSlotMap<T>::end()
+{
+    METHOD_ENTRY("CSlotMap::end")
+    return m_Objects.end();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns constant iterator to begin of dense range
+///
+/// \return Iterator to first object
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline typename CSlotMap<T>::const_iterator CSlotMap<T>::begin() const
+{
+    METHOD_ENTRY("CSlotMap::begin")
+    return m_Objects.cbegin();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns constant iterator to end of dense range
+///
+/// \return Iterator behind last object
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline typename CSlotMap<T>::const_iterator CSlotMap<T>::end() const
+{
+    METHOD_ENTRY("CSlotMap::end")
+    return m_Objects.cend();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns pointer to dense array of objects
+///
+/// \return Pointer to first object
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline T* CSlotMap<T>::data()
+{
+    METHOD_ENTRY("CSlotMap::data")
+    return m_Objects.data();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns constant pointer to dense array of objects
+///
+/// \return Pointer to first object
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline const T* CSlotMap<T>::data() const
+{
+    METHOD_ENTRY("CSlotMap::data")
+    return m_Objects.data();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns if slot map is empty
+///
+/// \return Slot map empty?
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline bool CSlotMap<T>::empty() const
+{
+    METHOD_ENTRY("CSlotMap::empty")
+    return m_Objects.empty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the number of objects
+///
+/// \return Number of objects (size of dense range)
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline std::uint32_t CSlotMap<T>::size() const
+{
+    METHOD_ENTRY("CSlotMap::size")
+    return static_cast<std::uint32_t>(m_Objects.size());
+}
+
+#include "slot_map.tpp"
+
+} // namespace bfe
+
+#endif // SLOT_MAP_H
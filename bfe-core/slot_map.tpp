@@ -0,0 +1,222 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       slot_map.tpp
+/// \brief      Implementation of class "CSlotMap"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-04
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#include "slot_map.h"
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Constructor
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+CSlotMap<T>::CSlotMap() : m_nFreeHead(0u)
+{
+    METHOD_ENTRY("CSlotMap::CSlotMap")
+    CTOR_CALL("CSlotMap")
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Constructs a new object in place
+///
+/// \param _Args Arguments forwarded to the constructor of the object
+///
+/// \return Handle id of new object, index is 0 (invalid) if map is full
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+template <class... TArgs>
+HandleID CSlotMap<T>::emplace(TArgs&&... _Args)
+{
+    METHOD_ENTRY("CSlotMap::emplace")
+
+    HandleID ID = this->allocateSlot();
+    if (ID.C.Index != 0u)
+    {
+        m_Objects.emplace_back(std::forward<TArgs>(_Args)...);
+    }
+    return ID;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Inserts a copy of given object
+///
+/// \param _Obj Object to be copied
+///
+/// \return Handle id of new object, index is 0 (invalid) if map is full
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+HandleID CSlotMap<T>::insert(const T& _Obj)
+{
+    METHOD_ENTRY("CSlotMap::insert")
+    return this->emplace(_Obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Inserts given object by moving it
+///
+/// \param _Obj Object to be moved
+///
+/// \return Handle id of new object, index is 0 (invalid) if map is full
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+HandleID CSlotMap<T>::insert(T&& _Obj)
+{
+    METHOD_ENTRY("CSlotMap::insert")
+    return this->emplace(std::move(_Obj));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Removes object, all instances of its handle id will become invalid
+///
+/// The last object of the dense range is moved into the gap to keep the
+/// range contiguous.
+///
+/// \param _ID Handle id of object to be removed
+///
+/// \return Success?
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+bool CSlotMap<T>::remove(const HandleID _ID)
+{
+    METHOD_ENTRY("CSlotMap::remove")
+
+    if (!this->isValid(_ID))
+    {
+        WARNING_MSG("Slot Map", "Handle " << _ID.C.Index << " not valid.")
+        return false;
+    }
+
+    const std::uint32_t nSlot  = _ID.C.Index-1;
+    const std::uint32_t nDense = m_Slots[nSlot].Dense;
+    const std::uint32_t nLast  = static_cast<std::uint32_t>(m_Objects.size())-1;
+
+    if (nDense != nLast)
+    {
+        m_Objects[nDense] = std::move(m_Objects[nLast]);
+        m_DenseToSlot[nDense] = m_DenseToSlot[nLast];
+        m_Slots[m_DenseToSlot[nDense]].Dense = nDense;
+    }
+    m_Objects.pop_back();
+    m_DenseToSlot.pop_back();
+
+    m_Slots[nSlot].Counter = HandleCounterType((m_Slots[nSlot].Counter+1u) & HANDLE_COUNTER_MASK);
+    m_Slots[nSlot].Dense = m_nFreeHead;
+    m_nFreeHead = nSlot+1;
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Removes all objects, all handle id's will become invalid
+///
+/// Slots are kept to maintain their counters, hence, stale handles are still
+/// detected after slots are reused.
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+void CSlotMap<T>::clear()
+{
+    METHOD_ENTRY("CSlotMap::clear")
+
+    for (const auto nSlot : m_DenseToSlot)
+    {
+        m_Slots[nSlot].Counter = HandleCounterType((m_Slots[nSlot].Counter+1u) & HANDLE_COUNTER_MASK);
+        m_Slots[nSlot].Dense = m_nFreeHead;
+        m_nFreeHead = nSlot+1;
+    }
+    m_Objects.clear();
+    m_DenseToSlot.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reserves memory for given number of objects
+///
+/// \param _nSize Number of objects to reserve memory for
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+void CSlotMap<T>::reserve(const std::uint32_t _nSize)
+{
+    METHOD_ENTRY("CSlotMap::reserve")
+
+    m_Objects.reserve(_nSize);
+    m_DenseToSlot.reserve(_nSize);
+    m_Slots.reserve(_nSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Takes a free slot or creates a new one, referring to the end of
+///        the dense range
+///
+/// \return Handle id of slot, index is 0 (invalid) if map is full
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+HandleID CSlotMap<T>::allocateSlot()
+{
+    METHOD_ENTRY("CSlotMap::allocateSlot")
+
+    HandleID ID;
+    std::uint32_t nSlot = 0u;
+
+    if (m_nFreeHead != 0u)
+    {
+        nSlot = m_nFreeHead-1;
+        m_nFreeHead = m_Slots[nSlot].Dense;
+    }
+    else if (m_Slots.size() < MAX_HANDLES)
+    {
+        nSlot = static_cast<std::uint32_t>(m_Slots.size());
+        m_Slots.emplace_back();
+    }
+    else
+    {
+        ERROR_MSG("Slot Map", "Maximum number of handles (" << MAX_HANDLES << ") reached.")
+        return ID;
+    }
+
+    m_Slots[nSlot].Counter = HandleCounterType((m_Slots[nSlot].Counter+1u) & HANDLE_COUNTER_MASK);
+    m_Slots[nSlot].Dense = static_cast<std::uint32_t>(m_Objects.size());
+    m_DenseToSlot.push_back(nSlot);
+
+    ID.C.Index = nSlot+1;
+    ID.C.Counter = m_Slots[nSlot].Counter;
+    return ID;
+}
@@ -37,9 +37,9 @@
 using namespace bfe;
 
 #ifdef BFE_MULTITHREADING
-    std::uint64_t CSpinlock::s_Sleeps = 0u;
-    std::uint64_t CSpinlock::s_Waits = 0u;
-    std::uint64_t CSpinlock::s_Yields = 0u;
+    std::atomic<std::uint64_t> CSpinlock::s_Sleeps{0u};
+    std::atomic<std::uint64_t> CSpinlock::s_Waits{0u};
+    std::atomic<std::uint64_t> CSpinlock::s_Yields{0u};
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -66,19 +66,19 @@ void CSpinlock::acquireLock()
                     asm("pause");
                 #endif
                 ++nIter;
-                DOM_STATS(DEBUG_BLK(++s_Waits;))
+                DOM_STATS(DEBUG_BLK(s_Waits.fetch_add(1u, std::memory_order_relaxed);))
             }
             else if (nIter < SPINLOCK_MAX_ITER*2)
             {
                 std::this_thread::yield();
                 ++nIter;
-                DOM_STATS(DEBUG_BLK(++s_Yields;))
+                DOM_STATS(DEBUG_BLK(s_Yields.fetch_add(1u, std::memory_order_relaxed);))
             }
             else
             {
                 using namespace std::chrono;
                 std::this_thread::sleep_for(500us);
-                DOM_STATS(DEBUG_BLK(++s_Sleeps;))
+                DOM_STATS(DEBUG_BLK(s_Sleeps.fetch_add(1u, std::memory_order_relaxed);))
             }
         }
     #endif
@@ -130,19 +130,19 @@ void CSpinlock::waitForRelease()
                     asm("pause");
                 #endif
                 ++nIter;
-                DOM_STATS(DEBUG_BLK(++s_Waits;))
+                DOM_STATS(DEBUG_BLK(s_Waits.fetch_add(1u, std::memory_order_relaxed);))
             }
             else if (nIter < SPINLOCK_MAX_ITER*2)
             {
                 std::this_thread::yield();
                 ++nIter;
-                DOM_STATS(DEBUG_BLK(++s_Yields;))
+                DOM_STATS(DEBUG_BLK(s_Yields.fetch_add(1u, std::memory_order_relaxed);))
             }
             else
             {
                 using namespace std::chrono;
                 std::this_thread::sleep_for(500us);
-                DOM_STATS(DEBUG_BLK(++s_Sleeps;))
+                DOM_STATS(DEBUG_BLK(s_Sleeps.fetch_add(1u, std::memory_order_relaxed);))
             }
         }
         isAccessed.clear(std::memory_order_release);
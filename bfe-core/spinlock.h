@@ -57,7 +57,8 @@ constexpr int SPINLOCK_MAX_ITER = 100;
 ///       https://geidav.wordpress.com/ (visited 2017-12-08)
 ///
 /// The spinlock uses an atomic_flag to signal access. If lock is hold for some
-/// iterations a sleep is involved to reduce CPU load.
+/// iterations a sleep is involved to reduce CPU load. For contended locks,
+/// \ref CAdaptiveLock avoids the latency of the fixed sleep.
 ///
 ////////////////////////////////////////////////////////////////////////////////
 class CSpinlock
@@ -76,9 +77,9 @@ class CSpinlock
         void waitForRelease();
         
         #ifdef BFE_MULTITHREADING
-            static std::uint64_t getSleeps(){return s_Sleeps;}
-            static std::uint64_t getWaits(){return s_Waits;}
-            static std::uint64_t getYields(){return s_Yields;}
+            static std::uint64_t getSleeps(){return s_Sleeps.load(std::memory_order_relaxed);}
+            static std::uint64_t getWaits(){return s_Waits.load(std::memory_order_relaxed);}
+            static std::uint64_t getYields(){return s_Yields.load(std::memory_order_relaxed);}
         #endif
         
     private:
@@ -86,9 +87,9 @@ class CSpinlock
         //--- Variables [private] --------------------------------------------//
         #ifdef BFE_MULTITHREADING
             std::atomic_flag isAccessed = ATOMIC_FLAG_INIT; ///< Indicates access, important for multithreading
-            static std::uint64_t s_Sleeps;
-            static std::uint64_t s_Waits;
-            static std::uint64_t s_Yields;
+            static std::atomic<std::uint64_t> s_Sleeps;     ///< Number of sleeps of all spinlocks
+            static std::atomic<std::uint64_t> s_Waits;      ///< Number of pauses of all spinlocks
+            static std::atomic<std::uint64_t> s_Yields;     ///< Number of yields of all spinlocks
         #endif
 };
 
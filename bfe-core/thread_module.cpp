@@ -30,30 +30,576 @@
 
 #include "thread_module.h"
 
+//--- Standard header --------------------------------------------------------//
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+    #include <cerrno>
+    #include <cstring>
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/resource.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+//--- Program header ---------------------------------------------------------//
+#include "handle.h"
+#include "job_system.h"
+
 using namespace bfe;
 
+//--- Enum parser ------------------------------------------------------------//
+static const std::unordered_map<std::string, SchedulingPolicyType> STRING_TO_SCHEDULING_POLICY_TYPE_MAP = {
+    {"default", SchedulingPolicyType::DEFAULT},
+    {"other", SchedulingPolicyType::OTHER},
+    {"batch", SchedulingPolicyType::BATCH},
+    {"idle", SchedulingPolicyType::IDLE},
+    {"fifo", SchedulingPolicyType::FIFO},
+    {"rr", SchedulingPolicyType::ROUND_ROBIN}
+}; ///< Map from string to SchedulingPolicyType
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Maps given string to scheduling policy
+///
+/// \param _strS String to be mapped
+///
+/// \return Scheduling policy
+///
+////////////////////////////////////////////////////////////////////////////////
+static SchedulingPolicyType mapStringToSchedulingPolicy(const std::string& _strS)
+{
+    METHOD_ENTRY("mapStringToSchedulingPolicy")
+    
+    const auto ci = STRING_TO_SCHEDULING_POLICY_TYPE_MAP.find(_strS);
+    if (ci != STRING_TO_SCHEDULING_POLICY_TYPE_MAP.end())
+        return ci->second;
+    else
+        return SchedulingPolicyType::INVALID;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Registry of all existing modules, used to access modules by name
+///
+////////////////////////////////////////////////////////////////////////////////
+struct ThreadModuleRegistry
+{
+    std::mutex                  Access;     ///< Protects list of modules
+    std::vector<IThreadModule*> Modules;    ///< Existing modules
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns registry of modules, constructed on first use
+///
+/// \return Registry of modules
+///
+////////////////////////////////////////////////////////////////////////////////
+static ThreadModuleRegistry& getRegistry()
+{
+    METHOD_ENTRY("getRegistry")
+    static ThreadModuleRegistry Registry;
+    return Registry;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns percentile of sorted values, using nearest rank
+///
+/// \param _Sorted Values in ascending order, not empty
+/// \param _fPercentile Percentile in range [0, 100]
+///
+/// \return Value of given percentile
+///
+////////////////////////////////////////////////////////////////////////////////
+static double percentile(const std::vector<double>& _Sorted, const double _fPercentile)
+{
+    METHOD_ENTRY("percentile")
+    
+    std::size_t nRank = std::size_t(std::ceil(_fPercentile/100.0 * _Sorted.size()));
+    if (nRank > 0u) --nRank;
+    return _Sorted[std::min(nRank, _Sorted.size()-1u)];
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Constructor
 ///
 ////////////////////////////////////////////////////////////////////////////////
-IThreadModule::IThreadModule() : m_fFrequency(THREAD_MODULE_DEFAULT_FREQUENCY),
+IThreadModule::IThreadModule() : m_strModuleName("Thread Module"),
+                                 m_fFrequency(THREAD_MODULE_DEFAULT_FREQUENCY),
                                  m_fTimeSlept(1.0),
-                                 m_fTimeAccel(1.0)
+                                 m_fTimeAccel(1.0),
+                                 m_TimesProcessed(THREAD_MODULE_STATISTICS_SIZE),
+                                 m_TimesSlept(THREAD_MODULE_STATISTICS_SIZE)
 {
     METHOD_ENTRY("IThreadModule::IThreadModule")
     CTOR_CALL("IThreadModule::IThreadModule")
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Destructor, removes module from registry
+///
+////////////////////////////////////////////////////////////////////////////////
+IThreadModule::~IThreadModule()
+{
+    METHOD_ENTRY("IThreadModule::~IThreadModule")
+    DTOR_CALL("IThreadModule::~IThreadModule")
     
-    #ifdef BFE_MULTITHREADING
-        m_strModuleName = "Thread Module";
+    std::lock_guard<std::mutex> Lock(getRegistry().Access);
+    auto& Modules = getRegistry().Modules;
+    Modules.erase(std::remove(Modules.begin(), Modules.end(), this), Modules.end());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns frame time statistics over the latest frames
+///
+/// Percentiles are computed by nearest rank from a sorted copy of the window,
+/// hence, this is meant for occasional queries, not per frame.
+///
+/// \return Statistics of module
+///
+////////////////////////////////////////////////////////////////////////////////
+ThreadModuleStatistics IThreadModule::getStatistics() const
+{
+    METHOD_ENTRY("IThreadModule::getStatistics")
+    
+    ThreadModuleStatistics Statistics;
+    std::vector<double> Processed;
+    double fSlept = 0.0;
+    
+    m_AccessStatistics.acquireLock();
+    Statistics.nFrames = m_nFrames;
+    Statistics.nOverruns = m_nOverruns;
+    Processed.reserve(m_TimesProcessed.size());
+    for (auto i=0u; i<m_TimesProcessed.size(); ++i)
+    {
+        Processed.push_back(m_TimesProcessed[i]);
+        fSlept += m_TimesSlept[i];
+    }
+    m_AccessStatistics.releaseLock();
+    
+    Statistics.nWindow = Processed.size();
+    if (Processed.empty()) return Statistics;
+    
+    std::sort(Processed.begin(), Processed.end());
+    double fSum = 0.0;
+    for (const auto fTime : Processed) fSum += fTime;
+    
+    Statistics.fMin = Processed.front();
+    Statistics.fMax = Processed.back();
+    Statistics.fMean = fSum / Processed.size();
+    Statistics.fP50 = percentile(Processed, 50.0);
+    Statistics.fP95 = percentile(Processed, 95.0);
+    Statistics.fP99 = percentile(Processed, 99.0);
+    Statistics.fSleepMean = fSlept / Processed.size();
+    
+    return Statistics;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns frame time statistics as readable text
+///
+/// \return Statistics of module, times in milliseconds
+///
+////////////////////////////////////////////////////////////////////////////////
+std::string IThreadModule::getStatisticsText() const
+{
+    METHOD_ENTRY("IThreadModule::getStatisticsText")
+    
+    const ThreadModuleStatistics Statistics = this->getStatistics();
+    
+    std::ostringstream oss;
+    oss << m_strModuleName << ": frames " << Statistics.nFrames <<
+           ", overruns " << Statistics.nOverruns <<
+           ", window " << Statistics.nWindow <<
+           ", min " << Statistics.fMin*1.0e3 <<
+           "ms, mean " << Statistics.fMean*1.0e3 <<
+           "ms, p50 " << Statistics.fP50*1.0e3 <<
+           "ms, p95 " << Statistics.fP95*1.0e3 <<
+           "ms, p99 " << Statistics.fP99*1.0e3 <<
+           "ms, max " << Statistics.fMax*1.0e3 <<
+           "ms, slept " << Statistics.fSleepMean*1.0e3 << "ms";
+    return oss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns settings of thread running the module
+///
+/// \return Thread settings
+///
+////////////////////////////////////////////////////////////////////////////////
+ThreadSettings IThreadModule::getThreadSettings() const
+{
+    METHOD_ENTRY("IThreadModule::getThreadSettings")
+    
+    m_AccessThreadSettings.acquireLock();
+    const ThreadSettings Settings = m_ThreadSettings;
+    m_AccessThreadSettings.releaseLock();
+    
+    return Settings;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Applies thread settings to the calling thread
+///
+/// The thread is named after the module, truncated to 15 characters. Cores,
+/// scheduling policy and nice value are only changed if set. Called by run()
+/// at start and whenever settings change, modules running in threads of their
+/// own may call it directly.
+///
+/// \return Success? Fails e.g. for real time policies without privileges.
+///
+////////////////////////////////////////////////////////////////////////////////
+bool IThreadModule::applyThreadSettings()
+{
+    METHOD_ENTRY("IThreadModule::applyThreadSettings")
+    
+    m_bThreadSettingsChanged = false;
+    const ThreadSettings Settings = this->getThreadSettings();
+    
+    #ifdef __linux__
+        bool bSuccess = true;
+        
+        pthread_setname_np(pthread_self(), m_strModuleName.substr(0, 15).c_str());
+        
+        if (!Settings.Cores.empty())
+        {
+            cpu_set_t Cores;
+            CPU_ZERO(&Cores);
+            for (const auto nCore : Settings.Cores)
+            {
+                if (nCore >= 0 && nCore < CPU_SETSIZE) CPU_SET(nCore, &Cores);
+            }
+            const int nError = pthread_setaffinity_np(pthread_self(), sizeof(Cores), &Cores);
+            if (nError != 0)
+            {
+                WARNING_MSG("Thread Module", "Couldn't set cores of " << m_strModuleName << ": " << std::strerror(nError))
+                bSuccess = false;
+            }
+        }
+        
+        if (Settings.SchedulingPolicy != SchedulingPolicyType::DEFAULT)
+        {
+            int nPolicy = SCHED_OTHER;
+            sched_param Param;
+            Param.sched_priority = 0;
+            switch (Settings.SchedulingPolicy)
+            {
+                case SchedulingPolicyType::BATCH: nPolicy = SCHED_BATCH; break;
+                case SchedulingPolicyType::IDLE: nPolicy = SCHED_IDLE; break;
+                case SchedulingPolicyType::FIFO:
+                    nPolicy = SCHED_FIFO;
+                    Param.sched_priority = Settings.nPriority;
+                    break;
+                case SchedulingPolicyType::ROUND_ROBIN:
+                    nPolicy = SCHED_RR;
+                    Param.sched_priority = Settings.nPriority;
+                    break;
+                default: break;
+            }
+            const int nError = pthread_setschedparam(pthread_self(), nPolicy, &Param);
+            if (nError != 0)
+            {
+                WARNING_MSG("Thread Module", "Couldn't set scheduling policy of " << m_strModuleName << ": " << std::strerror(nError))
+                bSuccess = false;
+            }
+        }
+        
+        // Nice values are per thread on Linux, addressed by thread id
+        if (Settings.bNice &&
+            setpriority(PRIO_PROCESS, id_t(syscall(SYS_gettid)), Settings.nNice) != 0)
+        {
+            WARNING_MSG("Thread Module", "Couldn't set nice value of " << m_strModuleName << ": " << std::strerror(errno))
+            bSuccess = false;
+        }
+        
+        return bSuccess;
+    #else
+        if (!Settings.Cores.empty() || Settings.bNice ||
+            Settings.SchedulingPolicy != SchedulingPolicyType::DEFAULT)
+        {
+            NOTICE_MSG("Thread Module", "Thread settings not supported on this platform, " << m_strModuleName << " unchanged.")
+        }
+        return false;
     #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Records processing and sleep time of a frame
+///
+/// A frame overruns if processing takes longer than the frame period given
+/// by frequency and time acceleration of the module.
+///
+/// \param _fProcessed Processing time of frame in seconds
+/// \param _fSlept Sleep time after frame in seconds
+///
+////////////////////////////////////////////////////////////////////////////////
+void IThreadModule::recordFrame(const double _fProcessed, const double _fSlept)
+{
+    METHOD_ENTRY("IThreadModule::recordFrame")
+    
+    const bool bOverrun = _fProcessed > 1.0/(m_fFrequency*m_fTimeAccel);
+    
+    m_AccessStatistics.acquireLock();
+    m_TimesProcessed.push_back(_fProcessed);
+    m_TimesSlept.push_back(_fSlept);
+    ++m_nFrames;
+    if (bOverrun) ++m_nOverruns;
+    m_AccessStatistics.releaseLock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Registers module in the global module registry
+///
+/// The module must be constructed completely, since it is accessible by
+/// other threads once registered. Registering it again has no effect.
+///
+////////////////////////////////////////////////////////////////////////////////
+void IThreadModule::registerModule()
+{
+    METHOD_ENTRY("IThreadModule::registerModule")
+    
+    std::lock_guard<std::mutex> Lock(getRegistry().Access);
+    if (!m_bRegistered)
+    {
+        getRegistry().Modules.push_back(this);
+        m_bRegistered = true;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Sets cores the thread running the module may run on
+///
+/// \param _Cores Indices of cores, affinity is unchanged if empty
+///
+////////////////////////////////////////////////////////////////////////////////
+void IThreadModule::setCores(const std::vector<int>& _Cores)
+{
+    METHOD_ENTRY("IThreadModule::setCores")
+    
+    m_AccessThreadSettings.acquireLock();
+    m_ThreadSettings.Cores = _Cores;
+    m_AccessThreadSettings.releaseLock();
+    m_bThreadSettingsChanged = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Sets cores the thread running the module may run on
+///
+/// \param _strCores Comma separated list of cores or ranges, e.g. "0,2-3",
+///                  or "all"
+///
+/// \return Success? Cores are unchanged if list is invalid.
+///
+////////////////////////////////////////////////////////////////////////////////
+bool IThreadModule::setCores(const std::string& _strCores)
+{
+    METHOD_ENTRY("IThreadModule::setCores")
+    
+    std::vector<int> Cores;
+    if (_strCores == "all")
+    {
+        for (auto i=0u; i<std::max(1u, std::thread::hardware_concurrency()); ++i) Cores.push_back(i);
+    }
+    else
+    {
+        std::istringstream iss(_strCores);
+        std::string strRange;
+        while (std::getline(iss, strRange, ','))
+        {
+            int nFirst = -1;
+            int nLast = -1;
+            char chDash = '-';
+            std::istringstream issRange(strRange);
+            if (!(issRange >> nFirst) || nFirst < 0)
+            {
+                WARNING_MSG("Thread Module", "Invalid cores <" << _strCores << ">, " << m_strModuleName << " unchanged.")
+                return false;
+            }
+            nLast = nFirst;
+            if (issRange >> chDash)
+            {
+                if (chDash != '-' || !(issRange >> nLast) || nLast < nFirst)
+                {
+                    WARNING_MSG("Thread Module", "Invalid cores <" << _strCores << ">, " << m_strModuleName << " unchanged.")
+                    return false;
+                }
+            }
+            for (auto i=nFirst; i<=nLast; ++i) Cores.push_back(i);
+        }
+        if (Cores.empty())
+        {
+            WARNING_MSG("Thread Module", "No cores given, " << m_strModuleName << " unchanged.")
+            return false;
+        }
+    }
+    this->setCores(Cores);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Sets nice value of thread running the module
+///
+/// \param _nNice Nice value, -20 (highest priority) to 19 (lowest)
+///
+////////////////////////////////////////////////////////////////////////////////
+void IThreadModule::setNice(const int _nNice)
+{
+    METHOD_ENTRY("IThreadModule::setNice")
+    
+    m_AccessThreadSettings.acquireLock();
+    m_ThreadSettings.nNice = _nNice;
+    m_ThreadSettings.bNice = true;
+    m_AccessThreadSettings.releaseLock();
+    m_bThreadSettingsChanged = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Sets priority of thread running the module, for real time policies
+///
+/// \param _nPriority Priority, 1 (lowest) to 99 (highest) on Linux
+///
+////////////////////////////////////////////////////////////////////////////////
+void IThreadModule::setPriority(const int _nPriority)
+{
+    METHOD_ENTRY("IThreadModule::setPriority")
+    
+    m_AccessThreadSettings.acquireLock();
+    m_ThreadSettings.nPriority = _nPriority;
+    m_AccessThreadSettings.releaseLock();
+    m_bThreadSettingsChanged = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Sets scheduling policy of thread running the module
+///
+/// \param _SchedulingPolicy Scheduling policy
+///
+////////////////////////////////////////////////////////////////////////////////
+void IThreadModule::setSchedulingPolicy(const SchedulingPolicyType _SchedulingPolicy)
+{
+    METHOD_ENTRY("IThreadModule::setSchedulingPolicy")
+    
+    m_AccessThreadSettings.acquireLock();
+    m_ThreadSettings.SchedulingPolicy = _SchedulingPolicy;
+    m_AccessThreadSettings.releaseLock();
+    m_bThreadSettingsChanged = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Sets scheduling policy of thread running the module
+///
+/// \param _strPolicy Scheduling policy, one of "default", "other", "batch",
+///                   "idle", "fifo", "rr"
+///
+/// \return Success? Policy is unchanged if unknown.
+///
+////////////////////////////////////////////////////////////////////////////////
+bool IThreadModule::setSchedulingPolicy(const std::string& _strPolicy)
+{
+    METHOD_ENTRY("IThreadModule::setSchedulingPolicy")
+    
+    const SchedulingPolicyType Policy = mapStringToSchedulingPolicy(_strPolicy);
+    if (Policy == SchedulingPolicyType::INVALID)
+    {
+        WARNING_MSG("Thread Module", "Unknown scheduling policy <" << _strPolicy << ">, " << m_strModuleName << " unchanged.")
+        return false;
+    }
+    this->setSchedulingPolicy(Policy);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls given function for all modules of given name
+///
+/// Names are compared with spaces replaced by underscores as well, thus,
+/// modules like "Lua Manager" can be given as single word "Lua_Manager".
+/// Modules can't be destroyed while the function is called.
+///
+/// \param _strName Name of module, all modules if empty
+/// \param _Function Function to be called for each matching module
+///
+/// \return Number of matching modules
+///
+////////////////////////////////////////////////////////////////////////////////
+int IThreadModule::forEachModule(const std::string& _strName,
+                                 const std::function<void(IThreadModule&)>& _Function)
+{
+    METHOD_ENTRY("IThreadModule::forEachModule")
+    
+    int nModules = 0;
+    
+    std::lock_guard<std::mutex> Lock(getRegistry().Access);
+    for (const auto pModule : getRegistry().Modules)
+    {
+        std::string strNameUnderscored = pModule->getModuleName();
+        std::replace(strNameUnderscored.begin(), strNameUnderscored.end(), ' ', '_');
+        
+        if (_strName.empty() || _strName == pModule->getModuleName() || _strName == strNameUnderscored)
+        {
+            _Function(*pModule);
+            ++nModules;
+        }
+    }
+    return nModules;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns statistics of modules as readable text
+///
+/// \param _strName Name of module, all modules if empty
+///
+/// \return Statistics of matching modules, one per line
+///
+////////////////////////////////////////////////////////////////////////////////
+std::string IThreadModule::getStatisticsText(const std::string& _strName)
+{
+    METHOD_ENTRY("IThreadModule::getStatisticsText")
+    
+    std::string strText;
+    
+    forEachModule(_strName, [&strText](IThreadModule& _Module)
+    {
+        if (!strText.empty()) strText += "\n";
+        strText += _Module.getStatisticsText();
+    });
+    if (strText.empty()) strText = "No module <" + _strName + "> found.";
+    return strText;
+}
+
 #ifdef BFE_MULTITHREADING
   ////////////////////////////////////////////////////////////////////////////////
   ///
   /// \brief Runs the visuals engine, called as a thread.
   ///
+  /// The thread is registered at the epoch manager of handles. Each frame
+  /// boundary is announced as quiescent state, hence, raw pointers obtained
+  /// from handles must not be kept across frames.
+  ///
   ///////////////////////////////////////////////////////////////////////////////
   void IThreadModule::run()
   {
@@ -61,6 +607,10 @@ IThreadModule::IThreadModule() : m_fFrequency(THREAD_MODULE_DEFAULT_FREQUENCY),
       
       INFO_MSG("Thread Module", m_strModuleName << " started.")
       
+      this->registerModule();
+      const int nEpochParticipant = CHandleBase::getEpochManager().registerParticipant();
+      
+      this->applyThreadSettings();
       this->preRun();
       m_bRunning = true;
       
@@ -70,7 +620,11 @@ IThreadModule::IThreadModule() : m_fFrequency(THREAD_MODULE_DEFAULT_FREQUENCY),
       while (m_bRunning)
       {
           if (!this->processFrame()) m_bRunning = false;
+          CHandleBase::getEpochManager().announce(nEpochParticipant);
+          if (m_bThreadSettingsChanged) this->applyThreadSettings();
+          ThreadModuleTimer.setSleepMode(m_SleepMode);
           m_fTimeSlept = ThreadModuleTimer.sleepRemaining(m_fFrequency*m_fTimeAccel);
+          this->recordFrame(1.0/(m_fFrequency*m_fTimeAccel) - m_fTimeSlept, std::max(0.0, m_fTimeSlept));
           
           if (m_fTimeSlept < 0.0)
           {
@@ -78,7 +632,59 @@ IThreadModule::IThreadModule() : m_fFrequency(THREAD_MODULE_DEFAULT_FREQUENCY),
                                           "s of " << 1.0/m_fFrequency << "s max.")
           }
       }
+      CHandleBase::getEpochManager().unregisterParticipant(nEpochParticipant);
+      
       INFO_MSG("Thread Module", m_strModuleName << " stopped.")
   }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  ///
+  /// \brief Runs the module as recurring job instead of a thread of its own
+  ///
+  /// Frames are processed by the workers of the given job system with the
+  /// frequency of the module. Workers announce quiescent states of the epoch
+  /// manager between jobs. The call returns immediately, the module is
+  /// stopped by terminate(). It must outlive the job system or be removed
+  /// from it before destruction. Thread settings aren't applied, since
+  /// workers are shared by all jobs.
+  ///
+  /// \param _pJobSystem Job system running the module
+  ///
+  ///////////////////////////////////////////////////////////////////////////////
+  void IThreadModule::runAsJob(CJobSystem* const _pJobSystem)
+  {
+      METHOD_ENTRY("IThreadModule::runAsJob")
+      
+      INFO_MSG("Thread Module", m_strModuleName << " started as job.")
+      
+      this->registerModule();
+      this->preRun();
+      m_bRunning = true;
+      
+      _pJobSystem->addRecurring([this]() -> bool
+      {
+          if (m_bRunning)
+          {
+              CTimer FrameTimer;
+              FrameTimer.start();
+              if (!this->processFrame()) m_bRunning = false;
+              FrameTimer.stop();
+              m_fTimeSlept = 1.0/(m_fFrequency*m_fTimeAccel) - FrameTimer.getTime();
+              this->recordFrame(FrameTimer.getTime(), std::max(0.0, m_fTimeSlept));
+              
+              if (m_fTimeSlept < 0.0)
+              {
+                  DEBUG_MSG("Thread Module", "Execution time of job " << m_strModuleName << " is too large: " << 1.0/m_fFrequency - m_fTimeSlept << 
+                                              "s of " << 1.0/m_fFrequency << "s max.")
+              }
+          }
+          if (!m_bRunning)
+          {
+              INFO_MSG("Thread Module", m_strModuleName << " stopped.")
+              return false;
+          }
+          return true;
+      }, m_fFrequency*m_fTimeAccel);
+  }
 #endif
 
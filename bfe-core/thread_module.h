@@ -32,21 +32,82 @@
 #define THREAD_MODULE_H
 
 //--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
 
 //--- Program header ---------------------------------------------------------//
 #include "conf_bfengine.h"
 #include "log.h"
+#include "adaptive_lock.h"
+#include "circular_buffer.h"
+#include "timer.h"
 
 /// BFEngine namespace
 namespace bfe
 {
 
 const double THREAD_MODULE_DEFAULT_FREQUENCY = 60.0;   ///< Default frequency for module
+const std::size_t THREAD_MODULE_STATISTICS_SIZE = 1024; ///< Number of frames in window of statistics
+
+class CJobSystem;
+
+/// Specifies the scheduling policy of a module's thread
+enum class SchedulingPolicyType
+{
+    INVALID,
+    DEFAULT,        ///< Policy of thread isn't changed
+    OTHER,          ///< Standard time sharing (SCHED_OTHER)
+    BATCH,          ///< Cpu intensive, non-interactive (SCHED_BATCH)
+    IDLE,           ///< Very low priority (SCHED_IDLE)
+    FIFO,           ///< Real time, first in first out, needs privileges (SCHED_FIFO)
+    ROUND_ROBIN     ///< Real time, round robin, needs privileges (SCHED_RR)
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Settings applied to the thread running a module
+///
+////////////////////////////////////////////////////////////////////////////////
+struct ThreadSettings
+{
+    std::vector<int>        Cores;              ///< Cores the thread may run on, unchanged if empty
+    SchedulingPolicyType    SchedulingPolicy = SchedulingPolicyType::DEFAULT; ///< Scheduling policy
+    int                     nPriority = 0;      ///< Priority for real time policies
+    int                     nNice = 0;          ///< Nice value for time sharing policies
+    bool                    bNice = false;      ///< Indicates if nice value is applied
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Frame time statistics of a module over a sliding window
+///
+////////////////////////////////////////////////////////////////////////////////
+struct ThreadModuleStatistics
+{
+    std::uint64_t   nFrames = 0u;       ///< Number of frames recorded since start
+    std::uint64_t   nOverruns = 0u;     ///< Number of frames exceeding their time budget since start
+    std::size_t     nWindow = 0u;       ///< Number of frames in window
+    double          fMin = 0.0;         ///< Minimum processing time in window
+    double          fMean = 0.0;        ///< Mean processing time in window
+    double          fP50 = 0.0;         ///< Median processing time in window
+    double          fP95 = 0.0;         ///< 95th percentile of processing time in window
+    double          fP99 = 0.0;         ///< 99th percentile of processing time in window
+    double          fMax = 0.0;         ///< Maximum processing time in window
+    double          fSleepMean = 0.0;   ///< Mean sleep time in window
+};
 
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Interface defining a general thread module
 ///
+/// Modules are listed in the global module registry, accessed by name e.g.
+/// by com function "module_stats", once registered by \ref registerModule.
+/// Running a module registers it, as do runners it is added to. Thus, name
+/// and settings of derived classes are set when it is listed.
+///
 ////////////////////////////////////////////////////////////////////////////////
 class IThreadModule
 {
@@ -55,19 +116,39 @@ class IThreadModule
 
         //--- Constructor/Destructor -----------------------------------------//
         IThreadModule();
-        virtual ~IThreadModule() {}
+        virtual ~IThreadModule();
         
         //--- Constant Methods -----------------------------------------------//
-        const double&   getFrequency() const;
-              double    getTimePerFrame() const;
-              double    getTimeProcessed() const;
+        const double&       getFrequency() const;
+        const std::string&  getModuleName() const;
+              SleepModeType getSleepMode() const;
+        ThreadModuleStatistics getStatistics() const;
+        std::string         getStatisticsText() const;
+        ThreadSettings      getThreadSettings() const;
+              double        getTimePerFrame() const;
+              double        getTimeProcessed() const;
                 
         //--- Methods --------------------------------------------------------//
+        bool            applyThreadSettings();
         virtual bool    processFrame() = 0;
+        void            recordFrame(const double, const double);
+        void            registerModule();
+        void            setCores(const std::vector<int>&);
+        bool            setCores(const std::string&);
         void            setFrequency(const double&);
+        void            setNice(const int);
+        void            setPriority(const int);
+        void            setSchedulingPolicy(const SchedulingPolicyType);
+        bool            setSchedulingPolicy(const std::string&);
+        void            setSleepMode(const SleepModeType);
+        
+        //--- Static methods -------------------------------------------------//
+        static int         forEachModule(const std::string&, const std::function<void(IThreadModule&)>&);
+        static std::string getStatisticsText(const std::string&);
 
         #ifdef BFE_MULTITHREADING
           void run();
+          void runAsJob(CJobSystem* const);
           void terminate();
         #endif
         
@@ -77,13 +158,29 @@ class IThreadModule
         #ifdef BFE_MULTITHREADING
           virtual void  preRun() {}         ///< Everything that needs to be done before run()
           
-          std::string   m_strModuleName;    ///< Name of module
-          bool          m_bRunning = false; ///< Indicates if thread is running
+          std::atomic<bool> m_bRunning{false}; ///< Indicates if thread is running, stopped by other threads
         #endif
         
+        std::string     m_strModuleName;    ///< Name of module
         double          m_fFrequency;       ///< Frequency of module update
         double          m_fTimeSlept;       ///< Sleep time of thread
         double          m_fTimeAccel;       ///< Time acceleration of module
+        SleepModeType   m_SleepMode = SleepModeType::CONDITION_VARIABLE; ///< Strategy of sleeping between frames
+        
+    private:
+        
+        //--- Variables [private] --------------------------------------------//
+        bool                    m_bRegistered = false;  ///< Indicates registration, guarded by registry
+        
+        mutable CAdaptiveLock   m_AccessStatistics;     ///< Protects statistics, read by other threads
+        CCircularBuffer<double> m_TimesProcessed;       ///< Processing times of latest frames
+        CCircularBuffer<double> m_TimesSlept;           ///< Sleep times of latest frames
+        std::uint64_t           m_nFrames = 0u;         ///< Number of frames recorded
+        std::uint64_t           m_nOverruns = 0u;       ///< Number of frames exceeding their time budget
+        
+        mutable CAdaptiveLock   m_AccessThreadSettings; ///< Protects thread settings, changed by other threads
+        ThreadSettings          m_ThreadSettings;       ///< Settings of thread running the module
+        std::atomic_bool        m_bThreadSettingsChanged{false}; ///< Indicates that settings need to be applied
 };
 
 //--- Implementation is done here for inline optimisation --------------------//
@@ -101,6 +198,32 @@ inline const double& IThreadModule::getFrequency() const
     return (m_fFrequency);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns name of module
+///
+/// \return Name of module
+///
+////////////////////////////////////////////////////////////////////////////////
+inline const std::string& IThreadModule::getModuleName() const
+{
+    METHOD_ENTRY("IThreadModule::getModuleName")
+    return m_strModuleName;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns strategy of sleeping between frames
+///
+/// \return Sleep mode
+///
+////////////////////////////////////////////////////////////////////////////////
+inline SleepModeType IThreadModule::getSleepMode() const
+{
+    METHOD_ENTRY("IThreadModule::getSleepMode")
+    return m_SleepMode;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Returns time per frame
@@ -140,6 +263,26 @@ inline void IThreadModule::setFrequency(const double& _fFrequency)
     m_fFrequency = _fFrequency;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Sets the strategy of sleeping between frames
+///
+/// Hybrid sleeping reduces jitter of high frequency modules by spinning
+/// shortly before the next frame, thus it costs cpu time. Only applies to
+/// modules running as thread, jobs are scheduled by the job system.
+///
+/// \param _SleepMode Sleep mode
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void IThreadModule::setSleepMode(const SleepModeType _SleepMode)
+{
+    METHOD_ENTRY("IThreadModule::setSleepMode")
+    
+    // Calibrate by the caller, not within a frame of the module
+    if (_SleepMode == SleepModeType::HYBRID) CTimer::getSleepMargin();
+    m_SleepMode = _SleepMode;
+}
+
 #ifdef BFE_MULTITHREADING
   ////////////////////////////////////////////////////////////////////////////////
   ///
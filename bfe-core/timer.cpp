@@ -30,11 +30,63 @@
 
 #include "timer.h"
 
+#include <algorithm>
 #include <string>
 #include <thread>
 
+#ifdef __linux__
+    #include <cerrno>
+    #include <time.h>
+#endif
+
 using namespace bfe;
 
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Sleeps until given time, without any spinning
+///
+/// On Linux, clock_nanosleep with an absolute time is used, which doesn't
+/// accumulate errors if interrupted. steady_clock is based on CLOCK_MONOTONIC.
+///
+/// \param _Until Time to wake up
+///
+///////////////////////////////////////////////////////////////////////////////
+static void sleepCoarse(const std::chrono::steady_clock::time_point& _Until)
+{
+    #ifdef __linux__
+        const auto nNs = std::chrono::duration_cast<std::chrono::nanoseconds>(_Until.time_since_epoch()).count();
+        timespec Time;
+        Time.tv_sec = nNs / 1000000000;
+        Time.tv_nsec = nNs % 1000000000;
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Time, nullptr) == EINTR) {}
+    #else
+        std::this_thread::sleep_until(_Until);
+    #endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Measures how much coarse sleeping oversleeps on this system
+///
+/// \return Time to spin before deadline in seconds
+///
+///////////////////////////////////////////////////////////////////////////////
+static double calibrateSleepMargin()
+{
+    using namespace std::chrono;
+    
+    constexpr int nSamples = 16;
+    
+    double fOversleptMax = 0.0;
+    for (auto i=0; i<nSamples; ++i)
+    {
+        const auto Until = steady_clock::now() + microseconds(200);
+        sleepCoarse(Until);
+        fOversleptMax = std::max(fOversleptMax, duration<double>(steady_clock::now() - Until).count());
+    }
+    return std::min(std::max(1.5*fOversleptMax, TIMER_SLEEP_MARGIN_MIN), TIMER_SLEEP_MARGIN_MAX);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief CTimer
@@ -44,8 +96,8 @@ CTimer::CTimer() : m_fCountAbsolute(0.0), m_fFrequency(-1.0)
 {
     // Initialise m_Start to be sure to have a valid time if stop() is called
     // without calling start() first
-    m_Start = std::chrono::high_resolution_clock::now();
-    m_StartAbsolute = std::chrono::high_resolution_clock::now();
+    m_Start = std::chrono::steady_clock::now();
+    m_StartAbsolute = std::chrono::steady_clock::now();
 
 }
 
@@ -56,7 +108,7 @@ CTimer::CTimer() : m_fCountAbsolute(0.0), m_fFrequency(-1.0)
 ///////////////////////////////////////////////////////////////////////////////
 void CTimer::start()
 {
-    m_Start = std::chrono::high_resolution_clock::now();
+    m_Start = std::chrono::steady_clock::now();
     m_fCountAbsolute += 1.0;
 }
 
@@ -67,7 +119,7 @@ void CTimer::start()
 ///////////////////////////////////////////////////////////////////////////////
 void CTimer::stop()
 {
-    m_Stop = std::chrono::high_resolution_clock::now();
+    m_Stop = std::chrono::steady_clock::now();
     
     m_fDiffTime = std::chrono::duration<double>(m_Stop - m_Start).count();
 }
@@ -83,6 +135,39 @@ void CTimer::restart()
     this->start();
 }
 
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns time to spin before a deadline when sleeping hybrid
+///
+/// The margin is calibrated once on first call by measuring how much the
+/// system oversleeps. Setting hybrid sleep mode calls it, hence, calibration
+/// doesn't delay the first frame sleeping hybrid.
+///
+/// \return Margin in seconds
+///
+///////////////////////////////////////////////////////////////////////////////
+double CTimer::getSleepMargin()
+{
+    static const double s_fSleepMargin = calibrateSleepMargin();
+    return s_fSleepMargin;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Sets strategy of sleeping
+///
+/// The margin of hybrid sleeping is calibrated when set, taking a few
+/// milliseconds once.
+///
+/// \param _SleepMode Sleep mode
+///
+///////////////////////////////////////////////////////////////////////////////
+void CTimer::setSleepMode(const SleepModeType _SleepMode)
+{
+    if (_SleepMode == SleepModeType::HYBRID) getSleepMargin();
+    m_SleepMode = _SleepMode;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Sleeps for the time that remains between stop and start given a frequency.
@@ -92,6 +177,10 @@ void CTimer::restart()
 /// according to the frequency.
 /// Sleep remaining automatically calls the start and stop method of timer.
 ///
+/// In hybrid mode, the thread sleeps until a calibrated margin before the
+/// deadline and spins for the rest of the time. This reduces the wake up
+/// error to a few microseconds at the cost of cpu time.
+///
 /// \param _fFreq Frequency of the loop
 /// \return Sleep time in seconds, might be negative if no time left
 ///
@@ -108,15 +197,35 @@ double CTimer::sleepRemaining(const double& _fFreq)
     {
         m_fFrequency = _fFreq;
         m_fCountAbsolute = 1.0;
-        m_StartAbsolute = std::chrono::high_resolution_clock::now();
+        m_StartAbsolute = std::chrono::steady_clock::now();
     }
     
     this->stop();
     double fFrametime = (1.0/_fFreq-m_fDiffTime);
     
-    std::unique_lock<std::mutex> lk(m_MutexCV);
-    if (m_CV.wait_until(lk, m_StartAbsolute + std::chrono::duration<double>(m_fCountAbsolute/_fFreq), [](){return false;}))
-    m_MutexCV.lock();
+    const auto Deadline = m_StartAbsolute + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                            std::chrono::duration<double>(m_fCountAbsolute/_fFreq));
+    const auto Now = std::chrono::steady_clock::now();
+    
+    if (m_SleepMode == SleepModeType::HYBRID)
+    {
+        using namespace std::chrono;
+        const auto Coarse = Deadline - duration_cast<steady_clock::duration>(duration<double>(getSleepMargin()));
+        if (Coarse > steady_clock::now()) sleepCoarse(Coarse);
+        while (steady_clock::now() < Deadline) {}
+    }
+    else
+    {
+        std::unique_lock<std::mutex> lk(m_MutexCV);
+        if (m_CV.wait_until(lk, Deadline, [](){return false;}))
+        m_MutexCV.lock();
+    }
+    
+    // No sleep at all if deadline already passed
+    if (Now < Deadline)
+        m_fWakeUpError = std::chrono::duration<double>(std::chrono::steady_clock::now() - Deadline).count();
+    else
+        m_fWakeUpError = 0.0;
     
     this->start();
     
@@ -133,7 +242,7 @@ double CTimer::sleepRemaining(const double& _fFreq)
 double CTimer::getSplitTime()
 {
     return std::chrono::duration<double>(
-            std::chrono::high_resolution_clock::now() - m_Start
+            std::chrono::steady_clock::now() - m_Start
         ).count();
 }
 
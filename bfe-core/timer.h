@@ -45,11 +45,22 @@
 
 /// Factor to upscale time from u-seconds to seconds
 constexpr double TIMER_OUTPUT_SEC_FACTOR = 0.000001;
+/// Minimum time spinning before deadline when sleeping hybrid
+constexpr double TIMER_SLEEP_MARGIN_MIN = 50.0e-6;
+/// Maximum time spinning before deadline when sleeping hybrid
+constexpr double TIMER_SLEEP_MARGIN_MAX = 2.0e-3;
 
 /// BFEngine namespace
 namespace bfe
 {
 
+/// Specifies how to sleep for the remaining time of a frame
+enum class SleepModeType
+{
+    CONDITION_VARIABLE, ///< Wait on condition variable, low cpu load, oversleeps up to 100us
+    HYBRID              ///< Sleep until calibrated margin before deadline, then spin
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Class providing timer functions
@@ -67,11 +78,17 @@ class CTimer
         void start();
         void stop();
         void restart();
+        void setSleepMode(const SleepModeType);
         double sleepRemaining(const double&);
 
         //--- Constant Methods -----------------------------------------------//
         double          getSplitTime();
+        inline SleepModeType getSleepMode() const {return m_SleepMode;} ///< Returns strategy of sleeping
         inline double   getTime() const {return m_fDiffTime;}   ///< Returns time passed
+        inline double   getWakeUpError() const {return m_fWakeUpError;} ///< Returns time woken up after deadline
+        
+        //--- Static methods -------------------------------------------------//
+        static double   getSleepMargin();
         
         //--- Friends --------------------------------------------------------//
         friend std::istream& operator>>(std::istream&, CTimer&);
@@ -80,9 +97,9 @@ class CTimer
     private:
 
         //--- Private Variables ----------------------------------------------//
-        std::chrono::high_resolution_clock::time_point m_Start; ///< Starting time
-        std::chrono::high_resolution_clock::time_point m_Stop;  ///< Stopping time
-        std::chrono::high_resolution_clock::time_point m_StartAbsolute; ///< Absolute starting time
+        std::chrono::steady_clock::time_point m_Start; ///< Starting time
+        std::chrono::steady_clock::time_point m_Stop;  ///< Stopping time
+        std::chrono::steady_clock::time_point m_StartAbsolute; ///< Absolute starting time
         
         std::condition_variable m_CV;               ///< Condition variable for sleeping 
         std::mutex              m_MutexCV;          ///< Mutex for sleeping
@@ -90,6 +107,9 @@ class CTimer
         double                  m_fFrequency;       ///< Frequency
 
         double                  m_fDiffTime = 0.0;  ///< Time between start and stop
+        double                  m_fWakeUpError = 0.0; ///< Time woken up after deadline of last sleep
+        
+        SleepModeType           m_SleepMode = SleepModeType::CONDITION_VARIABLE; ///< Strategy of sleeping
 
 };
 
@@ -32,46 +32,21 @@
 
 using namespace bfe;
 
-/// Global counter for unique IDs. Reserve 0 for no reference
-UIDType CUID::s_nUID = 1;
-
-/// Global list for unused unique IDs
-std::deque<UIDType> CUID::s_UnusedUIDs;
-
-/// Global list for reference counting of uids
-std::unordered_map<UIDType, std::uint32_t> CUID::s_ReferencedUIDs;
-
-/// Global lock
-bfe::CSpinlock CUID::s_Access;
-
 ///////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Constructor
 ///
 /// When the constructor is called, the specific ID is assigned. If there are
-/// any unused IDs, these will be used first.
+/// any unused IDs, these will be used first. If all IDs are used, see
+/// \ref UID_MAX, the allocator reports an error and the ID is 0, i.e. invalid.
 ///
 ///////////////////////////////////////////////////////////////////////////////
 CUID::CUID()
 {
     METHOD_ENTRY("CUID::CUID")
-    DTOR_CALL("CUID::CUID")
+    CTOR_CALL("CUID::CUID")
     
-    s_Access.acquireLock();
-    
-    if (s_UnusedUIDs.empty())
-    {
-        m_nUID = s_nUID++;
-    }
-    else
-    {
-        m_nUID = s_UnusedUIDs.front();
-        s_UnusedUIDs.pop_front();
-    }
-    s_ReferencedUIDs[m_nUID] = 1u;
-    m_strName = "UID_"+std::to_string(m_nUID);
-    
-    s_Access.releaseLock();
+    m_nUID = CUIDAllocator::getInstance().allocate();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -87,13 +62,29 @@ CUID::CUID()
 CUID::CUID(const CUID& _UID)
 {
     METHOD_ENTRY("CUID::CUID")
-    DTOR_CALL("CUID::CUID")
-    
-    s_Access.acquireLock();
+    CTOR_CALL("CUID::CUID")
     
     this->copy(_UID);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Move constructor
+///
+/// The reference is transferred, hence, the given UID becomes 0 (no
+/// reference).
+///
+/// \param _UID UID to be moved
+///
+///////////////////////////////////////////////////////////////////////////////
+CUID::CUID(CUID&& _UID) noexcept : m_nUID(_UID.m_nUID),
+                                   m_strName(std::move(_UID.m_strName))
+{
+    METHOD_ENTRY("CUID::CUID")
+    CTOR_CALL("CUID::CUID")
     
-    s_Access.releaseLock();
+    _UID.m_nUID = 0u;
+    _UID.m_strName.clear();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -110,16 +101,7 @@ CUID::~CUID()
     METHOD_ENTRY("CUID::~CUID")
     DTOR_CALL("CUID::~CUID")
     
-    s_Access.acquireLock();
-    
-    s_ReferencedUIDs[m_nUID] -= 1u;
-    if (s_ReferencedUIDs[m_nUID] == 0u)
-    {
-        s_UnusedUIDs.push_back(m_nUID);
-        s_ReferencedUIDs.erase(m_nUID);
-    }
-    
-    s_Access.releaseLock();
+    CUIDAllocator::getInstance().release(m_nUID);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -135,18 +117,34 @@ CUID& CUID::operator=(const CUID& _UID)
     
     if (this != &_UID)
     {
-        s_Access.acquireLock();
-        
-        s_ReferencedUIDs[m_nUID] -= 1u;
-        if (s_ReferencedUIDs[m_nUID] == 0u)
-        {
-            s_UnusedUIDs.push_back(m_nUID);
-            s_ReferencedUIDs.erase(m_nUID);
-        }
-            
+        const UIDType nUID = m_nUID;
         this->copy(_UID);
-        
-        s_Access.releaseLock();
+        CUIDAllocator::getInstance().release(nUID);
+    }
+    return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Move assignment operator
+///
+/// The reference is transferred, hence, the given UID becomes 0 (no
+/// reference).
+///
+/// \param _UID UID to be moved
+///
+///////////////////////////////////////////////////////////////////////////////
+CUID& CUID::operator=(CUID&& _UID) noexcept
+{
+    METHOD_ENTRY("CUID::operator=")
+    
+    if (this != &_UID)
+    {
+        CUIDAllocator::getInstance().release(m_nUID);
+        m_nUID = _UID.m_nUID;
+        m_strName = std::move(_UID.m_strName);
+        _UID.m_nUID = 0u;
+        _UID.m_strName.clear();
     }
     return *this;
 }
@@ -155,34 +153,17 @@ CUID& CUID::operator=(const CUID& _UID)
 ///
 /// \brief Sets a new value for this ID
 ///
+/// The name is reset to default name.
+///
 ////////////////////////////////////////////////////////////////////////////////
 void CUID::setNewID()
 {
     METHOD_ENTRY("CUID::setNewID")
     
-    s_Access.acquireLock();
-    
-    UIDType nTmp;
-    if (s_UnusedUIDs.empty())
-    {
-        nTmp = s_nUID++;
-    }
-    else
-    {
-        nTmp = s_UnusedUIDs.front();
-        s_UnusedUIDs.pop_front();
-    }
-    s_ReferencedUIDs[m_nUID] -= 1u;
-    if (s_ReferencedUIDs[m_nUID] == 0u)
-    {
-        s_UnusedUIDs.push_back(m_nUID);
-        s_ReferencedUIDs.erase(m_nUID);
-    }
-    s_ReferencedUIDs[nTmp] = 1u;
-    m_nUID = nTmp;
-    m_strName = "UID_"+std::to_string(m_nUID);
-    
-    s_Access.releaseLock();
+    const UIDType nUID = m_nUID;
+    m_nUID = CUIDAllocator::getInstance().allocate();
+    m_strName.clear();
+    CUIDAllocator::getInstance().release(nUID);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -198,12 +179,12 @@ void CUID::copy(const CUID& _UID)
     
     m_nUID = _UID.m_nUID;
     m_strName = _UID.m_strName;
-    s_ReferencedUIDs[_UID.m_nUID] += 1u;
+    CUIDAllocator::getInstance().addReference(m_nUID);
 }
 
 SERIALIZE_IMPL(CUID,
     SERIALIZE("uid_value", m_nUID)
-    SERIALIZE("uid_value_max", s_nUID)
-    SERIALIZE("uid_name", m_strName)
+    SERIALIZE("uid_value_max", CUIDAllocator::getInstance().getCounter())
+    SERIALIZE("uid_name", this->getName())
 )
 
@@ -33,24 +33,30 @@
 
 //--- Standard header --------------------------------------------------------//
 #include <cstdint>
-#include <deque>
 #include <unordered_map>
+#include <vector>
 
 //--- Program header ---------------------------------------------------------//
 #include "log.h"
-#include "spinlock.h"
 #include "serializable.h"
+#include "uid_allocator.h"
 
 /// BFEngine namespace
 namespace bfe
 {
 
-using UIDType = std::uint32_t;
-
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Class that manages a unique ID to identify objects etc.
 ///
+/// ID's are allocated and reference counted by the global UID allocator,
+/// which doesn't lock. Hence, UIDs may be created, copied and destroyed by
+/// multiple threads concurrently. Moving a UID transfers its reference
+/// without touching the reference counter.
+///
+/// The default name "UID_<value>" isn't stored but generated on access,
+/// since most UIDs are never asked for their name.
+///
 ////////////////////////////////////////////////////////////////////////////////
 class CUID : public bfe::ISerializable
 {
@@ -60,12 +66,14 @@ class CUID : public bfe::ISerializable
         //--- Constructor/Destructor -----------------------------------------//
         CUID();
         CUID(const CUID&);
+        CUID(CUID&&) noexcept;
         ~CUID();
         
         CUID& operator=(const CUID&);
+        CUID& operator=(CUID&&) noexcept;
         
         //--- Constant Methods -----------------------------------------------//
-        const std::string&  getName() const;
+        std::string         getName() const;
         const UIDType&      getValue() const;
         
         //--- Methods --------------------------------------------------------//
@@ -73,8 +81,8 @@ class CUID : public bfe::ISerializable
         void setNewID();
         
         //--- Static methods -------------------------------------------------//
-        static const std::deque<UIDType>& getUnusedUIDs();
-        static const std::unordered_map<UIDType, std::uint32_t>& getReferencedUIDs();
+        static std::vector<UIDType> getUnusedUIDs();
+        static std::unordered_map<UIDType, std::uint32_t> getReferencedUIDs();
         
     private:
         
@@ -82,14 +90,8 @@ class CUID : public bfe::ISerializable
         void copy(const CUID&);
         
         //--- Variables [private] --------------------------------------------//
-               UIDType             m_nUID;              ///< Unique ID for this instance
-               std::string         m_strName;           ///< Name for this instance
-               
-        static UIDType             s_nUID;              ///< Unique ID counter
-        static std::deque<UIDType> s_UnusedUIDs;        ///< Storage for unused / released IDs
-        static std::unordered_map<UIDType, std::uint32_t> s_ReferencedUIDs; ///< Storage for reference counting of uids
-        
-        static bfe::CSpinlock      s_Access;            ///< Global lock
+        UIDType             m_nUID;              ///< Unique ID for this instance
+        std::string         m_strName;           ///< Name for this instance, empty for default name
         
         SERIALIZE_DECL
 };
@@ -100,12 +102,16 @@ class CUID : public bfe::ISerializable
 ///
 /// \brief Returns the name as identifier
 ///
+/// If no name was set, the default name is generated without storing it,
+/// hence, concurrent calls don't race.
+///
 /// \return Name as identifier
 ///
 ////////////////////////////////////////////////////////////////////////////////
-inline const std::string& CUID::getName() const
+inline std::string CUID::getName() const
 {
     METHOD_ENTRY("CUID::getName")
+    if (m_strName.empty()) return "UID_"+std::to_string(m_nUID);
     return m_strName;
 }
 
@@ -126,6 +132,8 @@ inline const UIDType& CUID::getValue() const
 ///
 /// \brief Sets a name as identifier
 ///
+/// An empty name resets to default name.
+///
 /// \param _strName Name to be set as identifier
 ///
 ////////////////////////////////////////////////////////////////////////////////
@@ -137,15 +145,15 @@ inline void CUID::setName(const std::string& _strName)
 
 ////////////////////////////////////////////////////////////////////////////////
 ///
-/// \brief Returns all unused UIDs
+/// \brief Returns unused UIDs, cached by the calling thread
 ///
 /// \return Unused UIDs
 ///
 ////////////////////////////////////////////////////////////////////////////////
-inline const std::deque<UIDType>& CUID::getUnusedUIDs()
+inline std::vector<UIDType> CUID::getUnusedUIDs()
 {
     METHOD_ENTRY("CUID::getUnusedUIDs")
-    return s_UnusedUIDs;
+    return CUIDAllocator::getInstance().getUnusedUIDs();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -158,10 +166,10 @@ inline const std::deque<UIDType>& CUID::getUnusedUIDs()
 /// \return Referenced UIDs
 ///
 ////////////////////////////////////////////////////////////////////////////////
-inline const std::unordered_map<UIDType, std::uint32_t>& CUID::getReferencedUIDs()
+inline std::unordered_map<UIDType, std::uint32_t> CUID::getReferencedUIDs()
 {
     METHOD_ENTRY("CUID::getReferencedUIDs")
-    return s_ReferencedUIDs;
+    return CUIDAllocator::getInstance().getReferencedUIDs();
 }
 
 } // namespace bfe
@@ -0,0 +1,344 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       uid_allocator.cpp
+/// \brief      Implementation of class "CUIDAllocator"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-10
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#include "uid_allocator.h"
+
+//--- Standard header --------------------------------------------------------//
+#include <algorithm>
+
+using namespace bfe;
+
+/// Cache of calling thread, nullptr if not created yet or already destroyed
+static thread_local UIDThreadCache* t_pUIDThreadCache = nullptr;
+
+/// Indicates that the cache of calling thread was destroyed on thread exit
+static thread_local bool t_bUIDThreadCacheDestroyed = false;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Owns the cache of a thread, passing unused UIDs to global pool on
+///        thread exit
+///
+////////////////////////////////////////////////////////////////////////////////
+struct UIDThreadCacheOwner
+{
+    UIDThreadCacheOwner()
+    {
+        t_pUIDThreadCache = new UIDThreadCache;
+        MEM_ALLOC("UIDThreadCache")
+        t_pUIDThreadCache->nBlockNext = 0u;
+        t_pUIDThreadCache->nBlockEnd = 0u;
+    }
+    ~UIDThreadCacheOwner()
+    {
+        CUIDAllocator::getInstance().flushThreadCache();
+        delete t_pUIDThreadCache;
+        MEM_FREED("UIDThreadCache")
+        t_pUIDThreadCache = nullptr;
+        t_bUIDThreadCacheDestroyed = true;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the cache of calling thread, creating it on first call
+///
+/// \return Cache of calling thread, nullptr if thread is exiting
+///
+////////////////////////////////////////////////////////////////////////////////
+static UIDThreadCache* getUIDThreadCache()
+{
+    if (t_pUIDThreadCache == nullptr && !t_bUIDThreadCacheDestroyed)
+    {
+        static thread_local UIDThreadCacheOwner s_Owner;
+    }
+    return t_pUIDThreadCache;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Constructor
+///
+////////////////////////////////////////////////////////////////////////////////
+CUIDAllocator::CUIDAllocator() : m_nCounter(1u) // Reserve 0 for no reference
+{
+    METHOD_ENTRY("CUIDAllocator::CUIDAllocator")
+    CTOR_CALL("CUIDAllocator::CUIDAllocator")
+
+    for (auto& Chunk : m_Chunks) Chunk.store(nullptr, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Destructor, freeing reference counters
+///
+////////////////////////////////////////////////////////////////////////////////
+CUIDAllocator::~CUIDAllocator()
+{
+    METHOD_ENTRY("CUIDAllocator::~CUIDAllocator")
+    DTOR_CALL("CUIDAllocator::~CUIDAllocator")
+
+    for (auto& Chunk : m_Chunks)
+    {
+        if (Chunk.load() != nullptr)
+        {
+            delete[] Chunk.load();
+            MEM_FREED("std::atomic<std::uint32_t>[]")
+            Chunk.store(nullptr);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the global instance
+///
+/// \return Global UID allocator
+///
+////////////////////////////////////////////////////////////////////////////////
+CUIDAllocator& CUIDAllocator::getInstance()
+{
+    METHOD_ENTRY("CUIDAllocator::getInstance")
+
+    static CUIDAllocator s_Instance;
+    return s_Instance;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns all referenced UIDs with their number of references
+///
+/// This is meant for debugging, since all reference counters are scanned.
+///
+/// \return Referenced UIDs
+///
+////////////////////////////////////////////////////////////////////////////////
+std::unordered_map<UIDType, std::uint32_t> CUIDAllocator::getReferencedUIDs() const
+{
+    METHOD_ENTRY("CUIDAllocator::getReferencedUIDs")
+
+    std::unordered_map<UIDType, std::uint32_t> ReferencedUIDs;
+    const UIDType nCounter = std::min(m_nCounter.load(), UID_MAX+1u);
+    for (auto i=1u; i<nCounter; ++i)
+    {
+        const std::uint32_t nReferences = this->getReferences(i);
+        if (nReferences != 0u) ReferencedUIDs[i] = nReferences;
+    }
+    return ReferencedUIDs;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns released UIDs cached by the calling thread
+///
+/// UIDs passed to the global pool are not included.
+///
+/// \return Unused UIDs of calling thread
+///
+////////////////////////////////////////////////////////////////////////////////
+std::vector<UIDType> CUIDAllocator::getUnusedUIDs() const
+{
+    METHOD_ENTRY("CUIDAllocator::getUnusedUIDs")
+
+    const UIDThreadCache* const pCache = getUIDThreadCache();
+    if (pCache == nullptr) return std::vector<UIDType>();
+    return std::vector<UIDType>(pCache->Released.cbegin(), pCache->Released.cend());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Allocates a UID with one reference
+///
+/// Released UIDs of the calling thread are used first, then UIDs from the
+/// global pool, then new ones.
+///
+/// \return New UID, 0 if maximum number of UIDs is reached
+///
+////////////////////////////////////////////////////////////////////////////////
+UIDType CUIDAllocator::allocate()
+{
+    METHOD_ENTRY("CUIDAllocator::allocate")
+
+    UIDThreadCache* const pCache = getUIDThreadCache();
+    UIDType nUID = 0u;
+
+    if (pCache == nullptr)
+    {
+        // Thread is exiting, pass remaining UIDs of new block to global pool
+        if (!m_Pool.try_dequeue(nUID))
+        {
+            nUID = this->acquireBlock();
+            if (nUID == 0u) return 0u;
+            for (auto i=1u; i<UID_BLOCK_SIZE; ++i) m_Pool.enqueue(nUID+i);
+        }
+    }
+    else if (!pCache->Released.empty())
+    {
+        nUID = pCache->Released.front();
+        pCache->Released.pop_front();
+    }
+    else if (pCache->nBlockNext != pCache->nBlockEnd)
+    {
+        nUID = pCache->nBlockNext++;
+    }
+    else
+    {
+        UIDType Pooled[UID_CACHE_SIZE_MAX/2];
+        const std::size_t nPooled = m_Pool.size_approx() == 0u ? 0u :
+                                    m_Pool.try_dequeue_bulk(Pooled, UID_CACHE_SIZE_MAX/2);
+        if (nPooled != 0u)
+        {
+            nUID = Pooled[0];
+            pCache->Released.insert(pCache->Released.end(), Pooled+1, Pooled+nPooled);
+        }
+        else
+        {
+            nUID = this->acquireBlock();
+            if (nUID == 0u) return 0u;
+            pCache->nBlockNext = nUID+1u;
+            pCache->nBlockEnd = nUID+UID_BLOCK_SIZE;
+        }
+    }
+
+    this->getReferenceCounter(nUID).store(1u, std::memory_order_relaxed);
+    return nUID;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Removes a reference from given UID, which is reused if there are no
+///        references left
+///
+/// \param _nUID UID to remove reference from
+///
+////////////////////////////////////////////////////////////////////////////////
+void CUIDAllocator::release(const UIDType _nUID)
+{
+    METHOD_ENTRY("CUIDAllocator::release")
+
+    if (_nUID == 0u) return;
+    if (this->getReferenceCounter(_nUID).fetch_sub(1u, std::memory_order_acq_rel) != 1u) return;
+
+    UIDThreadCache* const pCache = getUIDThreadCache();
+    if (pCache == nullptr)
+    {
+        m_Pool.enqueue(_nUID);
+        return;
+    }
+
+    pCache->Released.push_back(_nUID);
+    if (pCache->Released.size() > UID_CACHE_SIZE_MAX)
+    {
+        // Pass oldest half to other threads
+        m_Pool.enqueue_bulk(pCache->Released.cbegin(), UID_CACHE_SIZE_MAX/2);
+        pCache->Released.erase(pCache->Released.cbegin(),
+                               pCache->Released.cbegin()+UID_CACHE_SIZE_MAX/2);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Passes all unused UIDs of the calling thread to the global pool
+///
+/// This is done automatically on thread exit.
+///
+////////////////////////////////////////////////////////////////////////////////
+void CUIDAllocator::flushThreadCache()
+{
+    METHOD_ENTRY("CUIDAllocator::flushThreadCache")
+
+    UIDThreadCache* const pCache = t_pUIDThreadCache;
+    if (pCache == nullptr) return;
+
+    if (!pCache->Released.empty())
+    {
+        m_Pool.enqueue_bulk(pCache->Released.cbegin(), pCache->Released.size());
+        pCache->Released.clear();
+    }
+    while (pCache->nBlockNext != pCache->nBlockEnd)
+    {
+        m_Pool.enqueue(pCache->nBlockNext++);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Takes a block of new UIDs from the global counter
+///
+/// \return First UID of block, 0 if maximum number of UIDs is reached
+///
+////////////////////////////////////////////////////////////////////////////////
+UIDType CUIDAllocator::acquireBlock()
+{
+    METHOD_ENTRY("CUIDAllocator::acquireBlock")
+
+    UIDType nFirst = m_nCounter.load(std::memory_order_relaxed);
+    do
+    {
+        if (nFirst > UID_MAX+1u-UID_BLOCK_SIZE)
+        {
+            ERROR_MSG("UID Allocator", "Maximum number of UIDs (" << UID_MAX << ") reached.")
+            BFE_ASSERT(nFirst <= UID_MAX+1u-UID_BLOCK_SIZE);
+            return 0u;
+        }
+    } while (!m_nCounter.compare_exchange_weak(nFirst, nFirst+UID_BLOCK_SIZE,
+                                               std::memory_order_relaxed));
+
+    this->allocateChunk(nFirst);
+    this->allocateChunk(nFirst+UID_BLOCK_SIZE-1u);
+    return nFirst;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Allocates the chunk of reference counters for given UID if needed
+///
+/// \param _nUID UID to allocate reference counter for
+///
+////////////////////////////////////////////////////////////////////////////////
+void CUIDAllocator::allocateChunk(const UIDType _nUID)
+{
+    METHOD_ENTRY("CUIDAllocator::allocateChunk")
+
+    auto& Chunk = m_Chunks[_nUID / UID_CHUNK_SIZE];
+    if (Chunk.load(std::memory_order_acquire) != nullptr) return;
+
+    std::atomic<std::uint32_t>* pChunk = new std::atomic<std::uint32_t>[UID_CHUNK_SIZE];
+    MEM_ALLOC("std::atomic<std::uint32_t>[]")
+    for (auto i=0u; i<UID_CHUNK_SIZE; ++i) pChunk[i].store(0u, std::memory_order_relaxed);
+
+    std::atomic<std::uint32_t>* pExpected = nullptr;
+    if (!Chunk.compare_exchange_strong(pExpected, pChunk, std::memory_order_acq_rel))
+    {
+        // Another thread was faster
+        delete[] pChunk;
+        MEM_FREED("std::atomic<std::uint32_t>[]")
+    }
+}
@@ -0,0 +1,207 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       uid_allocator.h
+/// \brief      Prototype of class "CUIDAllocator"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-10
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef UID_ALLOCATOR_H
+#define UID_ALLOCATOR_H
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "log.h"
+
+//--- Misc header ------------------------------------------------------------//
+#include "concurrentqueue.h"
+
+/// BFEngine namespace
+namespace bfe
+{
+
+using UIDType = std::uint32_t;
+
+//--- Constants --------------------------------------------------------------//
+constexpr UIDType       UID_BLOCK_SIZE      = 64u;      ///< Number of UIDs a thread takes from global counter at once
+constexpr std::size_t   UID_CACHE_SIZE_MAX  = 256u;     ///< Maximum number of released UIDs cached per thread
+constexpr UIDType       UID_CHUNK_SIZE      = 4096u;    ///< Number of reference counters per chunk
+constexpr UIDType       UID_CHUNKS_MAX      = 4096u;    ///< Maximum number of chunks
+constexpr UIDType       UID_MAX             = UID_CHUNK_SIZE*UID_CHUNKS_MAX-1u; ///< Maximum UID value, given by chunks
+
+static_assert(UID_CHUNKS_MAX <= std::numeric_limits<UIDType>::max() / UID_CHUNK_SIZE,
+              "UID chunks exceed the range of UID type.");
+static_assert((UID_MAX+1u) % UID_BLOCK_SIZE == 0u, "UID range must consist of whole blocks.");
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Thread local storage of UIDs, ready to be used
+///
+////////////////////////////////////////////////////////////////////////////////
+struct UIDThreadCache
+{
+    std::deque<UIDType> Released;       ///< Released UIDs, reused first (FIFO)
+    UIDType             nBlockNext;     ///< Next unused UID of current block
+    UIDType             nBlockEnd;      ///< End of current block
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Lock-free allocator and reference counter for unique ID's
+///
+/// Each thread takes blocks of UIDs from a global atomic counter and caches
+/// released UIDs locally, hence, allocation usually doesn't touch any shared
+/// state. If a thread releases more UIDs than it allocates, surplus UIDs are
+/// passed to a global pool, where other threads take them from. Unused UIDs
+/// of a thread are passed to the pool on thread exit.
+///
+/// Reference counters are stored in a dense array indexed by UID. It is
+/// divided into chunks which are allocated on demand and never moved. Hence,
+/// the range of UIDs is limited by the chunks to \ref UID_MAX, about 16.7
+/// million UIDs, instead of the full range of the UID type. Taking more UIDs
+/// from the counter, including those cached by threads, is an error reported
+/// and caught by assertion, since UID 0 is returned, which is invalid.
+///
+/// Since thread caches are thread local, there is only one global instance.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CUIDAllocator
+{
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        ~CUIDAllocator();
+
+        CUIDAllocator(const CUIDAllocator&) = delete;
+        CUIDAllocator& operator=(const CUIDAllocator&) = delete;
+
+        //--- Static methods -------------------------------------------------//
+        static CUIDAllocator& getInstance();
+
+        //--- Constant Methods -----------------------------------------------//
+        UIDType                                     getCounter() const;
+        std::uint32_t                               getReferences(const UIDType) const;
+        std::unordered_map<UIDType, std::uint32_t>  getReferencedUIDs() const;
+        std::vector<UIDType>                        getUnusedUIDs() const;
+
+        //--- Methods --------------------------------------------------------//
+        UIDType allocate();
+        void    addReference(const UIDType);
+        void    release(const UIDType);
+
+        void    flushThreadCache();
+
+    private:
+
+        //--- Constructor [private] ------------------------------------------//
+        CUIDAllocator();
+
+        //--- Methods [private] ----------------------------------------------//
+        std::atomic<std::uint32_t>& getReferenceCounter(const UIDType) const;
+        UIDType                     acquireBlock();
+        void                        allocateChunk(const UIDType);
+
+        //--- Variables [private] --------------------------------------------//
+        std::atomic<UIDType>                        m_nCounter;                 ///< Next UID not taken by any thread, 0 is reserved
+        std::atomic<std::atomic<std::uint32_t>*>    m_Chunks[UID_CHUNKS_MAX];   ///< Chunks of reference counters
+        moodycamel::ConcurrentQueue<UIDType>        m_Pool;                     ///< Released UIDs, shared by all threads
+};
+
+//--- Implementation is done here for inline optimisation --------------------//
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the global UID counter
+///
+/// All UIDs below have been taken by a thread at least once.
+///
+/// \return Global UID counter
+///
+////////////////////////////////////////////////////////////////////////////////
+inline UIDType CUIDAllocator::getCounter() const
+{
+    METHOD_ENTRY("CUIDAllocator::getCounter")
+    return m_nCounter.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the number of references of given UID
+///
+/// \param _nUID UID to return references for
+///
+/// \return Number of references
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint32_t CUIDAllocator::getReferences(const UIDType _nUID) const
+{
+    METHOD_ENTRY("CUIDAllocator::getReferences")
+    if (_nUID == 0u || m_Chunks[_nUID / UID_CHUNK_SIZE].load(std::memory_order_acquire) == nullptr)
+        return 0u;
+    return this->getReferenceCounter(_nUID).load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Adds a reference to given UID, e.g. if it is copied
+///
+/// \param _nUID UID to add reference for
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void CUIDAllocator::addReference(const UIDType _nUID)
+{
+    METHOD_ENTRY("CUIDAllocator::addReference")
+    if (_nUID != 0u) this->getReferenceCounter(_nUID).fetch_add(1u, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the reference counter of given UID
+///
+/// The chunk of given UID must have been allocated.
+///
+/// \param _nUID UID to return reference counter for
+///
+/// \return Reference counter
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::atomic<std::uint32_t>& CUIDAllocator::getReferenceCounter(const UIDType _nUID) const
+{
+    METHOD_ENTRY("CUIDAllocator::getReferenceCounter")
+    BFE_ASSERT(m_Chunks[_nUID / UID_CHUNK_SIZE].load(std::memory_order_relaxed) != nullptr);
+    return m_Chunks[_nUID / UID_CHUNK_SIZE].load(std::memory_order_acquire)[_nUID % UID_CHUNK_SIZE];
+}
+
+} // namespace bfe
+
+#endif // UID_ALLOCATOR_H
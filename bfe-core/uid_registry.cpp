@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       uid_registry.cpp
+/// \brief      Implementation of class "CUIDRegistry"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-11
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#include "uid_registry.h"
+
+using namespace bfe;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Constructor
+///
+////////////////////////////////////////////////////////////////////////////////
+CUIDRegistry::CUIDRegistry()
+{
+    METHOD_ENTRY("CUIDRegistry::CUIDRegistry")
+    CTOR_CALL("CUIDRegistry::CUIDRegistry")
+
+    for (auto& Chunk : m_Chunks) Chunk.store(nullptr, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Destructor, freeing all chunks
+///
+////////////////////////////////////////////////////////////////////////////////
+CUIDRegistry::~CUIDRegistry()
+{
+    METHOD_ENTRY("CUIDRegistry::~CUIDRegistry")
+    DTOR_CALL("CUIDRegistry::~CUIDRegistry")
+
+    for (auto& Chunk : m_Chunks)
+    {
+        if (Chunk.load() != nullptr)
+        {
+            delete[] Chunk.load();
+            MEM_FREED("std::atomic<IUIDUser*>[]")
+            Chunk.store(nullptr);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the global instance
+///
+/// \return Global UID registry
+///
+////////////////////////////////////////////////////////////////////////////////
+CUIDRegistry& CUIDRegistry::getInstance()
+{
+    METHOD_ENTRY("CUIDRegistry::getInstance")
+
+    static CUIDRegistry s_Instance;
+    return s_Instance;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Registers given object for given UID
+///
+/// \param _nUID UID of object
+/// \param _pUser Object to register
+///
+/// \return Success? Fails if another object is registered for given UID.
+///
+////////////////////////////////////////////////////////////////////////////////
+bool CUIDRegistry::add(const UIDType _nUID, IUIDUser* const _pUser)
+{
+    METHOD_ENTRY("CUIDRegistry::add")
+
+    if (_nUID == 0u || _nUID > UID_MAX) return false;
+
+    auto& Chunk = m_Chunks[_nUID / UID_CHUNK_SIZE];
+    if (Chunk.load(std::memory_order_acquire) == nullptr)
+    {
+        std::atomic<IUIDUser*>* pChunk = new std::atomic<IUIDUser*>[UID_CHUNK_SIZE];
+        MEM_ALLOC("std::atomic<IUIDUser*>[]")
+        for (auto i=0u; i<UID_CHUNK_SIZE; ++i) pChunk[i].store(nullptr, std::memory_order_relaxed);
+
+        std::atomic<IUIDUser*>* pExpected = nullptr;
+        if (!Chunk.compare_exchange_strong(pExpected, pChunk, std::memory_order_acq_rel))
+        {
+            // Another thread was faster
+            delete[] pChunk;
+            MEM_FREED("std::atomic<IUIDUser*>[]")
+        }
+    }
+
+    IUIDUser* pExpected = nullptr;
+    return this->getEntry(_nUID)->compare_exchange_strong(pExpected, _pUser, std::memory_order_release,
+                                                                             std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Unregisters given object for given UID
+///
+/// \param _nUID UID of object
+/// \param _pUser Object to unregister
+///
+/// \return Success? Fails if given object isn't registered for given UID.
+///
+////////////////////////////////////////////////////////////////////////////////
+bool CUIDRegistry::remove(const UIDType _nUID, const IUIDUser* const _pUser)
+{
+    METHOD_ENTRY("CUIDRegistry::remove")
+
+    std::atomic<IUIDUser*>* const pEntry = this->getEntry(_nUID);
+    if (pEntry == nullptr) return false;
+
+    IUIDUser* pExpected = const_cast<IUIDUser*>(_pUser);
+    return pEntry->compare_exchange_strong(pExpected, nullptr, std::memory_order_release,
+                                                               std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Replaces registered object for given UID, e.g. if it was moved
+///
+/// \param _nUID UID of object
+/// \param _pOld Object that is registered
+/// \param _pNew Object to be registered
+///
+/// \return Success? Fails if old object isn't registered for given UID.
+///
+////////////////////////////////////////////////////////////////////////////////
+bool CUIDRegistry::replace(const UIDType _nUID, const IUIDUser* const _pOld, IUIDUser* const _pNew)
+{
+    METHOD_ENTRY("CUIDRegistry::replace")
+
+    std::atomic<IUIDUser*>* const pEntry = this->getEntry(_nUID);
+    if (pEntry == nullptr) return false;
+
+    IUIDUser* pExpected = const_cast<IUIDUser*>(_pOld);
+    return pEntry->compare_exchange_strong(pExpected, _pNew, std::memory_order_release,
+                                                             std::memory_order_relaxed);
+}
@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       uid_registry.h
+/// \brief      Prototype of class "CUIDRegistry"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-11
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef UID_REGISTRY_H
+#define UID_REGISTRY_H
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <cstdint>
+
+//--- Program header ---------------------------------------------------------//
+#include "log.h"
+#include "uid_allocator.h"
+
+/// BFEngine namespace
+namespace bfe
+{
+
+//--- Forward declarations ---------------------------------------------------//
+class IUIDUser;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Concurrent reverse index from UID to the object using it
+///
+/// Objects are stored in a dense array indexed by UID, divided into chunks
+/// like the reference counters of the UID allocator. Hence, lookups are
+/// constant time and don't lock. UID users are registered explicitly when
+/// constructed completely, see \ref IUIDUser.
+///
+/// If a UID is shared by copies, it refers to the object that registered
+/// first. Objects returned by lookups might be destroyed concurrently,
+/// they must be protected by other means, e.g. epoch based reclamation.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CUIDRegistry
+{
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        ~CUIDRegistry();
+
+        CUIDRegistry(const CUIDRegistry&) = delete;
+        CUIDRegistry& operator=(const CUIDRegistry&) = delete;
+
+        //--- Static methods -------------------------------------------------//
+        static CUIDRegistry& getInstance();
+
+        //--- Constant Methods -----------------------------------------------//
+        IUIDUser* get(const UIDType) const;
+        template <class T>
+        T*        get(const UIDType) const;
+
+        //--- Methods --------------------------------------------------------//
+        bool add(const UIDType, IUIDUser* const);
+        bool remove(const UIDType, const IUIDUser* const);
+        bool replace(const UIDType, const IUIDUser* const, IUIDUser* const);
+
+    private:
+
+        //--- Constructor [private] ------------------------------------------//
+        CUIDRegistry();
+
+        //--- Methods [private] ----------------------------------------------//
+        std::atomic<IUIDUser*>* getEntry(const UIDType) const;
+
+        //--- Variables [private] --------------------------------------------//
+        std::atomic<std::atomic<IUIDUser*>*> m_Chunks[UID_CHUNKS_MAX]; ///< Chunks of registered objects
+};
+
+//--- Implementation is done here for inline optimisation --------------------//
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the object using given UID
+///
+/// \param _nUID UID of object
+///
+/// \return Object, nullptr if none is registered
+///
+////////////////////////////////////////////////////////////////////////////////
+inline IUIDUser* CUIDRegistry::get(const UIDType _nUID) const
+{
+    METHOD_ENTRY("CUIDRegistry::get")
+
+    const std::atomic<IUIDUser*>* const pEntry = this->getEntry(_nUID);
+    if (pEntry == nullptr) return nullptr;
+    return pEntry->load(std::memory_order_acquire);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the object using given UID, casted to given type
+///
+/// \param _nUID UID of object
+///
+/// \return Object, nullptr if none is registered or of different type
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline T* CUIDRegistry::get(const UIDType _nUID) const
+{
+    METHOD_ENTRY("CUIDRegistry::get")
+    return dynamic_cast<T*>(this->get(_nUID));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the entry of given UID
+///
+/// \param _nUID UID to return entry for
+///
+/// \return Entry, nullptr if UID is 0, out of range, or its chunk is not
+///         allocated
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::atomic<IUIDUser*>* CUIDRegistry::getEntry(const UIDType _nUID) const
+{
+    METHOD_ENTRY("CUIDRegistry::getEntry")
+
+    if (_nUID == 0u || _nUID > UID_MAX) return nullptr;
+    std::atomic<IUIDUser*>* const pChunk = m_Chunks[_nUID / UID_CHUNK_SIZE].load(std::memory_order_acquire);
+    if (pChunk == nullptr) return nullptr;
+    return &pChunk[_nUID % UID_CHUNK_SIZE];
+}
+
+} // namespace bfe
+
+#endif // UID_REGISTRY_H
@@ -32,10 +32,13 @@
 #define UID_USER_H
 
 //--- Standard header --------------------------------------------------------//
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 
 //--- Program header ---------------------------------------------------------//
 #include "uid.h"
+#include "uid_registry.h"
 
 /// BFEngine namespace
 namespace bfe
@@ -45,28 +48,194 @@ namespace bfe
 ///
 /// \brief Interface for classes that use a engine wide unique id.
 ///
+/// Objects can be registered with their UID in the global UID registry, hence,
+/// they can be looked up by UID in constant time. Lookups might cast the
+/// object, thus, it must only be registered while constructed completely:
+/// Objects created as \ref CUIDRegistered are registered automatically.
+/// Otherwise, the most derived class calls \ref registerUID at the end of its
+/// constructor and \ref unregisterUID first thing in its destructor.
+///
+/// Copies share the UID of the original, which stays registered. Thus, a copy
+/// can't be registered unless given a new UID by \ref setNewID. Moving takes
+/// over the UID, the moved object must be registered again. Move assignment
+/// takes over the registration, since both objects are complete.
+///
 ////////////////////////////////////////////////////////////////////////////////
 class IUIDUser
 {
 
     public:
    
+        //--- Constructor/Destructor -----------------------------------------//
+        IUIDUser() = default;
+        IUIDUser(const IUIDUser&);
+        IUIDUser(IUIDUser&&) noexcept;
+        virtual ~IUIDUser();
+        
+        IUIDUser& operator=(const IUIDUser&);
+        IUIDUser& operator=(IUIDUser&&) noexcept;
+        
         //--- Constant Methods -----------------------------------------------//
-        const std::string&  getName() const;
+        std::string         getName() const;
               UIDType       getUID() const;
+        bool                isRegistered() const;
         
         //--- Methods --------------------------------------------------------//
+        bool registerUID();
         void setName(const std::string&);
         void setNewID();
+        void unregisterUID();
         
     protected:
         
         //--- Protected variables --------------------------------------------//
-        CUID       m_UID; ///< Identifier
+        CUID       m_UID;                   ///< Identifier
+        bool       m_bRegistered = false;   ///< Indicates registration in UID registry
+};
+
+/// Indicates constructor arguments being a registered UID user to be copied
+template <class TRegistered, class... TArgs>
+struct UIDRegisteredCopy : std::false_type {};
+
+template <class TRegistered, class TArg>
+struct UIDRegisteredCopy<TRegistered, TArg> : std::is_same<std::decay_t<TArg>, TRegistered> {};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief UID user registered for its lifetime
+///
+/// Being the most derived class, the object is registered when constructed
+/// completely and unregistered before it is destroyed. Copies get a new UID,
+/// hence, they are registered, too.
+///
+/// \code
+///     CUIDRegistered<CWidgetText> Text(pFontManager);
+///     CUIDRegistry::getInstance().get<CWidgetText>(Text.getUID()); // &Text
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+class CUIDRegistered final : public T
+{
+
+    static_assert(std::is_base_of<IUIDUser, T>::value, "Registered type must be a UID user.");
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        template <class... TArgs, class = std::enable_if_t<!UIDRegisteredCopy<CUIDRegistered, TArgs...>::value>>
+        explicit CUIDRegistered(TArgs&&...);
+        CUIDRegistered(const CUIDRegistered&);
+        CUIDRegistered(CUIDRegistered&&) noexcept;
+        ~CUIDRegistered() override;
+
+        CUIDRegistered& operator=(const CUIDRegistered&);
+        CUIDRegistered& operator=(CUIDRegistered&&) = default;
 };
 
 //--- Implementation is done here for inline optimisation --------------------//
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Copy constructor
+///
+/// The UID is shared with the given object, the copy isn't registered.
+///
+/// \param _UIDUser UID user to be copied
+///
+////////////////////////////////////////////////////////////////////////////////
+inline IUIDUser::IUIDUser(const IUIDUser& _UIDUser) : m_UID(_UIDUser.m_UID)
+{
+    METHOD_ENTRY("IUIDUser::IUIDUser")
+    CTOR_CALL("IUIDUser::IUIDUser")
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Move constructor, taking over the UID of given object
+///
+/// The given object is unregistered, this object isn't registered yet.
+///
+/// \param _UIDUser UID user to be moved
+///
+////////////////////////////////////////////////////////////////////////////////
+inline IUIDUser::IUIDUser(IUIDUser&& _UIDUser) noexcept : m_UID(std::move(_UIDUser.m_UID))
+{
+    METHOD_ENTRY("IUIDUser::IUIDUser")
+    CTOR_CALL("IUIDUser::IUIDUser")
+    if (_UIDUser.m_bRegistered)
+    {
+        CUIDRegistry::getInstance().remove(m_UID.getValue(), &_UIDUser);
+        _UIDUser.m_bRegistered = false;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Destructor
+///
+/// Objects still registered are unregistered, but too late for concurrent
+/// lookups, see \ref unregisterUID.
+///
+////////////////////////////////////////////////////////////////////////////////
+inline IUIDUser::~IUIDUser()
+{
+    METHOD_ENTRY("IUIDUser::~IUIDUser")
+    DTOR_CALL("IUIDUser::~IUIDUser")
+    if (m_bRegistered)
+    {
+        DOM_DEV(WARNING_MSG("UID User", "Object <" << m_UID.getValue() << "> still registered when destroyed."))
+        this->unregisterUID();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Copy assignment operator
+///
+/// The UID is shared with the given object, this object is unregistered.
+///
+/// \param _UIDUser UID user to be copied
+///
+/// \return This UID user
+///
+////////////////////////////////////////////////////////////////////////////////
+inline IUIDUser& IUIDUser::operator=(const IUIDUser& _UIDUser)
+{
+    METHOD_ENTRY("IUIDUser::operator=")
+    if (this != &_UIDUser)
+    {
+        this->unregisterUID();
+        m_UID = _UIDUser.m_UID;
+    }
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Move assignment operator, taking over UID and registration
+///
+/// \param _UIDUser UID user to be moved
+///
+/// \return This UID user
+///
+////////////////////////////////////////////////////////////////////////////////
+inline IUIDUser& IUIDUser::operator=(IUIDUser&& _UIDUser) noexcept
+{
+    METHOD_ENTRY("IUIDUser::operator=")
+    if (this != &_UIDUser)
+    {
+        this->unregisterUID();
+        m_UID = std::move(_UIDUser.m_UID);
+        if (_UIDUser.m_bRegistered)
+        {
+            m_bRegistered = CUIDRegistry::getInstance().replace(m_UID.getValue(), &_UIDUser, this);
+            _UIDUser.m_bRegistered = false;
+        }
+    }
+    return *this;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Returns the entity's name
@@ -74,7 +243,7 @@ class IUIDUser
 /// \return Name of entity
 ///
 ////////////////////////////////////////////////////////////////////////////////
-inline const std::string& IUIDUser::getName() const
+inline std::string IUIDUser::getName() const
 {
     METHOD_ENTRY("IUIDUser::getName")
     return m_UID.getName();
@@ -93,6 +262,42 @@ inline UIDType IUIDUser::getUID() const
     return m_UID.getValue();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Indicates that the object is registered in the UID registry
+///
+/// \return Registered?
+///
+////////////////////////////////////////////////////////////////////////////////
+inline bool IUIDUser::isRegistered() const
+{
+    METHOD_ENTRY("IUIDUser::isRegistered")
+    return m_bRegistered;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Registers the object with its UID in the UID registry
+///
+/// Must be called when the object is constructed completely, since it might
+/// be looked up by other threads immediately.
+///
+/// \return Success? Fails if the UID is used by another object, e.g. the
+///         original of a copy.
+///
+////////////////////////////////////////////////////////////////////////////////
+inline bool IUIDUser::registerUID()
+{
+    METHOD_ENTRY("IUIDUser::registerUID")
+    if (m_bRegistered) return true;
+    m_bRegistered = CUIDRegistry::getInstance().add(m_UID.getValue(), this);
+    if (!m_bRegistered)
+    {
+        WARNING_MSG("UID User", "UID <" << m_UID.getValue() << "> used by another object, not registered.")
+    }
+    return m_bRegistered;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Sets the entities name
@@ -108,13 +313,110 @@ inline void IUIDUser::setName(const std::string& _strName)
 
 ////////////////////////////////////////////////////////////////////////////////
 ///
-/// \brief Sets a new ID
+/// \brief Sets a new ID, keeping registration
 ///
 ////////////////////////////////////////////////////////////////////////////////
 inline void IUIDUser::setNewID()
 {
     METHOD_ENTRY("IUIDUser::setNewID")
+    const bool bRegistered = m_bRegistered;
+    this->unregisterUID();
     m_UID.setNewID();
+    if (bRegistered) this->registerUID();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Unregisters the object from the UID registry
+///
+/// Must be called first thing in the destructor of the most derived class,
+/// before the object is destroyed partially.
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void IUIDUser::unregisterUID()
+{
+    METHOD_ENTRY("IUIDUser::unregisterUID")
+    if (!m_bRegistered) return;
+    CUIDRegistry::getInstance().remove(m_UID.getValue(), this);
+    m_bRegistered = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Constructor, registering the object when constructed completely
+///
+/// \param _Args Arguments for constructor of UID user
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+template <class... TArgs, class>
+inline CUIDRegistered<T>::CUIDRegistered(TArgs&&... _Args) : T(std::forward<TArgs>(_Args)...)
+{
+    METHOD_ENTRY("CUIDRegistered::CUIDRegistered")
+    this->registerUID();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Copy constructor, registering the copy with a new UID
+///
+/// \param _Registered Registered UID user to be copied
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline CUIDRegistered<T>::CUIDRegistered(const CUIDRegistered& _Registered) : T(_Registered)
+{
+    METHOD_ENTRY("CUIDRegistered::CUIDRegistered")
+    this->setNewID();
+    this->registerUID();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Move constructor, registering this object instead of given one
+///
+/// \param _Registered Registered UID user to be moved
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline CUIDRegistered<T>::CUIDRegistered(CUIDRegistered&& _Registered) noexcept : T(std::move(_Registered))
+{
+    METHOD_ENTRY("CUIDRegistered::CUIDRegistered")
+    this->registerUID();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Destructor, unregistering the object before it is destroyed
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline CUIDRegistered<T>::~CUIDRegistered()
+{
+    METHOD_ENTRY("CUIDRegistered::~CUIDRegistered")
+    this->unregisterUID();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Copy assignment operator, registering this object with a new UID
+///
+/// \param _Registered Registered UID user to be copied
+///
+/// \return This UID user
+///
+////////////////////////////////////////////////////////////////////////////////
+template <class T>
+inline CUIDRegistered<T>& CUIDRegistered<T>::operator=(const CUIDRegistered& _Registered)
+{
+    METHOD_ENTRY("CUIDRegistered::operator=")
+    if (this != &_Registered)
+    {
+        T::operator=(_Registered);
+        this->setNewID();
+        this->registerUID();
+    }
+    return *this;
 }
 
 } // namespace bfe
@@ -0,0 +1,251 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       writer_queue.cpp
+/// \brief      Implementation of class "CWriterQueue"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-19
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#include "writer_queue.h"
+
+#include "com_interface.h"
+
+using namespace bfe;
+
+/// Producer token of calling thread for one queue
+struct WriterQueueTokenCacheEntry
+{
+    std::uint64_t               nQueueID = 0u;      ///< Queue of token, 0 if unused
+    moodycamel::ProducerToken*  pToken = nullptr;   ///< Token owned by queue
+};
+
+/// Tokens of calling thread, entries of destroyed queues never match again
+static thread_local WriterQueueTokenCacheEntry t_TokenCache[WRITER_QUEUE_TOKENS_CACHED];
+/// Entry of calling thread's cache to be replaced next
+static thread_local std::size_t t_nTokenCacheNext = 0u;
+
+std::atomic<std::uint64_t> CWriterQueue::s_nIDNext(1u);
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Constructor
+///
+////////////////////////////////////////////////////////////////////////////////
+CWriterQueue::CWriterQueue() : m_nID(s_nIDNext.fetch_add(1u, std::memory_order_relaxed)),
+                               m_ConsumerToken(m_Queue)
+{
+    METHOD_ENTRY("CWriterQueue::CWriterQueue")
+    CTOR_CALL("CWriterQueue::CWriterQueue")
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Destructor, destroys remaining commands without calling them
+///
+////////////////////////////////////////////////////////////////////////////////
+CWriterQueue::~CWriterQueue()
+{
+    METHOD_ENTRY("CWriterQueue::~CWriterQueue")
+    DTOR_CALL("CWriterQueue::~CWriterQueue")
+
+    IBaseCommand* pCommand = nullptr;
+    while (m_Queue.try_dequeue(pCommand))
+    {
+        if (pCommand != nullptr) pCommand->destroy();
+    }
+    for (auto& Token : m_ProducerTokens)
+    {
+        Token.second.reset();
+        MEM_FREED_QUIET("moodycamel::ProducerToken")
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls all queued commands
+///
+/// Commands are dequeued in bulk into a batch, which is merged before
+/// calling if it contains commands to be merged. Commands enqueued while
+/// calling form the next batch. Must only be called by the thread of the
+/// writer domain.
+///
+/// \return Number of commands called
+///
+////////////////////////////////////////////////////////////////////////////////
+std::size_t CWriterQueue::flush()
+{
+    METHOD_ENTRY_QUIET("CWriterQueue::flush")
+
+    std::size_t nCalled = 0u;
+    std::size_t nCoalesced = 0u;
+    for (;;)
+    {
+        m_Batch.clear();
+        bool bCoalesce = false;
+        std::size_t nCommands = 0u;
+        do
+        {
+            const std::size_t nSize = m_Batch.size();
+            m_Batch.resize(nSize + WRITER_QUEUE_BULK_SIZE);
+            nCommands = m_Queue.try_dequeue_bulk(m_ConsumerToken, m_Batch.data() + nSize, WRITER_QUEUE_BULK_SIZE);
+            m_Batch.resize(nSize + nCommands);
+            for (auto i=nSize; i<m_Batch.size(); ++i)
+            {
+                if (m_Batch[i]->getCoalesce() != ComCoalesceType::NONE) bCoalesce = true;
+            }
+        } while (nCommands != 0u);
+        if (m_Batch.empty()) break;
+
+        if (bCoalesce) nCoalesced += this->coalesce();
+
+        for (const auto pCommand : m_Batch)
+        {
+            if (pCommand == nullptr) continue;
+            pCommand->callQueued();
+            // Returns the slot to the pool of the writer domain
+            pCommand->destroy();
+            ++nCalled;
+        }
+    }
+
+    // Only written by flushing thread, counted once per flush
+    if (nCalled > 0u)
+    {
+        m_nFlushes.fetch_add(1u, std::memory_order_relaxed);
+        m_nCommands.fetch_add(nCalled, std::memory_order_relaxed);
+        m_nCoalesced.fetch_add(nCoalesced, std::memory_order_relaxed);
+        if (nCalled > m_nDepthMax.load(std::memory_order_relaxed))
+            m_nDepthMax.store(nCalled, std::memory_order_relaxed);
+    }
+    return nCalled;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Resets number of flushes, commands and maximum depth
+///
+////////////////////////////////////////////////////////////////////////////////
+void CWriterQueue::resetStatistics()
+{
+    METHOD_ENTRY("CWriterQueue::resetStatistics")
+
+    m_nFlushes.store(0u, std::memory_order_relaxed);
+    m_nCommands.store(0u, std::memory_order_relaxed);
+    m_nCoalesced.store(0u, std::memory_order_relaxed);
+    m_nDepthMax.store(0u, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Merges commands of the batch with equal keys
+///
+/// Each command is merged into the latest command of its key, which is called
+/// at its position, then. Merged commands are destroyed and set to null.
+///
+/// The latest command per key is found by an open addressing table of at
+/// least twice the size of the batch, thus, nothing is allocated once the
+/// table has grown.
+///
+/// \return Number of commands merged
+///
+////////////////////////////////////////////////////////////////////////////////
+std::size_t CWriterQueue::coalesce()
+{
+    METHOD_ENTRY_QUIET("CWriterQueue::coalesce")
+
+    std::size_t nSize = WRITER_QUEUE_BULK_SIZE;
+    while (nSize < 2u*m_Batch.size()) nSize *= 2u;
+    const std::size_t nMask = nSize - 1u;
+    m_Latest.assign(nSize, WriterQueueLatest{0u, WRITER_QUEUE_NONE});
+
+    std::size_t nCoalesced = 0u;
+    for (auto i=0u; i<m_Batch.size(); ++i)
+    {
+        IBaseCommand* const pCommand = m_Batch[i];
+        if (pCommand->getCoalesce() == ComCoalesceType::NONE) continue;
+
+        // Keys are hashes of pointers and targets, thus, mixed for the mask
+        const std::size_t nKey = pCommand->getCoalesceKey();
+        std::size_t nSlot = (std::uint64_t(nKey) * 0x9e3779b97f4a7c15u >> 32) & nMask;
+        while (m_Latest[nSlot].nIndex != WRITER_QUEUE_NONE && m_Latest[nSlot].nKey != nKey)
+        {
+            nSlot = (nSlot + 1u) & nMask;
+        }
+
+        WriterQueueLatest& Latest = m_Latest[nSlot];
+        if (Latest.nIndex != WRITER_QUEUE_NONE)
+        {
+            // Keys with equal hashes aren't merged, but the latest is kept
+            if (pCommand->coalesce(m_Batch[Latest.nIndex]))
+            {
+                m_Batch[Latest.nIndex]->destroy();
+                m_Batch[Latest.nIndex] = nullptr;
+                ++nCoalesced;
+            }
+        }
+        Latest.nKey = nKey;
+        Latest.nIndex = i;
+    }
+    return nCoalesced;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the producer token of the calling thread
+///
+/// The token is created on first call of a thread. If it isn't cached, the
+/// token of the thread is looked up, thus, a thread never gets a second token
+/// which would break the order of its calls. If the thread cache is full, the
+/// oldest entry is replaced.
+///
+/// \return Producer token of calling thread
+///
+////////////////////////////////////////////////////////////////////////////////
+moodycamel::ProducerToken& CWriterQueue::getProducerToken()
+{
+    METHOD_ENTRY_QUIET("CWriterQueue::getProducerToken")
+
+    for (auto& Entry : t_TokenCache)
+    {
+        if (Entry.nQueueID == m_nID) return *Entry.pToken;
+    }
+
+    m_AccessTokens.acquireLock();
+    auto& pTokenOwned = m_ProducerTokens[std::this_thread::get_id()];
+    if (pTokenOwned == nullptr)
+    {
+        pTokenOwned.reset(new moodycamel::ProducerToken(m_Queue));
+        MEM_ALLOC_QUIET("moodycamel::ProducerToken")
+    }
+    moodycamel::ProducerToken* const pToken = pTokenOwned.get();
+    m_AccessTokens.releaseLock();
+
+    WriterQueueTokenCacheEntry& Entry = t_TokenCache[t_nTokenCacheNext];
+    t_nTokenCacheNext = (t_nTokenCacheNext + 1u) % WRITER_QUEUE_TOKENS_CACHED;
+    Entry.nQueueID = m_nID;
+    Entry.pToken = pToken;
+
+    return *pToken;
+}
@@ -0,0 +1,218 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       writer_queue.h
+/// \brief      Prototype of class "CWriterQueue"
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-19
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef WRITER_QUEUE_H
+#define WRITER_QUEUE_H
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "adaptive_lock.h"
+#include "command_pool.h"
+#include "log.h"
+
+//--- Misc header ------------------------------------------------------------//
+#include "concurrentqueue.h"
+
+/// BFEngine namespace
+namespace bfe
+{
+
+//--- Constants --------------------------------------------------------------//
+constexpr std::size_t WRITER_QUEUE_BULK_SIZE     = 64u;   ///< Commands dequeued at once when flushing
+constexpr std::size_t WRITER_QUEUE_TOKENS_CACHED = 8u;    ///< Producer tokens cached per thread
+constexpr std::size_t WRITER_QUEUE_NONE = std::numeric_limits<std::size_t>::max(); ///< Marks empty entries
+
+class IBaseCommand;
+
+/// Latest command of a key when merging
+struct WriterQueueLatest
+{
+    std::size_t nKey;   ///< Key of commands to be merged
+    std::size_t nIndex; ///< Index of latest command in batch, \ref WRITER_QUEUE_NONE if empty
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Queue of commands of one writer domain and their storage
+///
+/// Each calling thread, i.e. the thread of a module or a worker of the job
+/// system, enqueues through its own producer token, which keeps the order of
+/// the thread's calls. There is exactly one token per thread and queue, owned
+/// by the queue, since tokens must not outlive it. Recently used tokens are
+/// cached thread locally.
+///
+/// The queue is flushed by the thread of the writer domain only, which uses
+/// a single consumer token and dequeues in bulk. Before calling, queued
+/// commands of functions registered for merging are merged per key, see
+/// \ref ComCoalesceType, so that each key is called once per flush.
+///
+////////////////////////////////////////////////////////////////////////////////
+class CWriterQueue
+{
+
+    public:
+
+        //--- Constructor/Destructor -----------------------------------------//
+        CWriterQueue();
+        ~CWriterQueue();
+        CWriterQueue(const CWriterQueue&) = delete;
+        CWriterQueue& operator=(const CWriterQueue&) = delete;
+
+        //--- Constant methods -----------------------------------------------//
+        std::size_t     getDepth() const;
+        std::uint64_t   getDepthMax() const;
+        std::uint64_t   getNumberOfCoalesced() const;
+        std::uint64_t   getNumberOfCommands() const;
+        std::uint64_t   getNumberOfFlushes() const;
+
+        //--- Methods --------------------------------------------------------//
+        CCommandPool*   getPool() {return &m_Pool;}
+
+        void            enqueue(IBaseCommand* const);
+        std::size_t     flush();
+        void            resetStatistics();
+
+    private:
+
+        //--- Methods [private] ----------------------------------------------//
+        std::size_t                coalesce();
+        moodycamel::ProducerToken& getProducerToken();
+
+        //--- Variables [private] --------------------------------------------//
+        static std::atomic<std::uint64_t> s_nIDNext;    ///< ID of next queue, IDs are never reused
+
+        std::uint64_t                                           m_nID;              ///< Identifies queue in thread caches
+        CCommandPool                                            m_Pool;             ///< Slots of queued commands
+        moodycamel::ConcurrentQueue<IBaseCommand*>              m_Queue;            ///< Commands in order of calls per thread
+        moodycamel::ConsumerToken                               m_ConsumerToken;    ///< Token of flushing thread
+        std::unordered_map<std::thread::id,
+                           std::unique_ptr<moodycamel::ProducerToken>> m_ProducerTokens; ///< Token of each calling thread
+        CAdaptiveLock                                           m_AccessTokens;     ///< Protects tokens of calling threads
+        std::vector<IBaseCommand*>                              m_Batch;            ///< Commands of flush, null if merged
+        std::vector<WriterQueueLatest>                          m_Latest;           ///< Latest command per key, open addressing
+
+        std::atomic<std::uint64_t>  m_nFlushes{0u};     ///< Number of flushes calling commands
+        std::atomic<std::uint64_t>  m_nCommands{0u};    ///< Number of commands called
+        std::atomic<std::uint64_t>  m_nCoalesced{0u};   ///< Number of commands merged into later ones
+        std::atomic<std::uint64_t>  m_nDepthMax{0u};    ///< Maximum number of commands of one flush
+};
+
+//--- Implementation is done here for inline optimisation --------------------//
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the approximate number of queued commands
+///
+/// \return Number of commands queued
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::size_t CWriterQueue::getDepth() const
+{
+    METHOD_ENTRY_QUIET("CWriterQueue::getDepth")
+    return m_Queue.size_approx();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the maximum number of commands called by one flush
+///
+/// \return Maximum depth of queue when flushed
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint64_t CWriterQueue::getDepthMax() const
+{
+    METHOD_ENTRY_QUIET("CWriterQueue::getDepthMax")
+    return m_nDepthMax.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the number of commands merged into later ones, not called
+///
+/// \return Number of commands merged
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint64_t CWriterQueue::getNumberOfCoalesced() const
+{
+    METHOD_ENTRY_QUIET("CWriterQueue::getNumberOfCoalesced")
+    return m_nCoalesced.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the number of commands called by all flushes
+///
+/// \return Number of commands called
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint64_t CWriterQueue::getNumberOfCommands() const
+{
+    METHOD_ENTRY_QUIET("CWriterQueue::getNumberOfCommands")
+    return m_nCommands.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Returns the number of flushes that called at least one command
+///
+/// \return Number of flushes
+///
+////////////////////////////////////////////////////////////////////////////////
+inline std::uint64_t CWriterQueue::getNumberOfFlushes() const
+{
+    METHOD_ENTRY_QUIET("CWriterQueue::getNumberOfFlushes")
+    return m_nFlushes.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Enqueues a command through the token of the calling thread
+///
+/// \param _pCommand Command to be called when queue is flushed
+///
+////////////////////////////////////////////////////////////////////////////////
+inline void CWriterQueue::enqueue(IBaseCommand* const _pCommand)
+{
+    METHOD_ENTRY_QUIET("CWriterQueue::enqueue")
+    m_Queue.enqueue(this->getProducerToken(), _pCommand);
+}
+
+} // namespace bfe
+
+#endif // WRITER_QUEUE_H
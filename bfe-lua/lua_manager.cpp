@@ -33,11 +33,7 @@
 //--- Standard header --------------------------------------------------------//
 #include <string>
 
-//--- Misc header ------------------------------------------------------------//
-#include <eigen3/Eigen/Geometry>
-
 using namespace bfe;
-using namespace Eigen;
 
 ///////////////////////////////////////////////////////////////////////////////
 ///
@@ -52,9 +48,7 @@ CLuaManager::CLuaManager() : IComInterfaceProvider(),
     METHOD_ENTRY("CLuaManager::CLuaManager")
     CTOR_CALL("CLuaManager::CLuaManager")
     
-    #ifdef BFE_MULTITHREADING
-        m_strModuleName = "Lua Manager";
-    #endif
+    m_strModuleName = "Lua Manager";
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -83,290 +77,26 @@ bool CLuaManager::init()
         TablePW[Dom] = m_LuaState.create_table();
     }
     
-    for (auto Function : *m_pComInterface->getFunctions())
+    for (const auto& Function : *m_pComInterface->getFunctions())
     {
-        std::string strDomain((*m_pComInterface->getDomainsByFunction())[Function.first]);
-        
-        switch (Function.second->getSignature())
-        {
-            case SignatureType::BOOL_INT:
-            {   
-                std::function<bool(int)> Func =
-                    [=](const int _nN) -> bool {return m_pComInterface->call<bool, int>(Function.first, _nN);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::INT:
-            {   
-                std::function<int()> Func =
-                    [=]() -> int {return m_pComInterface->call<int>(Function.first);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::INT_INT:
+        const std::string strDomain((*m_pComInterface->getDomainsByFunction())[Function.first]);
+        const std::string strName(Function.first);
+
+        // Arguments and return values are converted according to the
+        // function's signature, thus, all signatures share one wrapper. The
+        // function is looked up by name when called, since it might be
+        // registered again meanwhile.
+        TablePW[strDomain.c_str()][strName.c_str()] =
+            [this, strName](sol::variadic_args _Args, sol::this_state _LuaState) -> sol::variadic_results
             {
-                std::function<int(int)> Func =
-                    [=](const int _nN) -> int {return m_pComInterface->call<int, int>(Function.first, _nN);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::INT_STRING:
-            {  
-                std::function<int(std::string)> Func =
-                    [=](const std::string& _strS) -> int {return m_pComInterface->call<int, std::string>(Function.first, _strS);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                    
-                break;
-            }   
-            case SignatureType::DOUBLE:
-            {   
-                std::function<double()> Func =
-                    [=]() -> double {return m_pComInterface->call<double>(Function.first);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                    
-                break;
-            }   
-            case SignatureType::DOUBLE_INT:
-            {   
-                std::function<double(int)> Func =
-                    [=](const int _nN) -> double {return m_pComInterface->call<double, int>(Function.first, _nN);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::DOUBLE_STRING:
-            {   
-                std::function<double(std::string)> Func =
-                    [=](const std::string& _strS) -> double {return m_pComInterface->call<double, std::string>(Function.first, _strS);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::DOUBLE_STRING_DOUBLE:
-            {   
-                std::function<double(std::string, double)> Func = 
-                    [=](const std::string& _strS, const double& _fD) -> double
-                    {return m_pComInterface->call<double, std::string, double>(Function.first, _strS, _fD);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::NONE:
-            {   
-                std::function<void()> Func =
-                    [=]() {m_pComInterface->call<void>(Function.first);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::NONE_BOOL:
-            {   
-                std::function<void(bool)> Func =
-                    [=](const bool _bB) {m_pComInterface->call<void, bool>(Function.first, _bB);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::NONE_DOUBLE:
-            {   
-                std::function<void(double)> Func =
-                    [=](const double& _fD) {m_pComInterface->call<void, double>(Function.first, _fD);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::NONE_2DOUBLE:
-            {   
-                std::function<void(double, double)> Func =
-                    [=](const double& _f1, const double& _f2) {m_pComInterface->call<void, double, double>(Function.first, _f1, _f2);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::NONE_INT:
-            {   
-                std::function<void(int)> Func =
-                    [=](const int _nN) {m_pComInterface->call<void, int>(Function.first, _nN);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::NONE_2INT:
-            {   
-                std::function<void(int, int)> Func =
-                    [=](const int _n1, const int _n2) {m_pComInterface->call<void, int, int>(Function.first, _n1, _n2);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::NONE_3INT:
-            {   
-                std::function<void(int, int, int)> Func =
-                    [=](const int _n1, const int _n2, const int _n3) {m_pComInterface->call<void, int, int>(Function.first, _n1, _n2, _n3);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::NONE_INT_DOUBLE:
-            {   
-                std::function<void(int, double)> Func =
-                    [=](const int _n1, const double& _f1) {m_pComInterface->call<void, int, double>(Function.first, _n1, _f1);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::NONE_INT_2DOUBLE:
-            {   
-                std::function<void(int, double, double)> Func =
-                    [=](const int _n1, const double& _f1, const double& _f2) {m_pComInterface->call<void, int, double, double>(Function.first, _n1, _f1, _f2);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }  
-            case SignatureType::NONE_INT_4DOUBLE:
-            {   
-                std::function<void(int, double, double, double, double)> Func =
-                    [=](const int _n1, const double& _f1, const double& _f2, const double& _f3, const double& _f4)
-                        {m_pComInterface->call<void, int, double, double, double, double>(Function.first, _n1, _f1, _f2, _f3, _f4);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::NONE_INT_DYN_ARRAY:
-            {   
-                std::function<void(int, sol::table)> Func =
-                    [=](const int _n1, const sol::table& _T)
-                    {
-                        std::vector<double> vecTable(_T.size());
-                        for (auto i = 1u; i <= _T.size(); ++i)
-                        {
-                            vecTable[i-1] = _T[i];
-                        }
-                        m_pComInterface->call<void, int, std::vector<double>>(Function.first, _n1, vecTable);
-                    };
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::NONE_INT_STRING:
-            {   
-                std::function<void(int, std::string)> Func =
-                    [=](const int _n1, const std::string& _str1) {m_pComInterface->call<void, int, std::string>(Function.first, _n1, _str1);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::NONE_STRING:
-            {   
-                std::function<void(std::string)> Func =
-                    [=](const std::string& _str1) {m_pComInterface->call<void, std::string>(Function.first, _str1);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::NONE_2STRING:
-            {   
-                std::function<void(std::string, std::string)> Func =
-                    [=](const std::string& _str1, const std::string& _str2)
-                        {m_pComInterface->call<void, std::string, std::string>(Function.first, _str1, _str2);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }
-            case SignatureType::NONE_4STRING:
-            {   
-                std::function<void(std::string, std::string, std::string, std::string)> Func =
-                    [=](const std::string& _str1, const std::string& _str2, const std::string& _str3, const std::string& _str4)
-                        {m_pComInterface->call<void, std::string, std::string, std::string, std::string>(Function.first, _str1, _str2, _str3, _str4);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }
-            case SignatureType::NONE_STRING_INT:
-            {   
-                std::function<void(std::string, int)> Func =
-                    [=](const std::string& _str1, const int _n1) {m_pComInterface->call<void, std::string, int>(Function.first, _str1, _n1);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::NONE_STRING_2INT:
-            {   
-                std::function<void(std::string, int, int)> Func =
-                    [=](const std::string& _str1, const int _n1, const int _n2)
-                        {m_pComInterface->call<void, std::string, int, int>(Function.first, _str1, _n1, _n2);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::NONE_STRING_DOUBLE:
-            {   
-                std::function<void(std::string, double)> Func =
-                    [=](const std::string& _str1, const double& _f1) {m_pComInterface->call<void, std::string, double>(Function.first, _str1, _f1);};
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::VEC2DDOUBLE:
-            {   
-                std::function<std::tuple<double, double>()> Func =
-                    [=]() -> std::tuple<double,double>
-                    {
-                        Vector2d vecV = m_pComInterface->call<Vector2d>(Function.first);
-                        return std::tie(vecV[0],vecV[1]);
-                    };
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::VEC2DDOUBLE_INT:
-            {   
-                std::function<std::tuple<double, double>(int)> Func =
-                    [=](const int _n1) -> std::tuple<double,double>
-                    {
-                        Vector2d vecV = m_pComInterface->call<Vector2d, int>(Function.first, _n1);
-                        return std::tie(vecV[0],vecV[1]);
-                    };
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::VEC2DDOUBLE_2INT:
-            {   
-                std::function<std::tuple<double, double>(int, int)> Func =
-                    [=](const int _n1, const int _n2) -> std::tuple<double,double>
-                    {
-                        Vector2d vecV = m_pComInterface->call<Vector2d, int, int>(Function.first, _n1, _n2);
-                        return std::tie(vecV[0],vecV[1]);
-                    };
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::VEC2DDOUBLE_STRING:
-            {   
-                std::function<std::tuple<double, double>(std::string)> Func =
-                    [=](const std::string& _str1) -> std::tuple<double,double>
-                    {
-                        Vector2d vecV = m_pComInterface->call<Vector2d, std::string>(Function.first, _str1);
-                        return std::tie(vecV[0],vecV[1]);
-                    };
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            case SignatureType::VEC2DDOUBLE_2STRING:
-            {   
-                std::function<std::tuple<double, double>(std::string, std::string)> Func =
-                    [=](const std::string& _str1, const std::string& _str2) -> std::tuple<double,double>
-                    {
-                        Vector2d vecV = m_pComInterface->call<Vector2d, std::string, std::string>(Function.first, _str1, _str2);
-                        return std::tie(vecV[0],vecV[1]);
-                    };
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }
-            case SignatureType::VEC2DINT:
-            {   
-                std::function<std::tuple<int, int>()> Func =
-                    [=]() -> std::tuple<int, int>
-                    {
-                        Vector2i vecV = m_pComInterface->call<Vector2i>(Function.first);
-                        return std::tie(vecV[0],vecV[1]);
-                    };
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }
-            case SignatureType::VEC2DINT_INT:
-            {   
-                std::function<std::tuple<int, int>(int)> Func =
-                    [=](const int _n1) -> std::tuple<int, int>
-                    {
-                        Vector2i vecV = m_pComInterface->call<Vector2i, int>(Function.first, _n1);
-                        return std::tie(vecV[0],vecV[1]);
-                    };
-                TablePW[strDomain.c_str()][Function.first.c_str()] = Func;
-                break;
-            }   
-            default:
-                DOM_DEV(NOTICE_MSG("Lua Manager", "Wrapper for " << Function.first << "'s signature not implemented."))
-                break;
-        }
+                CLuaComValueReader Reader(_Args);
+                CLuaComValueWriter Writer(_LuaState);
+                if (!m_pComInterface->invoke(strName, Reader, Writer))
+                {
+                    WARNING_MSG("Lua Manager", "Unknown function <" << strName << ">, not called.")
+                }
+                return Writer.getValues();
+            };
     }
     DOM_VAR(DEBUG_BLK(
         for (const auto& TablePWEntry : TablePW)
@@ -424,10 +154,10 @@ bool CLuaManager::processFrame()
         if (!m_bPaused)
         {
             m_TimeProcessed.start();
-            m_pComInterface->call<void>("e_lua_update");
+            m_LuaUpdate.call();
             m_TimeProcessed.stop();
         }
-        m_pComInterface->callWriters("lua");
+        m_pComInterface->callWriters(m_pWriterQueue);
         return true;
     }
     catch (const std::exception& _E)
@@ -453,6 +183,7 @@ void CLuaManager::myInitComInterface()
                                     "Update event of the lua main loop",
                                     {{ParameterType::NONE, "No return value"}},
                                     "system");
+    m_LuaUpdate = m_pComInterface->resolve<void>("e_lua_update");
     
     // Callback to physics pause
     std::function<void(void)> FuncPause =
@@ -540,8 +271,9 @@ void CLuaManager::myInitComInterface()
 ///
 /// \brief Register a Lua function as callback
 ///
-/// This method takes a Lua function and wraps it in a \ref CCommand, using
-/// a std::function. This command is then registered at the \ref CComInterface.
+/// This method takes a Lua function and registers it as generic callback at
+/// the \ref CComInterface, which wraps it according to the signature of the
+/// function.
 ///
 /// \note Callbacks do not have any return value, they just inherit the
 ///       parameters from function/event they are hooked on.
@@ -560,158 +292,181 @@ bool CLuaManager::registerCallback(const std::string& _strFunc,
 {
     METHOD_ENTRY("CLuaManager::registerCallback")
     
-    const auto ci = m_pComInterface->getFunctions()->find(_strFunc);
-    if (ci != m_pComInterface->getFunctions()->end())
+    if (m_pComInterface->getFunctions()->find(_strFunc) == m_pComInterface->getFunctions()->end())
     {
-        switch (ci->second->getSignature())
+        WARNING_MSG("Lua Manager", "Can't register callback on <" << _strFunc << ">, function unknown.")
+        return false;
+    }
+
+    return m_pComInterface->registerGenericCallback(_strFunc,
+        [this, _strCallback](const ComArgumentsWriterType& _WriteArgs)
         {
-            case SignatureType::DOUBLE:
-            case SignatureType::INT:
-            case SignatureType::NONE:
-            case SignatureType::VEC2DDOUBLE:
-            {
-                std::function<void(void)> Func = [=]() {m_LuaState[_strCallback]();};
-                m_pComInterface->registerCallback<void>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            case SignatureType::BOOL_INT:
-            case SignatureType::DOUBLE_INT:
-            case SignatureType::INT_INT:
-            case SignatureType::NONE_INT:
-            case SignatureType::VEC2DDOUBLE_INT:
-            case SignatureType::VEC2DINT_INT:
-            {
-                std::function<void(int)> Func = [=](const int _nN){m_LuaState[_strCallback](_nN);};
-                m_pComInterface->registerCallback<void, int>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            case SignatureType::DOUBLE_STRING:
-            case SignatureType::INT_STRING:
-            case SignatureType::NONE_STRING:
-            case SignatureType::VEC2DDOUBLE_STRING:
-            {
-                std::function<void(std::string)> Func = [=](const std::string& _strS){m_LuaState[_strCallback](_strS);};
-                m_pComInterface->registerCallback<void, std::string>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            case SignatureType::DOUBLE_STRING_DOUBLE:
-            case SignatureType::NONE_STRING_DOUBLE:
-            {
-                std::function<void(std::string, double)> Func = [=](const std::string& _strS, const double& _fD){m_LuaState[_strCallback](_strS, _fD);};
-                m_pComInterface->registerCallback<void, std::string, double>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            case SignatureType::NONE_BOOL:
-            {
-                std::function<void(bool)> Func = [=](const bool _bB){m_LuaState[_strCallback](_bB);};
-                m_pComInterface->registerCallback<void, bool>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            case SignatureType::NONE_DOUBLE:
-            {
-                std::function<void(double)> Func = [=](const double& _fD){m_LuaState[_strCallback](_fD);};
-                m_pComInterface->registerCallback<void, double>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            case SignatureType::NONE_2DOUBLE:
-            {
-                std::function<void(double, double)> Func = [=](const double& _f1, const double& _f2){m_LuaState[_strCallback](_f1, _f2);};
-                m_pComInterface->registerCallback<void, double, double>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            case SignatureType::NONE_2INT:
-            case SignatureType::VEC2DDOUBLE_2INT:
-            {
-                std::function<void(int, int)> Func = [=](const int _n1, const int _n2){m_LuaState[_strCallback](_n1, _n2);};
-                m_pComInterface->registerCallback<void, int, int>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            case SignatureType::NONE_3INT:
-            {
-                std::function<void(int, int, int)> Func = [=](const int _n1, const int _n2, const int _n3){m_LuaState[_strCallback](_n1, _n2, _n3);};
-                m_pComInterface->registerCallback<void, int, int, int>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            case SignatureType::NONE_INT_DOUBLE:
-            {
-                std::function<void(int, double)> Func = [=](const int _nN, const double& _fD){m_LuaState[_strCallback](_nN, _fD);};
-                m_pComInterface->registerCallback<void, int, double>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            case SignatureType::NONE_INT_2DOUBLE:
-            {
-                std::function<void(int, double, double)> Func = [=](const int _nN, const double& _f1, const double& _f2){m_LuaState[_strCallback](_nN, _f1, _f2);};
-                m_pComInterface->registerCallback<void, int, double, double>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            case SignatureType::NONE_INT_4DOUBLE:
-            {
-                std::function<void(int, double, double, double, double)> Func = [=](const int _nN, const double& _f1, const double& _f2,
-                                                                                                   const double& _f3, const double& _f4)
-                {m_LuaState[_strCallback](_nN, _f1, _f2, _f3, _f4);};
-                m_pComInterface->registerCallback<void, int, double, double, double, double>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            case SignatureType::NONE_INT_DYN_ARRAY:
-            {
-                std::function<void(int, std::vector<double>)> Func = [=](const int _nN, const std::vector<double>& _vecV)
-                {m_LuaState[_strCallback](_nN, _vecV);};
-                m_pComInterface->registerCallback<void, int, std::vector<double>>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            case SignatureType::NONE_INT_STRING:
-            {
-                std::function<void(int, std::string)> Func = [=](const int _nN, const std::string& _strS)
-                {m_LuaState[_strCallback](_nN, _strS);};
-                m_pComInterface->registerCallback<void, int, std::string>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            case SignatureType::NONE_2STRING:
-            {
-                std::function<void(std::string, std::string)> Func = [=](const std::string& _str1, const std::string& _str2)
-                    {m_LuaState[_strCallback](_str1, _str2);};
-                m_pComInterface->registerCallback<void, std::string>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            case SignatureType::NONE_4STRING:
-            {
-                std::function<void(std::string, std::string, std::string, std::string)> Func = 
-                    [=](const std::string& _str1, const std::string& _str2, const std::string& _str3, const std::string& _str4)
-                        {m_LuaState[_strCallback](_str1, _str2, _str3, _str4);};
-                m_pComInterface->registerCallback<void, std::string>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            case SignatureType::NONE_STRING_INT:
-            {
-                std::function<void(std::string, int)> Func = [=](const std::string& _strS, const int _nN)
-                {m_LuaState[_strCallback](_strS, _nN);};
-                m_pComInterface->registerCallback<void, std::string, int>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            case SignatureType::NONE_STRING_2INT:
-            {
-                std::function<void(std::string, int, int)> Func = [=](const std::string& _strS, const int _n1, const int _n2)
-                {m_LuaState[_strCallback](_strS, _n1, _n2);};
-                m_pComInterface->registerCallback<void, std::string, int, int>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            case SignatureType::VEC2DDOUBLE_2STRING:
-            {
-                std::function<void(std::string, std::string)> Func = [=](const std::string& _str1, const std::string& _str2)
-                {m_LuaState[_strCallback](_str1, _str2);};
-                m_pComInterface->registerCallback<void, std::string, std::string>(_strFunc, Func, _strWriterDomain);
-                break;
-            }
-            default:
-                DOM_DEV(NOTICE_MSG("Lua Manager", "Wrapper for " << ci->first << "'s signature not implemented."))
-                break;
-        }
+            CLuaComValueWriter Writer(m_LuaState.lua_state());
+            _WriteArgs(Writer);
+            m_LuaState[_strCallback](sol::as_args(Writer.getValues()));
+        }, _strWriterDomain);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads a boolean argument
+///
+/// \return Value read, false if missing
+///
+///////////////////////////////////////////////////////////////////////////////
+bool CLuaComValueReader::readBool()
+{
+    METHOD_ENTRY("CLuaComValueReader::readBool")
+    if (!this->isAvailable()) return false;
+    return m_Args[m_nIndex++].as<bool>();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads a floating point argument
+///
+/// \return Value read, zero if missing
+///
+///////////////////////////////////////////////////////////////////////////////
+double CLuaComValueReader::readDouble()
+{
+    METHOD_ENTRY("CLuaComValueReader::readDouble")
+    if (!this->isAvailable()) return 0.0;
+    return m_Args[m_nIndex++].as<double>();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads an array argument, given as Lua table
+///
+/// \return Values read, empty if missing
+///
+///////////////////////////////////////////////////////////////////////////////
+std::vector<double> CLuaComValueReader::readDoubleArray()
+{
+    METHOD_ENTRY("CLuaComValueReader::readDoubleArray")
+    if (!this->isAvailable()) return {};
+
+    sol::table Table = m_Args[m_nIndex++].as<sol::table>();
+    std::vector<double> Values(Table.size());
+    for (auto i = 1u; i <= Table.size(); ++i)
+    {
+        Values[i-1] = Table[i];
     }
-    else
+    return Values;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads an integer argument
+///
+/// \return Value read, zero if missing
+///
+///////////////////////////////////////////////////////////////////////////////
+int CLuaComValueReader::readInt()
+{
+    METHOD_ENTRY("CLuaComValueReader::readInt")
+    if (!this->isAvailable()) return 0;
+    return m_Args[m_nIndex++].as<int>();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads a string argument
+///
+/// \return Value read, empty if missing
+///
+///////////////////////////////////////////////////////////////////////////////
+std::string CLuaComValueReader::readString()
+{
+    METHOD_ENTRY("CLuaComValueReader::readString")
+    if (!this->isAvailable()) return "";
+    return m_Args[m_nIndex++].as<std::string>();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Checks if another argument was given
+///
+/// \return Argument available?
+///
+///////////////////////////////////////////////////////////////////////////////
+bool CLuaComValueReader::isAvailable() const
+{
+    METHOD_ENTRY("CLuaComValueReader::isAvailable")
+    if (m_nIndex < int(m_Args.size())) return true;
+
+    WARNING_MSG("Lua Manager", "Missing argument, using default value.")
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes a boolean value
+///
+/// \param _bValue Value to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CLuaComValueWriter::writeBool(const bool _bValue)
+{
+    METHOD_ENTRY("CLuaComValueWriter::writeBool")
+    m_Values.push_back(sol::make_object(m_pLuaState, _bValue));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes a floating point value
+///
+/// \param _fValue Value to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CLuaComValueWriter::writeDouble(const double _fValue)
+{
+    METHOD_ENTRY("CLuaComValueWriter::writeDouble")
+    m_Values.push_back(sol::make_object(m_pLuaState, _fValue));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes an array as Lua table
+///
+/// \param _Values Values to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CLuaComValueWriter::writeDoubleArray(const std::vector<double>& _Values)
+{
+    METHOD_ENTRY("CLuaComValueWriter::writeDoubleArray")
+
+    sol::table Table = sol::state_view(m_pLuaState).create_table(int(_Values.size()), 0);
+    for (auto i = 0u; i < _Values.size(); ++i)
     {
-        WARNING_MSG("Lua Manager", "Can't register callback on <" << _strFunc << ">, function unknown.")
-        return false;
+        Table[i+1] = _Values[i];
     }
-    
-    return true;
+    m_Values.push_back(sol::make_object(m_pLuaState, Table));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes an integer value
+///
+/// \param _nValue Value to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CLuaComValueWriter::writeInt(const int _nValue)
+{
+    METHOD_ENTRY("CLuaComValueWriter::writeInt")
+    m_Values.push_back(sol::make_object(m_pLuaState, _nValue));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes a string
+///
+/// \param _strValue Value to write
+///
+///////////////////////////////////////////////////////////////////////////////
+void CLuaComValueWriter::writeString(const std::string& _strValue)
+{
+    METHOD_ENTRY("CLuaComValueWriter::writeString")
+    m_Values.push_back(sol::make_object(m_pLuaState, _strValue));
 }
@@ -50,6 +50,62 @@ namespace bfe
 // Constants
 const std::string LUA_PACKAGE_PREFIX{"bfe"};
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads the arguments of a call from Lua
+///
+////////////////////////////////////////////////////////////////////////////////
+class CLuaComValueReader : public IComValueReader
+{
+    public:
+        //--- Constructor/Destructor -----------------------------------------//
+        explicit CLuaComValueReader(const sol::variadic_args& _Args) : m_Args(_Args) {}
+
+        //--- Methods --------------------------------------------------------//
+        bool                readBool() override;
+        double              readDouble() override;
+        std::vector<double> readDoubleArray() override;
+        int                 readInt() override;
+        std::string         readString() override;
+
+    private:
+
+        //--- Methods [private] ----------------------------------------------//
+        bool isAvailable() const;
+
+        //--- Variables [private] --------------------------------------------//
+        const sol::variadic_args&   m_Args;         ///< Arguments given by Lua
+        int                         m_nIndex = 0;   ///< Index of next argument
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Collects return values or callback arguments for Lua
+///
+////////////////////////////////////////////////////////////////////////////////
+class CLuaComValueWriter : public IComValueWriter
+{
+    public:
+        //--- Constructor/Destructor -----------------------------------------//
+        explicit CLuaComValueWriter(lua_State* const _pLuaState) : m_pLuaState(_pLuaState) {}
+
+        //--- Constant methods -----------------------------------------------//
+        const sol::variadic_results& getValues() const {return m_Values;}
+
+        //--- Methods --------------------------------------------------------//
+        void writeBool(const bool) override;
+        void writeDouble(const double) override;
+        void writeDoubleArray(const std::vector<double>&) override;
+        void writeInt(const int) override;
+        void writeString(const std::string&) override;
+
+    private:
+
+        //--- Variables [private] --------------------------------------------//
+        lua_State*              m_pLuaState;    ///< Lua state values are created in
+        sol::variadic_results   m_Values;       ///< Values written
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Class to handling Lua scripting
@@ -93,6 +149,8 @@ class CLuaManager : public IComInterfaceProvider,
         bool            m_bPaused;              ///< Indicates if processing is paused, depends on physics
         
         bfe::CTimer     m_TimeProcessed;        ///< Counts processing time for one Lua frame
+
+        CCommandRef<void> m_LuaUpdate;          ///< Update event, resolved since called each frame
 };
 
 //--- Implementation is done here for inline optimisation --------------------//
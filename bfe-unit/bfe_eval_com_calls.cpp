@@ -0,0 +1,307 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_eval_com_calls.cpp
+/// \brief      Main program for evaluation of com interface call throughput
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-17
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
+#include "log.h"
+#include "com_interface.h"
+#include "timer.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+//--- Constants --------------------------------------------------------------//
+static constexpr int NUMBER_OF_FUNCTIONS = 256;     // Registered functions, like a full engine
+static constexpr int NUMBER_OF_CALLS     = 1000000; // Calls per thread
+static constexpr int NUMBER_OF_EVENTS    = 1000;    // Queued setters per frame, e.g. mouse moves
+static constexpr int NUMBER_OF_TARGETS   = 16;      // Distinct targets of setters
+static constexpr int NUMBER_OF_FRAMES    = 1000;    // Frames flushing setters
+
+CComInterface*   g_pComInterface = nullptr; ///< Com interface with all functions registered
+std::atomic_bool g_bClean(true);            ///< Correctness of return values
+double           g_Targets[NUMBER_OF_TARGETS]; ///< Values of targets written by setters
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls function by name, i.e. with lookup and lock
+///
+/// \param _pnSum Sum of return values, prevents optimisation
+///
+///////////////////////////////////////////////////////////////////////////////
+void callByName(std::atomic<long>* const _pnSum)
+{
+    METHOD_ENTRY("callByName")
+
+    const std::string strName("function_" + std::to_string(NUMBER_OF_FUNCTIONS/2));
+    long nSum = 0;
+    for (auto i=0; i<NUMBER_OF_CALLS; ++i)
+    {
+        nSum += g_pComInterface->call<int, int>(strName, 1);
+    }
+    *_pnSum += nSum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls function by resolved reference, i.e. without lookup and lock
+///
+/// \param _pnSum Sum of return values, prevents optimisation
+///
+///////////////////////////////////////////////////////////////////////////////
+void callResolved(std::atomic<long>* const _pnSum)
+{
+    METHOD_ENTRY("callResolved")
+
+    const auto Function = g_pComInterface->resolve<int, int>("function_" + std::to_string(NUMBER_OF_FUNCTIONS/2));
+    long nSum = 0;
+    for (auto i=0; i<NUMBER_OF_CALLS; ++i)
+    {
+        nSum += Function.call(1);
+    }
+    *_pnSum += nSum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls function from a command string, parsed by streams
+///
+/// This is how commands from strings were called before, kept for
+/// comparison.
+///
+/// \param _pnSum Sum of return values, prevents optimisation
+///
+///////////////////////////////////////////////////////////////////////////////
+void callByStream(std::atomic<long>* const _pnSum)
+{
+    METHOD_ENTRY("callByStream")
+
+    const std::string strCommand("function_" + std::to_string(NUMBER_OF_FUNCTIONS/2) + " 1");
+    long nSum = 0;
+    for (auto i=0; i<NUMBER_OF_CALLS; ++i)
+    {
+        std::istringstream iss(strCommand);
+        std::ostringstream oss("");
+        std::string strName;
+        iss >> strName;
+
+        IBaseCommand* const pCommand = g_pComInterface->getFunctions()->at(strName);
+        CComStreamReader Reader(iss);
+        CComStreamWriter Writer(oss);
+        pCommand->invoke(g_pComInterface, strName, Reader, Writer);
+        nSum += std::stol(oss.str());
+    }
+    *_pnSum += nSum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Calls function from a command string, parsed in place
+///
+/// \param _pnSum Sum of return values, prevents optimisation
+///
+///////////////////////////////////////////////////////////////////////////////
+void callByString(std::atomic<long>* const _pnSum)
+{
+    METHOD_ENTRY("callByString")
+
+    const std::string strCommand("function_" + std::to_string(NUMBER_OF_FUNCTIONS/2) + " 1");
+    std::string strResult;
+    long nSum = 0;
+    for (auto i=0; i<NUMBER_OF_CALLS; ++i)
+    {
+        g_pComInterface->call(strCommand, strResult);
+        nSum += std::stol(strResult);
+    }
+    *_pnSum += nSum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Enqueues setters each frame and measures flushing the writer queue
+///
+/// \param _strName Name of setter
+/// \param _pWriterQueue Queue of setter
+///
+/// \return Setters flushed per second
+///
+///////////////////////////////////////////////////////////////////////////////
+double evaluateFlush(const std::string& _strName, CWriterQueue* const _pWriterQueue)
+{
+    METHOD_ENTRY("evaluateFlush")
+
+    const auto Setter = g_pComInterface->resolve<void, int, double>(_strName);
+    CTimer Timer;
+    double fTime = 0.0;
+    for (auto i=0; i<NUMBER_OF_FRAMES; ++i)
+    {
+        for (auto j=0; j<NUMBER_OF_EVENTS; ++j) Setter.call(j % NUMBER_OF_TARGETS, j);
+        Timer.start();
+        _pWriterQueue->flush();
+        Timer.stop();
+        fTime += Timer.getTime();
+
+        // Last values are written either way
+        if (g_Targets[0] != (NUMBER_OF_EVENTS-1) / NUMBER_OF_TARGETS * NUMBER_OF_TARGETS) g_bClean = false;
+    }
+    return double(NUMBER_OF_FRAMES) * NUMBER_OF_EVENTS / fTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Runs given number of callers and measures throughput
+///
+/// \param _Call Caller function
+/// \param _nThreads Number of caller threads
+///
+/// \return Calls per second
+///
+///////////////////////////////////////////////////////////////////////////////
+double evaluate(void (*_Call)(std::atomic<long>*), const int _nThreads)
+{
+    METHOD_ENTRY("evaluate")
+
+    std::atomic<long> nSum(0);
+    std::vector<std::thread> Threads;
+    CTimer Timer;
+
+    Timer.start();
+    for (auto i=0; i<_nThreads; ++i) Threads.emplace_back(_Call, &nSum);
+    for (auto& Thread : Threads) Thread.join();
+    Timer.stop();
+
+    const double fCalls = double(_nThreads) * NUMBER_OF_CALLS;
+    if (nSum != long(fCalls)) g_bClean = false;
+    return fCalls / Timer.getTime();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("Com Calls Evaluation", "Running...")
+
+    CComInterface ComInterface;
+    g_pComInterface = &ComInterface;
+
+    for (auto i=0; i<NUMBER_OF_FUNCTIONS; ++i)
+    {
+        ComInterface.registerFunction("function_" + std::to_string(i),
+                                      CCommand<int, int>([](const int _nN) -> int {return _nN;}),
+                                      "Returns given value");
+    }
+
+    const int nThreadsMax = std::max(1u, std::thread::hardware_concurrency());
+    for (auto nThreads=1; nThreads<=nThreadsMax; nThreads*=2)
+    {
+        const double fByName = evaluate(callByName, nThreads);
+        const double fResolved = evaluate(callResolved, nThreads);
+        INFO_MSG("Com Calls Evaluation", "Callers: " << nThreads
+                 << ", by name: " << fByName * 1.0e-6 << " MCalls/s"
+                 << ", resolved: " << fResolved * 1.0e-6 << " MCalls/s"
+                 << ", speedup: " << fResolved / fByName)
+    }
+
+    // Commands from strings, e.g. console or automation
+    {
+        const double fByStream = evaluate(callByStream, 1);
+        const double fByString = evaluate(callByString, 1);
+        INFO_MSG("Com Calls Evaluation", "String commands, callers: 1"
+                 << ", streams: " << fByStream * 1.0e-6 << " MCommands/s"
+                 << ", in place: " << fByString * 1.0e-6 << " MCommands/s"
+                 << ", speedup: " << fByString / fByStream)
+    }
+
+    // Setters of few targets, e.g. input, merged before calling
+    {
+        CWriterQueue* const pWriterQueue = ComInterface.registerWriterDomain("eval");
+        const auto Setter = [](const int _nTarget, const double _fValue) {g_Targets[_nTarget] = _fValue;};
+        // Like updating a transform, the value is still recoverable for checking
+        const auto Transform = [](const int _nTarget, const double _fValue)
+        {
+            const double fAngle = _fValue * 1.0e-3;
+            const double fX = std::cos(fAngle) * std::cos(fAngle) + std::sin(fAngle) * std::sin(fAngle);
+            g_Targets[_nTarget] = std::round(fX * _fValue);
+        };
+        for (const auto Merge : {ComCoalesceType::NONE, ComCoalesceType::LAST_PER_TARGET})
+        {
+            const std::string strSuffix(Merge == ComCoalesceType::NONE ? "" : "_merged");
+            ComInterface.registerFunction("setter" + strSuffix, CCommand<void, int, double>(Setter),
+                                          "Sets target, queued", {}, "", "eval", Merge);
+            ComInterface.registerFunction("transform" + strSuffix, CCommand<void, int, double>(Transform),
+                                          "Transforms target, queued", {}, "", "eval", Merge);
+        }
+        for (const std::string strName : {"setter", "transform"})
+        {
+            const double fUnmerged = evaluateFlush(strName, pWriterQueue);
+            const double fMerged = evaluateFlush(strName + "_merged", pWriterQueue);
+            INFO_MSG("Com Calls Evaluation", "Flushing " << strName << ", events: " << NUMBER_OF_EVENTS
+                     << ", targets: " << NUMBER_OF_TARGETS
+                     << ", unmerged: " << fUnmerged * 1.0e-6 << " MEvents/s"
+                     << ", merged: " << fMerged * 1.0e-6 << " MEvents/s"
+                     << ", speedup: " << fMerged / fUnmerged)
+        }
+    }
+
+    // Overhead of recording each call
+    ComInterface.setProfiling(true);
+    INFO_MSG("Com Calls Evaluation", "Profiled, callers: 1"
+             << ", by name: " << evaluate(callByName, 1) * 1.0e-6 << " MCalls/s"
+             << ", resolved: " << evaluate(callResolved, 1) * 1.0e-6 << " MCalls/s")
+    ComInterface.setProfiling(false);
+
+    if (g_bClean)
+    {
+        INFO_MSG("Com Calls Evaluation", "Passed.")
+        return EXIT_SUCCESS;
+    }
+    else
+    {
+        ERROR_MSG("Com Calls Evaluation", "Failed. Invalid return values.")
+        return EXIT_FAILURE;
+    }
+}
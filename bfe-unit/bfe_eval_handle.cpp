@@ -0,0 +1,302 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_eval_handle.cpp
+/// \brief      Main program for evaluation of handle throughput
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-02
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
+#include "log.h"
+#include "handle_manager.h"
+#include "timer.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+//--- Constants --------------------------------------------------------------//
+static constexpr int NUMBER_OF_HANDLES = 1024;      // Handles per thread
+static constexpr int NUMBER_OF_ROUNDS  = 1000;
+static constexpr int NUMBER_OF_ROUNDS_LAYOUT = 200;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reference handle slot, array of structures layout
+///
+/// This is the layout of the handle map before counters and pointers were
+/// split into separate arrays. It is only used for comparison.
+///
+////////////////////////////////////////////////////////////////////////////////
+struct HandleSlotAoS
+{
+    std::atomic<HandleCounterType>  Counter;    ///< Counter to manage stale handles
+    std::atomic<std::uint32_t>      NextFree;   ///< Index of next free slot while in free list
+    std::atomic<void*>              pEntry;     ///< Pointer represented by handle
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reference handle id, 64 bit layout
+///
+////////////////////////////////////////////////////////////////////////////////
+struct HandleIDWide
+{
+    std::uint32_t   Index;      ///< Actual handle id
+    std::uint16_t   Counter;    ///< Counter to manage stale handles
+    std::uint16_t   Free;       ///< Not used
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Adds and removes handles
+///
+/// \param _pHandleManager Handle manager to be evaluated
+///
+///////////////////////////////////////////////////////////////////////////////
+void addRemove(CHandleManager* const _pHandleManager)
+{
+    METHOD_ENTRY("addRemove")
+
+    std::vector<int>        Objects(NUMBER_OF_HANDLES);
+    std::vector<HandleID>   IDs(NUMBER_OF_HANDLES);
+
+    for (auto r=0; r<NUMBER_OF_ROUNDS; ++r)
+    {
+        for (auto i=0; i<NUMBER_OF_HANDLES; ++i) IDs[i] = _pHandleManager->add(&Objects[i]);
+        for (auto i=0; i<NUMBER_OF_HANDLES; ++i) _pHandleManager->remove(IDs[i]);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Adds and removes handles using the batch interface
+///
+/// \param _pHandleManager Handle manager to be evaluated
+///
+///////////////////////////////////////////////////////////////////////////////
+void addRemoveBatch(CHandleManager* const _pHandleManager)
+{
+    METHOD_ENTRY("addRemoveBatch")
+
+    std::vector<int>        Objects(NUMBER_OF_HANDLES);
+    std::vector<void*>      Entries(NUMBER_OF_HANDLES);
+    std::vector<HandleID>   IDs(NUMBER_OF_HANDLES);
+
+    for (auto i=0; i<NUMBER_OF_HANDLES; ++i) Entries[i] = &Objects[i];
+
+    for (auto r=0; r<NUMBER_OF_ROUNDS; ++r)
+    {
+        _pHandleManager->addBatch(Entries.data(), NUMBER_OF_HANDLES, IDs.data());
+        _pHandleManager->removeBatch(IDs.data(), NUMBER_OF_HANDLES);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Dereferences handles
+///
+/// \param _pHandleManager Handle manager to be evaluated
+/// \param _pIDs Handles to be dereferenced
+/// \param _pnSum Sum of dereferenced values, prevents optimisation
+///
+///////////////////////////////////////////////////////////////////////////////
+void access(CHandleManager* const _pHandleManager,
+            const std::vector<HandleID>* const _pIDs,
+            std::atomic<long>* const _pnSum)
+{
+    METHOD_ENTRY("access")
+
+    long nSum = 0;
+    for (auto r=0; r<NUMBER_OF_ROUNDS; ++r)
+    {
+        for (const auto ID : *_pIDs)
+        {
+            if (_pHandleManager->isValid(ID)) nSum += *_pHandleManager->get<int>(ID);
+        }
+    }
+    *_pnSum += nSum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Compares handle validation of the current layout with the array of
+///        structures layout
+///
+/// All slots are filled and validated in random order, which is the typical
+/// access pattern when entities refer to each other.
+///
+/// \return Test passed?
+///
+///////////////////////////////////////////////////////////////////////////////
+bool evaluateLayout()
+{
+    METHOD_ENTRY("evaluateLayout")
+
+    const std::uint32_t nHandles = MAX_HANDLES-1;
+
+    CHandleManager  HandleManager;
+    int             nObject = 1;
+
+    std::vector<HandleID>       IDs(nHandles);
+    std::vector<HandleIDWide>   IDsWide(nHandles);
+    std::vector<HandleSlotAoS>  SlotsAoS(MAX_HANDLES);
+
+    for (auto i=0u; i<nHandles; ++i)
+    {
+        IDs[i] = HandleManager.add(&nObject);
+        SlotsAoS[IDs[i].C.Index-1].Counter = IDs[i].C.Counter;
+        SlotsAoS[IDs[i].C.Index-1].NextFree = 0u;
+        SlotsAoS[IDs[i].C.Index-1].pEntry = &nObject;
+    }
+    std::shuffle(IDs.begin(), IDs.end(), std::mt19937(42));
+    for (auto i=0u; i<nHandles; ++i)
+    {
+        IDsWide[i].Index = IDs[i].C.Index;
+        IDsWide[i].Counter = IDs[i].C.Counter;
+        IDsWide[i].Free = 0u;
+    }
+
+    CTimer Timer;
+    std::uint32_t nValid = 0u;
+    std::uint32_t nValidAoS = 0u;
+
+    Timer.start();
+    for (auto r=0; r<NUMBER_OF_ROUNDS_LAYOUT; ++r)
+    {
+        for (const auto ID : IDs)
+        {
+            if (HandleManager.isValid(ID)) ++nValid;
+        }
+    }
+    Timer.stop();
+    const double fTimeSoA = Timer.getTime();
+
+    Timer.start();
+    for (auto r=0; r<NUMBER_OF_ROUNDS_LAYOUT; ++r)
+    {
+        for (const auto& ID : IDsWide)
+        {
+            if (ID.Index != 0u && ID.Index <= MAX_HANDLES &&
+                ID.Counter == SlotsAoS[ID.Index-1].Counter.load(std::memory_order_acquire)) ++nValidAoS;
+        }
+    }
+    Timer.stop();
+    const double fTimeAoS = Timer.getTime();
+
+    const double fValidations = double(nHandles) * NUMBER_OF_ROUNDS_LAYOUT;
+    INFO_MSG("Handle Evaluation", "Layout (AoS), " << sizeof(HandleIDWide) << " byte id, "
+                                  << sizeof(HandleSlotAoS) << " byte slot: "
+                                  << fTimeAoS / fValidations * 1.0e9 << " ns per validation")
+    INFO_MSG("Handle Evaluation", "Layout (SoA), " << sizeof(HandleID) << " byte id, "
+                                  << sizeof(HandleCounterType) << " byte counter: "
+                                  << fTimeSoA / fValidations * 1.0e9 << " ns per validation")
+
+    return (nValid == nValidAoS && nValid == std::uint32_t(fValidations));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("Handle Evaluation", "Running...")
+
+    const int nThreadsMax = std::max(1u, std::thread::hardware_concurrency());
+
+    for (auto nThreads=1; nThreads<=nThreadsMax; nThreads*=2)
+    {
+        CHandleManager HandleManager;
+        CTimer Timer;
+
+        // Add/remove throughput
+        std::vector<std::thread> Threads;
+        Timer.start();
+        for (auto i=0; i<nThreads; ++i) Threads.emplace_back(addRemove, &HandleManager);
+        for (auto& Thread : Threads) Thread.join();
+        Timer.stop();
+
+        const double fOps = 2.0 * nThreads * NUMBER_OF_HANDLES * NUMBER_OF_ROUNDS;
+        INFO_MSG("Handle Evaluation", "Threads: " << nThreads << ", add/remove: "
+                                      << fOps / Timer.getTime() * 1.0e-6 << " MOps/s")
+
+        // Batched add/remove throughput
+        Threads.clear();
+        Timer.start();
+        for (auto i=0; i<nThreads; ++i) Threads.emplace_back(addRemoveBatch, &HandleManager);
+        for (auto& Thread : Threads) Thread.join();
+        Timer.stop();
+
+        INFO_MSG("Handle Evaluation", "Threads: " << nThreads << ", add/remove (batch): "
+                                      << fOps / Timer.getTime() * 1.0e-6 << " MOps/s")
+
+        // Access throughput
+        std::vector<int>      Objects(NUMBER_OF_HANDLES, 1);
+        std::vector<HandleID> IDs;
+        for (auto& Object : Objects) IDs.push_back(HandleManager.add(&Object));
+
+        std::atomic<long> nSum(0);
+        Threads.clear();
+        Timer.start();
+        for (auto i=0; i<nThreads; ++i) Threads.emplace_back(access, &HandleManager, &IDs, &nSum);
+        for (auto& Thread : Threads) Thread.join();
+        Timer.stop();
+
+        const double fAccesses = double(nThreads) * NUMBER_OF_HANDLES * NUMBER_OF_ROUNDS;
+        INFO_MSG("Handle Evaluation", "Threads: " << nThreads << ", access:     "
+                                      << fAccesses / Timer.getTime() * 1.0e-6 << " MOps/s")
+
+        if (nSum != long(fAccesses))
+        {
+            ERROR_MSG("Handle Evaluation", "Failed. Invalid values.")
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!evaluateLayout())
+    {
+        ERROR_MSG("Handle Evaluation", "Failed. Invalid values.")
+        return EXIT_FAILURE;
+    }
+
+    INFO_MSG("Handle Evaluation", "Passed.")
+    return EXIT_SUCCESS;
+}
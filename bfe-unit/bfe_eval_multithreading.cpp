@@ -46,6 +46,8 @@
 
 //--- Misc-Header ------------------------------------------------------------//
 
+using namespace bfe;
+
 volatile int     g_nTest;
 volatile double  g_fTest;
 std::atomic_int  g_nTestAtomic;
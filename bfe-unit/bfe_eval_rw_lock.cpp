@@ -0,0 +1,240 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_eval_rw_lock.cpp
+/// \brief      Main program for evaluation of locks for read mostly data
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-13
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
+#include "log.h"
+#include "adaptive_lock.h"
+#include "rw_spinlock.h"
+#include "seqlock.h"
+#include "timer.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+//--- Constants --------------------------------------------------------------//
+static constexpr int NUMBER_OF_ENTRIES = 64;        // Entries of registry
+static constexpr int NUMBER_OF_LOOKUPS = 200000;    // Lookups per reader thread
+
+/// Value protected by seqlock, both members are always equal when consistent
+struct SeqValue
+{
+    std::uint64_t nA;   ///< First copy of value
+    std::uint64_t nB;   ///< Second copy of value
+};
+
+std::unordered_map<std::string, int>  g_Registry;   ///< Read mostly registry
+std::vector<std::string>              g_Names;      ///< Names to be looked up
+
+CAdaptiveLock   g_ExclusiveLock;    ///< Exclusive lock for comparison
+CRWSpinlock     g_RWLock;           ///< Reader-writer lock
+CSeqlock<SeqValue> g_SeqValue;      ///< Value protected by seqlock
+
+std::atomic_bool g_bClean;          ///< Consistency of values
+std::atomic_bool g_bExit;           ///< Stops writer
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Looks up registry, protected by exclusive lock
+///
+/// \param _pnSum Sum of values, prevents optimisation
+///
+///////////////////////////////////////////////////////////////////////////////
+void readExclusive(std::atomic<long>* const _pnSum)
+{
+    METHOD_ENTRY("readExclusive")
+
+    long nSum = 0;
+    for (auto i=0; i<NUMBER_OF_LOOKUPS; ++i)
+    {
+        g_ExclusiveLock.acquireLock();
+        nSum += g_Registry.find(g_Names[i % NUMBER_OF_ENTRIES])->second;
+        g_ExclusiveLock.releaseLock();
+    }
+    *_pnSum += nSum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Looks up registry, protected by reader-writer lock
+///
+/// \param _pnSum Sum of values, prevents optimisation
+///
+///////////////////////////////////////////////////////////////////////////////
+void readShared(std::atomic<long>* const _pnSum)
+{
+    METHOD_ENTRY("readShared")
+
+    long nSum = 0;
+    for (auto i=0; i<NUMBER_OF_LOOKUPS; ++i)
+    {
+        g_RWLock.acquireReadLock();
+        nSum += g_Registry.find(g_Names[i % NUMBER_OF_ENTRIES])->second;
+        g_RWLock.releaseReadLock();
+    }
+    *_pnSum += nSum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads value protected by seqlock
+///
+/// \param _pnSum Sum of values, prevents optimisation
+///
+///////////////////////////////////////////////////////////////////////////////
+void readSeq(std::atomic<long>* const _pnSum)
+{
+    METHOD_ENTRY("readSeq")
+
+    long nSum = 0;
+    for (auto i=0; i<NUMBER_OF_LOOKUPS; ++i)
+    {
+        const SeqValue Value = g_SeqValue.read();
+        if (Value.nA != Value.nB) g_bClean = false;
+        nSum += 1;
+    }
+    *_pnSum += nSum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Writes rarely to all protected data, like registration would
+///
+///////////////////////////////////////////////////////////////////////////////
+void write()
+{
+    METHOD_ENTRY("write")
+
+    std::uint64_t nValue = 0u;
+    while (!g_bExit)
+    {
+        g_ExclusiveLock.acquireLock();
+        g_Registry[g_Names[nValue % NUMBER_OF_ENTRIES]] = 1;
+        g_ExclusiveLock.releaseLock();
+
+        g_RWLock.acquireWriteLock();
+        g_Registry[g_Names[nValue % NUMBER_OF_ENTRIES]] = 1;
+        g_RWLock.releaseWriteLock();
+
+        ++nValue;
+        g_SeqValue.write({nValue, nValue});
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Runs given number of readers and measures throughput
+///
+/// \param _Read Reader function
+/// \param _nThreads Number of reader threads
+///
+/// \return Lookups per second
+///
+///////////////////////////////////////////////////////////////////////////////
+double evaluate(void (*_Read)(std::atomic<long>*), const int _nThreads)
+{
+    METHOD_ENTRY("evaluate")
+
+    std::atomic<long> nSum(0);
+    std::vector<std::thread> Threads;
+    CTimer Timer;
+
+    Timer.start();
+    for (auto i=0; i<_nThreads; ++i) Threads.emplace_back(_Read, &nSum);
+    for (auto& Thread : Threads) Thread.join();
+    Timer.stop();
+
+    const double fLookups = double(_nThreads) * NUMBER_OF_LOOKUPS;
+    if (nSum != long(fLookups)) g_bClean = false;
+    return fLookups / Timer.getTime();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("RW Lock Evaluation", "Running...")
+
+    for (auto i=0; i<NUMBER_OF_ENTRIES; ++i)
+    {
+        g_Names.push_back("function_" + std::to_string(i));
+        g_Registry[g_Names.back()] = 1;
+    }
+    g_bClean = true;
+    g_bExit = false;
+
+    std::thread Writer(write);
+
+    const int nThreadsMax = std::max(1u, std::thread::hardware_concurrency());
+    for (auto nThreads=1; nThreads<=nThreadsMax*2; nThreads*=2)
+    {
+        INFO_MSG("RW Lock Evaluation", "Readers: " << nThreads
+                 << ", exclusive: " << evaluate(readExclusive, nThreads) * 1.0e-6 << " MOps/s"
+                 << ", shared: " << evaluate(readShared, nThreads) * 1.0e-6 << " MOps/s"
+                 << ", seqlock: " << evaluate(readSeq, nThreads) * 1.0e-6 << " MOps/s")
+    }
+
+    g_bExit = true;
+    Writer.join();
+
+    INFO_MSG("RW Lock Evaluation", g_ExclusiveLock.getStatistics())
+
+    if (g_bClean)
+    {
+        INFO_MSG("RW Lock Evaluation", "Passed.")
+        return EXIT_SUCCESS;
+    }
+    else
+    {
+        ERROR_MSG("RW Lock Evaluation", "Failed. Invalid values.")
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_eval_timer.cpp
+/// \brief      Main program for evaluation of wake up error of timer sleep modes
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-16
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <algorithm>
+#include <ctime>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
+#include "log.h"
+#include "timer.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+//--- Constants --------------------------------------------------------------//
+static constexpr double DURATION = 1.0;     // Duration of each evaluation in seconds
+static constexpr double WORKLOAD = 0.25;    // Part of frame spent working
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Runs frames with given frequency and logs distribution of wake up error
+///
+/// \param _SleepMode Sleep mode of timer
+/// \param _fFrequency Frequency of frames
+///
+///////////////////////////////////////////////////////////////////////////////
+void evaluate(const SleepModeType _SleepMode, const double _fFrequency)
+{
+    METHOD_ENTRY("evaluate")
+
+    const int nFrames = int(DURATION * _fFrequency);
+    std::vector<double> Errors;
+    Errors.reserve(nFrames);
+
+    CTimer Timer;
+    CTimer WorkTimer;
+    Timer.setSleepMode(_SleepMode);
+    Timer.start();
+
+    const std::clock_t CPUStart = std::clock();
+    for (auto i=0; i<nFrames; ++i)
+    {
+        // Simulated work of frame
+        WorkTimer.start();
+        while (WorkTimer.getSplitTime() < WORKLOAD/_fFrequency) {}
+
+        Timer.sleepRemaining(_fFrequency);
+        if (i > 0) Errors.push_back(Timer.getWakeUpError());
+    }
+    const double fCPU = double(std::clock() - CPUStart) / CLOCKS_PER_SEC;
+
+    std::sort(Errors.begin(), Errors.end());
+    double fSum = 0.0;
+    for (const auto fError : Errors) fSum += fError;
+
+    INFO_MSG("Timer Evaluation", (_SleepMode == SleepModeType::HYBRID ? "Hybrid" : "Condition variable") <<
+             ", " << _fFrequency << "Hz, wake up error [us]: min " << Errors.front()*1.0e6 <<
+             ", mean " << fSum/Errors.size()*1.0e6 <<
+             ", p50 " << Errors[Errors.size()/2]*1.0e6 <<
+             ", p99 " << Errors[std::size_t(Errors.size()*0.99)]*1.0e6 <<
+             ", max " << Errors.back()*1.0e6 <<
+             ", cpu load " << fCPU/DURATION*100.0 << "%")
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("Timer Evaluation", "Running...")
+    INFO_MSG("Timer Evaluation", "Calibrated margin of hybrid sleep: " << CTimer::getSleepMargin()*1.0e6 << "us")
+
+    for (const auto fFrequency : {60.0, 250.0, 1000.0})
+    {
+        evaluate(SleepModeType::CONDITION_VARIABLE, fFrequency);
+        evaluate(SleepModeType::HYBRID, fFrequency);
+    }
+
+    INFO_MSG("Timer Evaluation", "Done.")
+    return EXIT_SUCCESS;
+}
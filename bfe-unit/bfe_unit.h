@@ -0,0 +1,47 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_unit.h
+/// \brief      Checks shared by unit tests
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-02
+///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef BFE_UNIT_H
+#define BFE_UNIT_H
+
+//--- Standard header --------------------------------------------------------//
+#include <cstdlib>
+
+//--- Program header ---------------------------------------------------------//
+#include "log.h"
+
+/// Fails the unit test, returning from main, if given condition isn't met
+#define BFE_UNIT_CHECK(a) if ((a) == false) \
+                          { \
+                              ERROR_MSG("Unit Test", "... interrupted. Test not successful.") \
+                              return EXIT_FAILURE; \
+                          }
+
+#endif // BFE_UNIT_H
@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_unit_adaptive_lock.cpp
+/// \brief      Main program for unit test of adaptive lock
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-12
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
+#include "log.h"
+#include "adaptive_lock.h"
+#include "com_interface.h"
+#include "bfe_unit.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+//--- Constants --------------------------------------------------------------//
+static constexpr int NUMBER_OF_THREADS    = 4;
+static constexpr int NUMBER_OF_INCREMENTS = 100000;  // Increments per thread
+
+CAdaptiveLock   g_Lock("unit_test_lock");
+std::uint64_t   g_nCounter = 0u; // Protected by lock
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Increments the counter, protected by lock
+///
+///////////////////////////////////////////////////////////////////////////////
+void increment()
+{
+    METHOD_ENTRY("increment")
+
+    for (auto i=0; i<NUMBER_OF_INCREMENTS; ++i)
+    {
+        g_Lock.acquireLock();
+        ++g_nCounter;
+        g_Lock.releaseLock();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("Unit test", "Starting unit test...")
+
+    //--- Mutual exclusion ---//
+    {
+        std::vector<std::thread> Threads;
+        for (auto i=0; i<NUMBER_OF_THREADS; ++i) Threads.emplace_back(increment);
+        for (auto& Thread : Threads) Thread.join();
+
+        INFO_MSG("Unit test", g_Lock.getStatistics())
+        BFE_UNIT_CHECK(g_nCounter == std::uint64_t(NUMBER_OF_THREADS*NUMBER_OF_INCREMENTS));
+        BFE_UNIT_CHECK(g_Lock.getAcquisitions() == std::uint64_t(NUMBER_OF_THREADS*NUMBER_OF_INCREMENTS));
+
+        std::uint64_t nWaits = 0u;
+        for (auto i=0; i<ADAPTIVE_LOCK_HISTOGRAM_BUCKETS; ++i) nWaits += g_Lock.getWaits(i);
+        BFE_UNIT_CHECK(nWaits == g_Lock.getContentions());
+    }
+
+    //--- Try lock ---//
+    {
+        g_Lock.resetStatistics();
+        BFE_UNIT_CHECK(g_Lock.tryLock() == true);
+        BFE_UNIT_CHECK(g_Lock.tryLock() == false);
+        g_Lock.releaseLock();
+        BFE_UNIT_CHECK(g_Lock.getAcquisitions() == 1u);
+    }
+
+    //--- Parked thread is woken up on release ---//
+    {
+        g_Lock.resetStatistics();
+        g_Lock.acquireLock();
+
+        std::atomic_bool bAcquired(false);
+        std::thread Waiter([&bAcquired]
+        {
+            g_Lock.acquireLock();
+            bAcquired = true;
+            g_Lock.releaseLock();
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        BFE_UNIT_CHECK(bAcquired == false);
+        g_Lock.releaseLock();
+        Waiter.join();
+
+        INFO_MSG("Unit test", g_Lock.getStatistics())
+        BFE_UNIT_CHECK(bAcquired == true);
+        BFE_UNIT_CHECK(g_Lock.getContentions() == 1u);
+        BFE_UNIT_CHECK(g_Lock.getParks() >= 1u);
+        BFE_UNIT_CHECK(g_Lock.getWaits(0) == 0u);
+    }
+
+    //--- Statistics by name ---//
+    {
+        CAdaptiveLock Anonymous;
+        CAdaptiveLock Named("unit_test_lock_2");
+
+        BFE_UNIT_CHECK(CAdaptiveLock::getStatistics("unit_test_lock") == g_Lock.getStatistics());
+        BFE_UNIT_CHECK(CAdaptiveLock::getStatistics("unknown").empty());
+        BFE_UNIT_CHECK(CAdaptiveLock::getStatistics("") == g_Lock.getStatistics() + "\n" +
+                                                          Named.getStatistics());
+
+        CComInterface ComInterface;
+        BFE_UNIT_CHECK(ComInterface.call<std::string>("lock_stats", std::string("unit_test_lock_2")) ==
+                       Named.getStatistics());
+    }
+    BFE_UNIT_CHECK(CAdaptiveLock::getStatistics("unit_test_lock_2").empty());
+
+    INFO_MSG("Unit test", "... finished. Test successful.")
+    return EXIT_SUCCESS;
+}
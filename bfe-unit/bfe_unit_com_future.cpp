@@ -0,0 +1,242 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_unit_com_future.cpp
+/// \brief      Main program for unit test of asynchronous com calls
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-31
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <thread>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
+#include "log.h"
+#include "com_interface.h"
+#include "bfe_unit.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("Unit test", "Starting unit test...")
+
+    CComInterface ComInterface;
+    CWriterQueue* const pQueue = ComInterface.registerWriterDomain("unit");
+
+    double fValue = 1.0;
+    int nCounter = 0;
+    int nCallbacks = 0;
+    CComFuture<double> FutureInner;
+
+    ComInterface.registerFunction("unit_get",
+                                  CCommand<double>([&]() {return fValue;}),
+                                  "Returns value");
+    ComInterface.registerFunction("unit_scale",
+                                  CCommand<double, double>([&](const double _fFactor)
+                                  {
+                                      fValue *= _fFactor;
+                                      return fValue;
+                                  }),
+                                  "Scales value, queued", {}, "", "unit");
+    ComInterface.registerFunction("unit_count",
+                                  CCommand<void>([&]() {++nCounter;}),
+                                  "Counts, queued", {}, "", "unit");
+    ComInterface.registerFunction("unit_query",
+                                  CCommand<int>([&]()
+                                  {
+                                      FutureInner = ComInterface.callAsync<double, double>("unit_scale", 3.0);
+                                      return 42;
+                                  }),
+                                  "Scales asynchronously");
+    ComInterface.registerCallback("unit_scale",
+                                  std::function<double(double)>([&](const double) {++nCallbacks; return 0.0;}));
+
+    //--- Readers are ready immediately ---//
+    {
+        CComFuture<double> Future = ComInterface.callAsync<double>("unit_get");
+        BFE_UNIT_CHECK(Future.isValid());
+        BFE_UNIT_CHECK(Future.isReady());
+        BFE_UNIT_CHECK(Future.get() == 1.0);
+
+        double fContinued = 0.0;
+        Future.then([&](const double _fValue) {fContinued = _fValue;});
+        BFE_UNIT_CHECK(fContinued == 1.0);
+
+        // Continuations are set once
+        Future.then([&](const double) {fContinued = 0.0;});
+        BFE_UNIT_CHECK(fContinued == 1.0);
+    }
+
+    //--- Writers are fulfilled when flushed ---//
+    {
+        CComFuture<double> Future = ComInterface.callAsync<double, double>("unit_scale", 2.0);
+        BFE_UNIT_CHECK(Future.isValid());
+        BFE_UNIT_CHECK(Future.isReady() == false);
+        BFE_UNIT_CHECK(nCallbacks == 1);
+        BFE_UNIT_CHECK(fValue == 1.0);
+
+        int nContinued = 0;
+        double fContinued = 0.0;
+        Future.then([&](const double _fValue) {++nContinued; fContinued = _fValue;});
+        BFE_UNIT_CHECK(nContinued == 0);
+
+        // Synchronous calls still return immediately
+        BFE_UNIT_CHECK((ComInterface.call<double, double>("unit_scale", 5.0) == 0.0));
+
+        ComInterface.callWriters(pQueue);
+        BFE_UNIT_CHECK(Future.isReady());
+        BFE_UNIT_CHECK(Future.get() == 2.0);
+        BFE_UNIT_CHECK(fValue == 10.0);
+        BFE_UNIT_CHECK(nContinued == 1);
+        BFE_UNIT_CHECK(fContinued == 2.0);
+
+        // Continuations are called once
+        ComInterface.callWriters(pQueue);
+        BFE_UNIT_CHECK(nContinued == 1);
+    }
+
+    //--- Writers without result ---//
+    {
+        CComFuture<void> Future = ComInterface.callAsync<void>("unit_count");
+        BFE_UNIT_CHECK(Future.isReady() == false);
+        bool bContinued = false;
+        Future.then([&]() {bContinued = true;});
+        Future.then([&]() {bContinued = false;});
+        ComInterface.callWriters("unit");
+        BFE_UNIT_CHECK(Future.isReady());
+        BFE_UNIT_CHECK(nCounter == 1);
+        BFE_UNIT_CHECK(bContinued);
+    }
+
+    //--- Unknown functions and different signatures ---//
+    {
+        BFE_UNIT_CHECK(ComInterface.callAsync<void>("unit_unknown").isValid() == false);
+        BFE_UNIT_CHECK((ComInterface.callAsync<int, int>("unit_scale", 2).isValid() == false));
+        ComInterface.callWriters(pQueue);
+        BFE_UNIT_CHECK(fValue == 10.0);
+        BFE_UNIT_CHECK(nCallbacks == 2);
+    }
+
+    //--- Calls failing or never called ---//
+    {
+        ComInterface.registerFunction("unit_throw",
+                                      CCommand<int>([]() -> int
+                                      {
+                                          throw CComInterfaceException(ComIntExceptionType::INVALID_VALUE);
+                                      }),
+                                      "Throws, queued", {}, "", "unit");
+        CComFuture<int> Future = ComInterface.callAsync<int>("unit_throw");
+        bool bContinued = false;
+        Future.then([&](const int) {bContinued = true;});
+        ComInterface.callWriters(pQueue);
+        BFE_UNIT_CHECK(Future.isFailed());
+        BFE_UNIT_CHECK(Future.isReady() == false);
+        Future.wait();
+        BFE_UNIT_CHECK(Future.get() == 0);
+        BFE_UNIT_CHECK(bContinued == false);
+
+        // Continuations set after failing aren't called either
+        Future.then([&](const int) {bContinued = true;});
+        BFE_UNIT_CHECK(bContinued == false);
+
+        // Queued calls are destroyed with their writer queue
+        ComAsyncStatePtr<void> pDropped = std::make_shared<CComAsyncState<void>>();
+        CComFuture<void> FutureDropped(pDropped);
+        {
+            const std::function<void()> Count = [&]() {++nCounter;};
+            CWriterQueue Queue;
+            Queue.enqueue(CCommandToQueueWrapper<void>::create(Queue.getPool(), &Count, nullptr, std::move(pDropped),
+                                                                ComCoalesceType::NONE));
+            BFE_UNIT_CHECK(FutureDropped.isFailed() == false);
+        }
+        FutureDropped.wait();
+        BFE_UNIT_CHECK(FutureDropped.isFailed());
+        BFE_UNIT_CHECK(nCounter == 1);
+    }
+
+    //--- Asynchronous calls made by asynchronous calls ---//
+    {
+        CComFuture<int> Future = ComInterface.callAsync<int>("unit_query");
+        BFE_UNIT_CHECK(Future.isReady());
+        BFE_UNIT_CHECK(Future.get() == 42);
+        BFE_UNIT_CHECK(FutureInner.isValid());
+        BFE_UNIT_CHECK(FutureInner.isReady() == false);
+        ComInterface.callWriters(pQueue);
+        BFE_UNIT_CHECK(FutureInner.get() == 30.0);
+    }
+
+    //--- Pipelined calls across threads ---//
+    {
+        constexpr int nCalls = 10000;
+
+        fValue = 1.0;
+        std::atomic<bool> bDone{false};
+        std::thread Writer([&]()
+        {
+            while (!bDone.load(std::memory_order_acquire)) ComInterface.callWriters(pQueue);
+            ComInterface.callWriters(pQueue);
+        });
+
+        std::atomic<int> nContinued{0};
+        std::vector<CComFuture<double>> Futures;
+        Futures.reserve(nCalls);
+        for (auto i=0; i<nCalls; ++i)
+        {
+            Futures.push_back(ComInterface.callAsync<double, double>("unit_scale", 1.0));
+            Futures.back().then([&](const double) {nContinued.fetch_add(1, std::memory_order_relaxed);});
+        }
+        Futures.back().wait();
+        bDone.store(true, std::memory_order_release);
+        Writer.join();
+
+        int nReady = 0;
+        for (const auto& Future : Futures)
+        {
+            if (Future.isReady() && Future.get() == 1.0) ++nReady;
+        }
+        BFE_UNIT_CHECK(nReady == nCalls);
+        BFE_UNIT_CHECK(nContinued.load() == nCalls);
+    }
+
+    INFO_MSG("Unit test", "... finished. Test successful.")
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,532 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_unit_com_interface.cpp
+/// \brief      Main program for unit test of com interface dispatching
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-17
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
+#include "log.h"
+#include "com_interface.h"
+#include "bfe_unit.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+/// Type unknown to readers and writers
+struct Unsupported
+{
+    int nValue; ///< Some value
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("Unit test", "Starting unit test...")
+
+    CComInterface ComInterface;
+    ComInterface.registerWriterDomain("unit");
+
+    double fSum = 0.0;
+    int nValue = 0;
+
+    // Functions stay registered, following sections still call them
+    int nCallbacks = 0;
+    int nSum = 0;
+
+    // Signatures are arbitrary, none of them needs to be known in advance
+    ComInterface.registerFunction("unit_add",
+                                  CCommand<double, double, double>([](const double _f1, const double _f2)
+                                  {
+                                      return _f1+_f2;
+                                  }),
+                                  "Adds two values");
+    ComInterface.registerFunction("unit_concat",
+                                  CCommand<std::string, std::string, std::string>([](const std::string& _str1,
+                                                                                     const std::string& _str2)
+                                  {
+                                      return _str1+_str2;
+                                  }),
+                                  "Concatenates two strings");
+    ComInterface.registerFunction("unit_flag",
+                                  CCommand<bool, int>([](const int _nN){return _nN > 0;}),
+                                  "Indicates a positive value");
+    ComInterface.registerFunction("unit_point",
+                                  CCommand<Vector2i>([]{return Vector2i(1, -1);}),
+                                  "Returns a point");
+    ComInterface.registerFunction("unit_scale",
+                                  CCommand<Vector2d, int>([](const int _nN){return Vector2d(_nN, 2.0*_nN);}),
+                                  "Returns a scaled vector");
+    ComInterface.registerFunction("unit_sum",
+                                  CCommand<void, int, std::vector<double>>([&](const int _nN,
+                                                                               const std::vector<double> _Values)
+                                  {
+                                      fSum = _nN;
+                                      for (const auto fV : _Values) fSum += fV;
+                                  }),
+                                  "Sums up all values");
+    ComInterface.registerFunction("unit_set",
+                                  CCommand<void, int>([&](const int _nN){nValue = _nN;}),
+                                  "Sets value, queued", {}, "", "unit");
+    ComInterface.registerFunction("unit_unsupported",
+                                  CCommand<void, Unsupported>([&](const Unsupported _U){nValue = _U.nValue;}),
+                                  "Function with unsupported argument");
+
+    //--- Calls from strings ---//
+    {
+        BFE_UNIT_CHECK(ComInterface.call(std::string("unit_add 1.5 2")) == "3.5");
+        BFE_UNIT_CHECK(ComInterface.call(std::string("unit_concat ab cd")) == "abcd");
+        BFE_UNIT_CHECK(ComInterface.call(std::string("unit_flag 3")) == "1");
+        BFE_UNIT_CHECK(ComInterface.call(std::string("unit_flag -3")) == "0");
+        BFE_UNIT_CHECK(ComInterface.call(std::string("unit_point")) == "1 -1");
+        BFE_UNIT_CHECK(ComInterface.call(std::string("unit_scale 2")) == "2 4");
+        BFE_UNIT_CHECK(ComInterface.call(std::string("unit_sum 1 2 3 4")) == "");
+        BFE_UNIT_CHECK(fSum == 10.0);
+
+        // Missing arguments default to zero
+        BFE_UNIT_CHECK(ComInterface.call(std::string("unit_add 1")) == "1");
+
+        // Unsupported types are skipped
+        BFE_UNIT_CHECK(ComInterface.call(std::string("unit_unsupported 5")) == "");
+        BFE_UNIT_CHECK(nValue == 0);
+
+        bool bThrown = false;
+        try
+        {
+            ComInterface.call(std::string("unit_unknown 1"));
+        }
+        catch (const CComInterfaceException&)
+        {
+            bThrown = true;
+        }
+        BFE_UNIT_CHECK(bThrown);
+
+        // Result is written to given string, replacing its content
+        std::string strResult("previous");
+        ComInterface.call(std::string("  unit_concat ab\tcd "), strResult);
+        BFE_UNIT_CHECK(strResult == "abcd");
+        ComInterface.call(std::string("unit_sum 1"), strResult);
+        BFE_UNIT_CHECK(strResult == "");
+    }
+
+    //--- Reading and writing like streams ---//
+    {
+        const std::vector<std::string> Inputs = {
+            "", "  ", "1 2.5 a 1 3 4", "12abc 1.5x y 0", "+3 -.5e2 word 1 1e3 -2",
+            "-3 1e 5 1", "1e+ 2 a 1", "99999999999 1 a 1", "-2147483648 1e400 s 0",
+            "2147483648 -1e400 s 1", "4 inf s 1 2", "0x10 0x10 s 1", "1 . s 1",
+            "1 2 a 2", "1 2 a -", "7 3 a 1 1 2 x 3", "- 1 a 1"
+        };
+        for (const auto& strInput : Inputs)
+        {
+            std::istringstream iss(strInput);
+            CComStreamReader StreamReader(iss);
+            CComStringReader StringReader(strInput.data(), strInput.data() + strInput.size());
+
+            BFE_UNIT_CHECK(StreamReader.readInt() == StringReader.readInt());
+            BFE_UNIT_CHECK(StreamReader.readDouble() == StringReader.readDouble());
+            BFE_UNIT_CHECK(StreamReader.readString() == StringReader.readString());
+            BFE_UNIT_CHECK(StreamReader.readBool() == StringReader.readBool());
+            BFE_UNIT_CHECK(StreamReader.readDoubleArray() == StringReader.readDoubleArray());
+            BFE_UNIT_CHECK(StreamReader.readInt() == StringReader.readInt());
+        }
+
+        std::ostringstream oss("");
+        std::string strValues("");
+        CComStreamWriter StreamWriter(oss);
+        CComStringWriter StringWriter(strValues);
+        for (auto* pWriter : std::vector<IComValueWriter*>{&StreamWriter, &StringWriter})
+        {
+            pWriter->writeBool(true);
+            pWriter->writeInt(std::numeric_limits<int>::min());
+            pWriter->writeDoubleArray({0.1, 1.0/3.0, -0.0, 123456789.0, 1.0e20, 2.5e-7,
+                                       std::numeric_limits<double>::infinity()});
+            pWriter->writeString("word");
+        }
+        BFE_UNIT_CHECK(oss.str() == strValues);
+    }
+
+    //--- Typed calls ---//
+    {
+        BFE_UNIT_CHECK((ComInterface.call<double, double, double>("unit_add", 2.0, 3.0) == 5.0));
+        BFE_UNIT_CHECK(ComInterface.call<std::string>("unit_concat") == "");
+
+        // Different signature isn't called
+        BFE_UNIT_CHECK(ComInterface.call<int>("unit_flag") == 0);
+    }
+
+    //--- Queued writers ---//
+    {
+        BFE_UNIT_CHECK(ComInterface.call(std::string("unit_set 5")) == "");
+        ComInterface.call<void, int>("unit_set", 7);
+        BFE_UNIT_CHECK(nValue == 0);
+        ComInterface.callWriters("unit");
+        BFE_UNIT_CHECK(nValue == 7);
+    }
+
+    //--- Callbacks independent of signature ---//
+    {
+        std::ostringstream ossReader("");
+        std::ostringstream ossWriter("");
+        BFE_UNIT_CHECK(ComInterface.registerGenericCallback("unit_add",
+            [&](const ComArgumentsWriterType& _WriteArgs)
+            {
+                CComStreamWriter Writer(ossReader);
+                _WriteArgs(Writer);
+            }));
+        BFE_UNIT_CHECK(ComInterface.registerGenericCallback("unit_scale",
+            [&](const ComArgumentsWriterType& _WriteArgs)
+            {
+                CComStreamWriter Writer(ossWriter);
+                _WriteArgs(Writer);
+            }, "unit"));
+        BFE_UNIT_CHECK(ComInterface.registerGenericCallback("unit_unknown",
+            [](const ComArgumentsWriterType&){}) == false);
+        BFE_UNIT_CHECK(ComInterface.registerGenericCallback("unit_unsupported",
+            [](const ComArgumentsWriterType&){}) == false);
+
+        BFE_UNIT_CHECK(ComInterface.call(std::string("unit_add 1 2")) == "3");
+        BFE_UNIT_CHECK(ossReader.str() == "1 2");
+
+        BFE_UNIT_CHECK(ComInterface.call(std::string("unit_scale 3")) == "3 6");
+        BFE_UNIT_CHECK(ossWriter.str() == "");
+        ComInterface.callWriters("unit");
+        BFE_UNIT_CHECK(ossWriter.str() == "3");
+    }
+
+    //--- Resolved functions ---//
+    {
+        // Resolving before registration, e.g. depending on order of modules
+        const auto Late = ComInterface.resolve<int, int>("unit_late");
+        BFE_UNIT_CHECK(Late.isValid() == false);
+        BFE_UNIT_CHECK(Late.call(3) == 0);
+
+        ComInterface.registerFunction("unit_late",
+                                      CCommand<int, int>([](const int _nN){return 2*_nN;}),
+                                      "Registered after resolving");
+        BFE_UNIT_CHECK(Late.isValid());
+        BFE_UNIT_CHECK(Late.call(3) == 6);
+
+        // Callbacks registered later are called, too
+        std::function<int(int)> Callback = [&](const int _nN){nCallbacks += _nN; return 0;};
+        ComInterface.registerCallback("unit_late", Callback);
+        BFE_UNIT_CHECK(Late.call(4) == 8);
+        BFE_UNIT_CHECK(nCallbacks == 4);
+        BFE_UNIT_CHECK((ComInterface.call<int, int>("unit_late", 5) == 10));
+        BFE_UNIT_CHECK(nCallbacks == 9);
+
+        // Wrong signature and unresolved reference aren't called
+        const auto Wrong = ComInterface.resolve<double, int>("unit_late");
+        BFE_UNIT_CHECK(Wrong.isValid() == false);
+        BFE_UNIT_CHECK(Wrong.call(3) == 0.0);
+        BFE_UNIT_CHECK(CCommandRef<int>().isValid() == false);
+
+        // Registering again replaces the function for resolved references
+        ComInterface.registerFunction("unit_late",
+                                      CCommand<int, int>([](const int _nN){return 3*_nN;}),
+                                      "Registered again");
+        BFE_UNIT_CHECK(Late.call(3) == 9);
+        BFE_UNIT_CHECK((ComInterface.call<int, int>("unit_late", 2) == 6));
+    }
+
+    //--- Pooled writer commands ---//
+    {
+        // Slots are reused, pool only grows if all slots are taken
+        CCommandPool Pool;
+        void* pSlot = Pool.allocate();
+        BFE_UNIT_CHECK(Pool.getNumberOfSlots() == COMMAND_POOL_CHUNK_SLOTS);
+        Pool.release(pSlot);
+        std::vector<void*> Slots;
+        for (auto i=0u; i<COMMAND_POOL_CHUNK_SLOTS; ++i) Slots.push_back(Pool.allocate());
+        BFE_UNIT_CHECK(Pool.getNumberOfSlots() == COMMAND_POOL_CHUNK_SLOTS);
+        Slots.push_back(Pool.allocate());
+        BFE_UNIT_CHECK(Pool.getNumberOfSlots() == 2*COMMAND_POOL_CHUNK_SLOTS);
+        for (auto pSlotTaken : Slots) Pool.release(pSlotTaken);
+
+        // Arguments are stored until writers are called, large ones on heap
+        std::string strSmall;
+        std::string strLarge;
+        ComInterface.registerFunction("unit_append",
+                                      CCommand<void, std::string, int>([&](const std::string& _strS, const int _nN)
+                                      {
+                                          strSmall += _strS + std::to_string(_nN);
+                                      }),
+                                      "Appends string and number", {}, "", "unit");
+        ComInterface.registerFunction("unit_append_large",
+                                      CCommand<void, std::string, std::string, std::string, std::string, std::string>(
+                                      [&](const std::string& _strA, const std::string& _strB, const std::string& _strC,
+                                          const std::string& _strD, const std::string& _strE)
+                                      {
+                                          strLarge += _strA + _strB + _strC + _strD + _strE;
+                                      }),
+                                      "Appends strings", {}, "", "unit");
+        for (auto i=0; i<3*int(COMMAND_POOL_CHUNK_SLOTS); ++i)
+        {
+            ComInterface.call<void, std::string, int>("unit_append", "a", i % 10);
+        }
+        ComInterface.call<void, std::string, std::string, std::string, std::string, std::string>(
+            "unit_append_large", "a", "b", "c", "d", "e");
+        BFE_UNIT_CHECK(strSmall.empty());
+        ComInterface.callWriters("unit");
+        BFE_UNIT_CHECK(strSmall.size() == 6*COMMAND_POOL_CHUNK_SLOTS);
+        BFE_UNIT_CHECK(strSmall.substr(0, 6) == "a0a1a2");
+        BFE_UNIT_CHECK(strLarge == "abcde");
+
+        // Commands left in queue are destroyed with com interface
+        ComInterface.call<void, std::string, int>("unit_append", "a", 1);
+    }
+
+    //--- Writer queues by handle and from several threads ---//
+    {
+        CWriterQueue* const pWriterQueue = ComInterface.registerWriterDomain("unit_mt");
+        BFE_UNIT_CHECK(pWriterQueue != nullptr);
+        BFE_UNIT_CHECK(ComInterface.getWriterQueue("unit_mt") == pWriterQueue);
+        BFE_UNIT_CHECK(ComInterface.getWriterQueue("unit_unknown") == nullptr);
+
+        ComInterface.registerFunction("unit_count",
+                                      CCommand<void, int>([&](const int _nN){nSum += _nN;}),
+                                      "Adds to sum", {}, "", "unit_mt");
+
+        // Each thread enqueues with its own producer token
+        constexpr int NUMBER_OF_THREADS = 4;
+        constexpr int NUMBER_OF_CALLS = 1000;
+        std::vector<std::thread> Threads;
+        for (auto i=0; i<NUMBER_OF_THREADS; ++i)
+        {
+            Threads.emplace_back([&]
+            {
+                for (auto j=0; j<NUMBER_OF_CALLS; ++j) ComInterface.call<void, int>("unit_count", 1);
+            });
+        }
+        for (auto& Thread : Threads) Thread.join();
+        BFE_UNIT_CHECK(nSum == 0);
+
+        ComInterface.callWriters(pWriterQueue);
+        BFE_UNIT_CHECK(nSum == NUMBER_OF_THREADS*NUMBER_OF_CALLS);
+        BFE_UNIT_CHECK(pWriterQueue->flush() == 0u);
+
+        // Calling thread reuses its token
+        ComInterface.call<void, int>("unit_count", 2);
+        ComInterface.call<void, int>("unit_count", 3);
+        BFE_UNIT_CHECK(pWriterQueue->flush() == 2u);
+        BFE_UNIT_CHECK(nSum == NUMBER_OF_THREADS*NUMBER_OF_CALLS+5);
+
+        // Cycling through more queues than tokens cached keeps the order
+        constexpr int NUMBER_OF_QUEUES = int(WRITER_QUEUE_TOKENS_CACHED)+2;
+        constexpr int NUMBER_OF_ROUNDS = 100;
+        std::vector<std::vector<int>> Orders(NUMBER_OF_QUEUES);
+        for (auto i=0; i<NUMBER_OF_QUEUES; ++i)
+        {
+            const std::string strName("unit_cycle_" + std::to_string(i));
+            ComInterface.registerWriterDomain(strName);
+            ComInterface.registerFunction(strName,
+                                          CCommand<void, int>([&Orders, i](const int _nN){Orders[i].push_back(_nN);}),
+                                          "Records order", {}, "", strName);
+        }
+        for (auto j=0; j<NUMBER_OF_ROUNDS; ++j)
+        {
+            for (auto i=0; i<NUMBER_OF_QUEUES; ++i)
+                ComInterface.call<void, int>("unit_cycle_" + std::to_string(i), j);
+        }
+        bool bOrdered = true;
+        for (auto i=0; i<NUMBER_OF_QUEUES; ++i)
+        {
+            ComInterface.callWriters("unit_cycle_" + std::to_string(i));
+            if (int(Orders[i].size()) != NUMBER_OF_ROUNDS) bOrdered = false;
+            for (auto j=0u; j<Orders[i].size(); ++j) if (Orders[i][j] != int(j)) bOrdered = false;
+        }
+        BFE_UNIT_CHECK(bOrdered);
+    }
+
+    //--- Merged writer commands ---//
+    {
+        CWriterQueue* const pWriterQueue = ComInterface.registerWriterDomain("unit_merge");
+
+        Vector2d vecCursor(0.0, 0.0);
+        double Positions[3] = {0.0, 0.0, 0.0};
+        Vector2d Moves[2] = {Vector2d(0.0, 0.0), Vector2d(0.0, 0.0)};
+        double fZoom = 0.0;
+        int nCalls = 0;
+        std::string strOrder;
+
+        ComInterface.registerFunction("unit_cursor",
+                                      CCommand<void, Vector2d>([&](const Vector2d& _vecCursor)
+                                      {
+                                          vecCursor = _vecCursor;
+                                          strOrder += "c";
+                                          ++nCalls;
+                                      }),
+                                      "Sets cursor, queued", {}, "", "unit_merge", ComCoalesceType::LAST);
+        ComInterface.registerFunction("unit_mark",
+                                      CCommand<void>([&]() {strOrder += "m"; ++nCalls;}),
+                                      "Marks order, queued", {}, "", "unit_merge");
+        ComInterface.registerFunction("unit_place",
+                                      CCommand<void, int, double>([&](const int _nTarget, const double _fPosition)
+                                      {
+                                          Positions[_nTarget] = _fPosition;
+                                          ++nCalls;
+                                      }),
+                                      "Places target, queued", {}, "", "unit_merge", ComCoalesceType::LAST_PER_TARGET);
+        ComInterface.registerFunction("unit_move",
+                                      CCommand<void, int, double, double>([&](const int _nTarget,
+                                                                              const double _fX, const double _fY)
+                                      {
+                                          Moves[_nTarget] += Vector2d(_fX, _fY);
+                                          ++nCalls;
+                                      }),
+                                      "Moves target, queued", {}, "", "unit_merge", ComCoalesceType::ACCUMULATE_PER_TARGET);
+        ComInterface.registerFunction("unit_zoom",
+                                      CCommand<void, double>([&](const double _fDelta) {fZoom += _fDelta; ++nCalls;}),
+                                      "Zooms, queued", {}, "", "unit_merge", ComCoalesceType::ACCUMULATE);
+        // Arguments that can't be summed up are never merged
+        ComInterface.registerFunction("unit_merge_unsupported",
+                                      CCommand<void, Unsupported>([&](const Unsupported) {++nCalls;}),
+                                      "Function with unsupported argument, queued", {}, "", "unit_merge",
+                                      ComCoalesceType::ACCUMULATE);
+
+        for (auto i=0; i<100; ++i)
+        {
+            ComInterface.call<void, Vector2d>("unit_cursor", Vector2d(i, -i));
+            if (i == 50) ComInterface.call<void>("unit_mark");
+            if (i < 30) ComInterface.call<void, int, double>("unit_place", i % 3, i);
+            if (i < 20) ComInterface.call<void, int, double, double>("unit_move", i % 2, 1.0, 0.5);
+            if (i < 10) ComInterface.call<void, double>("unit_zoom", 0.125);
+            if (i < 2) ComInterface.call<void, Unsupported>("unit_merge_unsupported", Unsupported{i});
+        }
+        BFE_UNIT_CHECK(pWriterQueue->flush() == 10u);
+        BFE_UNIT_CHECK(nCalls == 10);
+        BFE_UNIT_CHECK(pWriterQueue->getNumberOfCoalesced() == 153u);
+
+        // Merged calls are called at the position of the last call
+        BFE_UNIT_CHECK(strOrder == "mc");
+        BFE_UNIT_CHECK(vecCursor == Vector2d(99.0, -99.0));
+        BFE_UNIT_CHECK(Positions[0] == 27.0 && Positions[1] == 28.0 && Positions[2] == 29.0);
+        BFE_UNIT_CHECK(Moves[0] == Vector2d(10.0, 5.0) && Moves[1] == Vector2d(10.0, 5.0));
+        BFE_UNIT_CHECK(fZoom == 1.25);
+
+        // Earlier asynchronous calls are kept, their future must be fulfilled
+        CComFuture<void> Future = ComInterface.callAsync<void, Vector2d>("unit_cursor", Vector2d(1.0, 1.0));
+        ComInterface.call<void, Vector2d>("unit_cursor", Vector2d(2.0, 2.0));
+        ComInterface.call<void, Vector2d>("unit_cursor", Vector2d(3.0, 3.0));
+        BFE_UNIT_CHECK(pWriterQueue->flush() == 2u);
+        BFE_UNIT_CHECK(Future.isReady());
+        BFE_UNIT_CHECK(vecCursor == Vector2d(3.0, 3.0));
+        BFE_UNIT_CHECK(pWriterQueue->getNumberOfCoalesced() == 154u);
+
+        // Targets don't need to be summed up, other arguments must be numbers
+        ComInterface.registerFunction("unit_push",
+                                      CCommand<void, double*, double>([&](double* const _pfTarget, const double _fDelta)
+                                      {
+                                          *_pfTarget += _fDelta;
+                                          ++nCalls;
+                                      }),
+                                      "Pushes target, queued", {}, "", "unit_merge", ComCoalesceType::ACCUMULATE_PER_TARGET);
+        ComInterface.registerFunction("unit_append",
+                                      CCommand<void, std::string>([&](const std::string& _strText)
+                                      {
+                                          strOrder += _strText;
+                                          ++nCalls;
+                                      }),
+                                      "Appends text, queued", {}, "", "unit_merge", ComCoalesceType::ACCUMULATE);
+        nCalls = 0;
+        strOrder.clear();
+        for (auto i=0; i<10; ++i)
+        {
+            ComInterface.call<void, double*, double>("unit_push", &Positions[i % 2], 1.0);
+            if (i < 3) ComInterface.call<void, std::string>("unit_append", "a");
+        }
+        BFE_UNIT_CHECK(pWriterQueue->flush() == 5u);
+        BFE_UNIT_CHECK(nCalls == 5);
+        BFE_UNIT_CHECK(pWriterQueue->getNumberOfCoalesced() == 162u);
+        BFE_UNIT_CHECK(Positions[0] == 32.0 && Positions[1] == 33.0);
+        BFE_UNIT_CHECK(strOrder == "aaa");
+    }
+
+    //--- Call profile ---//
+    {
+        // Nothing is recorded while disabled
+        ComInterface.call<int, int>("unit_late", 1);
+        BFE_UNIT_CHECK(ComInterface.getProfile("unit_late") == "No profile of <unit_late> found.");
+
+        ComInterface.setProfiling(true);
+        const auto Late = ComInterface.resolve<int, int>("unit_late");
+        for (auto i=0; i<10; ++i) Late.call(i);
+        ComInterface.call<int, int>("unit_late", 1);
+        ComInterface.call<void, int>("unit_count", 1);
+        ComInterface.call<void, int>("unit_count", 1);
+        ComInterface.setProfiling(false);
+        ComInterface.call<int, int>("unit_late", 1);
+
+        // Queued calls are recorded if enqueued while enabled
+        ComInterface.callWriters("unit_mt");
+
+        const std::string strLate = ComInterface.getProfile("unit_late");
+        BFE_UNIT_CHECK(strLate.find("unit_late: calls 11, callbacks 11,") == 0u);
+        const std::string strCount = ComInterface.getProfile("unit_count");
+        BFE_UNIT_CHECK(strCount.find("unit_count: calls 2, callbacks 0,") == 0u);
+        BFE_UNIT_CHECK(strCount.find(", queued 2,") != std::string::npos);
+        const std::string strQueue = ComInterface.getProfile("unit_mt");
+        BFE_UNIT_CHECK(strQueue.find("queue unit_mt: flushes ") == 0u);
+        BFE_UNIT_CHECK(strQueue.find(", depth max 4000") != std::string::npos);
+
+        // Profile is also provided by command and file
+        BFE_UNIT_CHECK(ComInterface.call(std::string("com_profile unit_late")) == strLate);
+        BFE_UNIT_CHECK(ComInterface.call(std::string("com_profile_dump bfe_unit_com_profile.txt")) == "1");
+        std::ifstream InFile("bfe_unit_com_profile.txt");
+        std::string strLine;
+        bool bFound = false;
+        while (std::getline(InFile, strLine)) if (strLine == strLate) bFound = true;
+        BFE_UNIT_CHECK(bFound);
+        std::remove("bfe_unit_com_profile.txt");
+
+        ComInterface.resetProfile();
+        BFE_UNIT_CHECK(ComInterface.getProfile("unit_late") == "No profile of <unit_late> found.");
+    }
+
+    INFO_MSG("Unit test", "... finished. Test successful.")
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,343 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_unit_com_journal.cpp
+/// \brief      Main program for unit test of com journal recording and replay
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-24
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
+#include "log.h"
+#include "com_interface.h"
+#include "com_journal_player.h"
+#include "headless_runner.h"
+#include "bfe_unit.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+/// Type unknown to readers and writers
+struct Unsupported
+{
+    int nValue; ///< Some value
+};
+
+/// State changed by calls, compared after replay
+struct UnitState
+{
+    double      fTotal = 0.0;               ///< Sum of all additions
+    int         nValue = 0;                 ///< Value set by writer
+    int         nMoves = 0;                 ///< Number of moves
+    std::string strName;                    ///< Name set by script
+    Vector2d    vecPosition{0.0, 0.0};      ///< Position set by writer
+
+    bool operator==(const UnitState& _State) const
+    {
+        return fTotal == _State.fTotal && nValue == _State.nValue && nMoves == _State.nMoves &&
+               strName == _State.strName && vecPosition == _State.vecPosition;
+    }
+};
+
+/// Module flushing the writer queue of the unit test each frame
+class CFlushModule : public IThreadModule
+{
+    public:
+        explicit CFlushModule(CComInterface* const _pComInterface) : m_pComInterface(_pComInterface) {}
+        bool processFrame() override
+        {
+            m_pComInterface->callWriters("unit");
+            return true;
+        }
+    private:
+        CComInterface* m_pComInterface;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Registers the functions of the unit test
+///
+/// \param _ComInterface Com interface to register at
+/// \param _State State changed by functions
+///
+///////////////////////////////////////////////////////////////////////////////
+void registerFunctions(CComInterface& _ComInterface, UnitState& _State)
+{
+    METHOD_ENTRY("registerFunctions")
+
+    _ComInterface.registerWriterDomain("unit");
+
+    _ComInterface.registerFunction("unit_add",
+                                   CCommand<double, double, double>([&](const double _f1, const double _f2)
+                                   {
+                                       _State.fTotal += _f1+_f2;
+                                       return _State.fTotal;
+                                   }),
+                                   "Adds two values to total");
+    _ComInterface.registerFunction("unit_name",
+                                   CCommand<void, std::string>([&](const std::string& _strName)
+                                   {
+                                       _State.strName = _strName;
+                                   }),
+                                   "Sets name");
+    _ComInterface.registerFunction("unit_move",
+                                   CCommand<void, Vector2d>([&](const Vector2d& _vecPosition)
+                                   {
+                                       _State.vecPosition = _vecPosition;
+                                       ++_State.nMoves;
+                                   }),
+                                   "Moves, queued", {}, "", "unit");
+
+    // Calls made by functions are repeated when replaying the function
+    _ComInterface.registerFunction("unit_set",
+                                   CCommand<void, int>([&](const int _nN)
+                                   {
+                                       _State.nValue = _nN;
+                                       _ComInterface.call<void, Vector2d>("unit_move", Vector2d(_nN, -_nN));
+                                   }),
+                                   "Sets value and moves, queued", {}, "", "unit");
+    _ComInterface.registerFunction("unit_nested",
+                                   CCommand<void, int>([&](const int _nN)
+                                   {
+                                       _ComInterface.call<void, int>("unit_set", _nN);
+                                   }),
+                                   "Sets value by writer");
+    _ComInterface.registerFunction("unit_unsupported",
+                                   CCommand<void, Unsupported>([&](const Unsupported _U){_State.nValue = _U.nValue;}),
+                                   "Function with unsupported argument, queued", {}, "", "unit");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("Unit test", "Starting unit test...")
+
+    const std::string strJournal("bfe_unit_com_journal.bfj");
+
+    //--- Binary values ---//
+    {
+        std::string strValues;
+        CComBinaryWriter Writer(strValues);
+        Writer.writeBool(true);
+        Writer.writeDouble(0.1);
+        Writer.writeDoubleArray({1.0, -2.5, 1.0e300});
+        Writer.writeInt(-7);
+        Writer.writeString("two words");
+        Writer.writeInt(3);
+
+        CComBinaryReader Reader(strValues.data(), strValues.data() + strValues.size());
+        BFE_UNIT_CHECK(Reader.readBool() == true);
+        BFE_UNIT_CHECK(Reader.readDouble() == 0.1);
+        BFE_UNIT_CHECK((Reader.readDoubleArray() == std::vector<double>{1.0, -2.5, 1.0e300}));
+        BFE_UNIT_CHECK(Reader.readInt() == -7);
+        BFE_UNIT_CHECK(Reader.readString() == "two words");
+
+        // Different type fails, following values are missing
+        BFE_UNIT_CHECK(Reader.readDouble() == 0.0);
+        BFE_UNIT_CHECK(Reader.readInt() == 0);
+
+        // Truncated values are missing
+        CComBinaryReader Truncated(strValues.data(), strValues.data() + 4);
+        BFE_UNIT_CHECK(Truncated.readBool() == true);
+        BFE_UNIT_CHECK(Truncated.readDouble() == 0.0);
+    }
+
+    //--- Recording ---//
+    UnitState StateRecorded;
+    {
+        CComInterface ComInterface;
+        registerFunctions(ComInterface, StateRecorded);
+        CComJournal* const pJournal = ComInterface.getJournal();
+
+        // Nothing is recorded unless started
+        ComInterface.call(std::string("unit_add 1 1"));
+        BFE_UNIT_CHECK(pJournal->isRecording() == false);
+        BFE_UNIT_CHECK(ComInterface.call(std::string("com_journal_start " + strJournal)) == "1");
+        BFE_UNIT_CHECK(pJournal->isRecording());
+        BFE_UNIT_CHECK(pJournal->getNumberOfRecords() == 0u);
+
+        // Frame 2: command, writer called directly, typed reader not recorded
+        pJournal->setFrame(2u);
+        BFE_UNIT_CHECK(ComInterface.call(std::string("unit_add 1.5 2")) == "5.5");
+        ComInterface.call<void, int>("unit_set", 5);
+        ComInterface.call<double, double, double>("unit_add", 0.25, 0.25);
+        BFE_UNIT_CHECK(pJournal->getNumberOfRecords() == 2u);
+
+        // Writer calls made while flushing aren't recorded
+        ComInterface.callWriters("unit");
+        ComInterface.callWriters("unit");
+        BFE_UNIT_CHECK(StateRecorded.nMoves == 1);
+        BFE_UNIT_CHECK(pJournal->getNumberOfRecords() == 2u);
+
+        // Frame 5: calls made by a command aren't recorded, script and unsupported writer
+        pJournal->setFrame(5u);
+        ComInterface.call(std::string("unit_nested 7"));
+        BFE_UNIT_CHECK(pJournal->getNumberOfRecords() == 3u);
+        const std::string strScript("  journaled");
+        CComStringReader Reader(strScript.data(), strScript.data() + strScript.size());
+        std::string strReturn;
+        CComStringWriter Writer(strReturn);
+        BFE_UNIT_CHECK(ComInterface.invoke("unit_name", Reader, Writer));
+        BFE_UNIT_CHECK(ComInterface.invoke("unit_unknown", Reader, Writer) == false);
+        ComInterface.call<void, Unsupported>("unit_unsupported", Unsupported{3});
+        BFE_UNIT_CHECK(pJournal->getNumberOfRecords() == 4u);
+
+        // Names not fitting into 16 bits of length aren't recorded
+        pJournal->record(ComJournalOriginType::COMMAND, std::string(70000u, 'x'), "");
+        BFE_UNIT_CHECK(pJournal->getNumberOfRecords() == 4u);
+        ComInterface.callWriters("unit");
+        ComInterface.callWriters("unit");
+
+        pJournal->stop();
+        ComInterface.call(std::string("unit_add 1 1"));
+        BFE_UNIT_CHECK(pJournal->getNumberOfRecords() == 4u);
+
+        // Calls of state before recording are undone for comparison
+        StateRecorded.fTotal -= 2.0 + 0.5 + 2.0;
+        StateRecorded.nValue = 7;
+        BFE_UNIT_CHECK(StateRecorded.nMoves == 2);
+        BFE_UNIT_CHECK(StateRecorded.strName == "journaled");
+    }
+
+    //--- Replay, frame by frame within headless runner ---//
+    {
+        CComInterface ComInterface;
+        UnitState State;
+        registerFunctions(ComInterface, State);
+
+        CComJournalPlayer Player(&ComInterface);
+        BFE_UNIT_CHECK(Player.load(strJournal));
+        BFE_UNIT_CHECK(Player.getNumberOfRecords() == 4u);
+        BFE_UNIT_CHECK(Player.getFrame() == 2u);
+
+        CFlushModule Flush(&ComInterface);
+        CHeadlessRunner Runner;
+        BFE_UNIT_CHECK(Runner.addModule(&Player));
+        BFE_UNIT_CHECK(Runner.addModule(&Flush));
+
+        // Journal frames 2 and 3, calls of frame 2 only
+        BFE_UNIT_CHECK(Runner.run(2));
+        BFE_UNIT_CHECK(Player.getNumberOfReplayed() == 2u);
+        BFE_UNIT_CHECK(State.nValue == 5);
+        BFE_UNIT_CHECK(State.strName.empty());
+
+        // Runner stops with the last frame of the journal, i.e. frame 5
+        BFE_UNIT_CHECK(Runner.run(10) == false);
+        BFE_UNIT_CHECK(Runner.getTicks(&Player) == 4u);
+        BFE_UNIT_CHECK(Player.isDone());
+        BFE_UNIT_CHECK(Player.getNumberOfReplayed() == 4u);
+
+        // Writers enqueued by writers are called one frame later
+        Runner.run(1);
+        BFE_UNIT_CHECK(State == StateRecorded);
+    }
+
+    //--- Replay at once, excluding writer calls ---//
+    {
+        CComInterface ComInterface;
+        UnitState State;
+        registerFunctions(ComInterface, State);
+
+        CComJournalPlayer Player(&ComInterface);
+        Player.setOrigin(ComJournalOriginType::WRITER, false);
+        BFE_UNIT_CHECK(Player.load(strJournal));
+        BFE_UNIT_CHECK(Player.replay() == 3u);
+        BFE_UNIT_CHECK(Player.isDone());
+        BFE_UNIT_CHECK(Player.replay() == 0u);
+        ComInterface.callWriters("unit");
+        ComInterface.callWriters("unit");
+        BFE_UNIT_CHECK(State.fTotal == 3.5);
+        BFE_UNIT_CHECK(State.nValue == 7);
+        BFE_UNIT_CHECK(State.nMoves == 1);
+        BFE_UNIT_CHECK(State.strName == "journaled");
+    }
+
+    //--- Invalid journals ---//
+    {
+        CComInterface ComInterface;
+        CComJournalPlayer Player(&ComInterface);
+        BFE_UNIT_CHECK(Player.load("bfe_unit_com_journal_missing.bfj") == false);
+        BFE_UNIT_CHECK(Player.isDone());
+
+        // Truncated journal keeps calls read before
+        std::ifstream File(strJournal, std::ios::binary);
+        const std::string strContent((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+        File.close();
+        std::ofstream FileTruncated(strJournal, std::ios::binary | std::ios::trunc);
+        FileTruncated.write(strContent.data(), std::streamsize(strContent.size() - 1u));
+        FileTruncated.close();
+        BFE_UNIT_CHECK(Player.load(strJournal) == false);
+        BFE_UNIT_CHECK(Player.getNumberOfRecords() == 3u);
+
+        std::ofstream FileInvalid(strJournal, std::ios::binary | std::ios::trunc);
+        FileInvalid << "BFEX";
+        FileInvalid.close();
+        BFE_UNIT_CHECK(Player.load(strJournal) == false);
+        BFE_UNIT_CHECK(Player.getNumberOfRecords() == 0u);
+
+        // Length of arguments exceeding the file isn't allocated
+        const std::uint16_t nName = 0u;
+        const std::uint16_t nNameLength = 1u;
+        const std::uint64_t nFrame = 0u;
+        const std::uint32_t nLength = 0xFFFFFFF0u;
+        std::ofstream FileLength(strJournal, std::ios::binary | std::ios::trunc);
+        FileLength.write(COM_JOURNAL_MAGIC, sizeof(COM_JOURNAL_MAGIC));
+        FileLength.put(char(COM_JOURNAL_VERSION)).put(char(1));
+        FileLength.write(reinterpret_cast<const char*>(&nName), sizeof(nName));
+        FileLength.write(reinterpret_cast<const char*>(&nNameLength), sizeof(nNameLength));
+        FileLength.put('a').put(char(2));
+        FileLength.write(reinterpret_cast<const char*>(&nFrame), sizeof(nFrame));
+        FileLength.write(reinterpret_cast<const char*>(&nName), sizeof(nName));
+        FileLength.put(char(ComJournalOriginType::COMMAND));
+        FileLength.write(reinterpret_cast<const char*>(&nLength), sizeof(nLength));
+        FileLength << "abc";
+        FileLength.close();
+        BFE_UNIT_CHECK(Player.load(strJournal) == false);
+        BFE_UNIT_CHECK(Player.getNumberOfRecords() == 0u);
+    }
+    std::remove(strJournal.c_str());
+
+    INFO_MSG("Unit test", "... finished. Test successful.")
+
+    return EXIT_SUCCESS;
+}
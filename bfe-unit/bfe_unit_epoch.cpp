@@ -0,0 +1,245 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_unit_epoch.cpp
+/// \brief      Main program for unit test of deferred reclamation
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-09
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <thread>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
+#include "log.h"
+#include "epoch_manager.h"
+#include "handle.h"
+#include "bfe_unit.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+//--- Constants --------------------------------------------------------------//
+static constexpr int NUMBER_OF_READERS = 3;
+static constexpr int NUMBER_OF_OBJECTS = 256;
+static constexpr int NUMBER_OF_ROUNDS  = 200;
+static constexpr int OBJECT_ALIVE      = 1;
+static constexpr int OBJECT_DISPOSED   = -1;
+
+CHandleManager              g_HandleManager;
+CEpochManager               g_EpochManager;
+std::atomic<HandleRawType>  g_SharedIDs[NUMBER_OF_OBJECTS];
+std::atomic_int             g_nErrors;
+std::atomic_bool            g_bExit;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Accesses objects by handle, announcing a quiescent state per frame
+///
+/// Pointers are kept for the whole frame, as e.g. the render thread does.
+/// Their objects must not be disposed in the meantime.
+///
+///////////////////////////////////////////////////////////////////////////////
+void read()
+{
+    METHOD_ENTRY("read")
+
+    const int nParticipant = g_EpochManager.registerParticipant();
+
+    std::vector<int*> Objects;
+    while (!g_bExit)
+    {
+        Objects.clear();
+        for (auto i=0; i<NUMBER_OF_OBJECTS; ++i)
+        {
+            HandleID ID;
+            ID.Raw = g_SharedIDs[i].load();
+            if (g_HandleManager.isValid(ID))
+            {
+                int* const pObject = g_HandleManager.get<int>(ID);
+                if (pObject != nullptr) Objects.push_back(pObject);
+            }
+        }
+        std::this_thread::yield();
+        for (const auto pObject : Objects)
+        {
+            if (*pObject != OBJECT_ALIVE) ++g_nErrors;
+        }
+        g_EpochManager.announce(nParticipant);
+    }
+    g_EpochManager.unregisterParticipant(nParticipant);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("Unit test", "Starting unit test...")
+
+    //--- Single threaded: grace period ---//
+    {
+        CEpochManager EpochManager;
+        int nReleased = 0;
+
+        // No participants, release immediately
+        EpochManager.retire([&nReleased]{++nReleased;});
+        BFE_UNIT_CHECK(nReleased == 1);
+
+        const int nP1 = EpochManager.registerParticipant();
+        const int nP2 = EpochManager.registerParticipant();
+        BFE_UNIT_CHECK(nP1 != EPOCH_PARTICIPANT_NONE && nP2 != EPOCH_PARTICIPANT_NONE);
+        BFE_UNIT_CHECK(EpochManager.getNumberOfParticipants() == 2u);
+
+        const std::uint64_t nEpoch = EpochManager.getEpoch();
+        EpochManager.retire([&nReleased]{++nReleased;});
+        BFE_UNIT_CHECK(EpochManager.getNumberOfRetired() == 1u);
+
+        // One participant is not sufficient to advance the epoch
+        EpochManager.announce(nP1);
+        EpochManager.announce(nP1);
+        BFE_UNIT_CHECK(EpochManager.getEpoch() == nEpoch+1);
+        BFE_UNIT_CHECK(nReleased == 1);
+        EpochManager.announce(nP1);
+        BFE_UNIT_CHECK(EpochManager.getEpoch() == nEpoch+1);
+        BFE_UNIT_CHECK(nReleased == 1);
+
+        // Second participant passed, still one epoch to go
+        EpochManager.announce(nP2);
+        BFE_UNIT_CHECK(EpochManager.getEpoch() == nEpoch+2);
+        BFE_UNIT_CHECK(nReleased == 2);
+        BFE_UNIT_CHECK(EpochManager.getNumberOfRetired() == 0u);
+
+        // Unregistered participant doesn't hold back epochs
+        EpochManager.retire([&nReleased]{++nReleased;});
+        EpochManager.unregisterParticipant(nP2);
+        EpochManager.announce(nP1);
+        EpochManager.announce(nP1);
+        BFE_UNIT_CHECK(nReleased == 3);
+
+        // Pending entries are released if last participant leaves
+        EpochManager.retire([&nReleased]{++nReleased;});
+        BFE_UNIT_CHECK(nReleased == 3);
+        EpochManager.unregisterParticipant(nP1);
+        BFE_UNIT_CHECK(nReleased == 4);
+        BFE_UNIT_CHECK(EpochManager.getNumberOfParticipants() == 0u);
+    }
+
+    //--- Single threaded: retired handles ---//
+    {
+        CEpochManager& EpochManager = CHandleBase::getEpochManager();
+        const int nParticipant = EpochManager.registerParticipant();
+
+        int* pObject = new int(OBJECT_ALIVE);
+        CHandle<int> hObject(pObject);
+        const auto nFree = CHandleBase::getFreeHandles().size();
+        int nDisposed = 0;
+
+        BFE_UNIT_CHECK(hObject.retire([&nDisposed](int* _p){++nDisposed; delete _p;}) == true);
+        BFE_UNIT_CHECK(hObject.isValid() == false);
+        BFE_UNIT_CHECK(hObject.retire() == false);
+        BFE_UNIT_CHECK(hObject.retire([&nDisposed](int* _p){++nDisposed; delete _p;}) == false);
+        BFE_UNIT_CHECK(CHandleBase::getFreeHandles().size() == nFree);
+        BFE_UNIT_CHECK(nDisposed == 0);
+
+        // Default handles don't represent an object to be retired
+        CHandle<int> hDefault;
+        BFE_UNIT_CHECK(hDefault.retire([&nDisposed](int* _p){++nDisposed; delete _p;}) == false);
+
+        EpochManager.announce(nParticipant);
+        EpochManager.announce(nParticipant);
+        BFE_UNIT_CHECK(nDisposed == 1);
+        BFE_UNIT_CHECK(CHandleBase::getFreeHandles().size() == nFree+1);
+
+        EpochManager.unregisterParticipant(nParticipant);
+    }
+
+    //--- Multi threaded: readers keep pointers for one frame ---//
+    {
+        g_nErrors = 0;
+        g_bExit = false;
+
+        // Disposed objects are marked and kept until the end, so a premature
+        // disposal is detected by readers instead of accessing freed memory.
+        std::vector<int*> Objects;
+        std::vector<HandleID> IDs;
+        for (auto i=0; i<NUMBER_OF_OBJECTS; ++i)
+        {
+            Objects.push_back(new int(OBJECT_ALIVE));
+            IDs.push_back(g_HandleManager.add(Objects.back()));
+            g_SharedIDs[i].store(IDs.back().Raw);
+        }
+
+        std::vector<std::thread> Readers;
+        for (auto i=0; i<NUMBER_OF_READERS; ++i) Readers.emplace_back(read);
+
+        std::atomic_int nDisposed(0);
+        for (auto r=0; r<NUMBER_OF_ROUNDS; ++r)
+        {
+            for (auto i=0; i<NUMBER_OF_OBJECTS; ++i)
+            {
+                // Same as CHandle::retire, using a local handle manager
+                int* const pObject = g_HandleManager.get<int>(IDs[i]);
+                const HandleID ID = IDs[i];
+                BFE_UNIT_CHECK(g_HandleManager.invalidate(ID) == true);
+                g_EpochManager.retire([ID, pObject, &nDisposed]
+                {
+                    *pObject = OBJECT_DISPOSED;
+                    ++nDisposed;
+                    g_HandleManager.release(ID);
+                });
+
+                Objects.push_back(new int(OBJECT_ALIVE));
+                IDs[i] = g_HandleManager.add(Objects.back());
+                g_SharedIDs[i].store(IDs[i].Raw);
+            }
+            std::this_thread::yield();
+        }
+        g_bExit = true;
+        for (auto& Reader : Readers) Reader.join();
+        g_EpochManager.collect();
+
+        INFO_MSG("Unit test", "Errors: " << g_nErrors << ", disposed: " << nDisposed)
+        BFE_UNIT_CHECK(g_nErrors == 0);
+        BFE_UNIT_CHECK(g_EpochManager.getNumberOfRetired() == 0u);
+        BFE_UNIT_CHECK(nDisposed == NUMBER_OF_ROUNDS*NUMBER_OF_OBJECTS);
+
+        for (auto pObject : Objects) delete pObject;
+    }
+
+    INFO_MSG("Unit test", "... finished. Test successful.")
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_unit_frame_graph.cpp
+/// \brief      Main program for unit test of frame graph
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-15
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <functional>
+
+//--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
+#include "log.h"
+#include "frame_graph.h"
+#include "bfe_unit.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+//--- Constants --------------------------------------------------------------//
+static constexpr int NUMBER_OF_FRAMES = 200;
+
+/// Module calling a function each frame
+class CTestModule : public IThreadModule
+{
+    public:
+        explicit CTestModule(const std::function<bool()>& _Frame) : m_Frame(_Frame) {}
+        bool processFrame() override {return m_Frame();}
+    private:
+        std::function<bool()> m_Frame;
+};
+
+// Resources, only protected by dependencies of the frame graph
+int g_nEvents   = 0;
+int g_nCommands = 0;
+int g_nState    = 0;
+int g_nSnapshot = 0;
+
+std::atomic_bool g_bClean(true);
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("Unit test", "Starting unit test...")
+
+    CJobSystem JobSystem(4);
+
+    //--- Pipeline input -> lua -> simulation -> snapshot -> render ---//
+    {
+        int nFrameRender = 0;
+
+        CTestModule Input([]{++g_nEvents; return true;});
+        CTestModule Lua([]{g_nCommands = g_nEvents; return true;});
+        CTestModule Simulation([]
+        {
+            if (g_nCommands != g_nState+1) g_bClean = false;
+            g_nState = g_nCommands;
+            return true;
+        });
+        CTestModule Snapshot([]{g_nSnapshot = g_nState; return true;});
+        CTestModule Render([&nFrameRender]
+        {
+            // Rendered snapshot must be of same frame, i.e. not overwritten
+            // by the next frame's snapshot
+            if (g_nSnapshot != ++nFrameRender) g_bClean = false;
+            return true;
+        });
+
+        CFrameGraph FrameGraph(&JobSystem);
+
+        // Added in arbitrary order, sorted by dependencies
+        BFE_UNIT_CHECK(FrameGraph.addModule("render", &Render, {}, {"snapshot"}));
+        BFE_UNIT_CHECK(FrameGraph.addModule("snapshot", &Snapshot, {"snapshot"}, {"state"}));
+        BFE_UNIT_CHECK(FrameGraph.addModule("simulation", &Simulation, {"state"}, {"commands", "state"}));
+        BFE_UNIT_CHECK(FrameGraph.addModule("lua", &Lua, {"commands"}, {"events"}));
+        BFE_UNIT_CHECK(FrameGraph.addModule("input", &Input, {"events"}, {}));
+        BFE_UNIT_CHECK(FrameGraph.addModule("input", &Input, {"events"}, {}) == false);
+        BFE_UNIT_CHECK(FrameGraph.addModule("none", nullptr, {}, {}) == false);
+
+        BFE_UNIT_CHECK(FrameGraph.compile());
+        const auto& Order = FrameGraph.getOrder();
+        BFE_UNIT_CHECK(Order.size() == 5u);
+        BFE_UNIT_CHECK(FrameGraph.getNodes()[Order[0]].strName == "input");
+        BFE_UNIT_CHECK(FrameGraph.getNodes()[Order[1]].strName == "lua");
+        BFE_UNIT_CHECK(FrameGraph.getNodes()[Order[2]].strName == "simulation");
+        BFE_UNIT_CHECK(FrameGraph.getNodes()[Order[3]].strName == "snapshot");
+        BFE_UNIT_CHECK(FrameGraph.getNodes()[Order[4]].strName == "render");
+
+        for (auto nFramesInFlight=1; nFramesInFlight<=3; ++nFramesInFlight)
+        {
+            FrameGraph.setFramesInFlight(nFramesInFlight);
+            for (auto i=0; i<NUMBER_OF_FRAMES; ++i)
+            {
+                BFE_UNIT_CHECK(FrameGraph.processFrame());
+            }
+        }
+        FrameGraph.waitForFrames();
+
+        INFO_MSG("Unit test", "Latency of last frame: " << FrameGraph.getLatency()*1.0e6 << "us")
+        BFE_UNIT_CHECK(g_bClean == true);
+        BFE_UNIT_CHECK(FrameGraph.getFrame() == 3u*NUMBER_OF_FRAMES);
+        BFE_UNIT_CHECK(nFrameRender == 3*NUMBER_OF_FRAMES);
+        BFE_UNIT_CHECK(g_nSnapshot == 3*NUMBER_OF_FRAMES);
+        BFE_UNIT_CHECK(FrameGraph.getLatency() > 0.0);
+    }
+
+    //--- Cyclic dependencies ---//
+    {
+        CTestModule A([]{return true;});
+        CTestModule B([]{return true;});
+
+        CFrameGraph FrameGraph(&JobSystem);
+        BFE_UNIT_CHECK(FrameGraph.addModule("a", &A, {"a"}, {"b"}));
+        BFE_UNIT_CHECK(FrameGraph.addModule("b", &B, {"b"}, {"a"}));
+        BFE_UNIT_CHECK(FrameGraph.compile() == false);
+        BFE_UNIT_CHECK(FrameGraph.processFrame() == false);
+    }
+
+    //--- Module stopping ---//
+    {
+        int nFrames = 0;
+        CTestModule Module([&nFrames]{return ++nFrames != 10;});
+
+        CFrameGraph FrameGraph(&JobSystem);
+        BFE_UNIT_CHECK(FrameGraph.addModule("module", &Module, {}, {}));
+        while (FrameGraph.processFrame()) {}
+        FrameGraph.waitForFrames();
+
+        BFE_UNIT_CHECK(nFrames >= 10);
+        BFE_UNIT_CHECK(nFrames <= 10 + FRAME_GRAPH_FRAMES_IN_FLIGHT_DEFAULT);
+
+        // Stopping is reported once, processing resumes
+        BFE_UNIT_CHECK(FrameGraph.processFrame());
+    }
+
+    INFO_MSG("Unit test", "... finished. Test successful.")
+    return EXIT_SUCCESS;
+}
@@ -41,12 +41,14 @@
 #include <string>
 
 //--- Program header ---------------------------------------------------------//
-#include "conf_pw.h"
+#include "conf_bfengine.h"
 #include "log.h"
 #include "handle.h"
 
 //--- Misc-Header ------------------------------------------------------------//
 
+using namespace bfe;
+
 //--- Constants --------------------------------------------------------------//
 static constexpr int SHOW_HEADER = 1;
 static constexpr int SHOW_FOOTER = 2;
@@ -107,7 +109,7 @@ void outputInternalHandleData(const std::string& _strAction)
         }
         std::cout << std::endl;
         
-        for (auto Handle : *CHandleBase::getHandleMap())
+        for (auto Handle : CHandleBase::getHandleMap())
         {
             indent(INDENTION_L2);
             if (Handle.ID.C.Index != 0u)
@@ -131,13 +133,13 @@ void outputInternalHandleData(const std::string& _strAction)
         std::cout << std::endl;
         
         indent(INDENTION_L1);
-        std::cout << "Currently free handle indices: " << CHandleBase::getFreeHandles()->size() << std::endl;
+        std::cout << "Currently free handle indices: " << CHandleBase::getFreeHandles().size() << std::endl;
         indent(INDENTION_L1);
         std::cout << "================================\n" << std::endl;
         indent(INDENTION_L2);
-        if (CHandleBase::getFreeHandles()->size() > 0)
+        if (CHandleBase::getFreeHandles().size() > 0)
         {
-            for (auto FreeHandle : *CHandleBase::getFreeHandles())
+            for (auto FreeHandle : CHandleBase::getFreeHandles())
                 std::cout << FreeHandle << " ";
             std::cout << std::endl;
         }
@@ -289,6 +291,10 @@ int main()
     PW_UNIT_CHECK(hTwo.isValid() == true);
     PW_UNIT_CHECK(hThree.isValid() == true);
     PW_UNIT_CHECK(hFour.isValid() == true);
+    // Stale handles of a reused slot must not access the new object
+    PW_UNIT_CHECK(hOne.ptr() == nullptr);
+    PW_UNIT_CHECK(hCopy.ptr() == nullptr);
+    PW_UNIT_CHECK(hFour.ptr() == pf1);
     
     CHandle<std::string> hCopyStr;
     hCopyStr = hThree;
@@ -322,6 +328,8 @@ int main()
     PW_UNIT_CHECK(hThree.isValid() == true);
     PW_UNIT_CHECK(hCopyStr.isValid() == false);
     PW_UNIT_CHECK(hFour.isValid() == true);
+    PW_UNIT_CHECK(hThree.ptr() == pstrUpdate);
+    PW_UNIT_CHECK(hCopyStr.ptr() == nullptr);
     
                 
     INFO_MSG("Unit test", "...done. Test successful.")
@@ -0,0 +1,203 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_unit_handle_mt.cpp
+/// \brief      Main program for multi-threaded unit (stress) test of handles
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-02
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
+#include "log.h"
+#include "handle_manager.h"
+#include "bfe_unit.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+//--- Constants --------------------------------------------------------------//
+static constexpr int NUMBER_OF_WRITERS = 4;
+static constexpr int NUMBER_OF_READERS = 4;
+static constexpr int NUMBER_OF_OBJECTS = 512;   // Objects per writer
+static constexpr int NUMBER_OF_ROUNDS  = 200;
+
+CHandleManager                  g_HandleManager;
+int                             g_Objects[NUMBER_OF_WRITERS][NUMBER_OF_OBJECTS]; // Outlive all readers
+std::atomic<HandleRawType>      g_SharedIDs[NUMBER_OF_WRITERS*NUMBER_OF_OBJECTS];
+std::atomic<int>                g_SlotOwners[MAX_HANDLES];
+std::atomic_int                 g_nErrors;
+std::atomic_bool                g_bExit;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Adds and removes handles for the writers own objects
+///
+/// Each slot that is handed out is claimed by the writer, hence, two valid
+/// handles referring to the same slot would be detected. Writers with odd
+/// numbers use the batch interface.
+///
+/// \param _nWriter Number of writer thread
+///
+///////////////////////////////////////////////////////////////////////////////
+void write(const int _nWriter)
+{
+    METHOD_ENTRY("write")
+
+    int* const              Objects = g_Objects[_nWriter];
+    std::vector<void*>      Entries(NUMBER_OF_OBJECTS);
+    std::vector<HandleID>   IDs(NUMBER_OF_OBJECTS);
+    const bool              bBatch = (_nWriter % 2 == 1);
+
+    for (auto i=0; i<NUMBER_OF_OBJECTS; ++i) Entries[i] = &Objects[i];
+
+    for (auto r=0; r<NUMBER_OF_ROUNDS; ++r)
+    {
+        if (bBatch)
+        {
+            if (g_HandleManager.addBatch(Entries.data(), NUMBER_OF_OBJECTS, IDs.data()) != NUMBER_OF_OBJECTS)
+            {
+                ++g_nErrors;
+            }
+        }
+        for (auto i=0; i<NUMBER_OF_OBJECTS; ++i)
+        {
+            if (!bBatch) IDs[i] = g_HandleManager.add(&Objects[i]);
+            int nOwner = 0;
+            if (!g_SlotOwners[IDs[i].C.Index-1].compare_exchange_strong(nOwner, _nWriter+1) ||
+                !g_HandleManager.isValid(IDs[i]) ||
+                g_HandleManager.get<int>(IDs[i]) != &Objects[i])
+            {
+                ++g_nErrors;
+            }
+            g_SharedIDs[_nWriter*NUMBER_OF_OBJECTS+i].store(IDs[i].Raw, std::memory_order_relaxed);
+        }
+        for (auto i=0; i<NUMBER_OF_OBJECTS; ++i)
+        {
+            g_SlotOwners[IDs[i].C.Index-1].store(0);
+            if (!bBatch && !g_HandleManager.remove(IDs[i])) ++g_nErrors;
+        }
+        if (bBatch)
+        {
+            if (g_HandleManager.removeBatch(IDs.data(), NUMBER_OF_OBJECTS) != NUMBER_OF_OBJECTS)
+            {
+                ++g_nErrors;
+            }
+        }
+        for (auto i=0; i<NUMBER_OF_OBJECTS; ++i)
+        {
+            if (g_HandleManager.isValid(IDs[i])) ++g_nErrors;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Accesses handles concurrently to the writers
+///
+/// A handle that is valid before and after access must not return a foreign
+/// or null pointer.
+///
+///////////////////////////////////////////////////////////////////////////////
+void read()
+{
+    METHOD_ENTRY("read")
+
+    while (!g_bExit)
+    {
+        for (auto i=0; i<NUMBER_OF_WRITERS*NUMBER_OF_OBJECTS; ++i)
+        {
+            HandleID ID;
+            ID.Raw = g_SharedIDs[i].load(std::memory_order_relaxed);
+            if (g_HandleManager.isValid(ID))
+            {
+                int* pObject = g_HandleManager.get<int>(ID);
+                if (g_HandleManager.isValid(ID))
+                {
+                    if (pObject == nullptr || *pObject != i / NUMBER_OF_OBJECTS) ++g_nErrors;
+                }
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("Unit test", "Starting multi-threaded unit test...")
+
+    g_nErrors = 0;
+    g_bExit = false;
+    for (auto& ID : g_SharedIDs) ID.store(0u);
+    for (auto& Owner : g_SlotOwners) Owner.store(0);
+    for (auto i=0; i<NUMBER_OF_WRITERS; ++i)
+        for (auto j=0; j<NUMBER_OF_OBJECTS; ++j) g_Objects[i][j] = i;
+
+    std::vector<std::thread> Writers;
+    std::vector<std::thread> Readers;
+    for (auto i=0; i<NUMBER_OF_READERS; ++i) Readers.emplace_back(read);
+    for (auto i=0; i<NUMBER_OF_WRITERS; ++i) Writers.emplace_back(write, i);
+
+    for (auto& Writer : Writers) Writer.join();
+    g_bExit = true;
+    for (auto& Reader : Readers) Reader.join();
+
+    INFO_MSG("Unit test", "Errors: " << g_nErrors)
+    BFE_UNIT_CHECK(g_nErrors == 0);
+
+    // All handles are removed, hence, every slot must be in the free list
+    // exactly once. Slots are only allocated if there are not enough free
+    // ones. Since slots that are being removed in a batch are not free, yet,
+    // at most twice the number of concurrently used handles are allocated.
+    auto FreeHandles = g_HandleManager.getFreeHandles();
+    std::set<std::uint32_t> FreeHandlesUnique(FreeHandles.begin(), FreeHandles.end());
+    INFO_MSG("Unit test", "Slots used: " << g_HandleManager.getSize() << ", free: " << FreeHandles.size())
+    BFE_UNIT_CHECK(g_HandleManager.getSize() <= 2*NUMBER_OF_WRITERS*NUMBER_OF_OBJECTS);
+    BFE_UNIT_CHECK(FreeHandles.size() == g_HandleManager.getSize());
+    BFE_UNIT_CHECK(FreeHandlesUnique.size() == FreeHandles.size());
+    for (const auto& Entry : g_HandleManager.getHandleMap())
+    {
+        BFE_UNIT_CHECK(Entry.ID.C.Index == 0u && Entry.pEntry == nullptr);
+    }
+
+    INFO_MSG("Unit test", "... finished. Test successful.")
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_unit_headless_runner.cpp
+/// \brief      Main program for unit test of headless runner
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-16
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <cmath>
+#include <functional>
+#include <string>
+
+//--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
+#include "log.h"
+#include "headless_runner.h"
+#include "bfe_unit.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+/// Module with given frequency calling a function each frame
+class CTestModule : public IThreadModule
+{
+    public:
+        CTestModule(const double _fFrequency, const std::function<bool()>& _Frame) : m_Frame(_Frame)
+        {
+            m_fFrequency = _fFrequency;
+        }
+        bool processFrame() override {return m_Frame();}
+    private:
+        std::function<bool()> m_Frame;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("Unit test", "Starting unit test...")
+
+    //--- Modules of different frequencies, fixed order ---//
+    {
+        std::string strTrace;
+        CTestModule Physics(100.0, [&strTrace]{strTrace += "p"; return true;});
+        CTestModule Lua(25.0, [&strTrace]{strTrace += "l"; return true;});
+        CTestModule Input(50.0, [&strTrace]{strTrace += "i"; return true;});
+
+        CHeadlessRunner Runner;
+        BFE_UNIT_CHECK(IThreadModule::forEachModule("", [](IThreadModule&){}) == 0);
+        BFE_UNIT_CHECK(Runner.addModule(&Input));
+        BFE_UNIT_CHECK(Runner.addModule(&Lua));
+        BFE_UNIT_CHECK(Runner.addModule(&Physics));
+        BFE_UNIT_CHECK(Runner.addModule(&Physics) == false);
+        BFE_UNIT_CHECK(Runner.addModule(nullptr) == false);
+        BFE_UNIT_CHECK(IThreadModule::forEachModule("", [](IThreadModule&){}) == 3);
+        BFE_UNIT_CHECK(std::abs(Runner.getTimeStep() - 0.01) < 1.0e-12);
+
+        // Four frames of 10ms, modules due at the same time processed in order of registration
+        BFE_UNIT_CHECK(Runner.run(4));
+        BFE_UNIT_CHECK(strTrace == "ilp" "p" "ip" "p");
+
+        // An hour of simulated time, as fast as possible
+        BFE_UNIT_CHECK(Runner.runFor(3600.0 - 0.04));
+        BFE_UNIT_CHECK(Runner.getFrames() == 360000u);
+        BFE_UNIT_CHECK(Runner.getTicks(&Physics) == 360000u);
+        BFE_UNIT_CHECK(Runner.getTicks(&Input) == 180000u);
+        BFE_UNIT_CHECK(Runner.getTicks(&Lua) == 90000u);
+        BFE_UNIT_CHECK(std::abs(Runner.getSimulatedTime() - 3600.0) < 1.0e-6);
+        BFE_UNIT_CHECK(Runner.getFramesPerSecond() > 0.0);
+        BFE_UNIT_CHECK(Runner.getTimeAcceleration() > 1.0);
+        BFE_UNIT_CHECK(Physics.getStatistics().nFrames == 360000u);
+
+        // Larger time step, modules process several frames per step
+        Runner.setTimeStep(0.1);
+        BFE_UNIT_CHECK(Runner.run(10));
+        BFE_UNIT_CHECK(Runner.getTicks(&Physics) == 360100u);
+        BFE_UNIT_CHECK(Runner.getTicks(&Lua) == 90025u);
+    }
+
+    //--- Module stopping ---//
+    {
+        int nFrames = 0;
+        CTestModule Module(60.0, [&nFrames]{return ++nFrames < 10;});
+
+        CHeadlessRunner Runner;
+        BFE_UNIT_CHECK(Runner.addModule(&Module));
+        BFE_UNIT_CHECK(Runner.run(100) == false);
+        BFE_UNIT_CHECK(nFrames == 10);
+        BFE_UNIT_CHECK(Runner.getFrames() == 10u);
+    }
+
+    INFO_MSG("Unit test", "... finished. Test successful.")
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,257 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_unit_job_system.cpp
+/// \brief      Main program for unit test of job system
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-14
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
+#include "log.h"
+#include "handle.h"
+#include "job_system.h"
+#include "bfe_unit.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+//--- Constants --------------------------------------------------------------//
+static constexpr int NUMBER_OF_ELEMENTS = 100000;
+static constexpr int NUMBER_OF_JOBS     = 10000;    // More than fit into one deque
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("Unit test", "Starting unit test...")
+
+    CJobSystem JobSystem(4);
+    BFE_UNIT_CHECK(JobSystem.getNumberOfWorkers() == 4);
+
+    //--- Single job ---//
+    {
+        std::atomic<int> nValue(0);
+        JobPtrType pJob = JobSystem.createJob([&nValue]{nValue = 42;});
+        BFE_UNIT_CHECK(pJob->isFinished() == false);
+        JobSystem.submit(pJob);
+        JobSystem.wait(pJob);
+        BFE_UNIT_CHECK(pJob->isFinished() == true);
+        BFE_UNIT_CHECK(nValue == 42);
+    }
+
+    //--- Parallel for ---//
+    {
+        std::vector<int> Values(NUMBER_OF_ELEMENTS, 0);
+        JobSystem.parallelFor(0, NUMBER_OF_ELEMENTS, 1000, [&Values](const int _nBegin, const int _nEnd)
+        {
+            for (auto i=_nBegin; i<_nEnd; ++i) Values[i] += i;
+        });
+        bool bCorrect = true;
+        for (auto i=0; i<NUMBER_OF_ELEMENTS; ++i) if (Values[i] != i) bCorrect = false;
+        BFE_UNIT_CHECK(bCorrect);
+
+        // Empty range and grain larger than range
+        int nCalls = 0;
+        JobSystem.parallelFor(5, 5, 10, [&nCalls](const int, const int){++nCalls;});
+        BFE_UNIT_CHECK(nCalls == 0);
+        JobSystem.parallelFor(0, 5, 10, [&nCalls](const int _nBegin, const int _nEnd)
+        {
+            nCalls += _nEnd-_nBegin;
+        });
+        BFE_UNIT_CHECK(nCalls == 5);
+    }
+
+    //--- Children, submitted from inside of parent, more than deque size ---//
+    {
+        std::atomic<int> nChildren(0);
+        JobPtrType pParent = JobSystem.createJob([]{});
+        JobPtrType pSpawner = JobSystem.createChildJob(pParent, [&]
+        {
+            for (auto i=0; i<NUMBER_OF_JOBS; ++i)
+            {
+                JobSystem.submit(JobSystem.createChildJob(pParent, [&nChildren]{++nChildren;}));
+            }
+        });
+        JobSystem.submit(pSpawner);
+        JobSystem.submit(pParent);
+        JobSystem.wait(pParent);
+        BFE_UNIT_CHECK(nChildren == NUMBER_OF_JOBS);
+    }
+
+    //--- Dependencies ---//
+    {
+        std::vector<int> Order;
+        std::atomic<int> nStep(0);
+        JobPtrType pA = JobSystem.createJob([&]{Order.push_back(0); ++nStep;});
+        JobPtrType pB = JobSystem.createJob([&]{Order.push_back(1); ++nStep;});
+        JobPtrType pC = JobSystem.createJob([&]{Order.push_back(2); ++nStep;});
+        JobSystem.addDependency(pC, pB);
+        JobSystem.addDependency(pB, pA);
+
+        // Submit in reverse order, execution must follow dependencies
+        JobSystem.submit(pC);
+        JobSystem.submit(pB);
+        BFE_UNIT_CHECK(nStep == 0);
+        JobSystem.submit(pA);
+        JobSystem.wait(pC);
+        BFE_UNIT_CHECK(Order.size() == 3u);
+        BFE_UNIT_CHECK(Order[0] == 0 && Order[1] == 1 && Order[2] == 2);
+
+        // Dependency on finished job is ignored
+        JobPtrType pD = JobSystem.createJob([&]{++nStep;});
+        JobSystem.addDependency(pD, pA);
+        JobSystem.submit(pD);
+        JobSystem.wait(pD);
+        BFE_UNIT_CHECK(nStep == 4);
+    }
+
+    //--- Nested parallel for, waiting inside of jobs ---//
+    {
+        std::atomic<int> nSum(0);
+        JobSystem.parallelFor(0, 16, 1, [&](const int, const int)
+        {
+            JobSystem.parallelFor(0, 100, 10, [&nSum](const int _nBegin, const int _nEnd)
+            {
+                nSum += _nEnd-_nBegin;
+            });
+        });
+        BFE_UNIT_CHECK(nSum == 1600);
+    }
+
+    //--- Submitted from several external threads ---//
+    {
+        std::atomic<int> nSum(0);
+        std::vector<std::thread> Threads;
+        for (auto t=0; t<4; ++t)
+        {
+            Threads.emplace_back([&]
+            {
+                std::vector<JobPtrType> Jobs;
+                for (auto i=0; i<1000; ++i)
+                {
+                    Jobs.push_back(JobSystem.createJob([&nSum]{++nSum;}));
+                    JobSystem.submit(Jobs.back());
+                }
+                for (const auto& pJob : Jobs) JobSystem.wait(pJob);
+            });
+        }
+        for (auto& Thread : Threads) Thread.join();
+        BFE_UNIT_CHECK(nSum == 4000);
+    }
+
+    //--- Recurring functions ---//
+    {
+        std::atomic<int> nFrames(0);
+        std::atomic<bool> bConcurrent(false);
+        std::atomic<bool> bRunning(false);
+        JobSystem.addRecurring([&]() -> bool
+        {
+            if (bRunning.exchange(true)) bConcurrent = true;
+            ++nFrames;
+            bRunning = false;
+            return nFrames < 5;
+        }, 200.0);
+
+        std::atomic<int> nFramesRemoved(0);
+        const int nID = JobSystem.addRecurring([&]() -> bool {++nFramesRemoved; return true;}, 1000.0);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        JobSystem.removeRecurring(nID);
+        const int nFramesRemovedLast = nFramesRemoved;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        INFO_MSG("Unit test", "Recurring frames: " << nFrames << ", " << nFramesRemoved)
+        BFE_UNIT_CHECK(nFrames == 5);
+        BFE_UNIT_CHECK(bConcurrent == false);
+        BFE_UNIT_CHECK(nFramesRemoved > 0);
+        BFE_UNIT_CHECK(nFramesRemoved == nFramesRemovedLast);
+    }
+
+    //--- Recurring function removing itself ---//
+    {
+        std::atomic<int> nFrames(0);
+        std::atomic<int> nID(-1);
+        std::atomic<bool> bReturned(false);
+        nID = JobSystem.addRecurring([&]() -> bool
+        {
+            while (nID < 0) std::this_thread::yield();
+            if (++nFrames == 3)
+            {
+                JobSystem.removeRecurring(nID);
+                bReturned = true;
+            }
+            return true;
+        }, 1000.0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        BFE_UNIT_CHECK(bReturned == true);
+        BFE_UNIT_CHECK(nFrames == 3);
+    }
+
+    //--- Retired handles are released under sustained load ---//
+    {
+        using namespace std::chrono;
+        const auto End = steady_clock::now() + milliseconds(500);
+
+        // Chains of jobs keeping all workers busy
+        std::atomic<int> nChains(4*JobSystem.getNumberOfWorkers());
+        std::function<void()> Chain = [&]
+        {
+            const auto Busy = steady_clock::now() + microseconds(10);
+            while (steady_clock::now() < Busy) {}
+            if (steady_clock::now() < End)
+                JobSystem.submit(JobSystem.createJob(Chain));
+            else
+                --nChains;
+        };
+        for (auto i=nChains.load(); i>0; --i) JobSystem.submit(JobSystem.createJob(Chain));
+
+        std::atomic<bool> bReleased(false);
+        CHandleBase::getEpochManager().retire([&bReleased]{bReleased = true;});
+        while (!bReleased && steady_clock::now() < End) std::this_thread::yield();
+        BFE_UNIT_CHECK(bReleased == true);
+        while (nChains > 0) std::this_thread::yield();
+    }
+
+    INFO_MSG("Unit test", "... finished. Test successful.")
+    return EXIT_SUCCESS;
+}
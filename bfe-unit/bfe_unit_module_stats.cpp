@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_unit_module_stats.cpp
+/// \brief      Main program for unit test of module frame time statistics
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-16
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <cmath>
+#include <string>
+
+//--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
+#include "log.h"
+#include "com_interface.h"
+#include "thread_module.h"
+#include "bfe_unit.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+/// Module with a name of its own, processing nothing
+class CTestModule : public IThreadModule
+{
+    public:
+        explicit CTestModule(const std::string& _strName) {m_strModuleName = _strName;}
+        bool processFrame() override {return true;}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Compares floating point values
+///
+/// \return Equal?
+///
+////////////////////////////////////////////////////////////////////////////////
+static bool isEqual(const double _fA, const double _fB)
+{
+    return std::abs(_fA-_fB) < 1.0e-9;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("Unit test", "Starting unit test...")
+
+    CTestModule Physics("Physics Module");
+    Physics.setFrequency(10.0);
+    Physics.registerModule();
+
+    //--- Empty window ---//
+    {
+        const ThreadModuleStatistics Statistics = Physics.getStatistics();
+        BFE_UNIT_CHECK(Statistics.nFrames == 0u);
+        BFE_UNIT_CHECK(Statistics.nWindow == 0u);
+        BFE_UNIT_CHECK(Statistics.fMax == 0.0);
+    }
+
+    //--- Frame times 1ms...100ms, budget of 100ms ---//
+    {
+        for (auto i=100; i>=1; --i) Physics.recordFrame(i*1.0e-3, 0.1-i*1.0e-3);
+
+        const ThreadModuleStatistics Statistics = Physics.getStatistics();
+        BFE_UNIT_CHECK(Statistics.nFrames == 100u);
+        BFE_UNIT_CHECK(Statistics.nWindow == 100u);
+        BFE_UNIT_CHECK(Statistics.nOverruns == 0u);
+        BFE_UNIT_CHECK(isEqual(Statistics.fMin, 1.0e-3));
+        BFE_UNIT_CHECK(isEqual(Statistics.fMax, 100.0e-3));
+        BFE_UNIT_CHECK(isEqual(Statistics.fMean, 50.5e-3));
+        BFE_UNIT_CHECK(isEqual(Statistics.fP50, 50.0e-3));
+        BFE_UNIT_CHECK(isEqual(Statistics.fP95, 95.0e-3));
+        BFE_UNIT_CHECK(isEqual(Statistics.fP99, 99.0e-3));
+        BFE_UNIT_CHECK(isEqual(Statistics.fSleepMean, 49.5e-3));
+    }
+
+    //--- Overruns and sliding window ---//
+    {
+        for (auto i=0u; i<THREAD_MODULE_STATISTICS_SIZE; ++i) Physics.recordFrame(0.2, 0.0);
+
+        const ThreadModuleStatistics Statistics = Physics.getStatistics();
+        BFE_UNIT_CHECK(Statistics.nFrames == 100u+THREAD_MODULE_STATISTICS_SIZE);
+        BFE_UNIT_CHECK(Statistics.nWindow == THREAD_MODULE_STATISTICS_SIZE);
+        BFE_UNIT_CHECK(Statistics.nOverruns == THREAD_MODULE_STATISTICS_SIZE);
+        BFE_UNIT_CHECK(isEqual(Statistics.fMin, 0.2));
+        BFE_UNIT_CHECK(isEqual(Statistics.fP50, 0.2));
+        BFE_UNIT_CHECK(isEqual(Statistics.fSleepMean, 0.0));
+    }
+
+    //--- Query by com interface ---//
+    {
+        CTestModule Render("Render Module");
+        Render.recordFrame(0.001, 0.015);
+
+        // Modules are listed once registered
+        CComInterface ComInterface;
+        std::string strResult = ComInterface.call<std::string>("module_stats", std::string("Render_Module"));
+        BFE_UNIT_CHECK(strResult.find("No module") == 0u);
+        Render.registerModule();
+        Render.registerModule();
+
+        strResult = ComInterface.call<std::string>("module_stats", std::string("Render_Module"));
+        INFO_MSG("Unit test", strResult)
+        BFE_UNIT_CHECK(strResult.find("Render Module: frames 1,") == 0u);
+        BFE_UNIT_CHECK(strResult.find("Physics") == std::string::npos);
+
+        strResult = ComInterface.call<std::string>("module_stats", std::string(""));
+        BFE_UNIT_CHECK(strResult.find("Render Module") != std::string::npos);
+        BFE_UNIT_CHECK(strResult.find("Physics Module") != std::string::npos);
+        BFE_UNIT_CHECK(strResult.find("Render Module") == strResult.rfind("Render Module"));
+
+        strResult = ComInterface.call<std::string>("module_stats", std::string("Unknown"));
+        BFE_UNIT_CHECK(strResult.find("No module") == 0u);
+    }
+    BFE_UNIT_CHECK(IThreadModule::getStatisticsText("Render_Module").find("No module") == 0u);
+
+    INFO_MSG("Unit test", "... finished. Test successful.")
+    return EXIT_SUCCESS;
+}
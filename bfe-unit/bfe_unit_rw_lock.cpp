@@ -0,0 +1,251 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_unit_rw_lock.cpp
+/// \brief      Main program for unit test of reader-writer lock and seqlock
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-13
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <thread>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
+#include "log.h"
+#include "com_interface.h"
+#include "rw_spinlock.h"
+#include "seqlock.h"
+#include "bfe_unit.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+//--- Constants --------------------------------------------------------------//
+static constexpr int NUMBER_OF_READERS = 4;
+static constexpr int NUMBER_OF_WRITERS = 2;
+static constexpr int NUMBER_OF_WRITES  = 10000;     // Writes per writer thread
+
+/// Value protected by seqlock, both members are always equal when consistent
+struct Pair
+{
+    int nA;     ///< First copy of value
+    int nB;     ///< Second copy of value
+};
+
+CRWSpinlock     g_Lock;
+Pair            g_Pair{0, 0};   // Protected by reader-writer lock
+CSeqlock<Pair>  g_SeqPair;
+
+std::atomic_bool g_bClean(true);
+std::atomic_int  g_nWritersDone(0);
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Increments pairs, protected by write lock and seqlock
+///
+///////////////////////////////////////////////////////////////////////////////
+void write()
+{
+    METHOD_ENTRY("write")
+
+    for (auto i=0; i<NUMBER_OF_WRITES; ++i)
+    {
+        g_Lock.acquireWriteLock();
+        ++g_Pair.nA;
+        ++g_Pair.nB;
+        g_Lock.releaseWriteLock();
+
+        // Read-modify-write isn't atomic, hence only count own writes
+        g_SeqPair.write({i, i});
+    }
+    ++g_nWritersDone;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Reads pairs until writers are done, checking consistency
+///
+///////////////////////////////////////////////////////////////////////////////
+void read()
+{
+    METHOD_ENTRY("read")
+
+    while (g_nWritersDone < NUMBER_OF_WRITERS)
+    {
+        {
+            CReadLockGuard Lock(g_Lock);
+            if (g_Pair.nA != g_Pair.nB) g_bClean = false;
+        }
+        const Pair SeqPair = g_SeqPair.read();
+        if (SeqPair.nA != SeqPair.nB) g_bClean = false;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("Unit test", "Starting unit test...")
+
+    //--- Reader-writer lock, single thread ---//
+    {
+        CRWSpinlock Lock;
+
+        // Multiple (nested) readers, no writer meanwhile
+        BFE_UNIT_CHECK(Lock.tryReadLock() == true);
+        BFE_UNIT_CHECK(Lock.tryReadLock() == true);
+        BFE_UNIT_CHECK(Lock.getReaders() == 2u);
+        BFE_UNIT_CHECK(Lock.tryWriteLock() == false);
+        Lock.releaseReadLock();
+        BFE_UNIT_CHECK(Lock.tryWriteLock() == false);
+        Lock.releaseReadLock();
+        BFE_UNIT_CHECK(Lock.getReaders() == 0u);
+
+        // Single writer, no readers meanwhile
+        BFE_UNIT_CHECK(Lock.tryWriteLock() == true);
+        BFE_UNIT_CHECK(Lock.isWriteLocked() == true);
+        BFE_UNIT_CHECK(Lock.tryWriteLock() == false);
+        BFE_UNIT_CHECK(Lock.tryReadLock() == false);
+        Lock.releaseWriteLock();
+        BFE_UNIT_CHECK(Lock.isWriteLocked() == false);
+
+        {
+            CWriteLockGuard Guard(Lock);
+            BFE_UNIT_CHECK(Lock.isWriteLocked() == true);
+        }
+        BFE_UNIT_CHECK(Lock.isWriteLocked() == false);
+    }
+
+    //--- Reader-writer lock, waiting writer ---//
+    {
+        CRWSpinlock Lock;
+        std::atomic_bool bRead(false);
+        std::atomic_bool bNested(false);
+        std::atomic_bool bRelease(false);
+
+        // Reader holding the lock while a writer waits
+        std::thread Reader([&]
+        {
+            Lock.acquireReadLock();
+            bRead = true;
+            while (!Lock.isWritePending()) std::this_thread::yield();
+            bNested = Lock.tryReadLock();
+            if (bNested) Lock.releaseReadLock();
+            while (!bRelease) std::this_thread::yield();
+            Lock.releaseReadLock();
+        });
+        while (!bRead) std::this_thread::yield();
+        std::thread Writer([&]
+        {
+            CWriteLockGuard Guard(Lock);
+        });
+        while (!Lock.isWritePending()) std::this_thread::yield();
+
+        // New readers don't enter, nested ones do
+        BFE_UNIT_CHECK(Lock.tryReadLock() == false);
+        bRelease = true;
+        Reader.join();
+        Writer.join();
+        BFE_UNIT_CHECK(bNested == true);
+        BFE_UNIT_CHECK(Lock.getReaders() == 0u);
+        BFE_UNIT_CHECK(Lock.isWritePending() == false);
+        BFE_UNIT_CHECK(Lock.tryReadLock() == true);
+        Lock.releaseReadLock();
+    }
+
+    //--- Seqlock, single thread ---//
+    {
+        CSeqlock<Pair> SeqPair({1, 2});
+        BFE_UNIT_CHECK(SeqPair.getSequence() == 0u);
+        BFE_UNIT_CHECK(SeqPair.read().nA == 1 && SeqPair.read().nB == 2);
+        SeqPair.write({3, 4});
+        BFE_UNIT_CHECK(SeqPair.getSequence() == 2u);
+        BFE_UNIT_CHECK(SeqPair.read().nA == 3 && SeqPair.read().nB == 4);
+
+        CSeqlock<double> SeqDouble;
+        BFE_UNIT_CHECK(SeqDouble.read() == 0.0);
+    }
+
+    //--- Concurrent readers and writers ---//
+    {
+        std::vector<std::thread> Threads;
+        for (auto i=0; i<NUMBER_OF_READERS; ++i) Threads.emplace_back(read);
+        for (auto i=0; i<NUMBER_OF_WRITERS; ++i) Threads.emplace_back(write);
+        for (auto& Thread : Threads) Thread.join();
+
+        BFE_UNIT_CHECK(g_bClean == true);
+        BFE_UNIT_CHECK(g_Pair.nA == NUMBER_OF_WRITERS*NUMBER_OF_WRITES);
+        BFE_UNIT_CHECK(g_SeqPair.getSequence() == 2u*NUMBER_OF_WRITERS*NUMBER_OF_WRITES);
+        BFE_UNIT_CHECK(g_SeqPair.read().nA == NUMBER_OF_WRITES-1);
+    }
+
+    //--- Com interface, calls while registering ---//
+    {
+        CComInterface ComInterface;
+        ComInterface.registerFunction("unit_test_value",
+                                      CCommand<int>([]() -> int {return 42;}),
+                                      "Returns test value");
+
+        std::atomic_bool bDone(false);
+        std::vector<std::thread> Threads;
+        for (auto i=0; i<NUMBER_OF_READERS; ++i)
+        {
+            Threads.emplace_back([&]
+            {
+                while (!bDone)
+                {
+                    if (ComInterface.call<int>("unit_test_value") != 42) g_bClean = false;
+                }
+            });
+        }
+        for (auto i=0; i<100; ++i)
+        {
+            ComInterface.registerFunction("unit_test_value_" + std::to_string(i),
+                                          CCommand<int>([i]() -> int {return i;}),
+                                          "Returns test value");
+        }
+        bDone = true;
+        for (auto& Thread : Threads) Thread.join();
+
+        BFE_UNIT_CHECK(g_bClean == true);
+        BFE_UNIT_CHECK(ComInterface.call<int>("unit_test_value_99") == 99);
+        BFE_UNIT_CHECK(ComInterface.call(std::string("unit_test_value_7")) == "7");
+    }
+
+    INFO_MSG("Unit test", "... finished. Test successful.")
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_unit_slot_map.cpp
+/// \brief      Main program for unit test of slot map
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-04
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <string>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
+#include "log.h"
+#include "slot_map.h"
+#include "bfe_unit.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Outputs the dense range of the slot map
+///
+/// \param _strAction String, explaining which operation was done
+/// \param _SlotMap Slot map to output
+///
+///////////////////////////////////////////////////////////////////////////////
+void outputDenseRange(const std::string& _strAction, const CSlotMap<std::string>& _SlotMap)
+{
+    METHOD_ENTRY("outputDenseRange")
+    INFO_BLK(
+        std::cout << _strAction << std::endl;
+        std::cout << "  Dense range: ";
+        for (auto i=0u; i<_SlotMap.size(); ++i)
+        {
+            std::cout << _SlotMap.data()[i] << "(" << _SlotMap.getID(i).C.Index << ") ";
+        }
+        std::cout << std::endl;
+    )
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("Unit test", "Starting unit test...")
+
+    CSlotMap<std::string> SlotMap;
+
+    HandleID ID1 = SlotMap.insert("one");
+    HandleID ID2 = SlotMap.insert("two");
+    HandleID ID3 = SlotMap.emplace(3, 't');
+    HandleID ID4 = SlotMap.insert("four");
+    outputDenseRange("Inserted four objects", SlotMap);
+    BFE_UNIT_CHECK(SlotMap.size() == 4u);
+    BFE_UNIT_CHECK(*SlotMap.get(ID1) == "one");
+    BFE_UNIT_CHECK(*SlotMap.get(ID3) == "ttt");
+
+    // Removing from the middle moves the last object into the gap
+    BFE_UNIT_CHECK(SlotMap.remove(ID2) == true);
+    outputDenseRange("Removed object two", SlotMap);
+    BFE_UNIT_CHECK(SlotMap.size() == 3u);
+    BFE_UNIT_CHECK(SlotMap.isValid(ID2) == false);
+    BFE_UNIT_CHECK(SlotMap.get(ID2) == nullptr);
+    BFE_UNIT_CHECK(SlotMap.data()[1] == "four");
+    BFE_UNIT_CHECK(*SlotMap.get(ID4) == "four");
+    BFE_UNIT_CHECK(SlotMap.getID(1).Raw == ID4.Raw);
+    BFE_UNIT_CHECK(SlotMap.remove(ID2) == false);
+
+    // Freed slot is reused with a new counter, the stale handle stays invalid
+    HandleID ID5 = SlotMap.insert("five");
+    outputDenseRange("Inserted object five", SlotMap);
+    BFE_UNIT_CHECK(ID5.C.Index == ID2.C.Index);
+    BFE_UNIT_CHECK(ID5.C.Counter != ID2.C.Counter);
+    BFE_UNIT_CHECK(SlotMap.isValid(ID2) == false);
+    BFE_UNIT_CHECK(*SlotMap.get(ID5) == "five");
+
+    // Dense range holds all objects without gaps
+    std::string strAll;
+    for (const auto& strObj : SlotMap) strAll += strObj;
+    BFE_UNIT_CHECK(strAll == "onefourtttfive");
+
+    // Removing the last object does not move anything
+    BFE_UNIT_CHECK(SlotMap.remove(ID5) == true);
+    BFE_UNIT_CHECK(*SlotMap.get(ID1) == "one");
+    BFE_UNIT_CHECK(*SlotMap.get(ID3) == "ttt");
+    BFE_UNIT_CHECK(*SlotMap.get(ID4) == "four");
+
+    SlotMap.clear();
+    outputDenseRange("Cleared slot map", SlotMap);
+    BFE_UNIT_CHECK(SlotMap.empty() == true);
+    BFE_UNIT_CHECK(SlotMap.isValid(ID1) == false);
+    BFE_UNIT_CHECK(SlotMap.isValid(ID4) == false);
+
+    // Many insertions and removals keep handles and dense range consistent
+    std::vector<HandleID> IDs;
+    for (auto i=0; i<1000; ++i) IDs.push_back(SlotMap.insert(std::to_string(i)));
+    for (auto i=0; i<1000; i+=3) BFE_UNIT_CHECK(SlotMap.remove(IDs[i]) == true);
+    for (auto i=0; i<1000; ++i)
+    {
+        if (i % 3 == 0)
+        {
+            BFE_UNIT_CHECK(SlotMap.isValid(IDs[i]) == false);
+        }
+        else
+        {
+            BFE_UNIT_CHECK(*SlotMap.get(IDs[i]) == std::to_string(i));
+        }
+    }
+    for (auto i=0u; i<SlotMap.size(); ++i)
+    {
+        BFE_UNIT_CHECK(SlotMap.get(SlotMap.getID(i)) == &SlotMap.data()[i]);
+    }
+
+    INFO_MSG("Unit test", "... finished. Test successful.")
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_unit_thread_settings.cpp
+/// \brief      Main program for unit test of thread settings of modules
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-16
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/resource.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+//--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
+#include "log.h"
+#include "com_interface.h"
+#include "thread_module.h"
+#include "bfe_unit.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+/// Module with a name of its own, processing nothing
+class CTestModule : public IThreadModule
+{
+    public:
+        explicit CTestModule(const std::string& _strName) {m_strModuleName = _strName;}
+        bool processFrame() override {return true;}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("Unit test", "Starting unit test...")
+
+    CTestModule Render("Render Module");
+    Render.registerModule();
+
+    //--- Parsing of settings ---//
+    {
+        BFE_UNIT_CHECK(Render.getThreadSettings().Cores.empty());
+        BFE_UNIT_CHECK(Render.getThreadSettings().SchedulingPolicy == SchedulingPolicyType::DEFAULT);
+        BFE_UNIT_CHECK(Render.getThreadSettings().bNice == false);
+
+        BFE_UNIT_CHECK(Render.setCores(std::string("0,2-4,7")));
+        BFE_UNIT_CHECK((Render.getThreadSettings().Cores == std::vector<int>{0, 2, 3, 4, 7}));
+        BFE_UNIT_CHECK(Render.setCores(std::string("3-1")) == false);
+        BFE_UNIT_CHECK(Render.setCores(std::string("a")) == false);
+        BFE_UNIT_CHECK(Render.setCores(std::string("")) == false);
+        BFE_UNIT_CHECK(Render.getThreadSettings().Cores.size() == 5u);
+        BFE_UNIT_CHECK(Render.setCores(std::string("all")));
+        BFE_UNIT_CHECK(Render.getThreadSettings().Cores.size() == std::max(1u, std::thread::hardware_concurrency()));
+
+        BFE_UNIT_CHECK(Render.setSchedulingPolicy(std::string("batch")));
+        BFE_UNIT_CHECK(Render.getThreadSettings().SchedulingPolicy == SchedulingPolicyType::BATCH);
+        BFE_UNIT_CHECK(Render.setSchedulingPolicy(std::string("realtime")) == false);
+        BFE_UNIT_CHECK(Render.getThreadSettings().SchedulingPolicy == SchedulingPolicyType::BATCH);
+    }
+
+    //--- Configuration by com interface ---//
+    {
+        CComInterface ComInterface;
+        ComInterface.call<void>("module_set_cores", std::string("Render_Module"), std::string("0"));
+        ComInterface.call<void>("module_set_nice", std::string("Render_Module"), 5);
+        ComInterface.call<void>("module_set_scheduling", std::string("Render_Module"), std::string("other"));
+
+        const ThreadSettings Settings = Render.getThreadSettings();
+        BFE_UNIT_CHECK(Settings.Cores == std::vector<int>{0});
+        BFE_UNIT_CHECK(Settings.bNice == true);
+        BFE_UNIT_CHECK(Settings.nNice == 5);
+        BFE_UNIT_CHECK(Settings.SchedulingPolicy == SchedulingPolicyType::OTHER);
+    }
+
+    //--- Settings applied to thread ---//
+    #ifdef __linux__
+    {
+        bool bApplied = false;
+        bool bCores = false;
+        bool bNice = false;
+        std::string strName;
+
+        std::thread Thread([&]
+        {
+            bApplied = Render.applyThreadSettings();
+
+            cpu_set_t Cores;
+            CPU_ZERO(&Cores);
+            pthread_getaffinity_np(pthread_self(), sizeof(Cores), &Cores);
+            bCores = CPU_ISSET(0, &Cores) && CPU_COUNT(&Cores) == 1;
+
+            bNice = getpriority(PRIO_PROCESS, id_t(syscall(SYS_gettid))) == 5;
+
+            char achName[16];
+            pthread_getname_np(pthread_self(), achName, sizeof(achName));
+            strName = achName;
+        });
+        Thread.join();
+
+        BFE_UNIT_CHECK(bApplied);
+        BFE_UNIT_CHECK(bCores);
+        BFE_UNIT_CHECK(bNice);
+        BFE_UNIT_CHECK(strName == "Render Module");
+    }
+    #endif
+
+    INFO_MSG("Unit test", "... finished. Test successful.")
+    return EXIT_SUCCESS;
+}
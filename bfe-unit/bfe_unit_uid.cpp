@@ -37,13 +37,17 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 //--- Standard header --------------------------------------------------------//
+#include <utility>
+#include <vector>
 
 //--- Program header ---------------------------------------------------------//
-#include "conf_pw.h"
+#include "conf_bfengine.h"
 #include "uid.h"
 
 //--- Misc-Header ------------------------------------------------------------//
 
+using namespace bfe;
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// \brief Outputs data of UID internal structures
@@ -313,7 +317,47 @@ int main()
         ERROR_MSG("Unit test", "Incorrect default string (uid12=" << UID12.getName() << ")")
         return EXIT_FAILURE;
     }
-    
+    // Moving should transfer the reference without changing the counter
+    {
+        CUID UID14;
+        const UIDType nUID14 = UID14.getValue();
+        CUID UID15(std::move(UID14));
+        outputInternalUIDData("1x Move constructor");
+        if (UID15.getValue() != nUID14 || UID14.getValue() != 0u ||
+            CUIDAllocator::getInstance().getReferences(nUID14) != 1u)
+        {
+            ERROR_MSG("Unit test", "Incorrect uid value after move (uid15=" << UID15.getValue() << ")")
+            return EXIT_FAILURE;
+        }
+        if (UID15.getName() != "UID_"+std::to_string(nUID14))
+        {
+            ERROR_MSG("Unit test", "Incorrect default string (uid15=" << UID15.getName() << ")")
+            return EXIT_FAILURE;
+        }
+        CUID UID16;
+        const UIDType nUID16 = UID16.getValue();
+        UID16.setName("Moved");
+        UID15 = std::move(UID16);
+        outputInternalUIDData("1x Move assignment operator");
+        if (UID15.getValue() != nUID16 || UID15.getName() != "Moved" ||
+            CUIDAllocator::getInstance().getReferences(nUID14) != 0u ||
+            CUIDAllocator::getInstance().getReferences(nUID16) != 1u)
+        {
+            ERROR_MSG("Unit test", "Incorrect uid value after move (uid15=" << UID15.getValue() << ")")
+            return EXIT_FAILURE;
+        }
+        
+        // Reallocation of vectors shouldn't copy
+        std::vector<CUID> UIDs(1);
+        const UIDType nUID = UIDs.front().getValue();
+        for (auto i=0; i<100; ++i) UIDs.emplace_back();
+        if (UIDs.front().getValue() != nUID ||
+            CUIDAllocator::getInstance().getReferences(nUID) != 1u)
+        {
+            ERROR_MSG("Unit test", "Incorrect uid value after reallocation (uid=" << UIDs.front().getValue() << ")")
+            return EXIT_FAILURE;
+        }
+    }
  
     INFO_MSG("Unit test", "...done. Test successful.")
     return EXIT_SUCCESS;
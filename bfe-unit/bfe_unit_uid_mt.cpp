@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_unit_uid_mt.cpp
+/// \brief      Main program for multi-threaded unit test of unique ids
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-10
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "conf_bfengine.h"
+#include "log.h"
+#include "uid.h"
+#include "bfe_unit.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+//--- Constants --------------------------------------------------------------//
+static constexpr int NUMBER_OF_THREADS = 4;
+static constexpr int NUMBER_OF_UIDS    = 500;   // UIDs per thread and round
+static constexpr int NUMBER_OF_ROUNDS  = 200;
+static constexpr int NUMBER_OF_OWNERS  = 1 << 16;
+
+std::atomic<std::vector<CUID>*> g_Mailboxes[NUMBER_OF_THREADS];
+std::atomic<int>                g_Owners[NUMBER_OF_OWNERS];
+std::atomic_int                 g_nErrors;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Releases ownership of UIDs and destroys them
+///
+/// \param _pUIDs UIDs to be destroyed
+///
+///////////////////////////////////////////////////////////////////////////////
+void destroy(std::vector<CUID>* const _pUIDs)
+{
+    METHOD_ENTRY("destroy")
+
+    if (_pUIDs == nullptr) return;
+    for (const auto& UID : *_pUIDs)
+    {
+        g_Owners[UID.getValue()].store(0);
+    }
+    delete _pUIDs;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Creates and copies UIDs, passing them to the next thread
+///
+/// Each UID that is handed out is claimed by the thread, hence, two living
+/// UIDs with the same value would be detected. Since UIDs are destroyed by
+/// another thread, released UIDs are passed between threads.
+///
+/// \param _nThread Number of thread
+///
+///////////////////////////////////////////////////////////////////////////////
+void run(const int _nThread)
+{
+    METHOD_ENTRY("run")
+
+    for (auto r=0; r<NUMBER_OF_ROUNDS; ++r)
+    {
+        std::vector<CUID>* pUIDs = new std::vector<CUID>(NUMBER_OF_UIDS);
+        for (const auto& UID : *pUIDs)
+        {
+            int nUnowned = 0;
+            if (UID.getValue() == 0u || UID.getValue() >= NUMBER_OF_OWNERS ||
+                !g_Owners[UID.getValue()].compare_exchange_strong(nUnowned, _nThread+1))
+            {
+                ++g_nErrors;
+            }
+        }
+        for (const auto& UID : *pUIDs)
+        {
+            CUID Copy(UID);
+            if (Copy.getValue() != UID.getValue()) ++g_nErrors;
+            if (CUIDAllocator::getInstance().getReferences(UID.getValue()) != 2u) ++g_nErrors;
+        }
+        destroy(g_Mailboxes[(_nThread+1) % NUMBER_OF_THREADS].exchange(pUIDs));
+        destroy(g_Mailboxes[_nThread].exchange(nullptr));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("Unit test", "Starting multi-threaded unit test...")
+
+    g_nErrors = 0;
+    for (auto& Mailbox : g_Mailboxes) Mailbox.store(nullptr);
+    for (auto& Owner : g_Owners) Owner.store(0);
+
+    std::vector<std::thread> Threads;
+    for (auto i=0; i<NUMBER_OF_THREADS; ++i) Threads.emplace_back(run, i);
+    for (auto& Thread : Threads) Thread.join();
+    for (auto& Mailbox : g_Mailboxes) destroy(Mailbox.exchange(nullptr));
+
+    INFO_MSG("Unit test", "Errors: " << g_nErrors)
+    BFE_UNIT_CHECK(g_nErrors == 0);
+    BFE_UNIT_CHECK(CUID::getReferencedUIDs().empty());
+
+    // UIDs are reused, hence, new ones are only taken if not enough UIDs are
+    // cached by threads or in the global pool. At most two generations per
+    // thread are alive at the same time.
+    const UIDType nCounter = CUIDAllocator::getInstance().getCounter();
+    INFO_MSG("Unit test", "UID counter: " << nCounter)
+    BFE_UNIT_CHECK(nCounter <= 2*NUMBER_OF_THREADS*(2*NUMBER_OF_UIDS+UID_CACHE_SIZE_MAX+UID_BLOCK_SIZE));
+
+    // Default names are read concurrently
+    {
+        const CUID Shared;
+        const std::string strName("UID_"+std::to_string(Shared.getValue()));
+        std::vector<std::thread> Readers;
+        for (auto i=0; i<NUMBER_OF_THREADS; ++i)
+        {
+            Readers.emplace_back([&]
+            {
+                for (auto j=0; j<NUMBER_OF_UIDS; ++j) if (Shared.getName() != strName) ++g_nErrors;
+            });
+        }
+        for (auto& Reader : Readers) Reader.join();
+        BFE_UNIT_CHECK(g_nErrors == 0);
+    }
+
+    INFO_MSG("Unit test", "... finished. Test successful.")
+    return EXIT_SUCCESS;
+}
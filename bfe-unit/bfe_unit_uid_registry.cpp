@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of BFEngine, a 2D simulation engine.
+// Copyright (C) 2019 Torsten Büschenfeld
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file       bfe_unit_uid_registry.cpp
+/// \brief      Main program for unit test of UID registry
+///
+/// \author     Torsten Büschenfeld (planeworld@bfeld.eu)
+/// \date       2019-03-11
+///
+////////////////////////////////////////////////////////////////////////////////
+
+//--- Standard header --------------------------------------------------------//
+#include <utility>
+#include <vector>
+
+//--- Program header ---------------------------------------------------------//
+#include "com_interface.h"
+#include "conf_bfengine.h"
+#include "log.h"
+#include "uid_user.h"
+#include "bfe_unit.h"
+
+//--- Misc-Header ------------------------------------------------------------//
+
+using namespace bfe;
+
+/// Object using a UID
+class CObject : public IUIDUser
+{
+    public:
+        int m_nValue = 0;
+};
+
+/// Object of different type using a UID, registered explicitly
+class COther : public IUIDUser
+{
+    public:
+        ~COther() override {this->unregisterUID();}
+};
+
+/// Object registered for its lifetime
+typedef CUIDRegistered<CObject> CRegisteredObject;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \brief Main function
+///
+/// This is the entrance point for program startup.
+///
+/// \return Exit code
+///
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    Log.setColourScheme(LOG_COLOUR_SCHEME_ONBLACK);
+
+    INFO_MSG("Unit test", "Starting unit test...")
+
+    CUIDRegistry& Registry = CUIDRegistry::getInstance();
+
+    BFE_UNIT_CHECK(Registry.get(0u) == nullptr);
+    BFE_UNIT_CHECK(Registry.get(UID_MAX+1u) == nullptr);
+
+    UIDType nDestroyed = 0u;
+    {
+        CRegisteredObject Object;
+        Object.m_nValue = 42;
+        COther Other;
+        nDestroyed = Object.getUID();
+
+        // Objects not created as registered aren't registered until
+        // registered explicitly
+        BFE_UNIT_CHECK(Registry.get(Other.getUID()) == nullptr);
+        BFE_UNIT_CHECK(Other.registerUID());
+        BFE_UNIT_CHECK(Other.isRegistered());
+
+        // Lookup, typed lookup
+        BFE_UNIT_CHECK(Object.isRegistered());
+        BFE_UNIT_CHECK(Registry.get(Object.getUID()) == &Object);
+        BFE_UNIT_CHECK(Registry.get<CObject>(Object.getUID()) == &Object);
+        BFE_UNIT_CHECK(Registry.get<CObject>(Object.getUID())->m_nValue == 42);
+        BFE_UNIT_CHECK(Registry.get<COther>(Object.getUID()) == nullptr);
+        BFE_UNIT_CHECK(Registry.get<COther>(Other.getUID()) == &Other);
+
+        // Plain copies share the UID, the original stays registered
+        {
+            CObject Copy(Object);
+            BFE_UNIT_CHECK(Copy.getUID() == Object.getUID());
+            BFE_UNIT_CHECK(Copy.isRegistered() == false);
+            BFE_UNIT_CHECK(Copy.registerUID() == false);
+            BFE_UNIT_CHECK(Registry.get(Object.getUID()) == &Object);
+        }
+
+        // Registered copies get a new UID
+        {
+            CRegisteredObject Copy(Object);
+            BFE_UNIT_CHECK(Copy.getUID() != Object.getUID());
+            BFE_UNIT_CHECK(Copy.m_nValue == 42);
+            BFE_UNIT_CHECK(Registry.get(Copy.getUID()) == &Copy);
+            BFE_UNIT_CHECK(Registry.get(Object.getUID()) == &Object);
+
+            CRegisteredObject Assigned;
+            Assigned = Copy;
+            BFE_UNIT_CHECK(Assigned.getUID() != Copy.getUID());
+            BFE_UNIT_CHECK(Registry.get(Assigned.getUID()) == &Assigned);
+            BFE_UNIT_CHECK(Registry.get(Copy.getUID()) == &Copy);
+        }
+        BFE_UNIT_CHECK(Registry.get(Object.getUID()) == &Object);
+
+        // Moved objects are registered instead of the source
+        const UIDType nUID = Object.getUID();
+        CRegisteredObject Moved(std::move(Object));
+        BFE_UNIT_CHECK(Moved.getUID() == nUID);
+        BFE_UNIT_CHECK(Object.isRegistered() == false);
+        BFE_UNIT_CHECK(Registry.get(nUID) == &Moved);
+
+        CRegisteredObject Assigned;
+        const UIDType nUIDAssigned = Assigned.getUID();
+        Assigned = std::move(Moved);
+        BFE_UNIT_CHECK(Registry.get(nUID) == &Assigned);
+        BFE_UNIT_CHECK(Registry.get(nUIDAssigned) == nullptr);
+
+        // New ids are registered, old ones are not
+        Assigned.setNewID();
+        BFE_UNIT_CHECK(Registry.get(Assigned.getUID()) == &Assigned);
+        BFE_UNIT_CHECK(Registry.get(nUID) == nullptr);
+
+        // Reallocation of vectors keeps registry up to date
+        std::vector<CRegisteredObject> Objects(1);
+        for (auto i=0; i<100; ++i) Objects.emplace_back();
+        for (const auto& Obj : Objects)
+        {
+            BFE_UNIT_CHECK(Registry.get(Obj.getUID()) == &Obj);
+        }
+
+        // Lookup from the console and scripts
+        CComInterface ComInterface;
+        Assigned.setName("unit_object");
+        BFE_UNIT_CHECK((ComInterface.call<std::string, int>("uid_lookup", int(Assigned.getUID())) == "unit_object"));
+        BFE_UNIT_CHECK(ComInterface.call(std::string("uid_lookup ") + std::to_string(Objects[7].getUID())) ==
+                       Objects[7].getName());
+        BFE_UNIT_CHECK((ComInterface.call<std::string, int>("uid_lookup", 0).empty()));
+        BFE_UNIT_CHECK((ComInterface.call<std::string, int>("uid_lookup", -1).empty()));
+    }
+    // Destroyed objects are unregistered
+    BFE_UNIT_CHECK(Registry.get(nDestroyed) == nullptr);
+
+    INFO_MSG("Unit test", "... finished. Test successful.")
+    return EXIT_SUCCESS;
+}